@@ -5,7 +5,7 @@
 TEMPLATE = app
 TARGET = netlistviz
 
-QMAKE_CXXFLAGS += -std=c++11
+QMAKE_CXXFLAGS += -std=c++17
 
 QT += widgets
 requires(qtConfig(fontcombobox)))
@@ -25,6 +25,14 @@ CONFIG(release, debug|release) {
     DEFINES += TRACE QT_NO_DEBUG_OUTPUT
 }
 
+# gzip netlists, zstd ones with "qmake CONFIG+=zstd"
+LIBS += -lz
+
+zstd {
+    DEFINES += HAVE_ZSTD
+    LIBS += -lzstd
+}
+
 MOC_DIR = ./build
 OBJECTS_DIR = ./build
 RCC_DIR = ./build
@@ -48,26 +56,45 @@ HEADERS += ./Src/Main/MainWindow.h\
            ./Src/Schematic/SchematicTerminal.h\
            ./Src/Schematic/SchematicDot.h\
            ./Src/Schematic/ASGDialog.h\
+           ./Src/Schematic/DeviceListModel.h\
            ./Src/Schematic/SchematicView.h\
            ./Src/Schematic/SConnector.h\
            ./Src/Parser/CktParser.hpp\
            ./Src/Parser/MyParser.h\
+           ./Src/Parser/CktParseState.h\
+           ./Src/Parser/MmapScanner.h\
+           ./Src/Parser/SpiceValue.h\
+           ./Src/Parser/NetlistCache.h\
+           ./Src/Parser/InputSource.h\
+           ./Src/Parser/ParasiticReader.h\
            ./Src/Circuit/Node.h\
            ./Src/Circuit/Terminal.h\
            ./Src/Circuit/CircuitGraph.h\
            ./Src/Circuit/Device.h\
            ./Src/Circuit/Connector.h\
+           ./Src/Circuit/Subckt.h\
+           ./Src/Circuit/CompactGraph.h\
+           ./Src/Circuit/Compressor.h\
+           ./Src/Circuit/RCReducer.h\
+           ./Src/Circuit/DeviceTraits.h\
            ./Src/Define/Define.h\
            ./Src/Define/TypeDefine.h\
            ./Src/ASG/ASG.h\
-           ./Src/ASG/MatrixElement.h\
-           ./Src/ASG/Matrix.h\
            ./Src/ASG/Level.h\
+           ./Src/ASG/Component.h\
+           ./Src/ASG/CrossingReducer.h\
+           ./Src/ASG/LevelGraph.h\
+           ./Src/ASG/Annealer.h\
+           ./Src/ASG/GraphStats.h\
+           ./Src/ASG/LevelBFS.h\
+           ./Src/ASG/NetIndex.h\
            ./Src/ASG/Channel.h\
            ./Src/ASG/TablePlotter.h\
            ./Src/ASG/Wire.h\
            ./Src/ASG/Dot.h\
-           ./Src/Utilities/MyString.h
+           ./Src/Utilities/MyString.h\
+           ./Src/Utilities/NamePool.h\
+           ./Src/Utilities/Arena.h
 
 
 SOURCES += ./Src/Main/Main.cpp\
@@ -80,29 +107,46 @@ SOURCES += ./Src/Main/Main.cpp\
            ./Src/Schematic/SchematicTerminal.cpp\
            ./Src/Schematic/SchematicDot.cpp\
            ./Src/Schematic/ASGDialog.cpp\
+           ./Src/Schematic/DeviceListModel.cpp\
            ./Src/Schematic/RenderSchematic.cpp\
            ./Src/Schematic/IOSchematic.cpp\
            ./Src/Schematic/SchematicView.cpp\
            ./Src/Parser/CktScanner.cpp\
            ./Src/Parser/CktParser.cpp\
            ./Src/Parser/MyParser.cpp\
+           ./Src/Parser/MmapScanner.cpp\
+           ./Src/Parser/SpiceValue.cpp\
+           ./Src/Parser/NetlistCache.cpp\
+           ./Src/Parser/InputSource.cpp\
+           ./Src/Parser/ParasiticReader.cpp\
            ./Src/Circuit/Node.cpp\
            ./Src/Circuit/Terminal.cpp\
            ./Src/Circuit/CircuitGraph.cpp\
            ./Src/Circuit/Device.cpp\
+           ./Src/Circuit/Subckt.cpp\
+           ./Src/Circuit/CompactGraph.cpp\
+           ./Src/Circuit/Compressor.cpp\
+           ./Src/Circuit/RCReducer.cpp\
            ./Src/ASG/ASG.cpp\
            ./Src/ASG/LogicalPlacement.cpp\
            ./Src/ASG/LogicalRouting.cpp\
            ./Src/ASG/GeometricalPlacement.cpp\
            ./Src/ASG/GeometricalRouting.cpp\
-           ./Src/ASG/MatrixElement.cpp\
-           ./Src/ASG/Matrix.cpp\
            ./Src/ASG/Level.cpp\
+           ./Src/ASG/Component.cpp\
+           ./Src/ASG/CrossingReducer.cpp\
+           ./Src/ASG/LevelGraph.cpp\
+           ./Src/ASG/Annealer.cpp\
+           ./Src/ASG/GraphStats.cpp\
+           ./Src/ASG/LevelBFS.cpp\
+           ./Src/ASG/NetIndex.cpp\
            ./Src/ASG/Channel.cpp\
            ./Src/ASG/TablePlotter.cpp\
            ./Src/ASG/Wire.cpp\
            ./Src/ASG/Dot.cpp\
-           ./Src/Utilities/MyString.cpp
+           ./Src/Utilities/MyString.cpp\
+           ./Src/Utilities/NamePool.cpp\
+           ./Src/Utilities/Arena.cpp
 
 
 RESOURCES += ./Src/Schematic/Schematic.qrc
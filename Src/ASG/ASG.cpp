@@ -1,15 +1,20 @@
 #include "ASG.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <QDebug>
 #include <QString>
-#include "Matrix.h"
-#include "MatrixElement.h"
+#include <QThread>
 #include "TablePlotter.h"
 #include "Circuit/Device.h"
 #include "Circuit/Node.h"
 #include "Circuit/CircuitGraph.h"
+#include "Circuit/CompactGraph.h"
 #include "Level.h"
+#include "Component.h"
+#include "NetIndex.h"
+#include "GraphStats.h"
 #include "Channel.h"
-#include "Circuit/Connector.h"
 #include "Terminal.h"
 
 
@@ -17,13 +22,15 @@ ASG::ASG(CircuitGraph *ckt)
 {
     Q_ASSERT(ckt);
     m_ckt = ckt;
-    m_matrix = nullptr;
+    m_compact = nullptr;
+    m_nets = nullptr;
     m_levelPlotter = nullptr;
     m_logDataDestroyed = false;
+    m_crossingsBefore = 0;
+    m_crossingsAfter = 0;
+    m_passThreads = 1;
     m_ignoreCap = IgnoreGCap;
-
-    m_visited = new int[m_ckt->DeviceCount()];  
-    memset(m_visited, 0, sizeof(int) * m_ckt->DeviceCount());
+    m_deviceOrder = NetlistOrder;
 
     Prepare();
 }
@@ -31,11 +38,15 @@ ASG::ASG(CircuitGraph *ckt)
 ASG::ASG()
 {
     m_ckt = nullptr;
-    m_matrix = nullptr;
-    m_visited = nullptr;
+    m_compact = nullptr;
+    m_nets = nullptr;
     m_levelPlotter = nullptr;
     m_logDataDestroyed = false;
+    m_crossingsBefore = 0;
+    m_crossingsAfter = 0;
+    m_passThreads = 1;
     m_ignoreCap = IgnoreGCap;
+    m_deviceOrder = NetlistOrder;
 }
 
 ASG::~ASG()
@@ -43,20 +54,18 @@ ASG::~ASG()
 #ifdef TRACE
     qInfo() << LINE_INFO << endl;
 #endif
-    if (m_matrix) delete m_matrix;
-    delete []m_visited;
+    if (m_nets) delete m_nets;
     
-    foreach (Level *level, m_levels)
-        delete level;
-    m_levels.clear();
+    /* levels and channels */
+    DestroyComponents();
 
     if (m_levelPlotter)
         delete m_levelPlotter;
 
-    /* dots are destroyed in channel */
-    foreach (Channel *channel, m_channels)
-        delete channel;
-    m_channels.clear();
+    /* dots and wires */
+    foreach (Arena *arena, m_threadArenas)
+        delete arena;
+    m_threadArenas.clear();
 
     m_sdeviceList.clear();
     m_inChannelSWireList.clear();
@@ -69,15 +78,6 @@ void ASG::SetCircuitgraph(CircuitGraph *ckt)
     Q_ASSERT(ckt);
     m_ckt = ckt;
 
-    if (m_matrix) {
-        delete m_matrix;
-        m_matrix = nullptr;
-    }
-
-    if (m_visited) delete []m_visited;
-    m_visited = new int[m_ckt->DeviceCount()];
-    memset(m_visited, 0, sizeof(int) * m_ckt->DeviceCount());
-
     m_logDataDestroyed = false;
 
     Prepare();
@@ -89,46 +89,33 @@ int ASG::Prepare()
     qInfo() << LINE_INFO << endl;
 #endif
 
-    int error = LinkDevice();
+    /* the circuit is complete now, passes below read the frozen arrays */
+    m_compact = m_ckt->Freeze();
+#ifdef TRACE
+    qInfo() << "compact graph " << m_compact->MemoryBytes() << " bytes" << endl;
+#endif
 
-    return error;
+    /* nets are queried as a whole, device pairs are never listed */
+    if (m_nets) delete m_nets;
+    m_nets = new NetIndex(m_compact);
+
+    return OKAY;
 }
 
-/* Add connected devices to device, include connecting by gnd */
-int ASG::LinkDevice()
+/* first levels as CalLogicalCol() will take them */
+int ASG::CollectStats(GraphStats *stats) const
 {
-    /* Clear connections firstly */
-    foreach (Device *dev, m_ckt->GetDeviceList())
-        dev->ClearConnectors();
-
-    Node *node = nullptr;
-    Device *fromDev = nullptr, *toDev = nullptr;
-    foreach (node, m_ckt->GetNodeList()) {
-        foreach (fromDev, node->ConnectDeviceList()) {
-            foreach (toDev, node->ConnectDeviceList()) {
-                if (fromDev == toDev) continue;
-                fromDev->AddConnectDevice(toDev);
-            }
-        }
-    }
+    Q_ASSERT(stats AND m_compact);
 
-#ifdef DEBUGx
-    printf("--------------- Connect Devices ---------------\n");
-    QString tmp = "";
-    foreach (Device *dev, m_ckt->GetDeviceList()) {
-        qDebug() << dev->Name();
-        foreach (Connector *cd, dev->Connectors()) {
-            tmp += ("thisTer(" + QString::number(cd->thisTerminal->Id()) + "), ");
-            tmp += ("connectDev(" + cd->connectDevice->Name() + "), ");
-            tmp += ("connectTer(" + QString::number(cd->connectTerminal->Id()) + ")");
-            qInfo() << tmp;
-            tmp = "";
-        }
-    }
-    printf("-----------------------------------------------\n");
-#endif
+    std::vector<int> component;
+    int count = m_compact->Components(&component);
 
-    return OKAY;
+    std::vector<std::vector<int>> firstLevels;
+    int error = FirstLevelDevices(m_ckt->FirstLevelDeviceList(), component, count, &firstLevels);
+    if (error)
+        return ERROR;
+
+    return stats->Collect(m_compact, component, count, firstLevels);
 }
 
 void ASG::DestroyLogicalData()
@@ -137,31 +124,82 @@ void ASG::DestroyLogicalData()
     if (m_ckt) {
         delete m_ckt;
         m_ckt = nullptr;
+        m_compact = nullptr;
     }
 
-    /* channels and wires */
-    foreach (Channel *ch, m_channels)
-        delete ch;
-    m_channels.clear();
+    if (m_nets) {
+        delete m_nets;
+        m_nets = nullptr;
+    }
 
-    foreach (Level *level, m_levels)
-        delete level;
-    m_levels.clear();
+    DestroyComponents();
 
-    /* Matrix and it's elements */
-    if (m_matrix) {
-        delete m_matrix;
-        m_matrix = nullptr;
-    }
+    /* wires and dots */
+    m_arena.Reset();
+    foreach (Arena *arena, m_threadArenas)
+        delete arena;
+    m_threadArenas.clear();
 
     m_logDataDestroyed = true;
 }
 
+void ASG::DestroyComponents()
+{
+    foreach (Component *component, m_components)
+        delete component;
+    m_components.clear();
+}
+
+/*
+ * Components share no level, so pass may run on several at once. Threads
+ * take the next component of a queue, big ones come first so that the
+ * last one taken is small. Small circuits stay on this thread. A pass
+ * that spawns threads itself takes m_passThreads, the cores left to each
+ * component thread, so the two never oversubscribe.
+ */
+int ASG::ForEachComponent(const std::function<int(Component*, Arena*)> &pass)
+{
+    ComponentList queue = m_components;
+    std::stable_sort(queue.begin(), queue.end(), [](Component *a, Component *b) {
+        return a->DeviceCount() > b->DeviceCount();
+    });
+
+    int threads = QThread::idealThreadCount();
+    if (m_compact->DeviceCount() < COMPONENT_PARALLEL_MIN_DEVICES)
+        threads = 1;
+    threads = qMax(qMin(threads, queue.size()), 1);
+    m_passThreads = qMax(QThread::idealThreadCount() / threads, 1);
+    while (m_threadArenas.size() < threads - 1)
+        m_threadArenas.push_back(new Arena());
+
+    std::atomic<int> next(0);
+    std::atomic<int> error(OKAY);
+    auto work = [this, &pass, &queue, &next, &error](int tid) {
+        Arena *arena = (tid == 0) ? &m_arena : m_threadArenas.at(tid - 1);
+        for (int i = next++; i < queue.size(); i = next++) {
+            if (pass(queue.at(i), arena))
+                error = ERROR;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (int tid = 1; tid < threads; ++ tid)
+        workers.emplace_back(work, tid);
+    work(0);
+    for (std::thread &worker : workers)
+        worker.join();
+
+    return error;
+}
+
 
 /* Print and Plot */
 void ASG::PlotLevels(const QString &title)
 {
-    if (m_levels.size() < 1)
+    LevelList levels;
+    foreach (Component *component, m_components)
+        levels.append(component->Levels());
+    if (levels.size() < 1)
         return;
     
     if (m_levelPlotter) {
@@ -172,25 +210,25 @@ void ASG::PlotLevels(const QString &title)
     }
 
     int maxDeviceCountInLevel = -1;
-    foreach (Level *level, m_levels) {
+    foreach (Level *level, levels) {
         if (level->AllDeviceCount() > maxDeviceCountInLevel)
             maxDeviceCountInLevel = level->AllDeviceCount();
     }
 
-    m_levelPlotter->SetTableRowColCount(maxDeviceCountInLevel, m_levels.size());
+    m_levelPlotter->SetTableRowColCount(maxDeviceCountInLevel, levels.size());
 
     /* header */
     QStringList headerText;
-    for (int i = 0; i < m_levels.size(); ++ i) {
-        QString tmp = "L" + QString::number(m_levels.at(i)->Id());
+    for (int i = 0; i < levels.size(); ++ i) {
+        QString tmp = "L" + QString::number(levels.at(i)->Id());
         headerText << tmp;
     }
     m_levelPlotter->SetColHeaderText(headerText);
 
     /* content */
     int row = 0;
-    for (int i = 0; i < m_levels.size(); ++ i) {
-        Level *level = m_levels.at(i);
+    for (int i = 0; i < levels.size(); ++ i) {
+        Level *level = levels.at(i);
         row = 0;
         foreach (Device *dev, level->AllDevices()) {
             m_levelPlotter->AddItem(row, i, dev->Name());
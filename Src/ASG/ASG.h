@@ -5,18 +5,26 @@
  * @filename : ASG.h
  * @author   : Hao Limin
  * @date     : 2020.09.12
- * @desp     : Automatic Schematic Generator.
+ * @desp     : Automatic Schematic Generator. Connected components are
+ *           : laid out apart, their passes spread over threads, and
+ *           : the placed components are packed on shelves of the scene.
  * @modified : Hao Limin, 2020.09.24
  * @modified : Hao Limin, 2020.09.26
  */
 
+#include <functional>
+#include <vector>
 #include "Define/Define.h"
 #include "Define/TypeDefine.h"
+#include "Utilities/Arena.h"
 
-class Matrix;
 class TablePlotter;
 class CircuitGraph;
+class CompactGraph;
 class Level;
+class Component;
+class NetIndex;
+class GraphStats;
 class Wire;
 class Channel;
 class Dot;
@@ -35,8 +43,20 @@ public:
 
     void SetCircuitgraph(CircuitGraph *ckt);
     void SetIgnoreCapType(IgnoreCap type) { m_ignoreCap = type; }
+    void SetDeviceOrder(DeviceOrder order) { m_deviceOrder = order; }
+    IgnoreCap   IgnoreCapType() const  { return m_ignoreCap; }
+    DeviceOrder GetDeviceOrder() const { return m_deviceOrder; }
     int  Prepare();
+    /* counts and predicted costs, before LogicalPlacement() */
+    int  CollectStats(GraphStats *stats) const;
+    /* first levels FirstLevelDevices() takes for chosenList, in component order */
+    int  ResolveFirstLevelDevices(const DeviceList &chosenList, DeviceList *devList) const;
+    /* first levels found without a choice */
+    int  AutoFirstLevelDevices(DeviceList *devList) const
+    { return ResolveFirstLevelDevices(DeviceList(), devList); }
     int  LogicalPlacement();
+    /* optional, after LogicalPlacement(), see Annealer */
+    int  AnnealPlacement(int budgetMs);
     int  LogicalRouting();
     int  GeometricalPlacement(SchematicScene *scene);
     int  GeometricalRouting(SchematicScene *scene);
@@ -45,24 +65,20 @@ public:
     void DestroyLogicalData();
     bool DataDestroyed() const { return m_logDataDestroyed; }
 
+    /* wire crossings between adjacent levels, before the sweeps and after them or annealing */
+    qint64 CrossingsBefore() const { return m_crossingsBefore; }
+    qint64 CrossingsAfter() const  { return m_crossingsAfter; }
+
 private:
     DISALLOW_COPY_AND_ASSIGN(ASG);
 
-    /* --------------- Prepare --------------- */
-    int    LinkDevice();
-    /* --------------------------------------- */
-
-
     /* ---------- Logical Placement ---------- */
-    int         BuildIncidenceMatrix();
+    int         RenumberDevices();
     int         CalLogicalCol();
+    int         FirstLevelDevices(const DeviceList &chosenList, const std::vector<int> &component,
+                                  int count, std::vector<std::vector<int>> *firstLevels) const;
     int         CalLogicalRow();
-    int         InsertBasicDevice(Device *device);
-    Level*      CreateNextLevel(Level *preLevel) const;
-    int         ClassifyConnectDeviceByLevel();
-    int         EstimateLogicalRowGap();
-    int         DetermineFirstLevelLogicalRow();
-    int         ForwardPropagateLogicalRow();   // level0 -> level1 -> level2 -> ... -> leveln
+    int         IndexNetsByLevel();
     int         DecideDeviceOrientation();
     int         DecideDeviceWhetherToReverse();
     /* --------------------------------------- */
@@ -76,9 +92,7 @@ private:
 
 
     /* -------- Geometrical Placement -------- */
-    int                CalGeometricalCol();
-    int                TryPutDeviceIntoChannel();
-    int                CalGeometricalRow();
+    int                PackComponents();
     int                CreateSchematicDevices();
     int                RenderSchematicDevices(SchematicScene *scene);
     SchematicDevice*   CreateSchematicDevice(Device *dev) const;
@@ -96,17 +110,25 @@ private:
     /* --------------------------------------- */
 
 
+    /* pass on every component, big ones first, arena of the thread */
+    int  ForEachComponent(const std::function<int(Component*, Arena*)> &pass);
+    void DestroyComponents();
+
     /* Print and Plot */
     void PlotLevels(const QString &title);
 
 
     /* ASG members */
     CircuitGraph      *m_ckt;
-    Matrix            *m_matrix;
-    int               *m_visited;
+    const CompactGraph *m_compact;      // m_ckt->Freeze(), owned by m_ckt
+    NetIndex          *m_nets;         // nets of m_compact by level
+
+    /* Wires and Dots of this run, m_arena is thread 0's */
+    Arena              m_arena;
+    QVector<Arena*>    m_threadArenas;
+    int                m_passThreads;  // threads a pass may spawn, see ForEachComponent()
 
-    LevelList          m_levels;
-    ChannelList        m_channels;
+    ComponentList      m_components;   // by lowest device id
     TablePlotter      *m_levelPlotter;
 
     SDeviceList        m_sdeviceList;
@@ -115,7 +137,10 @@ private:
     SDotList           m_sdotList;
 
     bool               m_logDataDestroyed;
+    qint64             m_crossingsBefore;
+    qint64             m_crossingsAfter;
     IgnoreCap          m_ignoreCap;
+    DeviceOrder        m_deviceOrder;
 };
 
 #endif // NETLISTVIZ_ASG_ASG_H
@@ -0,0 +1,31 @@
+#####################
+# logical passes of ASG (placement, annealing and routing, no scene), shared
+# by the tests and tools that place, include it after Parser.pri
+# ASG::PlotLevels() links TablePlotter, so they need QT += widgets
+#####################
+
+HEADERS += $$SRC/ASG/ASG.h\
+           $$SRC/ASG/Level.h\
+           $$SRC/ASG/Component.h\
+           $$SRC/ASG/CrossingReducer.h\
+           $$SRC/ASG/LevelGraph.h\
+           $$SRC/ASG/Annealer.h\
+           $$SRC/ASG/GraphStats.h\
+           $$SRC/ASG/LevelBFS.h\
+           $$SRC/ASG/Channel.h\
+           $$SRC/ASG/TablePlotter.h\
+           $$SRC/ASG/Dot.h
+
+SOURCES += $$SRC/ASG/ASG.cpp\
+           $$SRC/ASG/LogicalPlacement.cpp\
+           $$SRC/ASG/LogicalRouting.cpp\
+           $$SRC/ASG/Level.cpp\
+           $$SRC/ASG/Component.cpp\
+           $$SRC/ASG/CrossingReducer.cpp\
+           $$SRC/ASG/LevelGraph.cpp\
+           $$SRC/ASG/Annealer.cpp\
+           $$SRC/ASG/GraphStats.cpp\
+           $$SRC/ASG/LevelBFS.cpp\
+           $$SRC/ASG/Channel.cpp\
+           $$SRC/ASG/TablePlotter.cpp\
+           $$SRC/ASG/Dot.cpp
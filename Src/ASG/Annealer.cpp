@@ -0,0 +1,303 @@
+#include "Annealer.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <QDebug>
+#include <QThread>
+#include "Circuit/Device.h"
+#include "Level.h"
+
+Annealer::Annealer(const NetIndex *nets, const LevelList &levels)
+    : m_graph(nets, levels)
+{
+    m_best.wirelength = 0;
+    m_best.crossings = 0;
+    m_best.cost = 0;
+    m_best.temperature = SA_END_T;
+    m_costBefore = 0;
+    m_rounds = 0;
+}
+
+Annealer::~Annealer()
+{
+}
+
+int Annealer::Run(const QElapsedTimer &clock, qint64 deadlineMs)
+{
+    int error = m_graph.Build();
+    if (error)
+        return ERROR;
+
+    int levelCount = m_graph.LevelCount();
+    m_gap.assign(levelCount, 1);
+    m_levelBegin.assign(levelCount + 1, 0);
+    for (int l = 0; l < levelCount; ++ l) {
+        m_gap[l] = qMax(m_graph.LevelAt(l)->RowGap(), 1);
+        m_levelBegin[l + 1] = m_levelBegin[l] + m_graph.DeviceCount(l);
+    }
+
+    /* the layout of logical placement */
+    Replica &start = m_best;
+    start.row.assign(levelCount, std::vector<int>());
+    start.order.assign(levelCount, std::vector<int>());
+    start.pos.assign(levelCount, std::vector<int>());
+    for (int l = 0; l < levelCount; ++ l) {
+        int count = m_graph.DeviceCount(l);
+        for (int i = 0; i < count; ++ i) {
+            start.row[l].push_back(m_graph.Devices(l).at(i)->LogicalRow());
+            start.order[l].push_back(i);
+        }
+        std::vector<int> &rows = start.row[l];
+        std::stable_sort(start.order[l].begin(), start.order[l].end(), [&rows](int a, int b) {
+            return rows[a] < rows[b];
+        });
+        start.pos[l].resize(count);
+        for (int p = 0; p < count; ++ p)
+            start.pos[l][start.order[l][p]] = p;
+    }
+    Evaluate(&start);
+    m_costBefore = start.cost;
+
+    int deviceCount = m_levelBegin.back();
+    if (levelCount < 2 || deviceCount < 2)
+        return OKAY;
+
+    m_replicas.assign(SA_REPLICAS, m_best);
+    for (int k = 0; k < SA_REPLICAS; ++ k)
+        m_replicas[k].random.seed(k + 1);
+
+    /* slot s of the ladder, coldest first, is run by replica slot[s] */
+    std::vector<int> slot(SA_REPLICAS);
+    for (int s = 0; s < SA_REPLICAS; ++ s)
+        slot[s] = s;
+
+    int moves = qMin(deviceCount, SA_MAX_ROUND_MOVES);
+    int threads = qMax(qMin(QThread::idealThreadCount(), SA_REPLICAS), 1);
+    std::mt19937 random(0);
+    double hottest = SA_INIT_T;
+
+    while (NOT clock.hasExpired(deadlineMs)) {
+        for (int s = 0; s < SA_REPLICAS; ++ s) {
+            double ratio = (SA_REPLICAS > 1) ? s * 1.0 / (SA_REPLICAS - 1) : 0;
+            m_replicas[slot[s]].temperature = SA_END_T * std::pow(hottest / SA_END_T, ratio);
+        }
+
+        std::atomic<int> next(0);
+        auto work = [this, moves, &clock, deadlineMs, &next]() {
+            for (int k = next++; k < (int)m_replicas.size(); k = next++)
+                Round(&m_replicas[k], moves, clock, deadlineMs);
+        };
+        std::vector<std::thread> workers;
+        for (int tid = 1; tid < threads; ++ tid)
+            workers.emplace_back(work);
+        work();
+        for (std::thread &worker : workers)
+            worker.join();
+        m_rounds++;
+
+        for (const Replica &replica : m_replicas) {
+            if (replica.cost < m_best.cost)
+                m_best = replica;
+        }
+
+        if (hottest <= SA_END_T)
+            break;
+        Exchange(&slot, m_rounds, &random);
+        hottest = qMax(hottest * SA_ALPHA, SA_END_T);
+    }
+
+#ifdef TRACE
+    qInfo() << "anneal cost" << m_costBefore << "->" << m_best.cost << "in" << m_rounds
+            << "round(s)," << clock.elapsed() << "ms into the placement";
+#endif
+
+    return OKAY;
+}
+
+void Annealer::Apply() const
+{
+    DeviceList devList;
+    for (int l = 0; l < m_graph.LevelCount(); ++ l) {
+        const DeviceList &devices = m_graph.Devices(l);
+        devList.clear();
+        for (int i : m_best.order[l]) {
+            devices.at(i)->SetLogicalRow(m_best.row[l][i]);
+            devList.push_back(devices.at(i));
+        }
+        m_graph.LevelAt(l)->ReorderDevices(devList);
+    }
+}
+
+/* the whole cost, once, moves update it */
+void Annealer::Evaluate(Replica *replica) const
+{
+    replica->wirelength = 0;
+    replica->crossings = 0;
+    for (int l = 0; l + 1 < m_graph.LevelCount(); ++ l) {
+        const LevelGraph::Adjacency &down = m_graph.Down(l);
+        for (int i = 0; i < m_graph.DeviceCount(l); ++ i) {
+            for (int k = down.begin[i]; k < down.begin[i + 1]; ++ k)
+                replica->wirelength += qAbs(replica->row[l][i] - replica->row[l + 1][down.other[k]]);
+        }
+        replica->crossings += m_graph.Crossings(l, replica->order[l], replica->pos[l + 1]);
+    }
+    replica->cost = replica->wirelength + SA_CROSSING_COST * replica->crossings;
+}
+
+int Annealer::CheckCosts() const
+{
+    std::vector<const Replica *> replicas = { &m_best };
+    for (const Replica &replica : m_replicas)
+        replicas.push_back(&replica);
+
+    Replica fresh;
+    for (const Replica *replica : replicas) {
+        fresh.row = replica->row;
+        fresh.order = replica->order;
+        fresh.pos = replica->pos;
+        Evaluate(&fresh);
+        if (fresh.wirelength != replica->wirelength || fresh.crossings != replica->crossings
+            || fresh.cost != replica->cost)
+            return ERROR;
+    }
+    return OKAY;
+}
+
+/* a round cut by the deadline leaves a consistent replica, its cost is kept per move */
+void Annealer::Round(Replica *replica, int moves, const QElapsedTimer &clock, qint64 deadlineMs) const
+{
+    std::uniform_int_distribution<int> anyDevice(0, m_levelBegin.back() - 1);
+    std::uniform_real_distribution<double> unit(0, 1);
+
+    int device = 0, level = 0, count = 0, p = 0;
+    int upper = 0, lower = 0, upperRow = 0, lowerRow = 0, row = 0, low = 0, high = 0;
+    qint64 wirelength = 0, crossings = 0;
+    for (int m = 0; m < moves; ++ m) {
+        if ((m & (SA_CLOCK_MOVES - 1)) == 0 AND m > 0 AND clock.hasExpired(deadlineMs))
+            return;
+        device = anyDevice(replica->random);
+        level = std::upper_bound(m_levelBegin.begin(), m_levelBegin.end(), device) - m_levelBegin.begin() - 1;
+        p = device - m_levelBegin[level];
+        count = m_graph.DeviceCount(level);
+        std::vector<int> &rows = replica->row[level];
+        std::vector<int> &order = replica->order[level];
+
+        /* swap with the next device, their rows are exchanged */
+        if (count > 1 AND unit(replica->random) < 0.5) {
+            if (p == count - 1)
+                p--;
+            upper = order[p];
+            lower = order[p + 1];
+            upperRow = rows[upper];
+            lowerRow = rows[lower];
+            wirelength = Wirelength(*replica, level, upper, lowerRow) - Wirelength(*replica, level, upper, upperRow)
+                       + Wirelength(*replica, level, lower, upperRow) - Wirelength(*replica, level, lower, lowerRow);
+            crossings = SwapCrossings(replica, level, upper, lower);
+            if (NOT Accept(replica, wirelength + SA_CROSSING_COST * crossings))
+                continue;
+
+            rows[upper] = lowerRow;
+            rows[lower] = upperRow;
+            order[p] = lower;
+            order[p + 1] = upper;
+            replica->pos[level][lower] = p;
+            replica->pos[level][upper] = p + 1;
+            replica->wirelength += wirelength;
+            replica->crossings += crossings;
+            replica->cost = replica->wirelength + SA_CROSSING_COST * replica->crossings;
+            continue;
+        }
+
+        /* shift between the neighbours, a row gap from each */
+        upper = order[p];
+        row = rows[upper];
+        low = (p > 0) ? rows[order[p - 1]] + m_gap[level] : row - m_gap[level];
+        high = (p < count - 1) ? rows[order[p + 1]] - m_gap[level] : row + m_gap[level];
+        if (low >= high)
+            continue;
+        lowerRow = std::uniform_int_distribution<int>(low, high)(replica->random);
+        if (lowerRow == row)
+            continue;
+        wirelength = Wirelength(*replica, level, upper, lowerRow) - Wirelength(*replica, level, upper, row);
+        if (NOT Accept(replica, wirelength))
+            continue;
+
+        rows[upper] = lowerRow;
+        replica->wirelength += wirelength;
+        replica->cost = replica->wirelength + SA_CROSSING_COST * replica->crossings;
+    }
+}
+
+/* Metropolis */
+bool Annealer::Accept(Replica *replica, double delta) const
+{
+    if (delta <= 0)
+        return true;
+    return std::uniform_real_distribution<double>(0, 1)(replica->random)
+           < std::exp(-delta / replica->temperature);
+}
+
+/* edges of device local of level, were it at row */
+qint64 Annealer::Wirelength(const Replica &replica, int level, int local, int row) const
+{
+    qint64 wirelength = 0;
+    const LevelGraph::Adjacency &down = m_graph.Down(level);
+    for (int k = down.begin[local]; k < down.begin[local + 1]; ++ k)
+        wirelength += qAbs(row - replica.row[level + 1][down.other[k]]);
+
+    const LevelGraph::Adjacency &up = m_graph.Up(level);
+    for (int k = up.begin[local]; k < up.begin[local + 1]; ++ k)
+        wirelength += qAbs(row - replica.row[level - 1][up.other[k]]);
+
+    return wirelength;
+}
+
+/*
+ * Crossings gained when upper and lower, next to each other, swap. Only
+ * their own edges change: with ends a of upper and b of lower in a
+ * neighbour level, a pair crosses now if a > b, after the swap if a < b.
+ */
+qint64 Annealer::SwapCrossings(Replica *replica, int level, int upper, int lower) const
+{
+    qint64 delta = 0;
+    std::vector<int> &upperEnds = replica->upperEnds;
+    std::vector<int> &lowerEnds = replica->lowerEnds;
+
+    for (int other : {level - 1, level + 1}) {
+        if (other < 0 || other >= m_graph.LevelCount())
+            continue;
+        const LevelGraph::Adjacency &adj = (other < level) ? m_graph.Up(level) : m_graph.Down(level);
+        const std::vector<int> &pos = replica->pos[other];
+
+        upperEnds.clear();
+        for (int k = adj.begin[upper]; k < adj.begin[upper + 1]; ++ k)
+            upperEnds.push_back(pos[adj.other[k]]);
+        lowerEnds.clear();
+        for (int k = adj.begin[lower]; k < adj.begin[lower + 1]; ++ k)
+            lowerEnds.push_back(pos[adj.other[k]]);
+        if (upperEnds.empty() || lowerEnds.empty())
+            continue;
+        std::sort(lowerEnds.begin(), lowerEnds.end());
+
+        for (int a : upperEnds) {
+            delta += lowerEnds.end() - std::upper_bound(lowerEnds.begin(), lowerEnds.end(), a);
+            delta -= std::lower_bound(lowerEnds.begin(), lowerEnds.end(), a) - lowerEnds.begin();
+        }
+    }
+
+    return delta;
+}
+
+/* adjacent slots, even pairs one round and odd pairs the next */
+void Annealer::Exchange(std::vector<int> *slot, int round, std::mt19937 *random) const
+{
+    std::uniform_real_distribution<double> unit(0, 1);
+    for (int s = round % 2; s + 1 < (int)slot->size(); s += 2) {
+        const Replica &colder = m_replicas[(*slot)[s]];
+        const Replica &hotter = m_replicas[(*slot)[s + 1]];
+        double exponent = (colder.cost - hotter.cost) * (1 / colder.temperature - 1 / hotter.temperature);
+        if (exponent >= 0 || unit(*random) < std::exp(exponent))
+            std::swap((*slot)[s], (*slot)[s + 1]);
+    }
+}
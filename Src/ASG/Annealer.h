@@ -0,0 +1,85 @@
+#ifndef NETLISTVIZ_ASG_ANNEALER_H
+#define NETLISTVIZ_ASG_ANNEALER_H
+
+/*
+ * @filename : Annealer.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Simulated annealing of the logical rows of one Component,
+ *           : an optional refinement after logical placement. The cost
+ *           : is the wirelength of the LevelGraph edges (row distance of
+ *           : their devices) plus SA_CROSSING_COST per crossing. A move
+ *           : swaps two devices next to each other in a level or shifts
+ *           : one between its neighbours, the row gap of the level kept,
+ *           : and its cost is updated from the edges of the moved devices
+ *           : only. SA_REPLICAS replicas run on threads at a ladder of
+ *           : temperatures from SA_END_T to a hottest one cooling from
+ *           : SA_INIT_T by SA_ALPHA a round, adjacent ones exchange their
+ *           : temperatures after each round (parallel tempering). The
+ *           : best layout of all rounds is kept until the deadline on the
+ *           : clock of the whole placement, which a replica reads every
+ *           : SA_CLOCK_MOVES moves and stops its round past.
+ */
+
+#include <random>
+#include <vector>
+#include <QElapsedTimer>
+#include <QtGlobal>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+#include "LevelGraph.h"
+
+class NetIndex;
+
+class Annealer
+{
+public:
+    Annealer(const NetIndex *nets, const LevelList &levels);
+    ~Annealer();
+
+    /* clock started with the placement, deadlineMs on it */
+    int     Run(const QElapsedTimer &clock, qint64 deadlineMs);
+    /* rows of the best layout to devices, levels in row order */
+    void    Apply() const;
+    double  CostBefore() const      { return m_costBefore; }
+    double  CostAfter() const       { return m_best.cost; }
+    qint64  CrossingsAfter() const  { return m_best.crossings; }
+    int     Rounds() const          { return m_rounds; }
+    /* ERROR if the cost a replica or the best layout kept by moves is not Evaluate() of its rows */
+    int     CheckCosts() const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(Annealer);
+
+    struct Replica
+    {
+        std::vector<std::vector<int>> row;      // by level, local index
+        std::vector<std::vector<int>> order;    // local index at position
+        std::vector<std::vector<int>> pos;      // position of local index
+        qint64            wirelength;
+        qint64            crossings;
+        double            cost;
+        double            temperature;
+        std::mt19937      random;
+        std::vector<int>  upperEnds;            // scratch of SwapCrossings()
+        std::vector<int>  lowerEnds;
+    };
+
+    void    Evaluate(Replica *replica) const;
+    void    Round(Replica *replica, int moves, const QElapsedTimer &clock, qint64 deadlineMs) const;
+    bool    Accept(Replica *replica, double delta) const;
+    qint64  Wirelength(const Replica &replica, int level, int local, int row) const;
+    qint64  SwapCrossings(Replica *replica, int level, int upper, int lower) const;
+    void    Exchange(std::vector<int> *slot, int round, std::mt19937 *random) const;
+
+    LevelGraph            m_graph;
+    std::vector<int>      m_gap;           // row gap by level
+    std::vector<int>      m_levelBegin;    // devices before level, LevelCount() + 1
+    std::vector<Replica>  m_replicas;
+    Replica               m_best;
+    double                m_costBefore;
+    int                   m_rounds;
+};
+
+#endif // NETLISTVIZ_ASG_ANNEALER_H
@@ -4,6 +4,7 @@
 #include "Circuit/Device.h"
 #include "Circuit/Terminal.h"
 #include "Dot.h"
+#include "Utilities/Arena.h"
 
 Channel::Channel(int id)
 {
@@ -19,16 +20,10 @@ Channel::Channel()
     m_holdColCount = 0;
 }
 
+/* wires and dots are freed with ASG's arena */
 Channel::~Channel()
 {
-    /* delete wires here */
-    foreach (Wire *wire, m_wires)
-        delete wire;
     m_wires.clear();
-
-    /* delete dots here */
-    foreach (Dot *dot, m_dots)
-        delete dot;
     m_dots.clear();
 }
 
@@ -47,7 +42,7 @@ void Channel::AddWires(const WireList &wires)
 /*
  * horizontal line: track is -1
  */
-void Channel::AssignTrackNumber(IgnoreCap ignore)
+void Channel::AssignTrackNumber(IgnoreCap ignore, Arena *arena)
 {
     Q_UNUSED(ignore);
 
@@ -147,7 +142,7 @@ void Channel::AssignTrackNumber(IgnoreCap ignore)
     m_trackCount = trackIndex;
 
     /* Sixth, create dots */
-    CreateDots(mergedWireList);
+    CreateDots(mergedWireList, arena);
 }
 
 bool Channel::CouldBeMergedWithWires(const WireList &wl, Wire *wire) const
@@ -160,7 +155,7 @@ bool Channel::CouldBeMergedWithWires(const WireList &wl, Wire *wire) const
     return true;
 }
 
-void Channel::CreateDots(const QVector<WireList> &mergedWireList)
+void Channel::CreateDots(const QVector<WireList> &mergedWireList, Arena *arena)
 {
     m_dots.clear();
     QMap<int, Dot*> dotMap;
@@ -178,7 +173,7 @@ void Channel::CreateDots(const QVector<WireList> &mergedWireList)
 
                 dot = dotMap.value(terminal->Id(), nullptr);
                 if (NOT dot) {
-                    dot = new Dot(m_id, otherWire->Track(), terminal);
+                    dot = arena->New<Dot>(m_id, otherWire->Track(), terminal);
                     dotMap.insert(terminal->Id(), dot);
                     m_dots.push_back(dot);
                 }
@@ -214,7 +209,7 @@ void Channel::CreateDots(const QVector<WireList> &mergedWireList)
 
                 dot = dotMap.value(terminal->Id(), nullptr);
                 if (NOT dot) {
-                    dot = new Dot(m_id, thisWire->Track(), terminal);
+                    dot = arena->New<Dot>(m_id, thisWire->Track(), terminal);
                     dotMap.insert(terminal->Id(), dot);
                     m_dots.push_back(dot);
                 }
@@ -15,6 +15,7 @@
 #include <QMap>
 
 class Wire;
+class Arena;
 
 class Channel
 {
@@ -27,7 +28,7 @@ public:
     int       Id() const    { return m_id; }
     void      AddWire(Wire *wire);
     void      AddWires(const WireList &wires);
-    void      AssignTrackNumber(IgnoreCap ignore);
+    void      AssignTrackNumber(IgnoreCap ignore, Arena *arena);
     WireList  Wires() const { return m_wires; }
     int       TrackCount() const { return m_trackCount; }
     bool      Empty() const { return (m_wires.size() == 0); }
@@ -44,7 +45,7 @@ private:
     bool      CouldBeSameTrackWithWires(const WireList &wires, Wire *wire) const;
     bool      CouldBeMergedWithWires(const WireList &wl, Wire *wire) const;
     bool      HaveCrossBetweenWires(const WireList &wl1, const WireList &wl2) const;
-    void      CreateDots(const QVector<WireList> &mergedWireList);
+    void      CreateDots(const QVector<WireList> &mergedWireList, Arena *arena);
 
     WireList   m_wires;
     int        m_id;
@@ -0,0 +1,399 @@
+#include "Component.h"
+#include <QDebug>
+#include "Circuit/Device.h"
+#include "Level.h"
+#include "Channel.h"
+#include "NetIndex.h"
+#include "CrossingReducer.h"
+#include "Annealer.h"
+
+Component::Component(int id)
+{
+    m_id = id;
+    m_deviceCount = 0;
+    m_crossingsBefore = 0;
+    m_crossingsAfter = 0;
+}
+
+/* dots and wires are destroyed with ASG's arenas */
+Component::~Component()
+{
+    foreach (Channel *ch, m_channels)
+        delete ch;
+    m_channels.clear();
+
+    foreach (Level *level, m_levels)
+        delete level;
+    m_levels.clear();
+}
+
+void Component::AddLevel(Level *level)
+{
+    Q_ASSERT(level);
+    m_levels.push_back(level);
+    m_deviceCount += level->AllDeviceCount();
+}
+
+/* threads : what ReduceCrossings() may use on its own, see ASG::ForEachComponent() */
+int Component::CalLogicalRow(NetIndex *nets, const QElapsedTimer &clock, int threads)
+{
+    int error = EstimateLogicalRowGap();
+    if (error)
+        return ERROR;
+
+    error = DetermineFirstLevelLogicalRow();
+    if (error)
+        return ERROR;
+
+    error = ForwardPropagateLogicalRow(nets);
+    if (error)
+        return ERROR;
+
+    error = ReduceCrossings(nets, clock, threads);
+    if (error)
+        return ERROR;
+
+    return error;
+}
+
+int Component::EstimateLogicalRowGap()
+{
+    if (m_levels.size() < 1)
+        return OKAY;
+
+    /* From last level backward propagation */
+    Level *lastLevel = m_levels.back();
+    Level *currLevel = nullptr;
+    Level *backLevel = lastLevel;
+    int currDeviceCount = 0, backDeviceCount = backLevel->AllDeviceCount();
+    int ratio = 1;
+
+    for (int i = m_levels.size() - 1; i >= 0; -- i) {
+        currLevel = m_levels.at(i);
+        currDeviceCount = currLevel->AllDeviceCount();
+        if (currDeviceCount == 0) {
+            currLevel->SetRowGap(DFT_MAX_DEVICE_ROW_GAP);
+            backLevel = currLevel;
+            continue;
+        }
+
+        ratio = backDeviceCount * 1.0 / currDeviceCount + 0.5;
+        if (ratio < 1)
+            ratio = 1;
+        currLevel->SetRowGap(backLevel->RowGap() * ratio);
+    }
+
+#ifdef DEBUGx
+    printf("--------------- Row Gap ---------------\n");
+
+    foreach (Level *l, m_levels)
+        qInfo() << l->Id() << "rowGap(" << l->RowGap() << ")";
+
+    printf("---------------------------------------\n");
+#endif
+
+    return OKAY;
+}
+
+int Component::DetermineFirstLevelLogicalRow()
+{
+    /* just simply assign logical row number */
+    if (m_levels.size() < 1)
+        return OKAY;
+
+    Level *firstLevel = m_levels.front();
+    int row = 0;
+    foreach (Device *dev, firstLevel->AllDevices()) {
+        dev->SetLogicalRow(row);
+        row += firstLevel->RowGap();
+    }
+
+#ifdef DEBUGx
+    firstLevel->PrintLogicalPos();
+#endif
+
+    return OKAY;
+}
+
+/* groups of nets are by level id, the ones this component adds are its own */
+int Component::ForwardPropagateLogicalRow(NetIndex *nets, bool keepOrder)
+{
+    if (m_levels.size() < 2)
+        return OKAY;
+
+    Level *level = nullptr;
+    for (int i = 1; i < m_levels.size(); ++ i) {
+        level = m_levels.at(i);
+        nets->AddRows(m_levels.at(i - 1)->AllDevices()); // final now
+        level->AssignDeviceLogicalRow(nets, keepOrder); // assign logical row to devices
+    }
+
+#ifdef DEBUGx
+    foreach (Level *level, m_levels)
+        level->PrintLogicalPos();
+#endif
+
+    return OKAY;
+}
+
+/*
+ * The forward pass orders a level by its predecessors only. Sweeps over
+ * the levels reorder them to cut crossings, then rows are assigned again
+ * in the new orders, the rows the forward pass added to nets taken back.
+ */
+int Component::ReduceCrossings(NetIndex *nets, const QElapsedTimer &clock, int threads)
+{
+    if (m_levels.size() < 2)
+        return OKAY;
+
+    CrossingReducer reducer(nets, m_levels);
+    reducer.SetThreadCount(threads);
+    int error = reducer.Run(clock);
+    if (error)
+        return ERROR;
+
+    m_crossingsBefore = reducer.CrossingsBefore();
+    m_crossingsAfter = reducer.CrossingsAfter();
+    if (m_crossingsAfter >= m_crossingsBefore)
+        return OKAY;
+
+    for (int i = 0; i + 1 < m_levels.size(); ++ i)
+        nets->RemoveRows(m_levels.at(i)->AllDevices());
+
+    reducer.Apply();
+
+    error = DetermineFirstLevelLogicalRow();
+    if (error)
+        return ERROR;
+
+    return ForwardPropagateLogicalRow(nets, true);
+}
+
+/* orientations are decided again after it */
+int Component::Anneal(const NetIndex *nets, const QElapsedTimer &clock, qint64 deadlineMs)
+{
+    if (m_levels.size() < 2 || clock.hasExpired(deadlineMs))
+        return OKAY;
+
+    Annealer annealer(nets, m_levels);
+    int error = annealer.Run(clock, deadlineMs);
+    if (error)
+        return ERROR;
+
+    if (annealer.CostAfter() >= annealer.CostBefore())
+        return OKAY;
+
+    annealer.Apply();
+    m_crossingsAfter = annealer.CrossingsAfter();
+
+    return OKAY;
+}
+
+/* after NetIndex::FreezeRows() */
+int Component::DecideDeviceOrientation(const NetIndex *nets)
+{
+    foreach (Level *level, m_levels) {
+        foreach (Device *dev, level->AllDevices())
+            dev->DecideOrientationByPredecessors(nets);
+    }
+
+#ifdef DEBUGx
+    foreach (Level *level, m_levels)
+        level->PrintOrientation();
+#endif
+
+    return OKAY;
+}
+
+int Component::DecideDeviceWhetherToReverse(const NetIndex *nets)
+{
+    foreach (Level *level, m_levels) {
+        foreach (Device *dev, level->AllDevices())
+            dev->DecideReverseByPredecessors(nets);
+    }
+
+    if (m_levels.size() > 0) {
+        foreach (Device *dev, m_levels.front()->AllDevices())
+            dev->DecideReverseBySuccessors(nets);
+    }
+
+#ifdef DEBUGx
+    foreach (Level *level, m_levels)
+        level->PrintReverse();
+#endif
+
+    return OKAY;
+}
+
+/*
+ * Level0     Level1     Level2  ...  Level(n)
+ *         |          |          |
+ *     Channel0   channel1  Channel(n-1)
+ *
+ * a channel takes the id of the level before it.
+ */
+int Component::CreateChannels(const NetIndex *nets, Arena *arena)
+{
+    foreach (Channel *ch, m_channels)
+        delete ch;
+    m_channels.clear();
+
+    Channel *newChannel = nullptr;
+    Level *level = nullptr;
+
+    for (int i = 1; i < m_levels.size(); ++ i) {
+        level = m_levels.at(i);
+
+        // new channel
+        newChannel = new Channel(m_levels.at(i - 1)->Id());
+
+        foreach (Device *dev, level->AllDevices()) {
+            newChannel->AddWires(dev->WiresFromPredecessors(nets, arena));
+        }
+
+        m_channels.push_back(newChannel);
+    }
+
+#ifdef DEBUGx
+    foreach (Channel *ch, m_channels)
+        ch->Print();
+#endif
+
+    return OKAY;
+}
+
+int Component::AssignTrackNumber(IgnoreCap ignore, Arena *arena)
+{
+    foreach (Channel *ch, m_channels) {
+        ch->AssignTrackNumber(ignore, arena);
+    }
+
+    return OKAY;
+}
+
+/* a level takes one col, a channel its HoldColCount() */
+int Component::ColCount()
+{
+    int count = m_levels.size();
+    foreach (Channel *ch, m_channels)
+        count += ch->HoldColCount();
+
+    return count;
+}
+
+int Component::RowCount() const
+{
+    int minLogRow = MinLogicalRow();
+    int maxLogRow = minLogRow;
+    foreach (Level *level, m_levels) {
+        foreach (Device *dev, level->AllDevices()) {
+            if (dev->LogicalRow() > maxLogRow)
+                maxLogRow = dev->LogicalRow();
+        }
+    }
+
+    return maxLogRow - minLogRow + 1;
+}
+
+int Component::MinLogicalRow() const
+{
+    bool first = true;
+    int minLogRow = 0;
+    foreach (Level *level, m_levels) {
+        foreach (Device *dev, level->AllDevices()) {
+            if (first || dev->LogicalRow() < minLogRow)
+                minLogRow = dev->LogicalRow();
+            first = false;
+        }
+    }
+
+    return minLogRow;
+}
+
+/* the top left cell of the component is (col, row) of the scene */
+int Component::Place(int col, int row)
+{
+    if (m_levels.size() < 1)
+        return OKAY;
+
+    int error = CalGeometricalCol(col);
+    if (error)
+        return ERROR;
+
+    error = TryPutDeviceIntoChannel();
+    if (error)
+        return ERROR;
+
+    error = CalGeometricalRow(row);
+    if (error)
+        return ERROR;
+
+#ifdef DEBUGx
+    foreach (Level *level, m_levels)
+        level->PrintGeometricalPos();
+#endif
+
+    return OKAY;
+}
+
+int Component::CalGeometricalCol(int col)
+{
+    int colIndex = col;
+    Level *level = nullptr;
+    Channel *ch = nullptr;
+
+    Q_ASSERT(m_levels.size() == m_channels.size() + 1);
+
+    for (int i = 0; i < m_channels.size(); ++ i) {
+        level = m_levels.at(i);
+        level->AssignDeviceGeometricalCol(colIndex);
+        colIndex++;
+        ch = m_channels.at(i);
+        /* Assign dots geometrical col, as to m_dots (same pointer) */
+        ch->AssignGeometricalCol(colIndex);
+        colIndex += ch->HoldColCount();
+    }
+
+    m_levels.back()->AssignDeviceGeometricalCol(colIndex);
+
+    return OKAY;
+}
+
+int Component::TryPutDeviceIntoChannel()
+{
+    Level *level = nullptr;
+    Channel *ch = nullptr;
+    for (int i = 0; i < m_channels.size(); ++ i) {
+        ch = m_channels.at(i);    // the former channel
+        level = m_levels.at(i+1);
+        level->TryPutDeviceIntoChannel(ch);
+    }
+
+    return OKAY;
+}
+
+int Component::CalGeometricalRow(int row)
+{
+    int shiftDown = row - MinLogicalRow();
+
+#ifdef DEBUGx
+    qInfo() << "Component" << m_id << "shift down" << shiftDown;
+#endif
+
+    foreach (Level *level, m_levels) {
+        foreach (Device *dev, level->AllDevices())
+            dev->SetGeometricalRow(dev->LogicalRow() + shiftDown);
+    }
+
+    return OKAY;
+}
+
+void Component::PrintLevels() const
+{
+    printf("------------- Component %d -------------\n", m_id);
+
+    foreach (Level *level, m_levels)
+        level->PrintAllDevices();
+
+    printf("---------------------------------------\n");
+}
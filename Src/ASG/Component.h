@@ -0,0 +1,79 @@
+#ifndef NETLISTVIZ_ASG_COMPONENT_H
+#define NETLISTVIZ_ASG_COMPONENT_H
+
+/*
+ * @filename : Component.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : One connected component of the circuit, laid out on its own.
+ *           : It owns its Levels and Channels and runs the level passes
+ *           : of ASG on them. Level ids of different components never
+ *           : meet (an empty id is left between them), so the NetIndex
+ *           : groups of two components are apart and the passes of
+ *           : different components may run on different threads. A
+ *           : placed component is a box of ColCount() x RowCount() cells,
+ *           : Place() moves it to its spot of the scene.
+ */
+
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class Arena;
+class NetIndex;
+class QElapsedTimer;
+
+class Component
+{
+public:
+    explicit Component(int id);
+    ~Component();
+
+    int   Id() const           { return m_id; }
+    void  AddLevel(Level *level);
+    const LevelList&   Levels() const   { return m_levels; }
+    const ChannelList& Channels() const { return m_channels; }
+    int   DeviceCount() const  { return m_deviceCount; }
+    /* between adjacent levels, before and after ReduceCrossings() and Anneal() */
+    qint64 CrossingsBefore() const { return m_crossingsBefore; }
+    qint64 CrossingsAfter() const  { return m_crossingsAfter; }
+
+    /* logical placement, nets are shared by all components, clock is the pass's */
+    int   CalLogicalRow(NetIndex *nets, const QElapsedTimer &clock, int threads);
+    int   DecideDeviceOrientation(const NetIndex *nets);
+    int   DecideDeviceWhetherToReverse(const NetIndex *nets);
+    /* optional, rows of the best layout Annealer finds by deadlineMs on clock */
+    int   Anneal(const NetIndex *nets, const QElapsedTimer &clock, qint64 deadlineMs);
+
+    /* logical routing, wires and dots are created in arena */
+    int   CreateChannels(const NetIndex *nets, Arena *arena);
+    int   AssignTrackNumber(IgnoreCap ignore, Arena *arena);
+
+    /* geometrical placement, size after logical routing */
+    int   ColCount();
+    int   RowCount() const;
+    int   Place(int col, int row);
+
+    void  PrintLevels() const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(Component);
+
+    int   EstimateLogicalRowGap();
+    int   DetermineFirstLevelLogicalRow();
+    int   ForwardPropagateLogicalRow(NetIndex *nets, bool keepOrder = false);   // level0 -> level1 -> ... -> leveln
+    int   ReduceCrossings(NetIndex *nets, const QElapsedTimer &clock, int threads);
+    int   MinLogicalRow() const;
+    int   CalGeometricalCol(int col);
+    int   TryPutDeviceIntoChannel();
+    int   CalGeometricalRow(int row);
+
+    int          m_id;
+    int          m_deviceCount;
+    qint64       m_crossingsBefore;
+    qint64       m_crossingsAfter;
+    LevelList    m_levels;
+    ChannelList  m_channels;
+};
+
+#endif // NETLISTVIZ_ASG_COMPONENT_H
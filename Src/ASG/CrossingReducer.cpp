@@ -0,0 +1,206 @@
+#include "CrossingReducer.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QThread>
+#include "Level.h"
+
+/* blocks of [begin, end) to at most threads, one thread below CROSS_PARALLEL_MIN_DEVICES */
+static void ForEachBlock(int count, int threads, const std::function<void(int, int)> &block)
+{
+    const int blockSize = 1024;
+    if (count < CROSS_PARALLEL_MIN_DEVICES)
+        threads = 1;
+    threads = qMax(qMin(threads, (count + blockSize - 1) / blockSize), 1);
+    if (threads == 1) {
+        block(0, count);
+        return;
+    }
+
+    std::atomic<int> next(0);
+    auto work = [count, blockSize, &block, &next]() {
+        for (int begin = next.fetch_add(blockSize); begin < count; begin = next.fetch_add(blockSize))
+            block(begin, qMin(begin + blockSize, count));
+    };
+
+    std::vector<std::thread> workers;
+    for (int tid = 1; tid < threads; ++ tid)
+        workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+CrossingReducer::CrossingReducer(const NetIndex *nets, const LevelList &levels)
+    : m_graph(nets, levels)
+{
+    m_crossingsBefore = 0;
+    m_crossingsAfter = 0;
+    m_sweeps = 0;
+    m_threadCount = 0;
+}
+
+CrossingReducer::~CrossingReducer()
+{
+}
+
+int CrossingReducer::Run(const QElapsedTimer &clock)
+{
+    int error = m_graph.Build();
+    if (error)
+        return ERROR;
+
+    int levelCount = m_graph.LevelCount();
+    m_order.assign(levelCount, std::vector<int>());
+    m_pos.assign(levelCount, std::vector<int>());
+    for (int l = 0; l < levelCount; ++ l) {
+        for (int i = 0; i < m_graph.DeviceCount(l); ++ i) {
+            m_order[l].push_back(i);
+            m_pos[l].push_back(i);
+        }
+    }
+    m_crossings.assign(qMax(levelCount - 1, 0), 0);
+
+    m_crossingsBefore = TotalCrossings();
+    m_crossingsAfter = m_crossingsBefore;
+
+    qint64 crossings = 0;
+    while (m_crossingsAfter > 0 AND m_sweeps < CROSS_MAX_SWEEPS) {
+        for (int l = 1; l < levelCount AND NOT clock.hasExpired(CROSS_TIME_BUDGET_MS); ++ l)
+            ReorderLevel(l, l - 1);
+        for (int l = levelCount - 2; l >= 0 AND NOT clock.hasExpired(CROSS_TIME_BUDGET_MS); -- l)
+            ReorderLevel(l, l + 1);
+        m_sweeps++;
+
+        crossings = 0;
+        for (qint64 c : m_crossings)
+            crossings += c;
+        Q_ASSERT(crossings <= m_crossingsAfter);
+        if (crossings == m_crossingsAfter)
+            break;
+        m_crossingsAfter = crossings;
+        if (clock.hasExpired(CROSS_TIME_BUDGET_MS))
+            break;
+    }
+
+#ifdef TRACE
+    qInfo() << "crossings" << m_crossingsBefore << "->" << m_crossingsAfter
+            << "in" << m_sweeps << "sweep(s)," << clock.elapsed() << "ms into the pass";
+#endif
+
+    return OKAY;
+}
+
+void CrossingReducer::Apply() const
+{
+    DeviceList devList;
+    for (int l = 0; l < m_graph.LevelCount(); ++ l) {
+        devList.clear();
+        for (int local : m_order[l])
+            devList.push_back(m_graph.Devices(l).at(local));
+        if (devList != m_graph.Devices(l))
+            m_graph.LevelAt(l)->ReorderDevices(devList);
+    }
+}
+
+qint64 CrossingReducer::TotalCrossings()
+{
+    qint64 total = 0;
+    for (int l = 0; l + 1 < m_graph.LevelCount(); ++ l) {
+        m_crossings[l] = m_graph.Crossings(l, m_order[l], m_pos[l + 1]);
+        total += m_crossings[l];
+    }
+    return total;
+}
+
+/* the order of level that crosses least with both of its neighbour levels */
+void CrossingReducer::ReorderLevel(int level, int fixed)
+{
+    int count = m_graph.DeviceCount(level);
+    if (count < 2)
+        return;
+
+    std::vector<double> barycenter, median;
+    CalKeys(level, fixed, &barycenter, &median);
+
+    bool hasPrev = (level > 0);
+    bool hasNext = (level + 1 < m_graph.LevelCount());
+    qint64 prevCrossings = hasPrev ? m_crossings[level - 1] : 0;
+    qint64 nextCrossings = hasNext ? m_crossings[level] : 0;
+
+    std::vector<int> order, pos(count);
+    qint64 prev = 0, next = 0;
+    for (const std::vector<double> *key : {&barycenter, &median}) {
+        /* ties keep the current order */
+        order = m_order[level];
+        std::stable_sort(order.begin(), order.end(), [key](int a, int b) {
+            return (*key)[a] < (*key)[b];
+        });
+        if (order == m_order[level])
+            continue;
+
+        for (int p = 0; p < count; ++ p)
+            pos[order[p]] = p;
+        prev = hasPrev ? m_graph.Crossings(level - 1, m_order[level - 1], pos) : 0;
+        next = hasNext ? m_graph.Crossings(level, order, m_pos[level + 1]) : 0;
+        if (prev + next >= prevCrossings + nextCrossings)
+            continue;
+
+        m_order[level] = order;
+        m_pos[level] = pos;
+        prevCrossings = prev;
+        nextCrossings = next;
+        if (hasPrev) m_crossings[level - 1] = prev;
+        if (hasNext) m_crossings[level] = next;
+    }
+}
+
+/*
+ * Barycenter and median of the positions of the neighbours in level fixed,
+ * as fractions of the level sizes. A device with no neighbour there keeps
+ * the fraction of its own position.
+ */
+void CrossingReducer::CalKeys(int level, int fixed, std::vector<double> *barycenter,
+                              std::vector<double> *median) const
+{
+    const LevelGraph::Adjacency &adj = (fixed < level) ? m_graph.Up(level) : m_graph.Down(level);
+    const std::vector<int> &fixedPos = m_pos[fixed];
+    const std::vector<int> &levelPos = m_pos[level];
+    double fixedSize = fixedPos.size();
+    double levelSize = levelPos.size();
+    int count = levelPos.size();
+
+    barycenter->resize(count);
+    median->resize(count);
+
+    int threads = (m_threadCount > 0) ? m_threadCount : QThread::idealThreadCount();
+    ForEachBlock(count, threads, [&](int begin, int end) {
+        std::vector<int> ends;
+        qint64 sum = 0;
+        size_t mid = 0;
+        for (int i = begin; i < end; ++ i) {
+            if (adj.begin[i] == adj.begin[i + 1]) {
+                (*barycenter)[i] = (*median)[i] = (levelPos[i] + 0.5) / levelSize;
+                continue;
+            }
+
+            ends.clear();
+            sum = 0;
+            for (int k = adj.begin[i]; k < adj.begin[i + 1]; ++ k) {
+                ends.push_back(fixedPos[adj.other[k]]);
+                sum += ends.back();
+            }
+            std::sort(ends.begin(), ends.end());
+            mid = ends.size() / 2;
+
+            (*barycenter)[i] = (sum * 1.0 / ends.size() + 0.5) / fixedSize;
+            if (ends.size() % 2)
+                (*median)[i] = (ends[mid] + 0.5) / fixedSize;
+            else
+                (*median)[i] = ((ends[mid - 1] + ends[mid]) / 2.0 + 0.5) / fixedSize;
+        }
+    });
+}
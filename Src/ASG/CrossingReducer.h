@@ -0,0 +1,66 @@
+#ifndef NETLISTVIZ_ASG_CROSSINGREDUCER_H
+#define NETLISTVIZ_ASG_CROSSINGREDUCER_H
+
+/*
+ * @filename : CrossingReducer.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Layer sweeps of one Component that reorder the devices of
+ *           : every level to cut wire crossings between adjacent levels.
+ *           : Edges are those of LevelGraph. A down sweep orders level l
+ *           : by level l - 1, an up sweep by level l + 1, each by
+ *           : barycenter and by median of neighbour positions, and keeps
+ *           : whichever of the two and the current order crosses least on
+ *           : both sides of l, so the count never grows. Keys of a big
+ *           : level are computed on up to SetThreadCount() threads.
+ *           : Sweeps stop after CROSS_MAX_SWEEPS, a sweep that gains
+ *           : nothing, or CROSS_TIME_BUDGET_MS on the clock of the whole
+ *           : pass, which all components share.
+ */
+
+#include <vector>
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+#include "LevelGraph.h"
+
+class NetIndex;
+
+class CrossingReducer
+{
+public:
+    CrossingReducer(const NetIndex *nets, const LevelList &levels);
+    ~CrossingReducer();
+
+    /* 0 : QThread::idealThreadCount(), 1 : serial */
+    void    SetThreadCount(int count) { m_threadCount = count; }
+    /* clock started with the pass, shared by the components */
+    int     Run(const QElapsedTimer &clock);
+    /* levels get the orders found, their rows are not touched */
+    void    Apply() const;
+    qint64  CrossingsBefore() const { return m_crossingsBefore; }
+    qint64  CrossingsAfter() const  { return m_crossingsAfter; }
+    int     Sweeps() const          { return m_sweeps; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(CrossingReducer);
+
+    qint64  TotalCrossings();
+    void    ReorderLevel(int level, int fixed);
+    void    CalKeys(int level, int fixed, std::vector<double> *barycenter,
+                    std::vector<double> *median) const;
+
+    LevelGraph                        m_graph;
+    std::vector<std::vector<int>>     m_order;       // local index at position
+    std::vector<std::vector<int>>     m_pos;         // position of local index
+    std::vector<qint64>               m_crossings;   // level l and l + 1
+
+    qint64                            m_crossingsBefore;
+    qint64                            m_crossingsAfter;
+    int                               m_sweeps;
+    int                               m_threadCount;
+};
+
+#endif // NETLISTVIZ_ASG_CROSSINGREDUCER_H
@@ -1,5 +1,7 @@
 #include "ASG.h"
+#include <algorithm>
 #include <QDebug>
+#include <QtMath>
 #include "Circuit/Device.h"
 #include "Circuit/Terminal.h"
 #include "Circuit/CircuitGraph.h"
@@ -10,6 +12,7 @@
 #include "Schematic/SConnector.h"
 #include "Level.h"
 #include "Channel.h"
+#include "Component.h"
 
 int ASG::GeometricalPlacement(SchematicScene *scene)
 {
@@ -18,23 +21,10 @@ int ASG::GeometricalPlacement(SchematicScene *scene)
 #endif
     int error = 0;
 
-    error = CalGeometricalCol();
+    error = PackComponents();
     if (error)
         return ERROR;
 
-    error = TryPutDeviceIntoChannel();
-    if (error)
-        return ERROR;
-
-    error = CalGeometricalRow();
-    if (error)
-        return ERROR;
-
-#ifdef DEBUGx
-    foreach (Level *level, m_levels)
-        level->PrintGeometricalPos();
-#endif
-
     error = CreateSchematicDevices();
     if (error)
         return ERROR;
@@ -47,80 +37,49 @@ int ASG::GeometricalPlacement(SchematicScene *scene)
 }
 
 
-int ASG::CalGeometricalCol()
-{
-    int colIndex = 0;
-    Level *level = nullptr;
-    Channel *ch = nullptr;
-
-    Q_ASSERT(m_levels.size() == m_channels.size() + 1);
-
-    for (int i = 0; i < m_channels.size(); ++ i) {
-        level = m_levels.at(i);
-        level->AssignDeviceGeometricalCol(colIndex);
-        colIndex++;
-        ch = m_channels.at(i);
-        /* Assign dots geometrical col, as to m_dots (same pointer) */
-        ch->AssignGeometricalCol(colIndex);
-        colIndex += ch->HoldColCount();
-    }
-
-    m_levels.back()->AssignDeviceGeometricalCol(colIndex);
-
-    return OKAY;
-}
-
-int ASG::TryPutDeviceIntoChannel()
-{
-#ifdef TRACE
-    qInfo() << LINE_INFO << endl;
-#endif
-
-    Level *level = nullptr;
-    Channel *ch = nullptr;
-    for (int i = 0; i < m_channels.size(); ++ i) {
-        ch = m_channels.at(i);    // the former channel
-        level = m_levels.at(i+1);
-        level->TryPutDeviceIntoChannel(ch);
-    }
-
-    return OKAY;
-}
-
-int ASG::CalGeometricalRow()
+/*
+ * Shelf packing. Components go tallest first, left to right on a shelf
+ * until the shelf is as wide as the widest component or the side of a
+ * square of their total area, then a new shelf opens under the tallest
+ * of the last one. A single component is placed as before, at (0, 0).
+ */
+int ASG::PackComponents()
 {
-    if (m_ckt->GetDeviceList().size() < 1)
-        return OKAY;
-
-    const DeviceList &devices = m_ckt->GetDeviceList();
-    Device *dev = devices.front();
-    int minLogRow = dev->LogicalRow();
-
-    for (int i = 1; i < devices.size(); ++ i) {
-        dev = devices.at(i);
-        if (dev->LogicalRow() < minLogRow)
-            minLogRow = dev->LogicalRow();
+    int count = m_components.size();
+    QVector<int> cols(count), rows(count), order(count);
+    qint64 area = 0;
+    int width = 0;
+
+    for (int i = 0; i < count; ++ i) {
+        cols[i] = m_components.at(i)->ColCount();
+        rows[i] = m_components.at(i)->RowCount();
+        area += (qint64)(cols[i] + COMPONENT_PACK_GAP_COL) * (rows[i] + COMPONENT_PACK_GAP_ROW);
+        width = qMax(width, cols[i]);
+        order[i] = i;
     }
-
-#ifdef DEBUGx
-    qInfo() << "Min LogicalRow =" << minLogRow;
-#endif
-
-    int geoRow = 0;
-    if (minLogRow >= 0) {
-        foreach (Device *dev, devices) {
-            geoRow = dev->LogicalRow();
-            dev->SetGeometricalRow(geoRow);
+    width = qMax(width, (int)qSqrt(area));
+    std::stable_sort(order.begin(), order.end(),
+                     [&rows](int a, int b) { return rows[a] > rows[b]; });
+
+    int col = 0, row = 0, shelfRows = 0;
+    int error = OKAY;
+    foreach (int i, order) {
+        if (col > 0 AND col + cols[i] > width) {
+            row += shelfRows + COMPONENT_PACK_GAP_ROW;
+            col = 0;
+            shelfRows = 0;
         }
-        return OKAY;
+        error = m_components.at(i)->Place(col, row);
+        if (error)
+            return ERROR;
+        col += cols[i] + COMPONENT_PACK_GAP_COL;
+        shelfRows = qMax(shelfRows, rows[i]);
     }
 
-    int shiftDown = -1 * minLogRow;
-
-    foreach (Device *dev, devices) {
-        geoRow = dev->LogicalRow() + shiftDown;
-        dev->SetGeometricalRow(geoRow);
-    }
+#ifdef TRACE
+    qInfo() << count << " components packed, " << width << " cols wide, "
+            << row + shelfRows << " rows high" << endl;
+#endif
 
     return OKAY;
 }
@@ -158,7 +117,7 @@ SchematicDevice* ASG::CreateSchematicDevice(Device *dev) const
     Q_ASSERT(dev);
 
     SchematicDevice *sdev = new SchematicDevice();
-    sdev->SetName(dev->Name());
+    sdev->SetName(dev->GetNamePool(), dev->GetNameId());
     sdev->SetId(dev->Id());
     sdev->SetDeviceType(dev->GetDeviceType());
     sdev->SetReverse(dev->Reverse());
@@ -166,9 +125,13 @@ SchematicDevice* ASG::CreateSchematicDevice(Device *dev) const
     sdev->SetOrientation(dev->GetOrientation()); 
     dev->SetSchematicDevice(sdev);
 
-    foreach (Connector *cd, dev->Connectors()) {
-        SConnector *scd = new SConnector(cd->thisTerminal->GetSchematicTerminal(),
-                cd->connectTerminal->GetSchematicTerminal(), cd->connectDevice->GetSchematicDevice());
+    /* SchematicDevice::ConnectTerminal() reads the first connector of a terminal */
+    for (int pin = 0; pin < dev->TerminalCount(); ++ pin) {
+        ConnectorView connectors = dev->Connectors(m_compact, pin);
+        if (connectors.Empty()) continue;
+        const Connector cd = *connectors.begin();
+        SConnector *scd = new SConnector(cd.thisTerminal->GetSchematicTerminal(),
+                cd.connectTerminal->GetSchematicTerminal(), cd.connectDevice->GetSchematicDevice());
         sdev->AddConnector(scd);
     }
 
@@ -7,6 +7,7 @@
 #include "Wire.h"
 #include "Dot.h"
 #include "Level.h"
+#include "Component.h"
 
 int ASG::GeometricalRouting(SchematicScene *scene)
 {
@@ -47,12 +48,14 @@ int ASG::CreateSchematicWires()
     Wire *wire = nullptr;
     SchematicWire *swire = nullptr;
 
-    foreach (channel, m_channels) {
-        foreach (wire, channel->Wires()) {
-            swire = CreateSchematicWire(wire);
-            swire->SetTrackCount(channel->TrackCount());
-            swire->SetHoldColCount(channel->HoldColCount());
-            m_inChannelSWireList.push_back(swire);
+    foreach (Component *component, m_components) {
+        foreach (channel, component->Channels()) {
+            foreach (wire, channel->Wires()) {
+                swire = CreateSchematicWire(wire);
+                swire->SetTrackCount(channel->TrackCount());
+                swire->SetHoldColCount(channel->HoldColCount());
+                m_inChannelSWireList.push_back(swire);
+            }
         }
     }
 
@@ -67,10 +70,12 @@ int ASG::CreateSchematicWires()
     /* In Level */
     m_inLevelSWireList.clear();
     Level *level = nullptr;
-    foreach (level, m_levels) {
-        foreach (wire, level->Wires()) {
-            swire = CreateSchematicWire(wire);
-            m_inLevelSWireList.push_back(swire);
+    foreach (Component *component, m_components) {
+        foreach (level, component->Levels()) {
+            foreach (wire, level->Wires(m_nets, &m_arena)) {
+                swire = CreateSchematicWire(wire);
+                m_inLevelSWireList.push_back(swire);
+            }
         }
     }
 
@@ -118,12 +123,14 @@ int ASG::CreateSchematicDots()
     Dot *dot = nullptr;
     Channel *ch = nullptr;
 
-    foreach (ch, m_channels) {
-        foreach (dot, ch->Dots()) {
-            sdot = CreateSchematicDot(dot);
-            sdot->SetTrackCount(ch->TrackCount());
-            sdot->SetHoldColCount(ch->HoldColCount());
-            m_sdotList.push_back(sdot);
+    foreach (Component *component, m_components) {
+        foreach (ch, component->Channels()) {
+            foreach (dot, ch->Dots()) {
+                sdot = CreateSchematicDot(dot);
+                sdot->SetTrackCount(ch->TrackCount());
+                sdot->SetHoldColCount(ch->HoldColCount());
+                m_sdotList.push_back(sdot);
+            }
         }
     }
 
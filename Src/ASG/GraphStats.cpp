@@ -0,0 +1,226 @@
+#include "GraphStats.h"
+#include <QDebug>
+#include <QObject>
+#include "Circuit/CompactGraph.h"
+#include "Wire.h"
+
+GraphStats::GraphStats()
+{
+    m_deviceCount = 0;
+    m_nodeCount = 0;
+    m_terminalCount = 0;
+    m_componentCount = 0;
+    m_maxFanout = 0;
+    m_groundFanout = 0;
+    m_connectors = 0;
+    m_maxLevelWidth = 0;
+    m_maxDepth = 0;
+    m_widthSquares = 0;
+}
+
+GraphStats::~GraphStats()
+{
+}
+
+int GraphStats::Collect(const CompactGraph *graph, const std::vector<int> &component, int count,
+                        const std::vector<std::vector<int>> &firstLevels)
+{
+    Q_ASSERT(graph);
+    Q_ASSERT((int)component.size() == graph->DeviceCount());
+
+    m_deviceCount = graph->DeviceCount();
+    m_nodeCount = graph->NodeCount();
+    m_terminalCount = graph->TerminalCount();
+    m_componentCount = count;
+
+    CountNodes(graph);
+    CountLevels(graph, component, firstLevels);
+    PredictStages();
+
+#ifdef TRACE
+    Print();
+#endif
+
+    return OKAY;
+}
+
+void GraphStats::CountNodes(const CompactGraph *graph)
+{
+    m_fanout.fill(0, 1);
+    m_maxFanout = 0;
+    m_groundFanout = 0;
+    m_connectors = 0;
+
+    qint64 degree = 0;
+    int bucket = 0;
+    for (int node = 0; node < m_nodeCount; ++ node) {
+        degree = graph->NodeDegree(node);
+        m_connectors += degree * (degree - 1);
+        if (node == (int)CompactGraph::GND_NODE) {
+            m_groundFanout = degree;
+            continue;
+        }
+        m_maxFanout = qMax(m_maxFanout, (int)degree);
+        if (degree < 1) continue;
+
+        for (bucket = 0; (2LL << bucket) <= degree; ++ bucket) {}
+        if (bucket >= m_fanout.size())
+            m_fanout.resize(bucket + 1);
+        m_fanout[bucket]++;
+    }
+}
+
+/* a BFS from all first levels, nodes are expanded once as in CompactGraph */
+void GraphStats::CountLevels(const CompactGraph *graph, const std::vector<int> &component,
+                             const std::vector<std::vector<int>> &firstLevels)
+{
+    m_levelWidths.clear();
+    m_maxLevelWidth = 0;
+    m_maxDepth = 0;
+    m_widthSquares = 0;
+
+    std::vector<quint8> visited(m_deviceCount, 0);
+    std::vector<quint8> expanded(m_nodeCount, 0);
+    std::vector<int> width(m_componentCount, 0);
+    std::vector<int> frontier, next, touched;
+
+    for (const std::vector<int> &first : firstLevels) {
+        for (int dev : first) {
+            if (visited[dev]) continue;
+            visited[dev] = 1;
+            frontier.push_back(dev);
+        }
+    }
+
+    quint32 node = 0, other = 0;
+    while (NOT frontier.empty()) {
+        /* the widths of this depth, one per component */
+        touched.clear();
+        for (int dev : frontier) {
+            if (width[component[dev]]++ == 0)
+                touched.push_back(component[dev]);
+        }
+        for (int c : touched) {
+            m_levelWidths.push_back(width[c]);
+            m_maxLevelWidth = qMax(m_maxLevelWidth, width[c]);
+            m_widthSquares += (qint64)width[c] * width[c];
+            width[c] = 0;
+        }
+        m_maxDepth++;
+
+        next.clear();
+        for (int dev : frontier) {
+            for (quint32 ter = graph->TerminalBegin(dev); ter < graph->TerminalEnd(dev); ++ ter) {
+                node = graph->TerminalNode(ter);
+                if (node == CompactGraph::GND_NODE || expanded[node]) continue;
+                expanded[node] = 1;
+                for (quint32 i = graph->NodeBegin(node); i < graph->NodeEnd(node); ++ i) {
+                    other = graph->TerminalDevice(graph->NodeTerminal(i));
+                    if (visited[other]) continue;
+                    visited[other] = 1;
+                    next.push_back(other);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+}
+
+/*
+ * Linear models in the counts. The level BFS reads a terminal as its
+ * device claims the net and again as the net is expanded, rows of a level
+ * and tracks of its channel are quadratic in its width, a wire per
+ * terminal is an upper bound of the wires.
+ */
+void GraphStats::PredictStages()
+{
+    m_stages.clear();
+
+    qint64 devices = m_deviceCount, terminals = m_terminalCount;
+    qint64 items = devices + 2 * terminals;     // devices, their terminals, wires
+    StageCost stage;
+
+    stage.name = QObject::tr("Level BFS");
+    stage.bytes = devices * 4 * sizeof(int) + m_nodeCount * (sizeof(int) + 1);
+    stage.seconds = terminals * 2 * STATS_NS_PER_BFS_TERMINAL * 1e-9;
+    m_stages.push_back(stage);
+
+    stage.name = QObject::tr("Net index");
+    stage.bytes = terminals * 6 * sizeof(int) + devices * sizeof(int);
+    stage.seconds = terminals * STATS_NS_PER_TERMINAL * 1e-9;
+    m_stages.push_back(stage);
+
+    stage.name = QObject::tr("Logical rows");
+    stage.bytes = devices * 2 * sizeof(int);
+    stage.seconds = (m_widthSquares * STATS_NS_PER_ROW_WIDTH_SQUARE + terminals * STATS_NS_PER_TERMINAL) * 1e-9;
+    m_stages.push_back(stage);
+
+    stage.name = QObject::tr("Logical routing");
+    stage.bytes = terminals * (sizeof(Wire) + 2 * sizeof(Wire*));
+    stage.seconds = (m_widthSquares * STATS_NS_PER_TRACK_WIDTH_SQUARE + terminals * STATS_NS_PER_TERMINAL) * 1e-9;
+    m_stages.push_back(stage);
+
+    stage.name = QObject::tr("Schematic");
+    stage.bytes = items * STATS_BYTES_PER_SCENE_ITEM;
+    stage.seconds = items * STATS_NS_PER_SCENE_ITEM * 1e-9;
+    m_stages.push_back(stage);
+}
+
+qint64 GraphStats::TotalBytes() const
+{
+    qint64 bytes = 0;
+    foreach (const StageCost &stage, m_stages)
+        bytes += stage.bytes;
+    return bytes;
+}
+
+double GraphStats::TotalSeconds() const
+{
+    double seconds = 0;
+    foreach (const StageCost &stage, m_stages)
+        seconds += stage.seconds;
+    return seconds;
+}
+
+CostVerdict GraphStats::Verdict() const
+{
+    if (TotalBytes() > STATS_MAX_BYTES)
+        return CostTooBig;
+    if (TotalSeconds() > STATS_SLOW_SECONDS)
+        return CostSlow;
+    return CostOkay;
+}
+
+QString GraphStats::Report() const
+{
+    QString report;
+    report += QObject::tr("devices %1, nodes %2, terminals %3, components %4\n")
+              .arg(m_deviceCount).arg(m_nodeCount).arg(m_terminalCount).arg(m_componentCount);
+
+    report += QObject::tr("node fanout (ground %1, max %2) :").arg(m_groundFanout).arg(m_maxFanout);
+    for (int bucket = 0; bucket < m_fanout.size(); ++ bucket) {
+        if (m_fanout.at(bucket) == 0) continue;
+        report += QString(" [%1, %2) %3").arg(1LL << bucket).arg(2LL << bucket).arg(m_fanout.at(bucket));
+    }
+    report += "\n";
+
+    report += QObject::tr("pairwise connectors %1\n").arg(m_connectors);
+    report += QObject::tr("levels %1, max depth %2, max level width %3\n")
+              .arg(LevelCount()).arg(m_maxDepth).arg(m_maxLevelWidth);
+
+    foreach (const StageCost &stage, m_stages) {
+        report += QString("%1 : %2 MB, %3 s\n").arg(stage.name, -18)
+                  .arg(stage.bytes / double(1 << 20), 0, 'f', 1).arg(stage.seconds, 0, 'f', 2);
+    }
+    report += QObject::tr("total : %1 MB, %2 s")
+              .arg(TotalBytes() / double(1 << 20), 0, 'f', 1).arg(TotalSeconds(), 0, 'f', 2);
+
+    return report;
+}
+
+void GraphStats::Print() const
+{
+    printf("--------------- Graph Stats ---------------\n");
+    qInfo().noquote() << Report();
+    printf("-------------------------------------------\n");
+}
@@ -0,0 +1,97 @@
+#ifndef NETLISTVIZ_ASG_GRAPHSTATS_H
+#define NETLISTVIZ_ASG_GRAPHSTATS_H
+
+/*
+ * @filename : GraphStats.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Pre-pass over the frozen circuit, before ASG commits to a
+ *           : layout. Node fanout, pairwise connectors, components and
+ *           : the level widths of a BFS from the first levels are counted
+ *           : in O(terminals), then memory and time of every ASG stage
+ *           : are predicted from the counts with the per-unit costs of
+ *           : Define.h. Widths matter most: rows and tracks of a level
+ *           : cost the square of its width. Filled by ASG::CollectStats().
+ */
+
+#include <vector>
+#include <QString>
+#include <QVector>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class CompactGraph;
+
+enum CostVerdict { CostOkay = 0, CostSlow, CostTooBig };
+
+struct StageCost
+{
+    QString name;
+    qint64  bytes;
+    double  seconds;
+};
+
+class GraphStats
+{
+public:
+    GraphStats();
+    ~GraphStats();
+
+    /* component and first levels as ASG::CalLogicalCol() takes them */
+    int     Collect(const CompactGraph *graph, const std::vector<int> &component, int count,
+                    const std::vector<std::vector<int>> &firstLevels);
+
+    int     DeviceCount() const    { return m_deviceCount; }
+    int     NodeCount() const      { return m_nodeCount; }
+    int     TerminalCount() const  { return m_terminalCount; }
+    int     ComponentCount() const { return m_componentCount; }
+
+    /* bucket b counts non-ground nodes of [2^b, 2^(b+1)) terminals */
+    const QVector<qint64>& FanoutHistogram() const { return m_fanout; }
+    int     MaxFanout() const      { return m_maxFanout; }
+    int     GroundFanout() const   { return m_groundFanout; }
+    /* a connector per ordered terminal pair of a node, ground included */
+    qint64  ConnectorCount() const { return m_connectors; }
+
+    /* one width per level of a component */
+    const std::vector<int>& LevelWidths() const { return m_levelWidths; }
+    int     LevelCount() const     { return m_levelWidths.size(); }
+    int     MaxLevelWidth() const  { return m_maxLevelWidth; }
+    int     MaxDepth() const       { return m_maxDepth; }
+
+    const QVector<StageCost>& Stages() const { return m_stages; }
+    qint64  TotalBytes() const;
+    double  TotalSeconds() const;
+    CostVerdict Verdict() const;
+
+    QString Report() const;
+    void    Print() const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(GraphStats);
+
+    void    CountNodes(const CompactGraph *graph);
+    void    CountLevels(const CompactGraph *graph, const std::vector<int> &component,
+                        const std::vector<std::vector<int>> &firstLevels);
+    void    PredictStages();
+
+    int                 m_deviceCount;
+    int                 m_nodeCount;
+    int                 m_terminalCount;
+    int                 m_componentCount;
+
+    QVector<qint64>     m_fanout;
+    int                 m_maxFanout;
+    int                 m_groundFanout;
+    qint64              m_connectors;
+
+    std::vector<int>    m_levelWidths;
+    int                 m_maxLevelWidth;
+    int                 m_maxDepth;
+    qint64              m_widthSquares;     // sum of width^2
+
+    QVector<StageCost>  m_stages;
+};
+
+#endif // NETLISTVIZ_ASG_GRAPHSTATS_H
@@ -1,6 +1,8 @@
 #include "Level.h"
 #include <QDebug>
 #include <QPointF>
+#include <QtMath>
+#include <vector>
 #include "Circuit/Device.h"
 #include "Circuit/Terminal.h"
 #include "Wire.h"
@@ -52,7 +54,13 @@ void Level::UpdateDeviceLevelId()
         dev->SetLevelId(m_id);
 }
 
-void Level::AssignDeviceLogicalRow()
+void Level::ReorderDevices(const DeviceList &devList)
+{
+    Q_ASSERT(devList.size() == m_devices.size());
+    m_devices = devList;
+}
+
+void Level::AssignDeviceLogicalRow(const NetIndex *nets, bool keepOrder)
 {
     m_rows.clear();
     if (m_devices.size() < 1)
@@ -60,48 +68,23 @@ void Level::AssignDeviceLogicalRow()
 
     /* 1. Initialize logical row */
     foreach (Device *dev, m_devices)
-        dev->CalLogicalRowByPredecessors();
+        dev->CalLogicalRowByPredecessors(nets);
 
     /* 2. Sort by Logical row */
-    SortByLogicalRow(m_devices);
+    if (NOT keepOrder)
+        SortByLogicalRow(m_devices);
 
 #ifdef DEBUGx
     qInfo() << "Before Assign Logical Row in Level";
     PrintLogicalPos();
 #endif
 
-    /* 3. put the first devie's row into rows */
-    Device *dev = m_devices.front();
-    m_rows.push_back(dev->LogicalRow());
-
-    /* 4. deal with the rest */
-    int row = 0, currMaxRow = 0;
-    for (int i = 1; i < m_devices.size(); ++ i) {
-        dev = m_devices.at(i);
-        row = dev->LogicalRow();
-        currMaxRow = m_rows.back();
-
-        if (row < currMaxRow) {
-            RowsFlexibleShiftUpBy(m_rows, (currMaxRow - row) / 2);
-            row = m_rows.back() + m_rowGap;
-            // row = currMaxRow + m_rowGap;
-            currMaxRow = row;
-            m_rows.push_back(currMaxRow);
-            continue;
-        }
-
-        if (row > currMaxRow) {
-            currMaxRow = row;
-            m_rows.push_back(currMaxRow);
-            continue;
-        }
-
-        /* row == currMxRow */
-        RowsFlexibleShiftUpBy(m_rows, m_rowGap);
-        row = currMaxRow + m_rowGap;
-        currMaxRow = row;
-        m_rows.push_back(currMaxRow);
-    }
+    /* 3. closest rows in this order, m_rowGap apart */
+    QVector<int> wanted;
+    wanted.reserve(m_devices.size());
+    foreach (Device *dev, m_devices)
+        wanted.push_back(dev->LogicalRow());
+    FitRows(wanted, m_rowGap, m_rows);
 
     Q_ASSERT(m_rows.size() == m_devices.size());
 
@@ -127,24 +110,42 @@ void Level::RowsShiftUpBy(QVector<int> &rows, int n) const
         rows[i] -= n;
 }
 
-void Level::RowsFlexibleShiftUpBy(QVector<int> &rows, int n) const
+/*
+ * Rows in order, at least gap apart and closest to the wanted (predecessor)
+ * rows in least squares. With s_i = row_i - i * gap the gap
+ * means s_i <= s_(i+1), so pool adjacent violators fits s: a block whose
+ * mean is above the mean of the block before it is merged into that one.
+ * Every device is pushed once and merged once, O(n) after the sort.
+ */
+void Level::FitRows(const QVector<int> &wanted, int gap, QVector<int> &rows)
 {
-    if (rows.size() == 0)
-        return;
-
-    int curr = 0, prev = 0;
-
-    for (int i = rows.size() - 1; i > 0; -- i) {
-        curr = rows.at(i);
-        prev = rows.at(i - 1);
-        if (curr - prev >= (n + 1)) {
-            rows[i] -= n;
-            return;
+    struct Block
+    {
+        double sum;
+        int    count;
+        double Mean() const { return sum / count; }
+    };
+
+    int n = wanted.size();
+    std::vector<Block> blocks;
+    blocks.reserve(n);
+    for (int i = 0; i < n; ++ i) {
+        blocks.push_back({double(wanted.at(i)) - double(i) * gap, 1});
+        while (blocks.size() > 1 AND blocks[blocks.size() - 2].Mean() >= blocks.back().Mean()) {
+            blocks[blocks.size() - 2].sum += blocks.back().sum;
+            blocks[blocks.size() - 2].count += blocks.back().count;
+            blocks.pop_back();
         }
-        rows[i] -= n;
     }
 
-    rows[0] -= n;
+    /* rounding keeps the means in order, so the gap holds */
+    rows.resize(n);
+    int i = 0, s = 0;
+    for (const Block &block : blocks) {
+        s = qFloor(block.Mean() + 0.5);
+        for (int k = 0; k < block.count; ++ k, ++ i)
+            rows[i] = s + i * gap;
+    }
 }
 
 void Level::AssignDeviceGeometricalCol(int col)
@@ -154,12 +155,13 @@ void Level::AssignDeviceGeometricalCol(int col)
     }
 }
 
-void Level::CollectWires()
+/* wires are created in arena, duplicates are dropped with it */
+void Level::CollectWires(const NetIndex *nets, Arena *arena)
 {
     m_wires.clear();
 
     foreach (Device *dev, m_devices) {
-        foreach (Wire *wire, dev->WiresToFellows())
+        foreach (Wire *wire, dev->WiresToFellows(nets, arena))
             AddWire(wire);
     }
 }
@@ -178,9 +180,9 @@ void Level::AddWire(Wire *wire)
         m_wires.insert(key, wire);
 }
 
-WireList Level::Wires()
+WireList Level::Wires(const NetIndex *nets, Arena *arena)
 {
-    CollectWires();
+    CollectWires(nets, arena);
 
     WireList wires;
     foreach (Wire *wire, m_wires.values())
@@ -234,7 +236,7 @@ void Level::PrintAllDevices() const
     printf("---------------------------------------\n");
 }
 
-void Level::PrintAllConnections() const
+void Level::PrintAllConnections(const NetIndex *nets) const
 {
     printf("--------------- Level %d ---------------\n", m_id);
 
@@ -242,11 +244,11 @@ void Level::PrintAllConnections() const
     foreach (Device *dev, m_devices) {
         result += (dev->Name() + " ");
         result += ("predecessors( ");
-        foreach (Device *predecessor, dev->Predecessors())
+        foreach (Device *predecessor, dev->Predecessors(nets))
             result += (predecessor->Name() + " ");
         result += ("), ");
         result += ("successors( ");
-        foreach (Device *successor, dev->Successors())
+        foreach (Device *successor, dev->Successors(nets))
             result += (successor->Name() + " ");
         result += (")");
         qInfo() << result;
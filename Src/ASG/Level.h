@@ -14,6 +14,8 @@
 
 class Device;
 class Channel;
+class Arena;
+class NetIndex;
 
 class Level
 {
@@ -30,29 +32,34 @@ public:
     int        AllDeviceCount() const { return m_devices.size(); }
     void       SetId(int id);
     int        Id() const { return m_id; }
-    void       AssignDeviceLogicalRow();
+    /* same devices in another order, see CrossingReducer */
+    void       ReorderDevices(const DeviceList &devList);
+    /* keepOrder : rows follow the current order, not predecessor rows */
+    void       AssignDeviceLogicalRow(const NetIndex *nets, bool keepOrder = false);
     void       AssignDeviceGeometricalCol(int col);
     void       SetRowGap(int gap) { m_rowGap = gap; };
     int        RowGap() const { return m_rowGap; }
-    WireList   Wires();
+    WireList   Wires(const NetIndex *nets, Arena *arena);
     void       TryPutDeviceIntoChannel(Channel *ch);
 
     void       PrintAllDevices() const;
-    void       PrintAllConnections() const;
+    void       PrintAllConnections(const NetIndex *nets) const;
     void       PrintRowGap() const;
     void       PrintLogicalPos() const;
     void       PrintOrientation() const;
     void       PrintReverse() const;
     void       PrintGeometricalPos() const;
 
+    /* rows in order, gap apart and closest to the wanted ones, see Tools/LevelBench */
+    static void FitRows(const QVector<int> &wanted, int gap, QVector<int> &rows);
+
 private:
     DISALLOW_COPY_AND_ASSIGN(Level);
 
     void UpdateDeviceLevelId();
     void SortByLogicalRow(DeviceList &devList) const;
     void RowsShiftUpBy(QVector<int> &rows, int n) const;
-    void RowsFlexibleShiftUpBy(QVector<int> &rows, int n) const;
-    void CollectWires();
+    void CollectWires(const NetIndex *nets, Arena *arena);
     void AddWire(Wire *wire);
 
     DeviceList           m_devices;
@@ -0,0 +1,426 @@
+#include "LevelBFS.h"
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <QThread>
+#include <QtAlgorithms>
+#include "Circuit/CompactGraph.h"
+#include "Circuit/DeviceTraits.h"
+
+LevelBFS::LevelBFS(const CompactGraph *graph)
+{
+    Q_ASSERT(graph);
+    m_graph = graph;
+    m_size = graph->DeviceCount();
+    m_netCount = graph->NodeCount();
+    m_threadCount = 0;
+    m_topDownSteps = 0;
+    m_bottomUpSteps = 0;
+    m_bottomUp = false;
+    m_frontierEdges = 0;
+    m_netEdges = 0;
+    m_unvisitedEdges = 0;
+    m_job = nullptr;
+    m_jobThreads = 1;
+    m_pending = 0;
+    m_generation = 0;
+    m_quit = false;
+}
+
+LevelBFS::~LevelBFS()
+{
+    StopWorkers();
+}
+
+int LevelBFS::Run(const std::vector<int> &sources, std::vector<std::vector<int>> *levels)
+{
+    Q_ASSERT(levels);
+    levels->clear();
+    m_topDownSteps = 0;
+    m_bottomUpSteps = 0;
+
+    int threads = m_threadCount;
+    if (threads <= 0)
+        threads = QThread::idealThreadCount();
+    if (m_graph->TerminalCount() < BFS_PARALLEL_MIN_TERMINALS)
+        threads = 1;
+    threads = qMax(threads, 1);
+
+    int words = (m_size + 63) / 64;
+    m_visited = std::vector<std::atomic<quint64>>(words);
+    for (std::atomic<quint64> &word : m_visited)
+        word.store(0, std::memory_order_relaxed);
+    /* only a parallel step races for parents and nets */
+    m_parent = std::vector<std::atomic<int>>(threads > 1 ? m_size : 0);
+    for (std::atomic<int> &parent : m_parent)
+        parent.store(INT_MAX, std::memory_order_relaxed);
+    m_netPos = std::vector<std::atomic<int>>(threads > 1 ? m_netCount : 0);
+    for (std::atomic<int> &pos : m_netPos)
+        pos.store(INT_MAX, std::memory_order_relaxed);
+    m_expanded.assign(m_netCount, 0);
+    m_claimed.clear();
+    m_claimedBy.assign(threads, std::vector<quint32>());
+    m_claimedEdges.assign(threads, 0);
+    m_found.assign(threads, std::vector<quint64>());
+    m_foundEdges.assign(threads, 0);
+
+    m_frontier = sources;
+    m_frontierEdges = 0;
+    for (int dev : sources) {
+        Q_ASSERT(dev >= 0 && dev < m_size);
+        if (Visited(dev)) continue;
+        VisitOwned(dev);
+        m_frontierEdges += Terminals(dev);
+    }
+    m_unvisitedEdges = m_graph->TerminalCount() - m_frontierEdges;
+
+    if (threads > 1)
+        StartWorkers(threads);
+
+    m_bottomUp = false;
+    while (NOT m_frontier.empty()) {
+        for (int tid = 0; tid < threads; ++ tid) {
+            m_claimedBy[tid].clear();
+            m_claimedEdges[tid] = 0;
+            m_found[tid].clear();
+            m_foundEdges[tid] = 0;
+        }
+
+        /* one thread walks top-down, a net is expanded once anyway */
+        if (threads == 1 || m_frontierEdges < BFS_PARALLEL_MIN_TERMINALS) {
+            m_bottomUp = false;
+            StepSerial();
+            m_topDownSteps++;
+        } else {
+            StepParallel(threads);
+        }
+        MergeFound();
+
+        if (m_frontier.empty())
+            break;
+        levels->push_back(m_frontier);
+    }
+
+    StopWorkers();
+
+    return OKAY;
+}
+
+/* claimed nets first, then a direction by their terminals */
+void LevelBFS::StepParallel(int threads)
+{
+    RunJob(&LevelBFS::ClaimNets, threads);
+    CollectClaimed();
+
+    if (NOT m_bottomUp AND m_netEdges > m_unvisitedEdges / BFS_TOP_DOWN_ALPHA)
+        m_bottomUp = true;
+    else if (m_bottomUp AND (qint64)m_frontier.size() < m_size / BFS_BOTTOM_UP_BETA)
+        m_bottomUp = false;
+
+    qint64 work = m_bottomUp ? m_unvisitedEdges : m_netEdges;
+    int stepThreads = (work < BFS_PARALLEL_MIN_TERMINALS) ? 1 : threads;
+    if (m_bottomUp) {
+        RunJob(&LevelBFS::BottomUp, stepThreads);
+        m_bottomUpSteps++;
+    } else {
+        RunJob(&LevelBFS::TopDown, stepThreads);
+        m_topDownSteps++;
+    }
+    RunJob(&LevelBFS::SortFound, stepThreads);
+    ExpandClaimed();
+}
+
+/* claims and expands in frontier order, the first device on a net has the smallest position */
+void LevelBFS::StepSerial()
+{
+    std::vector<quint64> &found = m_found[0];
+    qint64 edges = 0;
+    quint32 node = 0;
+    int dev = 0, other = 0;
+    size_t first = 0;
+    bool sorted = true;
+
+    for (int pos = 0; pos < (int)m_frontier.size(); ++ pos) {
+        dev = m_frontier[pos];
+        if (NOT Traits(m_graph->Type(dev)).expandsNets) continue;
+        first = found.size();
+        sorted = true;
+        for (quint32 ter = m_graph->TerminalBegin(dev); ter < m_graph->TerminalEnd(dev); ++ ter) {
+            node = m_graph->TerminalNode(ter);
+            if (node == CompactGraph::GND_NODE || m_expanded[node]) continue;
+            m_expanded[node] = 1;
+            for (quint32 j = m_graph->NodeBegin(node); j < m_graph->NodeEnd(node); ++ j) {
+                other = m_graph->TerminalDevice(m_graph->NodeTerminal(j));
+                if (Visited(other)) continue;
+                VisitOwned(other);
+                if (found.size() > first AND found.back() > Key(pos, other))
+                    sorted = false;
+                found.push_back(Key(pos, other));
+                edges += Terminals(other);
+            }
+        }
+        /* a net lists devices by id, the nets of dev may interleave */
+        if (NOT sorted)
+            std::sort(found.begin() + first, found.end());
+    }
+
+    m_foundEdges[0] = edges;
+}
+
+int LevelBFS::Terminals(int dev) const
+{
+    return m_graph->TerminalEnd(dev) - m_graph->TerminalBegin(dev);
+}
+
+/* nets of frontier devices not expanded yet, a net keeps the smallest position */
+void LevelBFS::ClaimNets(int tid)
+{
+    int count = m_frontier.size();
+    int lo = (qint64)count * tid / m_jobThreads;
+    int hi = (qint64)count * (tid + 1) / m_jobThreads;
+    std::vector<quint32> &claimed = m_claimedBy[tid];
+    qint64 edges = 0;
+    quint32 node = 0;
+    int dev = 0, cur = 0;
+
+    for (int pos = lo; pos < hi; ++ pos) {
+        dev = m_frontier[pos];
+        if (NOT Traits(m_graph->Type(dev)).expandsNets) continue;
+        for (quint32 ter = m_graph->TerminalBegin(dev); ter < m_graph->TerminalEnd(dev); ++ ter) {
+            node = m_graph->TerminalNode(ter);
+            if (node == CompactGraph::GND_NODE || m_expanded[node]) continue;
+            cur = m_netPos[node].load(std::memory_order_relaxed);
+            while (pos < cur) {
+                if (m_netPos[node].compare_exchange_weak(cur, pos, std::memory_order_relaxed)) {
+                    if (cur == INT_MAX) {
+                        claimed.push_back(node);
+                        edges += m_graph->NodeDegree(node);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    m_claimedEdges[tid] = edges;
+}
+
+/* claimed nets, a device keeps the smallest position of a net reaching it */
+void LevelBFS::TopDown(int tid)
+{
+    int count = m_claimed.size();
+    int lo = (qint64)count * tid / m_jobThreads;
+    int hi = (qint64)count * (tid + 1) / m_jobThreads;
+    std::vector<quint64> &found = m_found[tid];
+    qint64 edges = 0;
+    quint32 node = 0;
+    int pos = 0, dev = 0, cur = 0;
+
+    for (int i = lo; i < hi; ++ i) {
+        node = m_claimed[i];
+        pos = m_netPos[node].load(std::memory_order_relaxed);
+        for (quint32 j = m_graph->NodeBegin(node); j < m_graph->NodeEnd(node); ++ j) {
+            dev = m_graph->TerminalDevice(m_graph->NodeTerminal(j));
+            if (Visited(dev)) continue;
+            cur = m_parent[dev].load(std::memory_order_relaxed);
+            while (pos < cur) {
+                if (m_parent[dev].compare_exchange_weak(cur, pos, std::memory_order_relaxed)) {
+                    if (cur == INT_MAX) {
+                        found.push_back(dev);
+                        edges += Terminals(dev);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    m_foundEdges[tid] = edges;
+}
+
+/* unvisited devices, the smallest position of their claimed nets */
+void LevelBFS::BottomUp(int tid)
+{
+    int words = m_visited.size();
+    int lo = (qint64)words * tid / m_jobThreads;
+    int hi = (qint64)words * (tid + 1) / m_jobThreads;
+    std::vector<quint64> &found = m_found[tid];
+    qint64 edges = 0;
+    quint64 unvisited = 0;
+    quint32 node = 0;
+    int dev = 0, best = 0, pos = 0;
+
+    for (int w = lo; w < hi; ++ w) {
+        unvisited = ~m_visited[w].load(std::memory_order_relaxed);
+        if (w == words - 1 && (m_size & 63))
+            unvisited &= (1ULL << (m_size & 63)) - 1;
+        while (unvisited) {
+            dev = (w << 6) + qCountTrailingZeroBits(unvisited);
+            unvisited &= unvisited - 1;
+            best = INT_MAX;
+            for (quint32 ter = m_graph->TerminalBegin(dev); ter < m_graph->TerminalEnd(dev); ++ ter) {
+                node = m_graph->TerminalNode(ter);
+                if (node == CompactGraph::GND_NODE) continue;
+                pos = m_netPos[node].load(std::memory_order_relaxed);
+                if (pos < best)
+                    best = pos;
+            }
+            if (best == INT_MAX) continue;
+            /* the word belongs to this thread */
+            VisitOwned(dev);
+            found.push_back(Key(best, dev));
+            edges += Terminals(dev);
+        }
+    }
+
+    m_foundEdges[tid] = edges;
+}
+
+/* Key(parent, dev) is the serial queue order */
+void LevelBFS::SortFound(int tid)
+{
+    std::vector<quint64> &found = m_found[tid];
+    if (NOT m_bottomUp) {
+        int dev = 0;
+        for (quint64 &key : found) {
+            dev = (int)key;
+            key = Key(m_parent[dev].load(std::memory_order_relaxed), dev);
+            Visit(dev);
+        }
+    }
+    std::sort(found.begin(), found.end());
+}
+
+void LevelBFS::MergeFound()
+{
+    std::vector<int> &level = m_next;
+    int threads = m_found.size(), nonEmpty = 0, last = 0;
+    size_t total = 0;
+
+    m_frontierEdges = 0;
+    for (int tid = 0; tid < threads; ++ tid) {
+        m_frontierEdges += m_foundEdges[tid];
+        total += m_found[tid].size();
+        if (m_found[tid].empty()) continue;
+        nonEmpty++;
+        last = tid;
+    }
+    m_unvisitedEdges -= m_frontierEdges;
+    level.clear();
+    level.reserve(total);
+
+    if (nonEmpty <= 1) {
+        for (quint64 key : m_found[last])
+            level.push_back((int)(key & 0xffffffffULL));
+        m_frontier.swap(level);
+        return;
+    }
+
+    typedef std::pair<quint64, int> Head;   // key, thread
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head>> heads;
+    std::vector<size_t> next(threads, 0);
+    for (int tid = 0; tid < threads; ++ tid) {
+        if (NOT m_found[tid].empty())
+            heads.push(Head(m_found[tid].front(), tid));
+    }
+
+    while (NOT heads.empty()) {
+        Head head = heads.top();
+        heads.pop();
+        level.push_back((int)(head.first & 0xffffffffULL));
+        const std::vector<quint64> &found = m_found[head.second];
+        if (++ next[head.second] < found.size())
+            heads.push(Head(found[next[head.second]], head.second));
+    }
+    m_frontier.swap(level);
+}
+
+void LevelBFS::CollectClaimed()
+{
+    m_claimed.clear();
+    m_netEdges = 0;
+    for (size_t tid = 0; tid < m_claimedBy.size(); ++ tid) {
+        m_claimed.insert(m_claimed.end(), m_claimedBy[tid].begin(), m_claimedBy[tid].end());
+        m_netEdges += m_claimedEdges[tid];
+    }
+}
+
+/* every device of a claimed net is visited now, the net is never claimed again */
+void LevelBFS::ExpandClaimed()
+{
+    for (quint32 node : m_claimed) {
+        m_expanded[node] = 1;
+        m_netPos[node].store(INT_MAX, std::memory_order_relaxed);
+    }
+}
+
+void LevelBFS::RunJob(Job job, int threads)
+{
+    if (threads <= 1 || m_workers.empty()) {
+        m_jobThreads = 1;
+        (this->*job)(0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = job;
+        m_jobThreads = threads;
+        m_pending = threads - 1;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    (this->*job)(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]{ return m_pending == 0; });
+}
+
+/* seen is the generation at start, the jobs of an earlier Run() are not taken */
+void LevelBFS::WorkerLoop(int tid, quint64 seen)
+{
+    Job job = nullptr;
+
+    for (;;) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_wake.wait(lock, [this, seen]{ return m_generation != seen; });
+        seen = m_generation;
+        if (m_quit)
+            return;
+        job = m_job;
+        lock.unlock();
+
+        (this->*job)(tid);
+
+        lock.lock();
+        if (-- m_pending == 0)
+            m_done.notify_one();
+    }
+}
+
+void LevelBFS::StartWorkers(int threads)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_quit = false;
+    for (int tid = 1; tid < threads; ++ tid)
+        m_workers.emplace_back(&LevelBFS::WorkerLoop, this, tid, m_generation);
+}
+
+void LevelBFS::StopWorkers()
+{
+    if (m_workers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+        m_generation++;
+    }
+    m_wake.notify_all();
+
+    for (std::thread &worker : m_workers)
+        worker.join();
+    m_workers.clear();
+}
@@ -0,0 +1,114 @@
+#ifndef NETLISTVIZ_ASG_LEVELBFS_H
+#define NETLISTVIZ_ASG_LEVELBFS_H
+
+/*
+ * @filename : LevelBFS.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Level-synchronous BFS over the nets of the CompactGraph
+ *           : for CalLogicalCol, no device pairs are built. Frontier
+ *           : devices claim their non-ground nets, a net keeps the
+ *           : smallest frontier position and is expanded once in the
+ *           : whole run. A small step does both in one walk. A big one
+ *           : claims on threads, then goes top-down (claimed nets list
+ *           : their unvisited devices) or bottom-up (unvisited devices
+ *           : look for a claimed net), chosen by terminal counts. A new
+ *           : device keeps the smallest frontier position that reaches
+ *           : it, so every level comes out in the order a serial queue
+ *           : gives.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <QtGlobal>
+#include "Define/Define.h"
+
+class CompactGraph;
+
+class LevelBFS
+{
+public:
+    explicit LevelBFS(const CompactGraph *graph);
+    ~LevelBFS();
+
+    /* 0 : QThread::idealThreadCount(), 1 : serial */
+    void SetThreadCount(int count) { m_threadCount = count; }
+    /* levels after sources, devices are CompactGraph ids */
+    int  Run(const std::vector<int> &sources, std::vector<std::vector<int>> *levels);
+    int  TopDownSteps() const  { return m_topDownSteps; }
+    int  BottomUpSteps() const { return m_bottomUpSteps; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(LevelBFS);
+
+    typedef void (LevelBFS::*Job)(int tid);
+
+    bool Visited(int dev) const
+    { return m_visited[dev >> 6].load(std::memory_order_relaxed) & (1ULL << (dev & 63)); }
+    void Visit(int dev)
+    { m_visited[dev >> 6].fetch_or(1ULL << (dev & 63), std::memory_order_relaxed); }
+    /* no other thread writes the word, no locked instruction */
+    void VisitOwned(int dev)
+    {
+        std::atomic<quint64> &word = m_visited[dev >> 6];
+        word.store(word.load(std::memory_order_relaxed) | (1ULL << (dev & 63)), std::memory_order_relaxed);
+    }
+    static quint64 Key(int pos, int dev) { return ((quint64)pos << 32) | (quint32)dev; }
+
+    int  Terminals(int dev) const;
+
+    void StepSerial();
+    void StepParallel(int threads);
+    void ClaimNets(int tid);
+    void TopDown(int tid);
+    void BottomUp(int tid);
+    void SortFound(int tid);
+    void MergeFound();
+    void CollectClaimed();
+    void ExpandClaimed();
+
+    void RunJob(Job job, int threads);
+    void WorkerLoop(int tid, quint64 seen);
+    void StartWorkers(int threads);
+    void StopWorkers();
+
+    const CompactGraph                *m_graph;
+    int                                m_size;
+    int                                m_netCount;
+    int                                m_threadCount;
+    int                                m_topDownSteps;
+    int                                m_bottomUpSteps;
+
+    std::vector<std::atomic<quint64>>  m_visited;       // bitmap
+    std::vector<int>                   m_frontier;      // devices of the level
+    std::vector<int>                   m_next;          // the next one, swapped in
+    std::vector<std::atomic<int>>      m_parent;        // smallest frontier position, top-down
+    std::vector<std::atomic<int>>      m_netPos;        // smallest frontier position, claimed nets
+    std::vector<quint8>                m_expanded;      // nets claimed by an earlier step
+    std::vector<quint32>               m_claimed;       // nets of the step
+    std::vector<std::vector<quint32>>  m_claimedBy;     // per thread
+    std::vector<qint64>                m_claimedEdges;  // per thread, terminals of the nets
+    std::vector<std::vector<quint64>>  m_found;         // per thread, Key(parent, dev)
+    std::vector<qint64>                m_foundEdges;    // per thread, terminals of the devices
+    bool                               m_bottomUp;
+    qint64                             m_frontierEdges;
+    qint64                             m_netEdges;
+    qint64                             m_unvisitedEdges;
+
+    /* workers wait for a new generation, run m_job, count down m_pending */
+    std::vector<std::thread>           m_workers;
+    std::mutex                         m_mutex;
+    std::condition_variable            m_wake;
+    std::condition_variable            m_done;
+    Job                                m_job;
+    int                                m_jobThreads;
+    int                                m_pending;
+    quint64                            m_generation;
+    bool                               m_quit;
+};
+
+#endif // NETLISTVIZ_ASG_LEVELBFS_H
@@ -0,0 +1,139 @@
+#include "LevelGraph.h"
+#include <algorithm>
+#include "Circuit/CompactGraph.h"
+#include "Circuit/Device.h"
+#include "Level.h"
+#include "NetIndex.h"
+
+LevelGraph::LevelGraph(const NetIndex *nets, const LevelList &levels)
+{
+    Q_ASSERT(nets);
+    m_nets = nets;
+    m_levels = levels;
+}
+
+LevelGraph::~LevelGraph()
+{
+}
+
+/* edges from the NetIndex groups of every net at two adjacent levels */
+int LevelGraph::Build()
+{
+    const CompactGraph *graph = m_nets->Graph();
+    int levelCount = m_levels.size();
+
+    m_devices.assign(levelCount, DeviceList());
+    m_local.clear();
+    for (int l = 0; l < levelCount; ++ l) {
+        m_devices[l] = m_levels.at(l)->AllDevices();
+        for (int i = 0; i < m_devices[l].size(); ++ i)
+            m_local.push_back({m_devices[l].at(i)->Id(), i});
+    }
+    std::sort(m_local.begin(), m_local.end());
+
+    m_down.assign(levelCount, Adjacency());
+    m_up.assign(levelCount, Adjacency());
+
+    std::vector<int> others;
+    quint32 node = 0;
+    int group = 0, levelId = 0, nextId = 0;
+    for (int l = 0; l + 1 < levelCount; ++ l) {
+        levelId = m_levels.at(l)->Id();
+        nextId = m_levels.at(l + 1)->Id();
+        Adjacency &down = m_down[l];
+        down.begin.push_back(0);
+
+        foreach (Device *dev, m_devices[l]) {
+            others.clear();
+            for (quint32 ter = graph->TerminalBegin(dev->Id()); ter < graph->TerminalEnd(dev->Id()); ++ ter) {
+                node = graph->TerminalNode(ter);
+                if (node == CompactGraph::GND_NODE)
+                    continue;
+                group = m_nets->FindGroup(node, nextId);
+                if (group < 0)
+                    continue;
+                if ((long long)m_nets->Count(node, levelId) * m_nets->GroupSize(group) > CROSS_MAX_NET_PAIRS)
+                    continue;
+                for (quint32 i = m_nets->GroupBegin(group); i < m_nets->GroupEnd(group); ++ i)
+                    others.push_back(LocalIndex(graph->TerminalDevice(m_nets->Entry(i))));
+            }
+            std::sort(others.begin(), others.end());
+            others.erase(std::unique(others.begin(), others.end()), others.end());
+            down.other.insert(down.other.end(), others.begin(), others.end());
+            down.begin.push_back(down.other.size());
+        }
+
+        Transpose(l);
+    }
+
+    /* no level after the last one, none before the first one */
+    if (levelCount > 0) {
+        m_down[levelCount - 1].begin.assign(m_devices[levelCount - 1].size() + 1, 0);
+        m_up[0].begin.assign(m_devices[0].size() + 1, 0);
+    }
+
+    return OKAY;
+}
+
+int LevelGraph::LocalIndex(quint32 dev) const
+{
+    auto it = std::lower_bound(m_local.begin(), m_local.end(), std::make_pair((int)dev, 0));
+    Q_ASSERT(it != m_local.end() AND it->first == (int)dev);
+    return it->second;
+}
+
+/* m_up[level + 1] from m_down[level] */
+void LevelGraph::Transpose(int level)
+{
+    const Adjacency &down = m_down[level];
+    Adjacency &up = m_up[level + 1];
+    int count = m_devices[level + 1].size();
+
+    up.begin.assign(count + 1, 0);
+    for (int other : down.other)
+        up.begin[other + 1]++;
+    for (int j = 0; j < count; ++ j)
+        up.begin[j + 1] += up.begin[j];
+
+    std::vector<int> fill(up.begin.begin(), up.begin.end() - 1);
+    up.other.resize(down.other.size());
+    for (int i = 0; i < m_devices[level].size(); ++ i) {
+        for (int k = down.begin[i]; k < down.begin[i + 1]; ++ k)
+            up.other[fill[down.other[k]]++] = i;
+    }
+}
+
+/*
+ * Edges are taken by their upper end, an edge crosses the ones taken
+ * before whose lower end is below its own, counted by a Fenwick tree over
+ * the positions of level + 1. O(E log V).
+ */
+qint64 LevelGraph::Crossings(int level, const std::vector<int> &order,
+                             const std::vector<int> &nextPos) const
+{
+    const Adjacency &down = m_down[level];
+    std::vector<int> tree(nextPos.size() + 1, 0);
+    std::vector<int> ends;
+    qint64 crossings = 0, taken = 0, atOrAbove = 0;
+
+    for (int i : order) {
+        ends.clear();
+        for (int k = down.begin[i]; k < down.begin[i + 1]; ++ k)
+            ends.push_back(nextPos[down.other[k]]);
+
+        /* edges of one device share an end, they do not cross */
+        for (int pos : ends) {
+            atOrAbove = 0;
+            for (int p = pos + 1; p > 0; p -= p & (-p))
+                atOrAbove += tree[p];
+            crossings += taken - atOrAbove;
+        }
+        for (int pos : ends) {
+            for (int p = pos + 1; p < (int)tree.size(); p += p & (-p))
+                tree[p]++;
+            taken++;
+        }
+    }
+
+    return crossings;
+}
@@ -0,0 +1,64 @@
+#ifndef NETLISTVIZ_ASG_LEVELGRAPH_H
+#define NETLISTVIZ_ASG_LEVELGRAPH_H
+
+/*
+ * @filename : LevelGraph.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Edges between adjacent levels of one Component, for the
+ *           : passes that reorder devices (CrossingReducer, Annealer).
+ *           : Two devices of adjacent levels on one net are an edge,
+ *           : once however many nets they share. Ground and nets of more
+ *           : than CROSS_MAX_NET_PAIRS device pairs are left out. A
+ *           : device is its local index in the level, as AllDevices()
+ *           : gave it when the graph was built.
+ */
+
+#include <vector>
+#include <QtGlobal>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class NetIndex;
+
+class LevelGraph
+{
+public:
+    /* neighbours in the next level (down) or the previous one (up) */
+    struct Adjacency
+    {
+        std::vector<int> begin;     // devices of the level + 1
+        std::vector<int> other;     // local index in the other level
+    };
+
+    LevelGraph(const NetIndex *nets, const LevelList &levels);
+    ~LevelGraph();
+
+    int   Build();
+    int   LevelCount() const                     { return m_levels.size(); }
+    Level* LevelAt(int level) const              { return m_levels.at(level); }
+    const DeviceList& Devices(int level) const   { return m_devices[level]; }
+    int   DeviceCount(int level) const           { return m_devices[level].size(); }
+    const Adjacency& Down(int level) const       { return m_down[level]; }
+    const Adjacency& Up(int level) const         { return m_up[level]; }
+
+    /* edges of level (in order) and level + 1 (at nextPos) that cross */
+    qint64 Crossings(int level, const std::vector<int> &order,
+                     const std::vector<int> &nextPos) const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(LevelGraph);
+
+    int   LocalIndex(quint32 dev) const;
+    void  Transpose(int level);
+
+    const NetIndex                   *m_nets;
+    LevelList                         m_levels;
+    std::vector<DeviceList>           m_devices;     // by level
+    std::vector<std::pair<int, int>>  m_local;       // (device id, local index), sorted
+    std::vector<Adjacency>            m_down;        // level l to l + 1
+    std::vector<Adjacency>            m_up;          // level l to l - 1
+};
+
+#endif // NETLISTVIZ_ASG_LEVELGRAPH_H
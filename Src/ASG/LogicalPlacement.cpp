@@ -2,28 +2,31 @@
 #include <QDebug>
 #include <QtMath>
 #include <QTime>
+#include <QElapsedTimer>
 #include "Circuit/CircuitGraph.h"
-#include "Matrix.h"
-#include "MatrixElement.h"
+#include "Circuit/CompactGraph.h"
 #include "Circuit/Device.h"
 #include "Circuit/Terminal.h"
 #include "Circuit/Node.h"
 #include "Level.h"
+#include "LevelBFS.h"
+#include "Component.h"
+#include "NetIndex.h"
 
 int ASG::LogicalPlacement()
 {
 #ifdef TRACE
     qInfo() << LINE_INFO << endl;
 #endif
-    int error = BuildIncidenceMatrix();
+    int error = RenumberDevices();
     if (error)
         return ERROR;
-    
+
     error = CalLogicalCol();
     if (error)
         return ERROR;
 
-    error = ClassifyConnectDeviceByLevel();
+    error = IndexNetsByLevel();
     if (error)
         return ERROR;
 
@@ -48,367 +51,300 @@ int ASG::LogicalPlacement()
     return error;
 }
 
-int ASG::BuildIncidenceMatrix()
+/*
+ * Components one after another on one clock, each annealed until the time
+ * of the components before it and its own share by device count is up, so
+ * time one leaves goes to the next and budgetMs covers them all. Replicas
+ * of one component run on threads. Orientations follow the new rows.
+ */
+int ASG::AnnealPlacement(int budgetMs)
 {
-    if (m_matrix) delete m_matrix;
-    int size = m_ckt->DeviceCount();
-    m_matrix = new Matrix(size);
-
-    /* Row and Col header */
-    int row = 0, col = 0;
-    Device *device = nullptr;
-    foreach (device, m_ckt->GetDeviceList()) {
-        row = device->Id();
-        col = device->Id();
-        m_matrix->SetRowHeadDevice(row, device);
-        m_matrix->SetColHeadDevice(col, device);
-    }
+    if (m_logDataDestroyed || NOT m_nets)
+        return ERROR;
 
-    /* insert matrix elements */
-    foreach (device, m_ckt->GetDeviceList()) {
-        switch (device->GetDeviceType()) {
-            case RESISTOR:
-            case CAPACITOR:
-            case INDUCTOR:
-            case ISRC:
-            case VSRC:
-                InsertBasicDevice(device);
-                break;
-            default:;
-        }
+    qint64 deviceCount = 0;
+    foreach (Component *component, m_components)
+        deviceCount += component->DeviceCount();
+    if (deviceCount < 1)
+        return OKAY;
+
+    QElapsedTimer clock;
+    clock.start();
+
+    int error = OKAY;
+    qint64 devicesSoFar = 0, deadline = 0;
+    m_crossingsAfter = 0;
+    foreach (Component *component, m_components) {
+        devicesSoFar += component->DeviceCount();
+        deadline = budgetMs * devicesSoFar / deviceCount;
+        error = component->Anneal(m_nets, clock, deadline);
+        if (error)
+            return ERROR;
+        m_crossingsAfter += component->CrossingsAfter();
     }
-#ifdef DEBUGx
-    // m_matrix->Print();
-    m_matrix->Plot();
+
+#ifdef TRACE
+    qInfo() << "crossings between levels after annealing" << m_crossingsAfter;
 #endif
-    return OKAY;
+
+    error = DecideDeviceOrientation();
+    if (error)
+        return ERROR;
+
+    return DecideDeviceWhetherToReverse();
 }
 
-/* R, L, C, V, I */
-/* undirected graph */
-int ASG::InsertBasicDevice(Device *device)
+/* ids in m_deviceOrder, the frozen arrays are built again */
+int ASG::RenumberDevices()
 {
-    /* device is from device */
-    Node *posNode = device->GetTerminal(Positive)->GetNode();
-    Node *negNode = device->GetTerminal(Negative)->GetNode();
-    /* to device */
-    Device *toDev = nullptr;
-    int row = 0, col = 0;
-
-    Q_ASSERT(posNode && negNode);
-
-    if (NOT posNode->IsGnd()) {
-        foreach (toDev, posNode->ConnectDeviceList()) {
-            row = device->Id();
-            col = toDev->Id();
-            if (row == col) continue;
-            Terminal *toTer = toDev->GetTerminal(posNode);
-            Q_ASSERT(toTer);
-            m_matrix->InsertElement(row, col, device, device->GetTerminal(Positive), toDev, toTer); 
-        }
-    }
+    if (m_deviceOrder == NetlistOrder)
+        return OKAY;
 
-    if (NOT negNode->IsGnd()) {
-        foreach (toDev, negNode->ConnectDeviceList()) {
-            row = device->Id();
-            col = toDev->Id();
-            if (row == col) continue;
-            Terminal *toTer = toDev->GetTerminal(negNode);
-            Q_ASSERT(toTer);
-            m_matrix->InsertElement(row, col, device, device->GetTerminal(Negative), toDev, toTer);
-        }
-    }
+    int error = m_ckt->Renumber(m_deviceOrder);
+    if (error)
+        return ERROR;
 
-    return OKAY;
+    return Prepare();
 }
 
+/*
+ * Every connected component gets its own levels. One BFS runs from the
+ * first levels of all components, a level of it lists the components in
+ * the order of their sources, so it is cut into the levels a BFS of each
+ * component would give. Level ids of a component start at its base, one
+ * id is left empty before the next component.
+ */
 int ASG::CalLogicalCol()
 {
 #ifdef TRACE
     qInfo() << LINE_INFO << endl;
 #endif
 
-    m_levels.clear();
+    DestroyComponents();
 
-    /* set all device unvisited */
-    memset(m_visited, 0, sizeof(int) * m_ckt->DeviceCount());
+    std::vector<int> component;
+    int count = m_compact->Components(&component);
 
-    Level *level = nullptr;
-    int currLevelId = 0;
+    std::vector<std::vector<int>> firstLevels;
+    int error = FirstLevelDevices(m_ckt->FirstLevelDeviceList(), component, count, &firstLevels);
+    if (error)
+        return ERROR;
 
-    /* level 0 */
-    level = new Level(currLevelId);
-    level->AddDevices(m_ckt->FirstLevelDeviceList());
+    std::vector<int> sources;
+    sources.reserve(m_compact->DeviceCount());
+    for (const std::vector<int> &first : firstLevels)
+        sources.insert(sources.end(), first.begin(), first.end());
 
-#ifdef DEBUGx
-    level->PrintAllDevices();
-#endif
+    std::vector<std::vector<int>> devices;
+    LevelBFS bfs(m_compact);
+    error = bfs.Run(sources, &devices);
+    if (error)
+        return ERROR;
 
-    /* set first level devices as visited */
-    Device *device = nullptr;
-    foreach (device, m_ckt->FirstLevelDeviceList())
-        m_visited[device->Id()] = 1;
-    
-    int totalDeviceNumber = m_ckt->GetDeviceList().size();
-    int currDeviceNumber = level->AllDeviceCount();
-    
-    m_levels.push_back(level);
-    currLevelId++;
-
-    /* the rest levels */
-    while (NOT level->Empty()) {
-        level = CreateNextLevel(level);
-        if (level->Empty()) break;
-        level->SetId(currLevelId);
-        currLevelId++;
-#ifdef DEBUGx
-        level->PrintAllDevices();
-#endif
-        m_levels.push_back(level);
-        currDeviceNumber += level->AllDeviceCount();
+    /* levels of every component, the first level included */
+    std::vector<int> depth(count, 1);
+    for (size_t step = 0; step < devices.size(); ++ step) {
+        for (int dev : devices[step])
+            depth[component[dev]] = step + 2;
+    }
+    std::vector<int> base(count, 0);
+    int levelId = 0;
+    for (int c = 0; c < count; ++ c) {
+        base[c] = levelId;
+        levelId += depth[c] + 1;
     }
 
-#ifdef DEBUGx
-    qInfo() << "total device(" << totalDeviceNumber << "), "
-            << "current device(" << currDeviceNumber << ")" << endl;
-#endif
-
-    return OKAY;
-}
+    Level *level = nullptr;
+    m_components.reserve(count);
+    for (int c = 0; c < count; ++ c) {
+        m_components.push_back(new Component(c));
+        level = new Level(base[c]);
+        for (int dev : firstLevels[c])
+            level->AddDevice(m_compact->GetDevice(dev));
+        m_components.back()->AddLevel(level);
+    }
 
-Level* ASG::CreateNextLevel(Level *prevLevel) const
-{
-    Q_ASSERT(prevLevel);
-
-    Level *nextLevel = new Level();
-    int id = 0;
-    MatrixElement *element = nullptr;
-    Device *device = nullptr;
-
-    foreach (device, prevLevel->AllDevices()) {
-        id = device->Id();
-        element = m_matrix->RowHead(id).head;
-        while (element) {
-            device = element->ToDevice();
-            if (m_visited[device->Id()]) {
-                element = element->NextInRow();
-                continue;
+    /* a level of the BFS touches components in source order */
+    std::vector<int> touched;
+    std::vector<Level*> stepLevel(count, nullptr);
+    int c = 0;
+    for (size_t step = 0; step < devices.size(); ++ step) {
+        touched.clear();
+        for (int dev : devices[step]) {
+            c = component[dev];
+            if (NOT stepLevel[c]) {
+                stepLevel[c] = new Level(base[c] + step + 1);
+                touched.push_back(c);
             }
-            nextLevel->AddDevice(device);
-            element = element->NextInRow();
-            m_visited[device->Id()] = 1;
+            stepLevel[c]->AddDevice(m_compact->GetDevice(dev));
+        }
+        for (int t : touched) {
+            m_components.at(t)->AddLevel(stepLevel[t]);
+            stepLevel[t] = nullptr;
         }
     }
 
-    return nextLevel;
-}
-
-int ASG::ClassifyConnectDeviceByLevel()
-{
-    foreach (Device *dev, m_ckt->GetDeviceList())
-        dev->ClassifyConnectDeviceByLevel();
-
+#ifdef TRACE
+    qInfo() << count << " components, level BFS " << bfs.TopDownSteps() << " top-down, "
+            << bfs.BottomUpSteps() << " bottom-up steps" << endl;
+#endif
 #ifdef DEBUGx
-    foreach (Level *level, m_levels)
-        level->PrintAllConnections();
+    foreach (Component *comp, m_components)
+        comp->PrintLevels();
 #endif
 
     return OKAY;
 }
 
-int ASG::CalLogicalRow()
+/*
+ * First level of a component, the first kind it has of: the chosen first
+ * level devices, its sources to ground, its floating sources, its port
+ * devices (on a node of no other device, at most FL_MAX_PORT_DEVICES),
+ * else its peripheral device. Chosen devices keep their order, a device
+ * chosen twice is taken once, others go by id.
+ */
+int ASG::FirstLevelDevices(const DeviceList &chosenList, const std::vector<int> &component, int count,
+                           std::vector<std::vector<int>> *firstLevels) const
 {
-    int error = EstimateLogicalRowGap();
-    if (error)
-        return ERROR;
-
-    error = DetermineFirstLevelLogicalRow();
-    if (error)
-        return ERROR;
-
-    error = ForwardPropagateLogicalRow();
-    if (error)
-        return ERROR;
-
-    return error;
-}
-
-int ASG::EstimateLogicalRowGap()
-{
-#ifdef TRACE
-    qInfo() << LINE_INFO << endl;
-#endif
-
-    if (m_levels.size() < 1)
-        return OKAY;
-
-#if 0
-    /* First, find max device count level */
-    Level *maxDeviceCountLevel = m_levels.front();
-    int    maxDeviceCount = maxDeviceCountLevel->AllDeviceCount();
-    int    maxDeviceCountIndex = 0;
-    Level *level = nullptr;
-
-    for (int i = 1; i < m_levels.size(); ++ i) {
-        level = m_levels.at(i);
-        if (level->AllDeviceCount() > maxDeviceCount) {
-            maxDeviceCount = level->AllDeviceCount();
-            maxDeviceCountLevel = level;
-            maxDeviceCountIndex = i;
-        }
+    enum Kind { Chosen = 0, GroundedSource, FloatingSource, Port, Peripheral };
+
+    firstLevels->assign(count, std::vector<int>());
+    std::vector<quint8> kind(count, Peripheral);
+    std::vector<quint8> taken(component.size(), 0);
+
+    int dev = 0;
+    foreach (Device *device, chosenList) {
+        dev = device->Id();
+        if (taken[dev]) continue;
+        taken[dev] = 1;
+        kind[component[dev]] = Chosen;
+        (*firstLevels)[component[dev]].push_back(dev);
     }
-    Q_ASSERT(maxDeviceCountLevel->AllDeviceCount() > 0);
-
-    /* Second, assign DFT_MAX_DEVICE_ROW_GAP to this level */
-    maxDeviceCountLevel->SetRowGap(DFT_MAX_DEVICE_ROW_GAP);
-
-    /* Third, deal with [0, indexOfMaxDeviceCount) */
-    Level *nextLevel = nullptr, *currLevel = nullptr; 
-    nextLevel = maxDeviceCountLevel;
-    int nextDeviceCount = nextLevel->AllDeviceCount();
-    int currDeviceCount = 0;
-    int ratio = 1;
-
-    for (int i = maxDeviceCountIndex - 1; i >= 0; -- i) {
-        currLevel = m_levels.at(i);
-        currDeviceCount = currLevel->AllDeviceCount();
-        if (currDeviceCount == 0) {
-            currLevel->SetRowGap(DFT_MAX_DEVICE_ROW_GAP);
-            nextLevel = currLevel;
-            continue;
+
+    int c = 0, k = Peripheral;
+    quint32 node = 0;
+    DeviceType type = Other;
+    for (dev = 0; dev < (int)component.size(); ++ dev) {
+        c = component[dev];
+        if (kind[c] == Chosen) continue;
+
+        type = m_compact->Type(dev);
+        if (m_compact->GetDevice(dev)->MaybeAtFirstLevel()) {
+            k = GroundedSource;
+        } else if (type == VSRC || type == ISRC) {
+            k = FloatingSource;
+        } else {
+            k = Peripheral;
+            for (quint32 ter = m_compact->TerminalBegin(dev); ter < m_compact->TerminalEnd(dev); ++ ter) {
+                node = m_compact->TerminalNode(ter);
+                if (node != CompactGraph::GND_NODE AND m_compact->NodeDegree(node) == 1)
+                    k = Port;
+            }
         }
 
-        ratio = nextDeviceCount * 1.0 / currDeviceCount + 0.5;
-        currLevel->SetRowGap(nextLevel->RowGap() * ratio);
+        if (k > kind[c]) continue;
+        if (k < kind[c]) {
+            kind[c] = k;
+            (*firstLevels)[c].clear();
+        }
+        if (k != Peripheral)
+            (*firstLevels)[c].push_back(dev);
     }
 
-    /* Fourth, deal with (indexOfMaxDeviceCount, lastIndex] */
-    Level *prevLevel = nullptr;
-    prevLevel = maxDeviceCountLevel;
-    int prevDeviceCount = prevLevel->AllDeviceCount();
-
-    for (int i = maxDeviceCountIndex + 1; i < m_levels.size(); ++ i) {
-        currLevel = m_levels.at(i);
-        currDeviceCount = currLevel->AllDeviceCount();
-        if (currDeviceCount == 0) {
-            currLevel->SetRowGap(DFT_MAX_DEVICE_ROW_GAP);
-            nextLevel = currLevel;
-            continue;
+    bool peripheral = false;
+    for (c = 0; c < count; ++ c) {
+        if (kind[c] == Port AND (int)(*firstLevels)[c].size() > FL_MAX_PORT_DEVICES) {
+            kind[c] = Peripheral;
+            (*firstLevels)[c].clear();
         }
-
-        ratio = prevDeviceCount * 1.0 / currDeviceCount + 0.5;
-        currLevel->SetRowGap(prevLevel->RowGap() * ratio);
-        prevLevel = currLevel;
+        peripheral = peripheral || (kind[c] == Peripheral);
     }
+    if (NOT peripheral)
+        return OKAY;
 
-#ifdef DEBUG
-    foreach (Level *level, m_levels) {
-        level->PrintRowGap();
+    std::vector<quint32> devices;
+    m_compact->PeripheralDevices(&devices);
+    for (quint32 device : devices) {
+        c = component[device];
+        if (kind[c] == Peripheral AND (*firstLevels)[c].empty())
+            (*firstLevels)[c].push_back(device);
     }
-#endif
 
-#endif
+    return OKAY;
+}
 
-    /* From last level backward propagation */
-    Level *lastLevel = m_levels.back();
-    Level *currLevel = nullptr;
-    Level *backLevel = lastLevel;
-    int currDeviceCount = 0, backDeviceCount = backLevel->AllDeviceCount();
-    int ratio = 1;
-
-    for (int i = m_levels.size() - 1; i >= 0; -- i) {
-        currLevel = m_levels.at(i);
-        currDeviceCount = currLevel->AllDeviceCount();
-        if (currDeviceCount == 0) {
-            currLevel->SetRowGap(DFT_MAX_DEVICE_ROW_GAP);
-            backLevel = currLevel;
-            continue;
-        }
+int ASG::ResolveFirstLevelDevices(const DeviceList &chosenList, DeviceList *devList) const
+{
+    Q_ASSERT(devList AND m_compact);
+    devList->clear();
 
-        ratio = backDeviceCount * 1.0 / currDeviceCount + 0.5;
-        if (ratio < 1)
-            ratio = 1;
-        currLevel->SetRowGap(backLevel->RowGap() * ratio);
-    }
+    std::vector<int> component;
+    int count = m_compact->Components(&component);
 
-#ifdef DEBUGx
-    printf("--------------- Row Gap ---------------\n");
-
-    foreach (Level *l, m_levels)
-        qInfo() << l->Id() << "rowGap(" << l->RowGap() << ")";
+    std::vector<std::vector<int>> firstLevels;
+    int error = FirstLevelDevices(chosenList, component, count, &firstLevels);
+    if (error)
+        return ERROR;
 
-    printf("---------------------------------------\n");
-#endif
+    for (const std::vector<int> &first : firstLevels) {
+        for (int dev : first)
+            devList->push_back(m_compact->GetDevice(dev));
+    }
 
     return OKAY;
 }
 
-int ASG::DetermineFirstLevelLogicalRow()
+/* nets by level of their devices, instead of connectors by level */
+int ASG::IndexNetsByLevel()
 {
-    /* just simply assign logical row number */
-    if (m_levels.size() < 1)
-        return OKAY;
-    
-    Level *firstLevel = m_levels.front();
-    int row = 0;
-    foreach (Device *dev, firstLevel->AllDevices()) {
-        dev->SetLogicalRow(row);
-        row += firstLevel->RowGap();
-    }
+    m_nets->Build();
 
 #ifdef DEBUGx
-    firstLevel->PrintLogicalPos();
+    foreach (Component *component, m_components) {
+        foreach (Level *level, component->Levels())
+            level->PrintAllConnections(m_nets);
+    }
 #endif
 
     return OKAY;
 }
 
-int ASG::ForwardPropagateLogicalRow()
+/* rows of a component come from its own levels, the crossing budget is the pass's */
+int ASG::CalLogicalRow()
 {
-    if (m_levels.size() < 2)
-        return OKAY;
-
-    Level *level = nullptr;
-    for (int i = 1; i < m_levels.size(); ++ i) {
-        level = m_levels.at(i);
-        level->AssignDeviceLogicalRow(); // assign logical row to devices
+    QElapsedTimer clock;
+    clock.start();
+    int error = ForEachComponent([this, &clock](Component *component, Arena *) {
+        return component->CalLogicalRow(m_nets, clock, m_passThreads);
+    });
+
+    m_crossingsBefore = 0;
+    m_crossingsAfter = 0;
+    foreach (Component *component, m_components) {
+        m_crossingsBefore += component->CrossingsBefore();
+        m_crossingsAfter += component->CrossingsAfter();
     }
 
-#ifdef DEBUGx
-    foreach (Level *level, m_levels)
-        level->PrintLogicalPos();
+#ifdef TRACE
+    qInfo() << "crossings between levels" << m_crossingsBefore << "->" << m_crossingsAfter;
 #endif
 
-    return OKAY;
+    return error;
 }
 
+/* every row is final, fellows on a net are found by row */
 int ASG::DecideDeviceOrientation()
 {
-    foreach (Device *dev, m_ckt->GetDeviceList())
-        dev->DecideOrientationByPredecessors();
+    m_nets->FreezeRows();
 
-#ifdef DEBUGx
-    foreach (Level *level, m_levels)
-        level->PrintOrientation();
-#endif
-
-    return OKAY;
+    return ForEachComponent([this](Component *component, Arena *) {
+        return component->DecideDeviceOrientation(m_nets);
+    });
 }
 
 int ASG::DecideDeviceWhetherToReverse()
 {
-    foreach (Device *dev, m_ckt->GetDeviceList())
-        dev->DecideReverseByPredecessors();
-
-    if (m_levels.size() > 0) {
-        foreach (Device *dev, m_levels.front()->AllDevices())
-            dev->DecideReverseBySuccessors();
-    }
-
-#ifdef DEBUGx
-    foreach (Level *level, m_levels)
-        level->PrintReverse();
-#endif
-
-    return OKAY;
+    return ForEachComponent([this](Component *component, Arena *) {
+        return component->DecideDeviceWhetherToReverse(m_nets);
+    });
 }
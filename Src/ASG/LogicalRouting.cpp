@@ -2,6 +2,7 @@
 #include <QDebug>
 #include "Channel.h"
 #include "Level.h"
+#include "Component.h"
 #include "Circuit/Device.h"
 #include "Wire.h"
 #include "Dot.h"
@@ -21,8 +22,10 @@ int ASG::LogicalRouting()
         return ERROR;
 
 #ifdef DEBUGx
-    foreach (Channel *ch, m_channels)
-        ch->Print();
+    foreach (Component *component, m_components) {
+        foreach (Channel *ch, component->Channels())
+            ch->Print();
+    }
 #endif
 
     error = CreateDots();
@@ -32,45 +35,16 @@ int ASG::LogicalRouting()
     return OKAY;
 }
 
-/*
- * Level0     Level1     Level2  ...  Level(n)
- *         |          |          |
- *     Channel0   channel1  Channel(n-1)
- */
+/* channels between the levels of every component, see Component */
 int ASG::CreateChannels()
 {
 #ifdef TRACE
     qInfo() << LINE_INFO << endl;
 #endif
 
-    m_channels.clear();
-
-    int channelIndex = 0;
-    Channel *newChannel = nullptr;
-    Device *dev = nullptr;
-
-    Level *level = nullptr;
-
-    for (int i = 1; i < m_levels.size(); ++ i) {
-        level = m_levels.at(i);
-
-        // new channel
-        newChannel = new Channel(channelIndex);
-
-        foreach (dev, level->AllDevices()) {
-            newChannel->AddWires(dev->WiresFromPredecessors());
-        }
-
-        m_channels.push_back(newChannel);
-        channelIndex++;
-    }
-
-#ifdef DEBUGx
-    foreach (Channel *ch, m_channels)
-        ch->Print();
-#endif
-
-    return OKAY;
+    return ForEachComponent([this](Component *component, Arena *arena) {
+        return component->CreateChannels(m_nets, arena);
+    });
 }
 
 int ASG::AssignTrackNumber()
@@ -79,19 +53,18 @@ int ASG::AssignTrackNumber()
     qInfo() << LINE_INFO << endl;
 #endif
 
-    foreach (Channel *ch, m_channels) {
-        ch->AssignTrackNumber(m_ignoreCap);
-    }
-
-    return OKAY;
+    return ForEachComponent([this](Component *component, Arena *arena) {
+        return component->AssignTrackNumber(m_ignoreCap, arena);
+    });
 }
 
 /* Create Dot in Channel */
 int ASG::CreateDots()
 {
     DotList dots;
-    foreach (Channel *ch, m_channels) {
-        dots.append(ch->Dots());
+    foreach (Component *component, m_components) {
+        foreach (Channel *ch, component->Channels())
+            dots.append(ch->Dots());
     }
 
 #ifdef DEBUGx
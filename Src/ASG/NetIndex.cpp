@@ -0,0 +1,124 @@
+#include "NetIndex.h"
+#include <algorithm>
+#include "Circuit/CompactGraph.h"
+#include "Circuit/Device.h"
+
+NetIndex::NetIndex(const CompactGraph *graph)
+{
+    Q_ASSERT(graph);
+    m_graph = graph;
+}
+
+NetIndex::~NetIndex()
+{
+}
+
+void NetIndex::Build()
+{
+    int deviceCount = m_graph->DeviceCount();
+    int nodeCount = m_graph->NodeCount();
+    int terminalCount = m_graph->TerminalCount();
+
+    m_level.resize(deviceCount);
+    for (int dev = 0; dev < deviceCount; ++ dev)
+        m_level[dev] = m_graph->GetDevice(dev)->LevelId();
+
+    m_entry.resize(terminalCount);
+    m_rows.clear();
+    m_terminalGroup.resize(terminalCount);
+    m_nodeGroup.assign(nodeCount + 1, 0);
+    m_groupBegin.clear();
+    m_groupLevel.clear();
+
+    /* node CSR is in terminal id order, keep it inside a level */
+    auto byLevel = [this](quint32 a, quint32 b) {
+        return m_level[m_graph->TerminalDevice(a)] < m_level[m_graph->TerminalDevice(b)];
+    };
+
+    quint32 i = 0, ter = 0;
+    int level = 0;
+    for (int node = 0; node < nodeCount; ++ node) {
+        m_nodeGroup[node] = m_groupLevel.size();
+        for (i = m_graph->NodeBegin(node); i < m_graph->NodeEnd(node); ++ i)
+            m_entry[i] = m_graph->NodeTerminal(i);
+        std::stable_sort(m_entry.begin() + m_graph->NodeBegin(node),
+                         m_entry.begin() + m_graph->NodeEnd(node), byLevel);
+
+        for (i = m_graph->NodeBegin(node); i < m_graph->NodeEnd(node); ++ i) {
+            ter = m_entry[i];
+            level = m_level[m_graph->TerminalDevice(ter)];
+            if (i == m_graph->NodeBegin(node) || level != m_groupLevel.back()) {
+                m_groupBegin.push_back(i);
+                m_groupLevel.push_back(level);
+            }
+            m_terminalGroup[ter] = m_groupLevel.size() - 1;
+        }
+    }
+    m_nodeGroup[nodeCount] = m_groupLevel.size();
+    m_groupBegin.push_back(terminalCount);
+
+    m_groupRowSum.assign(m_groupLevel.size(), 0);
+}
+
+/* devices of one level, with their final rows */
+void NetIndex::AddRows(const DeviceList &devices)
+{
+    quint32 ter = 0;
+    foreach (Device *dev, devices) {
+        for (ter = m_graph->TerminalBegin(dev->Id()); ter < m_graph->TerminalEnd(dev->Id()); ++ ter)
+            m_groupRowSum[m_terminalGroup[ter]] += dev->LogicalRow();
+    }
+}
+
+void NetIndex::RemoveRows(const DeviceList &devices)
+{
+    quint32 ter = 0;
+    foreach (Device *dev, devices) {
+        for (ter = m_graph->TerminalBegin(dev->Id()); ter < m_graph->TerminalEnd(dev->Id()); ++ ter)
+            m_groupRowSum[m_terminalGroup[ter]] -= dev->LogicalRow();
+    }
+}
+
+void NetIndex::FreezeRows()
+{
+    m_rows.resize(m_entry.size());
+    for (size_t i = 0; i < m_entry.size(); ++ i)
+        m_rows[i] = m_graph->GetDevice(m_graph->TerminalDevice(m_entry[i]))->LogicalRow();
+
+    for (size_t group = 0; group < m_groupLevel.size(); ++ group)
+        std::sort(m_rows.begin() + m_groupBegin[group], m_rows.begin() + m_groupBegin[group + 1]);
+}
+
+/* -1 if no terminal of node is at level */
+int NetIndex::FindGroup(quint32 node, int level) const
+{
+    auto first = m_groupLevel.begin() + m_nodeGroup[node];
+    auto last = m_groupLevel.begin() + m_nodeGroup[node + 1];
+    auto it = std::lower_bound(first, last, level);
+    if (it == last || *it != level)
+        return -1;
+    return it - m_groupLevel.begin();
+}
+
+int NetIndex::Count(quint32 node, int level) const
+{
+    int group = FindGroup(node, level);
+    return (group < 0) ? 0 : GroupSize(group);
+}
+
+qint64 NetIndex::RowSum(quint32 node, int level) const
+{
+    int group = FindGroup(node, level);
+    return (group < 0) ? 0 : m_groupRowSum[group];
+}
+
+bool NetIndex::HasRow(quint32 node, int level, int row) const
+{
+    Q_ASSERT(m_rows.size() == m_entry.size());
+
+    int group = FindGroup(node, level);
+    if (group < 0)
+        return false;
+    return std::binary_search(m_rows.begin() + GroupBegin(group),
+                              m_rows.begin() + GroupEnd(group), row);
+}
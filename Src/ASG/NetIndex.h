@@ -0,0 +1,65 @@
+#ifndef NETLISTVIZ_ASG_NETINDEX_H
+#define NETLISTVIZ_ASG_NETINDEX_H
+
+/*
+ * @filename : NetIndex.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Nets as hyperedges for the level passes. Terminals of every
+ *           : CompactGraph node are grouped by the level of their device,
+ *           : so "terminals of net n at level l" is one range. Per group
+ *           : row sums and sorted rows answer the predecessor and fellow
+ *           : queries of Device without pairing the devices of a net.
+ *           : Build() after CalLogicalCol, AddRows() once per level when
+ *           : its rows are final, FreezeRows() when all rows are final.
+ */
+
+#include <vector>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class CompactGraph;
+
+class NetIndex
+{
+public:
+    explicit NetIndex(const CompactGraph *graph);
+    ~NetIndex();
+
+    const CompactGraph* Graph() const { return m_graph; }
+
+    void    Build();
+    void    AddRows(const DeviceList &devices);
+    /* rows of AddRows() taken back, before they change */
+    void    RemoveRows(const DeviceList &devices);
+    void    FreezeRows();
+
+    /* terminals of node at level, entries of [GroupBegin, GroupEnd) */
+    int     FindGroup(quint32 node, int level) const;
+    quint32 GroupBegin(int group) const      { return m_groupBegin[group]; }
+    quint32 GroupEnd(int group) const        { return m_groupBegin[group + 1]; }
+    int     GroupSize(int group) const       { return m_groupBegin[group + 1] - m_groupBegin[group]; }
+    quint32 Entry(quint32 i) const           { return m_entry[i]; }
+    int     Count(quint32 node, int level) const;
+    qint64  RowSum(quint32 node, int level) const;
+    /* all terminals of node are at one level */
+    bool    SingleLevel(quint32 node) const  { return m_nodeGroup[node + 1] - m_nodeGroup[node] == 1; }
+    /* a device at level has a terminal on node and is at row, after FreezeRows() */
+    bool    HasRow(quint32 node, int level, int row) const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(NetIndex);
+
+    const CompactGraph   *m_graph;
+    std::vector<int>      m_level;          // per device
+    std::vector<quint32>  m_entry;          // terminals, by node, level, terminal id
+    std::vector<int>      m_rows;           // rows of m_entry devices, sorted in group
+    std::vector<quint32>  m_nodeGroup;      // NodeCount() + 1
+    std::vector<quint32>  m_groupBegin;     // group count + 1
+    std::vector<int>      m_groupLevel;
+    std::vector<qint64>   m_groupRowSum;
+    std::vector<int>      m_terminalGroup;  // per terminal
+};
+
+#endif // NETLISTVIZ_ASG_NETINDEX_H
@@ -16,14 +16,6 @@ Wire::Wire(Device *fromDevice, Terminal *fromTerminal,
     m_swire = nullptr;
 }
 
-Wire::~Wire()
-{
-#ifdef TRACEx
-    qInfo() << LINE_INFO << endl;
-#endif
-
-}
-
 SchematicDevice* Wire::FromSDevice() const
 {
     SchematicDevice *dev = m_fromDevice->GetSchematicDevice();
@@ -24,7 +24,6 @@ class Wire
 {
 public:
     Wire(Device *fromDevice, Terminal *fromTerminal, Device *toDevice, Terminal *toTerminal);
-    ~Wire();
 
     void      SetTrack(int track)  { m_trackGiven = true; m_track = track; }
     int       Track() const        { return m_track; }
@@ -1,219 +1,497 @@
 #include "CircuitGraph.h"
-#include <regex>
 #include <QDebug>
 #include "Circuit/Device.h"
 #include "Node.h"
 #include "Terminal.h"
+#include "Subckt.h"
+#include "Compressor.h"
+#include "RCReducer.h"
+#include "CompactGraph.h"
+#include "DeviceTraits.h"
 
 CircuitGraph::CircuitGraph()
+    : m_namePool(new NamePool)
 {
     m_nodeNumber = 1;
     m_deviceNumber = 0;
     m_terminalNumber = 0;
+    m_topCalls = nullptr;
+    m_compact = nullptr;
+    m_compressed = false;
+    m_reduced = false;
 }
 
 CircuitGraph::~CircuitGraph()
 {
-    /* delete all devices, terminals here */
-    foreach (Device *device, m_deviceList)
-        delete device;
     Clear();
 }
 
-/* Just clear containers here, devices and terminals are destroyed in SchematicXXX */
+/* Back to an empty graph, devices, nodes and terminals are freed with m_arena.
+ * Names stay in m_namePool, SchematicDevices may still hold them. */
 void CircuitGraph::Clear()
 {
+    Unfreeze();
     m_deviceTable.clear();
     m_deviceList.clear();
     m_firstLevelDeviceList.clear();
+    m_firstLevelMarks.clear();
+    m_firstLevelMarkSet.clear();
 
-    // node will be hold by SchematicTerminal
-    // DestroyAllNodes();
     m_nodeTable.clear();
     m_nodeList.clear();
-}
 
-/* Destroy all nodes here */
-void CircuitGraph::DestroyAllNodes()
-{
-    Node *node = nullptr;
-    foreach (node, m_nodeTable.values())
-        delete node;
+    foreach (Subckt *subckt, m_subcktTable)
+        delete subckt;
+    m_subcktTable.clear();
+    delete m_topCalls;
+    m_topCalls = nullptr;
+
+    m_arena.Reset();
+    m_nodeNumber = 1;
+    m_deviceNumber = 0;
+    m_terminalNumber = 0;
+    m_compressed = false;
+    m_reduced = false;
 }
 
-int CircuitGraph::InsertR(QString name, QString posName, QString negName, double value)
+int CircuitGraph::InsertDevice(DeviceType type, std::string_view name,
+        const std::string_view *nodeNames, double value)
 {
-#ifdef TRACEx
-    qInfo() << LINE_INFO << endl;
-#endif
+    NameId nameId = InternName(name);
 
-    if (m_deviceTable.contains(name)) {
-        qInfo() << "ERROR: Redefine " << name << endl;
+    /* check before creating nodes, a rejected device adds no node */
+    if (Redefined(type, nameId)) {
+        qInfo() << "ERROR: Redefine " << m_namePool->Name(nameId) << endl;
         return ERROR;
     }
 
-    Device *r = new Device(RESISTOR, name);
-    r->SetValue(value);
-    Terminal *posTer = InsertNode(posName, r);
-    Terminal *negTer = InsertNode(negName, r);
-    r->AddTerminal(posTer, Positive);
-    r->AddTerminal(negTer, Negative);
-    r->SetId(m_deviceNumber);
+    Node *nodes[MAX_DEVICE_TERMINALS];
+    for (int pin = 0; pin < Traits(type).terminalCount; ++ pin)
+        nodes[pin] = InsertNode(nodeNames[pin]);
+
+    return InsertDevice(type, nameId, nodes, value);
+}
+
+/* the terminal count and the tags are constants of T, nothing is looked up per device */
+template <DeviceType T>
+int CircuitGraph::InsertDevice(NameId name, Node *const *nodes, double value)
+{
+    Unfreeze();
+
+    Device *device = m_arena.New<Device>(T, m_namePool.data(), name);
+    device->SetValue(value);
+    bool toGnd = false;
+    for (int pin = 0; pin < DeviceKind<T>::TerminalCount; ++ pin) {
+        Q_ASSERT(nodes[pin]);
+        Terminal *terminal = CreateTerminal(nodes[pin], device);
+        device->AddTerminal(terminal, pin);
+        toGnd = toGnd || nodes[pin]->IsGnd();
+    }
+    device->SetId(m_deviceNumber);
     m_deviceNumber++;
-    m_deviceTable.insert(name, r);
-    m_deviceList.push_back(r);
+
+    /* tag cap category */
+    if (DeviceKind<T>::GroundCap)
+        device->SetAsGroundCap(toGnd);
+
+    /* tag isrc and vsrc */
+    if (DeviceKind<T>::Source && toGnd)
+        device->SetMaybeAtFirstLevel(true);
+
+    m_deviceTable.insert(name, device);
+    m_deviceList.push_back(device);
 
     return OKAY;
 }
 
-int CircuitGraph::InsertC(QString name, QString posName, QString negName, double value)
+/* nodes are resolved by caller, who should check Redefined() firstly */
+int CircuitGraph::InsertDevice(DeviceType type, NameId name, Node *const *nodes, double value)
 {
-#ifdef TRACEx
-    qInfo() << LINE_INFO << endl;
-#endif
-    if (m_deviceTable.contains(name)) {
-        qInfo() << "ERROR: Redefine " << name << endl;
-        return ERROR;
+    switch (type) {
+        case RESISTOR:  return InsertDevice<RESISTOR>(name, nodes, value);
+        case CAPACITOR: return InsertDevice<CAPACITOR>(name, nodes, value);
+        case INDUCTOR:  return InsertDevice<INDUCTOR>(name, nodes, value);
+        case ISRC:      return InsertDevice<ISRC>(name, nodes, value);
+        case VSRC:      return InsertDevice<VSRC>(name, nodes, value);
+        case MOSFET:    return InsertDevice<MOSFET>(name, nodes, value);
+        case BJT:       return InsertDevice<BJT>(name, nodes, value);
+        default:
+            qInfo() << "ERROR: " << m_namePool->Name(name) << " is not a netlist device" << endl;
+            return ERROR;
     }
+}
 
-    Device *c = new Device(CAPACITOR, name);
-    c->SetValue(value);
-    Terminal *posTer = InsertNode(posName, c);
-    Terminal *negTer = InsertNode(negName, c);
-    c->AddTerminal(posTer, Positive);
-    c->AddTerminal(negTer, Negative);
-    c->SetId(m_deviceNumber);
-    m_deviceNumber++;
+/* R and C can not be redefined, L, I and V are not checked */
+bool CircuitGraph::Redefined(DeviceType type, NameId name) const
+{
+    if (type != RESISTOR && type != CAPACITOR)
+        return false;
 
-    /* tag cap category */
-    if (posTer->NodeIsGnd() || negTer->NodeIsGnd()) {
-        c->SetAsGroundCap(true);
+    return m_deviceTable.contains(name);
+}
+
+Node* CircuitGraph::InsertNode(std::string_view name)
+{
+    return InsertNode(InternName(name), IsGnd(name));
+}
+
+/* name is interned already, i.e. restored by NetlistCache */
+Node* CircuitGraph::InsertNode(NameId nameId, bool gnd)
+{
+    Node *node = nullptr;
+    NodeTable::const_iterator finder;
+    finder = m_nodeTable.find(nameId);
+    if (finder != m_nodeTable.constEnd())
+        return finder.value(); // found
+
+    node = m_arena.New<Node>(m_namePool.data(), nameId);
+    if (gnd) {
+        node->SetId(0);
+        node->SetGnd(true);
     } else {
-        c->SetAsGroundCap(false);
+        node->SetId(m_nodeNumber);
+        m_nodeNumber++;
+        node->SetGnd(false);
     }
+    m_nodeTable.insert(nameId, node);
+    m_nodeList.push_back(node);
 
-    m_deviceTable.insert(name, c);
-    m_deviceList.push_back(c);
+    return node;
+}
 
+/* nullptr if name is defined already */
+Subckt* CircuitGraph::DefineSubckt(std::string_view name)
+{
+    QString key = Subckt::Key(name);
+    if (m_subcktTable.contains(key))
+        return nullptr;
+
+    Subckt *subckt = new Subckt(name);
+    m_subcktTable.insert(key, subckt);
+    return subckt;
+}
+
+Subckt* CircuitGraph::FindSubckt(std::string_view name) const
+{
+    return m_subcktTable.value(Subckt::Key(name), nullptr);
+}
+
+/* X line at top level, kept until Flatten(), the subckt may be defined later */
+int CircuitGraph::InsertX(std::string_view name, std::string_view subckt,
+        const std::string_view *nodes, int nodeCount)
+{
+    if (NOT m_topCalls)
+        m_topCalls = new Subckt("");
+
+    m_topCalls->AddCall(name, subckt, nodes, nodeCount);
     return OKAY;
 }
 
-int CircuitGraph::InsertL(QString name, QString posName, QString negName, double value)
+int CircuitGraph::PendingInstanceCount() const
 {
-#ifdef TRACEx
-    qInfo() << LINE_INFO << endl;
-#endif
+    return m_topCalls ? m_topCalls->Calls().size() : 0;
+}
+
+/*
+ * Expand pending X instances into devices and nodes, named by instance
+ * path, i.e. X1/X2/R1 and X1/n3. Called by ASG, before it reads devices.
+ */
+int CircuitGraph::Flatten()
+{
+    if (PendingInstanceCount() == 0)
+        return OKAY;
+
+    int error = ExpandSubckt(m_topCalls, "", NodeList(), 0);
+    m_topCalls->ClearCalls();
+
+    return error;
+}
+
+/* ports are the caller's nodes, the others are created as prefix + local name */
+int CircuitGraph::ExpandSubckt(const Subckt *subckt, const std::string &prefix,
+        const NodeList &ports, int depth)
+{
+    if (depth > MAX_SUBCKT_DEPTH) {
+        qInfo() << "ERROR: Recursive subckt " << QString::fromStdString(subckt->Name()) << endl;
+        return ERROR;
+    }
+
+    NodeList nodes(subckt->NodeCount(), nullptr);
+    for (int i = 0; i < ports.size(); ++ i)
+        nodes[i] = ports.at(i);
+
+    auto localNode = [&](int index) {
+        Node *&node = nodes[index];
+        if (NOT node) {
+            const std::string &name = subckt->NodeName(index);
+            node = IsGnd(name) ? InsertNode(name) : InsertNode(prefix + name);
+        }
+        return node;
+    };
+
+    for (const SubcktElement &element : subckt->Elements()) {
+        NameId name = InternName(prefix + element.name);
+        if (Redefined(element.type, name)) {
+            qInfo() << "ERROR: Redefine " << m_namePool->Name(name) << endl;
+            continue;
+        }
+        Node *elementNodes[MAX_DEVICE_TERMINALS];
+        for (int pin = 0; pin < Traits(element.type).terminalCount; ++ pin)
+            elementNodes[pin] = localNode(element.nodes[pin]);
+        InsertDevice(element.type, name, elementNodes, element.value);
+    }
+
+    for (const SubcktCall &call : subckt->Calls()) {
+        Subckt *child = FindSubckt(call.subckt);
+        if (NOT child) {
+            qInfo() << "ERROR: Undefined subckt " << QString::fromStdString(call.subckt) << endl;
+            return ERROR;
+        }
+        if ((int)call.nodes.size() != child->PortCount()) {
+            qInfo() << "ERROR: " << QString::fromStdString(prefix + call.name)
+                     << " has " << call.nodes.size() << " nodes, "
+                     << QString::fromStdString(child->Name()) << " has "
+                     << child->PortCount() << " ports" << endl;
+            return ERROR;
+        }
+
+        NodeList actual;
+        actual.reserve(call.nodes.size());
+        for (int index : call.nodes)
+            actual.push_back(localNode(index));
+
+        if (ExpandSubckt(child, prefix + call.name + "/", actual, depth + 1))
+            return ERROR;
+    }
 
-    Device *l = new Device(INDUCTOR, name);
-    l->SetValue(value);
-    Terminal *posTer = InsertNode(posName, l);
-    Terminal *negTer = InsertNode(negName, l);
-    l->AddTerminal(posTer, Positive);
-    l->AddTerminal(negTer, Negative);
-    l->SetId(m_deviceNumber);
-    m_deviceNumber++;
-    m_deviceTable.insert(name, l);
-    m_deviceList.push_back(l);
-    
     return OKAY;
 }
 
-int CircuitGraph::InsertI(QString name, QString posName, QString negName, double value)
+void CircuitGraph::Reserve(int deviceCount, int nodeCount)
 {
-#ifdef TRACEx
-    qInfo() << LINE_INFO << endl;
-#endif
+    m_deviceTable.reserve(deviceCount);
+    m_deviceList.reserve(deviceCount);
+    m_nodeTable.reserve(nodeCount);
+    m_nodeList.reserve(nodeCount);
+}
 
-    Device *i = new Device(ISRC, name);
-    i->SetValue(value);
-    Terminal *posTer = InsertNode(posName, i);
-    Terminal *negTer = InsertNode(negName, i);
-    i->AddTerminal(posTer, Positive);
-    i->AddTerminal(negTer, Negative);
-    i->SetId(m_deviceNumber);
-    m_deviceNumber++;
+const CompactGraph* CircuitGraph::Freeze()
+{
+    if (NOT m_compact)
+        m_compact = new CompactGraph(this);
+    return m_compact;
+}
+
+/*
+ * Netlist order is random for extracted netlists, the ASG passes then
+ * jump around memory. New device ids follow order, terminal and node
+ * ids follow the devices. Device pointers are kept.
+ */
+int CircuitGraph::Renumber(DeviceOrder order)
+{
+    if (order == NetlistOrder)
+        return OKAY;
 
-    /* tag isrc */
-    if (posTer->NodeIsGnd() || negTer->NodeIsGnd())
-        i->SetMaybeAtFirstLevel(true);
+    const CompactGraph *compact = Freeze();
+    std::vector<quint32> perm;  // new id -> old id
+    if (order == RCMOrder) {
+        compact->CuthillMcKeeOrder(&perm, true);
+    } else {
+        std::vector<quint32> sources;
+        foreach (Device *device, m_firstLevelDeviceList)
+            sources.push_back(device->Id());
+        compact->BFSOrder(sources, &perm);
+    }
+    Q_ASSERT((int)perm.size() == m_deviceList.size());
+
+    /* terminals and nodes by first use, read from the frozen arrays */
+    std::vector<int> nodeIds(compact->NodeCount(), 0);  // old -> new, 0 until used
+    DeviceList devList(perm.size());
+    quint32 oldId = 0, oldNode = 0;
+    int terminalId = 0, nodeId = 1;
+    for (int id = 0; id < devList.size(); ++ id) {
+        oldId = perm[id];
+        devList[id] = compact->GetDevice(oldId);
+        devList[id]->SetId(id);
+        for (quint32 ter = compact->TerminalBegin(oldId); ter < compact->TerminalEnd(oldId); ++ ter) {
+            compact->GetTerminal(ter)->SetId(terminalId++);
+            oldNode = compact->TerminalNode(ter);
+            if (oldNode != CompactGraph::GND_NODE && nodeIds[oldNode] == 0)
+                nodeIds[oldNode] = nodeId++;
+        }
+    }
+    m_deviceList = devList;
 
-    m_deviceTable.insert(name, i);
-    m_deviceList.push_back(i);
+    foreach (Node *node, m_nodeList) {
+        if (node->IsGnd()) continue;
+        if (nodeIds[node->Id()] == 0)
+            nodeIds[node->Id()] = nodeId++;
+        node->SetId(nodeIds[node->Id()]);
+    }
 
+    Unfreeze();
     return OKAY;
 }
 
-int CircuitGraph::InsertV(QString name, QString posName, QString negName, double value)
+/*
+ * Folded devices and the nodes inside chains leave the lists, they stay
+ * in m_arena as members of the composites. Ids are dense again, first
+ * levels are the composites holding them. A second call keeps the graph,
+ * composites would be folded again into composites of composites.
+ */
+int CircuitGraph::Compress(const QSet<QString> &expanded)
 {
-#ifdef TRACEx
-    qInfo() << LINE_INFO << endl;
+    if (m_compressed)
+        return OKAY;
+    Unfreeze();
+
+#ifdef TRACE
+    int deviceCount = m_deviceList.size(), nodeCount = m_nodeList.size();
 #endif
+    Compressor compressor(this, expanded);
+    int error = compressor.Run();
+    if (error)
+        return ERROR;
+    ReplaceDeviceList(compressor.Devices());
+    m_compressed = true;
+
+    DeviceList firstLevels;
+    QSet<Device*> seen;
+    foreach (Device *device, m_firstLevelDeviceList) {
+        while (device->Composite())
+            device = device->Composite();
+        if (NOT seen.contains(device)) {
+            seen.insert(device);
+            firstLevels.push_back(device);
+        }
+    }
+    m_firstLevelDeviceList = firstLevels;
 
-    Device *v = new Device(VSRC, name);
-    v->SetValue(value);
-    Terminal *posTer = InsertNode(posName, v);
-    Terminal *negTer = InsertNode(negName, v);
-    v->AddTerminal(posTer, Positive);
-    v->AddTerminal(negTer, Negative);
-    v->SetId(m_deviceNumber);
-    m_deviceNumber++;
+#ifdef TRACE
+    qInfo() << "compress " << compressor.FoldCount() << " folds, devices " << deviceCount
+            << " -> " << m_deviceList.size() << ", nodes " << nodeCount
+            << " -> " << m_nodeList.size() << endl;
+#endif
 
-    /* tag vsrc */
-    if (posTer->NodeIsGnd() || negTer->NodeIsGnd())
-        v->SetMaybeAtFirstLevel(true);
+    return OKAY;
+}
 
-    m_deviceTable.insert(name, v);
-    m_deviceList.push_back(v);
+/* once, on the devices of the netlist: a second call or one after Compress() keeps the graph */
+int CircuitGraph::ReduceRC(double maxFrequency, double maxError)
+{
+    if (m_reduced || m_compressed)
+        return OKAY;
+    Unfreeze();
+
+#ifdef TRACE
+    int deviceCount = m_deviceList.size(), nodeCount = m_nodeList.size();
+#endif
+    RCReducer reducer(this, maxFrequency, maxError);
+    int error = reducer.Run();
+    if (error)
+        return ERROR;
+    ReplaceDeviceList(reducer.Devices());
+    m_reduced = true;
+
+#ifdef TRACE
+    qInfo() << "reduce rc " << reducer.EliminatedCount() << " nodes eliminated, devices " << deviceCount
+            << " -> " << m_deviceList.size() << ", nodes " << nodeCount
+            << " -> " << m_nodeList.size() << endl;
+#endif
 
     return OKAY;
 }
 
-Terminal* CircuitGraph::InsertNode(const QString &name, Device *device)
+/*
+ * Ids are dense again, nodes left without devices are dropped. The name
+ * of a folded device maps to its composite (so .FIRSTLEVEL marks still
+ * resolve), the name of an eliminated one is dropped.
+ */
+void CircuitGraph::ReplaceDeviceList(const DeviceList &devList)
 {
-    Node *node = nullptr;
-    NodeTable::const_iterator finder;
-    finder = m_nodeTable.find(name);
-    if (finder != m_nodeTable.constEnd()) {
-        node = finder.value(); // found
-    } else {
-        node = new Node(name);
-        if (IsGnd(name)) {
-            node->SetId(0);
-            node->SetGnd(true);
+    m_deviceList = devList;
+
+    foreach (Node *node, m_nodeList)
+        node->ClearDevices();
+    m_terminalNumber = 0;
+    for (int id = 0; id < m_deviceList.size(); ++ id) {
+        Device *device = m_deviceList.at(id);
+        device->SetId(id);
+        for (int pin = 0; pin < device->TerminalCount(); ++ pin) {
+            device->TerminalAt(pin)->SetId(m_terminalNumber++);
+            device->TerminalAt(pin)->GetNode()->AddDevice(device);
+        }
+    }
+    m_deviceNumber = m_deviceList.size();
+
+    DeviceTable::iterator it = m_deviceTable.begin();
+    while (it != m_deviceTable.end()) {
+        Device *device = it.value();
+        while (device->Composite())
+            device = device->Composite();
+        if (NOT Alive(device)) {
+            it = m_deviceTable.erase(it);
+            continue;
+        }
+        it.value() = device;
+        ++ it;
+    }
+
+    NodeList nodeList;
+    m_nodeNumber = 1;
+    foreach (Node *node, m_nodeList) {
+        if (node->IsGnd()) {
+            nodeList.push_back(node);
+        } else if (NOT node->ConnectDeviceList().isEmpty()) {
+            node->SetId(m_nodeNumber++);
+            nodeList.push_back(node);
         } else {
-            node->SetId(m_nodeNumber);
-            m_nodeNumber++;
-            node->SetGnd(false);
+            m_nodeTable.remove(node->GetNameId());
         }
-        m_nodeTable.insert(name, node);
-        m_nodeList.push_back(node);
     }
+    m_nodeList = nodeList;
+}
 
-    node->AddDevice(device);
+/* in m_deviceList, ids are dense after ReplaceDeviceList() */
+bool CircuitGraph::Alive(const Device *device) const
+{
+    int id = device->Id();
+    return (id >= 0 AND id < m_deviceList.size() AND m_deviceList.at(id) == device);
+}
 
-    Terminal *terminal = CreateTerminal(node);
-    terminal->SetDevice(device);
-    return terminal;
+void CircuitGraph::Unfreeze()
+{
+    if (m_compact) {
+        delete m_compact;
+        m_compact = nullptr;
+    }
 }
 
-Terminal* CircuitGraph::CreateTerminal(Node *node)
+Terminal* CircuitGraph::CreateTerminal(Node *node, Device *device)
 {
-    Terminal *terminal = new Terminal(node);
+    node->AddDevice(device);
+
+    Terminal *terminal = m_arena.New<Terminal>(node);
     terminal->SetId(m_terminalNumber);
     m_terminalNumber++;
+    terminal->SetDevice(device);
     return terminal;
 }
 
-bool CircuitGraph::IsGnd(const QString &name) const
+/* the same as regex "^(0|gnd)$" (icase), which is too slow for every new node */
+bool CircuitGraph::IsGnd(std::string_view name) const
 {
-    std::regex gndRex("^(0|gnd)$", std::regex::icase);
-    bool ret = std::regex_match(name.toStdString(), gndRex);
-    return ret;
+    if (name == "0")
+        return true;
+    if (name.size() != 3)
+        return false;
+
+    return ((name[0] | 0x20) == 'g' AND (name[1] | 0x20) == 'n' AND (name[2] | 0x20) == 'd');
 }
 
 Device* CircuitGraph::GetDevice(const QString &name) const
 {
-    return m_deviceTable[name];
+    return m_deviceTable.value(m_namePool->Find(name), nullptr);
 }
 
 void CircuitGraph::SetFirstLevelDeviceList(const DeviceList &devList)
@@ -222,12 +500,44 @@ void CircuitGraph::SetFirstLevelDeviceList(const DeviceList &devList)
     m_firstLevelDeviceList = devList;
 }
 
+void CircuitGraph::MarkFirstLevel(NameId name)
+{
+    if (NOT m_firstLevelMarkSet.contains(name)) {
+        m_firstLevelMarkSet.insert(name);
+        m_firstLevelMarks.push_back(name);
+    }
+}
+
+/* after Flatten(), so marks may name devices in subcircuits (X1/VIN) */
+int CircuitGraph::ApplyFirstLevelMarks()
+{
+    DeviceList devList;
+    QSet<Device*> seen;
+    foreach (NameId name, m_firstLevelMarks) {
+        Device *device = m_deviceTable.value(name, nullptr);
+        if (NOT device) {
+            qInfo() << "ERROR: .FIRSTLEVEL " << m_namePool->Name(name) << " is not a device" << endl;
+            return ERROR;
+        }
+        /* folded by Compress(), the composite is at first level */
+        while (device->Composite())
+            device = device->Composite();
+        if (NOT seen.contains(device)) {
+            seen.insert(device);
+            devList.push_back(device);
+        }
+    }
+
+    SetFirstLevelDeviceList(devList);
+    return OKAY;
+}
+
 void CircuitGraph::PrintCircuit() const
 {
     Node *node = nullptr;
     Device *dev = nullptr;
     qInfo() << "\n--------------- Node ---------------";
-    foreach (node, m_nodeTable.values()) {
+    foreach (node, m_nodeList) {
         node->Print();
     }
     qInfo() << "------------------------------------\n";
@@ -11,9 +11,16 @@
 
 #include "Define/Define.h"
 #include "Define/TypeDefine.h"
+#include <string>
+#include <string_view>
 #include <QVector>
+#include <QSet>
+#include <QString>
+#include "Utilities/NamePool.h"
+#include "Utilities/Arena.h"
 
 class Terminal;
+class CompactGraph;
 
 class CircuitGraph
 {
@@ -21,12 +28,42 @@ public:
     CircuitGraph();
     ~CircuitGraph();
 
-    /* For Inserting Devices */
-    int InsertR(QString, QString, QString, double);
-    int InsertC(QString, QString, QString, double);
-    int InsertL(QString, QString, QString, double);
-    int InsertI(QString, QString, QString, double);
-    int InsertV(QString, QString, QString, double);
+    /* For Inserting Devices, nodes are in DeviceTraits pin order */
+    int InsertDevice(DeviceType type, std::string_view name,
+                     const std::string_view *nodeNames, double value);
+
+    /* For Inserting with resolved nodes (MmapScanner parallel merge) */
+    NameId InternName(std::string_view name) { return m_namePool->Intern(name); }
+    Node*  InsertNode(std::string_view name);
+    Node*  InsertNode(NameId name, bool gnd);
+    bool   Redefined(DeviceType type, NameId name) const;
+    int    InsertDevice(DeviceType type, NameId name, Node *const *nodes, double value);
+
+    /* For .subckt, definitions are templates and X lines are expanded by Flatten() */
+    Subckt* DefineSubckt(std::string_view name);
+    Subckt* FindSubckt(std::string_view name) const;
+    int     InsertX(std::string_view name, std::string_view subckt,
+                    const std::string_view *nodes, int nodeCount);
+    int     Flatten();
+    bool    Hierarchical() const { return NOT m_subcktTable.isEmpty(); }
+    int     PendingInstanceCount() const;
+
+    /* For ASG, built once the circuit is complete (after Flatten()) */
+    const CompactGraph* Freeze();
+    /* device, terminal and node ids in order, before Freeze() for ASG */
+    int    Renumber(DeviceOrder order);
+    /* series/parallel composites, see Compressor, after Flatten(), once per parse */
+    int    Compress(const QSet<QString> &expanded = QSet<QString>());
+    /* TICER elimination of quick RC nodes, see RCReducer, after Flatten(), before Compress() */
+    int    ReduceRC(double maxFrequency, double maxError);
+    bool   Compressed() const { return m_compressed; }
+    bool   Reduced() const    { return m_reduced; }
+
+    /* size known in advance, i.e. NetlistCache */
+    void   Reserve(int deviceCount, int nodeCount);
+
+    /* Device, Node and SchematicDevice names live here */
+    NamePool*   GetNamePool() const { return m_namePool.data(); }
 
     int         DeviceCount() const { return m_deviceList.size(); }
     DeviceList  GetDeviceList() const { return m_deviceList; }
@@ -34,31 +71,54 @@ public:
     void        SetFirstLevelDeviceList(const DeviceList &devList);
     DeviceList  FirstLevelDeviceList() const { return m_firstLevelDeviceList; }
     int         FirstLevelDeviceListSize() const { return m_firstLevelDeviceList.size(); }
+
+    /* For .FIRSTLEVEL, names are kept until ApplyFirstLevelMarks() finds the devices */
+    void        MarkFirstLevel(std::string_view name) { MarkFirstLevel(InternName(name)); }
+    void        MarkFirstLevel(NameId name);
+    bool        HasFirstLevelMarks() const { return NOT m_firstLevelMarks.isEmpty(); }
+    QVector<NameId> FirstLevelMarks() const { return m_firstLevelMarks; }
+    int         ApplyFirstLevelMarks();
     NodeList    GetNodeList() const { return m_nodeList; }
 
     void Clear();
-    void DestroyAllNodes();
     void PrintCircuit() const;
 
 private:
     DISALLOW_COPY_AND_ASSIGN(CircuitGraph);
 
-    Terminal* InsertNode(const QString &name, Device *device);
-    Terminal* CreateTerminal(Node *node);
-    bool      IsGnd(const QString &name) const;
+    template <DeviceType T>
+    int       InsertDevice(NameId name, Node *const *nodes, double value);
+    Terminal* CreateTerminal(Node *node, Device *device);
+    void      Unfreeze();
+    void      ReplaceDeviceList(const DeviceList &devList);
+    bool      Alive(const Device *device) const;
+    bool      IsGnd(std::string_view name) const;
+    int       ExpandSubckt(const Subckt *subckt, const std::string &prefix,
+                           const NodeList &ports, int depth);
 
 
-    /* For Inserting */
+    /* For Inserting, devices, nodes and terminals live in m_arena */
+    NamePoolPtr   m_namePool;
+    Arena         m_arena;
     DeviceTable   m_deviceTable;
     NodeTable     m_nodeTable;
     int           m_nodeNumber;
     int           m_deviceNumber;
     int           m_terminalNumber;
 
+    /* For .subckt, m_topCalls keeps the X lines out of any definition */
+    SubcktTable   m_subcktTable;
+    Subckt       *m_topCalls;
+
     /* For ASG */
     DeviceList    m_deviceList;
     DeviceList    m_firstLevelDeviceList;
+    QVector<NameId> m_firstLevelMarks;
+    QSet<NameId>  m_firstLevelMarkSet;  // m_firstLevelMarks, for lookup
     NodeList      m_nodeList;
+    CompactGraph *m_compact;      // frozen m_deviceList and m_nodeList
+    bool          m_compressed;   // Compress() ran, until Clear()
+    bool          m_reduced;      // ReduceRC() ran, until Clear()
 };
 
 #endif // NETLISTVIZ_CIRCUIT_CIRCUITGRAPH_H
@@ -0,0 +1,357 @@
+#include "CompactGraph.h"
+#include <algorithm>
+#include "CircuitGraph.h"
+#include "Device.h"
+#include "Node.h"
+#include "Terminal.h"
+
+template <typename T>
+static inline qint64 VectorBytes(const std::vector<T> &vec)
+{
+    return vec.capacity() * sizeof(T);
+}
+
+
+CompactGraph::CompactGraph(const CircuitGraph *ckt)
+{
+    Q_ASSERT(ckt);
+
+    DeviceList devList = ckt->GetDeviceList();
+    int deviceCount = devList.size();
+
+    int nodeCount = GND_NODE + 1;
+    foreach (Node *node, ckt->GetNodeList())
+        nodeCount = qMax(nodeCount, node->Id() + 1);
+
+    m_deviceType.reserve(deviceCount);
+    m_deviceValue.reserve(deviceCount);
+    m_deviceOffset.reserve(deviceCount + 1);
+    m_devices.reserve(deviceCount);
+    m_terminalNode.reserve(2 * deviceCount);
+    m_terminalDevice.reserve(2 * deviceCount);
+    m_terminals.reserve(2 * deviceCount);
+
+    m_deviceOffset.push_back(0);
+    for (int i = 0; i < deviceCount; ++ i) {
+        Device *device = devList.at(i);
+        Q_ASSERT(device->Id() == i);
+        m_deviceType.push_back(device->GetDeviceType());
+        m_deviceValue.push_back(device->Value());
+        m_devices.push_back(device);
+        for (int pin = 0; pin < device->TerminalCount(); ++ pin) {
+            Terminal *terminal = device->TerminalAt(pin);
+            m_terminalNode.push_back(terminal->NodeIsGnd() ? GND_NODE : terminal->NodeId());
+            m_terminalDevice.push_back(i);
+            m_terminals.push_back(terminal);
+        }
+        m_deviceOffset.push_back(m_terminalNode.size());
+    }
+
+    /* counting sort by node, stable, so a node lists its terminals by device id */
+    m_nodeOffset.assign(nodeCount + 1, 0);
+    for (quint32 node : m_terminalNode)
+        m_nodeOffset[node + 1]++;
+    for (int i = 0; i < nodeCount; ++ i)
+        m_nodeOffset[i + 1] += m_nodeOffset[i];
+
+    std::vector<quint32> next(m_nodeOffset.begin(), m_nodeOffset.end() - 1);
+    m_nodeTerminal.resize(m_terminalNode.size());
+    for (size_t ter = 0; ter < m_terminalNode.size(); ++ ter)
+        m_nodeTerminal[next[m_terminalNode[ter]]++] = ter;
+}
+
+CompactGraph::~CompactGraph()
+{
+}
+
+/* computed for one device, the pairs of a net are never stored */
+void CompactGraph::Neighbors(quint32 dev, std::vector<quint32> *neighbors) const
+{
+    neighbors->clear();
+    for (quint32 ter = TerminalBegin(dev); ter < TerminalEnd(dev); ++ ter) {
+        quint32 node = m_terminalNode[ter];
+        if (node == GND_NODE)
+            continue;
+        for (quint32 i = NodeBegin(node); i < NodeEnd(node); ++ i) {
+            quint32 other = m_terminalDevice[m_nodeTerminal[i]];
+            if (other != dev)
+                neighbors->push_back(other);
+        }
+    }
+
+    std::sort(neighbors->begin(), neighbors->end());
+    neighbors->erase(std::unique(neighbors->begin(), neighbors->end()), neighbors->end());
+}
+
+/*
+ * BFS from sources, appending to order. A non-ground node is expanded
+ * once, so a big net costs its terminals and not its pairs. Devices
+ * reached from one device go by (degree, id) if degree is given, else
+ * by id. Returns where the last level starts in order, depth gets the
+ * count of levels.
+ */
+size_t CompactGraph::Sweep(const std::vector<quint32> &sources, const std::vector<quint32> *degree,
+        std::vector<quint8> *visited, std::vector<quint8> *expanded,
+        std::vector<quint32> *order, int *depth) const
+{
+    size_t head = order->size();
+    for (quint32 dev : sources) {
+        if ((*visited)[dev]) continue;
+        (*visited)[dev] = 1;
+        order->push_back(dev);
+    }
+
+    auto byDegree = [degree](quint32 a, quint32 b) {
+        return (*degree)[a] < (*degree)[b] || ((*degree)[a] == (*degree)[b] && a < b);
+    };
+
+    std::vector<quint32> reached;
+    size_t levelEnd = order->size(), lastLevel = head;
+    int levels = 1;
+    quint32 dev = 0, node = 0, other = 0;
+    while (head < order->size()) {
+        if (head == levelEnd) {
+            lastLevel = head;
+            levelEnd = order->size();
+            levels++;
+        }
+        dev = (*order)[head++];
+        reached.clear();
+        for (quint32 ter = TerminalBegin(dev); ter < TerminalEnd(dev); ++ ter) {
+            node = m_terminalNode[ter];
+            if (node == GND_NODE || (*expanded)[node]) continue;
+            (*expanded)[node] = 1;
+            for (quint32 i = NodeBegin(node); i < NodeEnd(node); ++ i) {
+                other = m_terminalDevice[m_nodeTerminal[i]];
+                if ((*visited)[other]) continue;
+                (*visited)[other] = 1;
+                reached.push_back(other);
+            }
+        }
+        if (degree)
+            std::sort(reached.begin(), reached.end(), byDegree);
+        else
+            std::sort(reached.begin(), reached.end());
+        order->insert(order->end(), reached.begin(), reached.end());
+    }
+
+    if (depth)
+        *depth = levels;
+    return lastLevel;
+}
+
+/* devices sharing a non-ground node with dev, counted once per terminal */
+void CompactGraph::DeviceDegrees(std::vector<quint32> *degree) const
+{
+    int deviceCount = DeviceCount();
+    degree->assign(deviceCount, 0);
+    quint32 node = 0;
+    for (int dev = 0; dev < deviceCount; ++ dev) {
+        for (quint32 ter = TerminalBegin(dev); ter < TerminalEnd(dev); ++ ter) {
+            node = m_terminalNode[ter];
+            if (node != GND_NODE)
+                (*degree)[dev] += NodeDegree(node) - 1;
+        }
+    }
+}
+
+/* a low degree device of the last level of order, from index last on */
+static quint32 LowestDegree(const std::vector<quint32> &order, size_t last,
+                            const std::vector<quint32> &degree)
+{
+    quint32 low = order[last];
+    for (size_t i = last; i < order.size(); ++ i) {
+        if (degree[order[i]] < degree[low])
+            low = order[i];
+    }
+    return low;
+}
+
+/*
+ * Cuthill-McKee, a component starts from a low degree device of the
+ * last level of a BFS from its lowest degree device (George-Liu, one
+ * step). reverse gives RCM.
+ */
+void CompactGraph::CuthillMcKeeOrder(std::vector<quint32> *order, bool reverse) const
+{
+    int deviceCount = DeviceCount();
+    std::vector<quint32> degree;
+    DeviceDegrees(&degree);
+
+    std::vector<quint32> candidates(deviceCount);
+    for (int dev = 0; dev < deviceCount; ++ dev)
+        candidates[dev] = dev;
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&degree](quint32 a, quint32 b) { return degree[a] < degree[b]; });
+
+    std::vector<quint8> visited(deviceCount, 0);
+    std::vector<quint8> expanded(NodeCount(), 0);
+    std::vector<quint32> sources(1);
+    order->clear();
+    order->reserve(deviceCount);
+
+    size_t first = 0, last = 0;
+    quint32 start = 0;
+    for (quint32 candidate : candidates) {
+        if (visited[candidate]) continue;
+        first = order->size();
+        sources[0] = candidate;
+        last = Sweep(sources, &degree, &visited, &expanded, order);
+
+        start = LowestDegree(*order, last, degree);
+        if (start == candidate) continue;
+
+        Unvisit(first, &visited, &expanded, order);
+        sources[0] = start;
+        Sweep(sources, &degree, &visited, &expanded, order);
+    }
+
+    if (reverse)
+        std::reverse(order->begin(), order->end());
+}
+
+/*
+ * One pseudo-peripheral device per component (George-Liu): a BFS from
+ * its lowest degree device, then from a low degree device of the last
+ * level while the depth grows, FL_PERIPHERAL_SWEEPS BFS at most. The
+ * source of the deepest BFS is taken, laid out from there a component is
+ * deep and narrow.
+ */
+void CompactGraph::PeripheralDevices(std::vector<quint32> *peripheral) const
+{
+    int deviceCount = DeviceCount();
+    std::vector<quint32> degree;
+    DeviceDegrees(&degree);
+
+    std::vector<quint32> candidates(deviceCount);
+    for (int dev = 0; dev < deviceCount; ++ dev)
+        candidates[dev] = dev;
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&degree](quint32 a, quint32 b) { return degree[a] < degree[b]; });
+
+    std::vector<quint8> visited(deviceCount, 0);
+    std::vector<quint8> expanded(NodeCount(), 0);
+    std::vector<quint32> order, sources(1);
+    order.reserve(deviceCount);
+    peripheral->clear();
+
+    size_t last = 0;
+    int depth = 0, nextDepth = 0;
+    quint32 next = 0, best = 0;
+    for (quint32 candidate : candidates) {
+        if (visited[candidate]) continue;
+        sources[0] = best = candidate;
+        last = Sweep(sources, &degree, &visited, &expanded, &order, &depth);
+
+        for (int sweep = 1; sweep < FL_PERIPHERAL_SWEEPS; ++ sweep) {
+            next = LowestDegree(order, last, degree);
+            if (next == best) break;
+            Unvisit(0, &visited, &expanded, &order);
+            sources[0] = next;
+            last = Sweep(sources, &degree, &visited, &expanded, &order, &nextDepth);
+            if (nextDepth <= depth) break;
+            best = next;
+            depth = nextDepth;
+        }
+        peripheral->push_back(best);
+
+        /* the component stays visited, order is only kept for one */
+        order.clear();
+    }
+}
+
+/* the BFS tree from index first of order on is not visited again */
+void CompactGraph::Unvisit(size_t first, std::vector<quint8> *visited, std::vector<quint8> *expanded,
+                        std::vector<quint32> *order) const
+{
+    for (size_t i = first; i < order->size(); ++ i) {
+        (*visited)[(*order)[i]] = 0;
+        for (quint32 ter = TerminalBegin((*order)[i]); ter < TerminalEnd((*order)[i]); ++ ter)
+            (*expanded)[m_terminalNode[ter]] = 0;
+    }
+    order->resize(first);
+}
+
+/* sources first, devices they do not reach by their own BFS from the lowest id */
+void CompactGraph::BFSOrder(const std::vector<quint32> &sources, std::vector<quint32> *order) const
+{
+    int deviceCount = DeviceCount();
+    std::vector<quint8> visited(deviceCount, 0);
+    std::vector<quint8> expanded(NodeCount(), 0);
+    order->clear();
+    order->reserve(deviceCount);
+
+    Sweep(sources, nullptr, &visited, &expanded, order);
+
+    std::vector<quint32> rest(1);
+    for (int dev = 0; dev < deviceCount; ++ dev) {
+        if (visited[dev]) continue;
+        rest[0] = dev;
+        Sweep(rest, nullptr, &visited, &expanded, order);
+    }
+}
+
+/* union-find on nodes, the ground does not join anything. Returns the count */
+int CompactGraph::Components(std::vector<int> *component) const
+{
+    int deviceCount = DeviceCount();
+    int nodeCount = NodeCount();
+    std::vector<quint32> parent(nodeCount);
+    for (int node = 0; node < nodeCount; ++ node)
+        parent[node] = node;
+
+    auto find = [&parent](quint32 node) {
+        while (parent[node] != node) {
+            parent[node] = parent[parent[node]];
+            node = parent[node];
+        }
+        return node;
+    };
+
+    /* first non-ground node of a device, GND_NODE if none */
+    std::vector<quint32> first(deviceCount, GND_NODE);
+    quint32 node = 0, root = 0, other = 0;
+    for (int dev = 0; dev < deviceCount; ++ dev) {
+        for (quint32 ter = TerminalBegin(dev); ter < TerminalEnd(dev); ++ ter) {
+            node = m_terminalNode[ter];
+            if (node == GND_NODE) continue;
+            if (first[dev] == GND_NODE) {
+                first[dev] = node;
+                root = find(node);
+                continue;
+            }
+            other = find(node);
+            if (other == root) continue;
+            /* the smaller root stays a root */
+            if (other < root)
+                std::swap(other, root);
+            parent[other] = root;
+        }
+    }
+
+    std::vector<int> nodeComponent(nodeCount, -1);
+    int count = 0;
+    component->resize(deviceCount);
+    for (int dev = 0; dev < deviceCount; ++ dev) {
+        if (first[dev] == GND_NODE) {
+            (*component)[dev] = count++;
+            continue;
+        }
+        root = find(first[dev]);
+        if (nodeComponent[root] < 0)
+            nodeComponent[root] = count++;
+        (*component)[dev] = nodeComponent[root];
+    }
+
+    return count;
+}
+
+qint64 CompactGraph::MemoryBytes() const
+{
+    return sizeof(*this)
+           + VectorBytes(m_deviceType) + VectorBytes(m_deviceValue)
+           + VectorBytes(m_deviceOffset) + VectorBytes(m_terminalNode)
+           + VectorBytes(m_terminalDevice) + VectorBytes(m_nodeOffset)
+           + VectorBytes(m_nodeTerminal)
+           + VectorBytes(m_devices) + VectorBytes(m_terminals);
+}
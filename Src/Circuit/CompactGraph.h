@@ -0,0 +1,95 @@
+#ifndef NETLISTVIZ_CIRCUIT_COMPACTGRAPH_H
+#define NETLISTVIZ_CIRCUIT_COMPACTGRAPH_H
+
+/*
+ * @filename : CompactGraph.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Frozen struct-of-arrays form of CircuitGraph for ASG passes.
+ *           : Devices are indexed by Device::Id(), nodes by Node::Id()
+ *           : (all ground nodes are node 0, as Device::GetTerminal(Node*)
+ *           : sees them). Terminals of a device are a range of the
+ *           : terminal arrays, terminals of a node a range of the node
+ *           : CSR, every index is 32 bits. Built by CircuitGraph::Freeze(),
+ *           : dropped when the circuit changes. Device orders for
+ *           : CircuitGraph::Renumber() walk the nodes as hyperedges,
+ *           : and so do the connected components ASG lays out apart
+ *           : and the peripheral devices it may start them from.
+ */
+
+#include <vector>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class CircuitGraph;
+
+class CompactGraph
+{
+public:
+    const static quint32 GND_NODE = 0;
+
+    explicit CompactGraph(const CircuitGraph *ckt);
+    ~CompactGraph();
+
+    int         DeviceCount() const   { return m_deviceType.size(); }
+    int         NodeCount() const     { return m_nodeOffset.size() - 1; }
+    int         TerminalCount() const { return m_terminalNode.size(); }
+
+    /* device arrays */
+    DeviceType  Type(quint32 dev) const  { return static_cast<DeviceType>(m_deviceType[dev]); }
+    double      Value(quint32 dev) const { return m_deviceValue[dev]; }
+    quint32     TerminalBegin(quint32 dev) const { return m_deviceOffset[dev]; }
+    quint32     TerminalEnd(quint32 dev) const   { return m_deviceOffset[dev + 1]; }
+
+    /* terminal arrays */
+    quint32     TerminalNode(quint32 ter) const   { return m_terminalNode[ter]; }
+    quint32     TerminalDevice(quint32 ter) const { return m_terminalDevice[ter]; }
+
+    /* node CSR, entries are terminals, in device id order */
+    quint32     NodeBegin(quint32 node) const { return m_nodeOffset[node]; }
+    quint32     NodeEnd(quint32 node) const   { return m_nodeOffset[node + 1]; }
+    quint32     NodeTerminal(quint32 i) const { return m_nodeTerminal[i]; }
+    int         NodeDegree(quint32 node) const { return m_nodeOffset[node + 1] - m_nodeOffset[node]; }
+
+    /* devices sharing a non-ground node with dev, ascending id, no dev itself */
+    void        Neighbors(quint32 dev, std::vector<quint32> *neighbors) const;
+
+    /* device ids in a new order, every device once, components one after another */
+    void        CuthillMcKeeOrder(std::vector<quint32> *order, bool reverse) const;
+    void        BFSOrder(const std::vector<quint32> &sources, std::vector<quint32> *order) const;
+    /* a device of greatest eccentricity per component, for first levels */
+    void        PeripheralDevices(std::vector<quint32> *peripheral) const;
+
+    /* devices joined by non-ground nodes, numbered by their lowest device id */
+    int         Components(std::vector<int> *component) const;
+
+    /* back to the objects, for passes that still write into them */
+    Device*     GetDevice(quint32 dev) const   { return m_devices[dev]; }
+    Terminal*   GetTerminal(quint32 ter) const { return m_terminals[ter]; }
+
+    qint64      MemoryBytes() const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(CompactGraph);
+
+    size_t      Sweep(const std::vector<quint32> &sources, const std::vector<quint32> *degree,
+                      std::vector<quint8> *visited, std::vector<quint8> *expanded,
+                      std::vector<quint32> *order, int *depth = nullptr) const;
+    void        Unvisit(size_t first, std::vector<quint8> *visited, std::vector<quint8> *expanded,
+                        std::vector<quint32> *order) const;
+    void        DeviceDegrees(std::vector<quint32> *degree) const;
+
+    std::vector<quint8>     m_deviceType;
+    std::vector<double>     m_deviceValue;
+    std::vector<quint32>    m_deviceOffset;     // DeviceCount() + 1
+    std::vector<quint32>    m_terminalNode;
+    std::vector<quint32>    m_terminalDevice;
+    std::vector<quint32>    m_nodeOffset;       // NodeCount() + 1
+    std::vector<quint32>    m_nodeTerminal;
+
+    std::vector<Device*>    m_devices;
+    std::vector<Terminal*>  m_terminals;
+};
+
+#endif // NETLISTVIZ_CIRCUIT_COMPACTGRAPH_H
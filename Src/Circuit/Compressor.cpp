@@ -0,0 +1,386 @@
+#include "Compressor.h"
+#include <algorithm>
+#include <QDebug>
+#include "CircuitGraph.h"
+#include "Device.h"
+#include "Node.h"
+#include "Terminal.h"
+
+Compressor::Compressor(CircuitGraph *ckt, const QSet<QString> &expanded)
+{
+    Q_ASSERT(ckt);
+    m_ckt = ckt;
+    m_expanded = expanded;
+    m_foldCount = 0;
+    m_round = 0;
+}
+
+Compressor::~Compressor()
+{
+}
+
+int Compressor::Run()
+{
+    DeviceList devList = m_ckt->GetDeviceList();
+
+    int nodeCount = 1;
+    foreach (Node *node, m_ckt->GetNodeList())
+        nodeCount = qMax(nodeCount, node->Id() + 1);
+
+    m_nodes.assign(nodeCount, nullptr);
+    foreach (Node *node, m_ckt->GetNodeList()) {
+        if (NOT node->IsGnd())
+            m_nodes[node->Id()] = node;
+        else if (NOT m_nodes[0])
+            m_nodes[0] = node;
+    }
+    m_incident.assign(nodeCount, std::vector<int>());
+    m_queued.assign(nodeCount, 0);
+    m_seen.assign(nodeCount, -1);
+
+    for (int i = 0; i < devList.size(); ++ i)
+        AddDevice(devList.at(i), i, devList.at(i), 1);
+
+    for (int node = 1; node < nodeCount; ++ node) {
+        if (m_nodes[node])
+            MarkDirty(node);
+    }
+
+    /* a round folds what the last one made foldable, nodes in id order */
+    std::vector<int> work;
+    for (m_round = 0; NOT m_dirty.empty(); ++ m_round) {
+        work.swap(m_dirty);
+        m_dirty.clear();
+        std::sort(work.begin(), work.end());
+        for (int node : work)
+            m_queued[node] = 0;
+
+        for (int node : work)
+            FoldParallel(node);
+        for (int node : work)
+            FoldSeries(node);
+    }
+
+    return OKAY;
+}
+
+DeviceList Compressor::Devices() const
+{
+    std::vector<int> order;
+    for (size_t dev = 0; dev < m_devices.size(); ++ dev) {
+        if (m_alive[dev])
+            order.push_back(dev);
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return m_rank[a] < m_rank[b];
+    });
+
+    DeviceList devList;
+    devList.reserve(order.size());
+    for (int dev : order)
+        devList.push_back(m_devices[dev]);
+    return devList;
+}
+
+/* working index is the id until CircuitGraph::Compress() renumbers */
+void Compressor::AddDevice(Device *dev, int rank, Device *leaf, int leaves)
+{
+    int index = m_devices.size();
+    dev->SetId(index);
+    m_devices.push_back(dev);
+    m_alive.push_back(1);
+    m_pinned.push_back(0);
+    m_rank.push_back(rank);
+    m_leaf.push_back(leaf);
+    m_leaves.push_back(leaves);
+
+    int node = 0;
+    for (int pin = 0; pin < dev->TerminalCount(); ++ pin) {
+        node = NodeOf(index, pin);
+        if (node != 0)
+            m_incident[node].push_back(index);
+    }
+}
+
+void Compressor::MarkDirty(int node)
+{
+    if (node == 0 || m_queued[node])
+        return;
+    m_queued[node] = 1;
+    m_dirty.push_back(node);
+}
+
+int Compressor::NodeOf(int dev, int pin) const
+{
+    Terminal *terminal = m_devices[dev]->TerminalAt(pin);
+    return terminal->NodeIsGnd() ? 0 : terminal->NodeId();
+}
+
+int Compressor::OtherEnd(int dev, int node) const
+{
+    int node0 = NodeOf(dev, 0);
+    return (node0 == node) ? NodeOf(dev, 1) : node0;
+}
+
+/* a two-terminal R, L or C between two different nodes */
+bool Compressor::Foldable(int dev) const
+{
+    if (NOT m_alive[dev] || m_pinned[dev])
+        return false;
+
+    DeviceType type = m_devices[dev]->GetDeviceType();
+    if (type != RESISTOR AND type != INDUCTOR AND type != CAPACITOR)
+        return false;
+
+    return NodeOf(dev, 0) != NodeOf(dev, 1);
+}
+
+/* folded devices are dropped from the list when it is read */
+const std::vector<int>& Compressor::Incident(int node)
+{
+    std::vector<int> &devs = m_incident[node];
+    devs.erase(std::remove_if(devs.begin(), devs.end(), [this](int dev) {
+        return NOT m_alive[dev];
+    }), devs.end());
+    return devs;
+}
+
+/*
+ * Through : two R/L to different nodes and ground caps, nothing else.
+ * Stub    : one R/L and ground caps, the chain ends at ground here.
+ */
+Compressor::ChainNode Compressor::Classify(int node, int *first, int *second, std::vector<int> *caps)
+{
+    if (node == 0)
+        return Outside;
+    if (caps)
+        caps->clear();
+
+    int count = 0, capCount = 0;
+    DeviceType type = RESISTOR;
+    for (int dev : Incident(node)) {
+        if (NOT Foldable(dev))
+            return Outside;
+        type = m_devices[dev]->GetDeviceType();
+        if (type == CAPACITOR AND OtherEnd(dev, node) == 0) {
+            if (caps)
+                caps->push_back(dev);
+            capCount++;
+            continue;
+        }
+        if (type == CAPACITOR || count == 2)
+            return Outside;
+        if (count == 0)
+            *first = dev;
+        else
+            *second = dev;
+        count++;
+    }
+
+    if (count == 1 AND capCount > 0)
+        return Stub;
+    if (count == 2 AND OtherEnd(*first, node) != OtherEnd(*second, node))
+        return Through;
+    return Outside;
+}
+
+/* one fold per device type and other node, members in netlist order */
+void Compressor::FoldParallel(int node)
+{
+    std::vector<int> group;
+    for (int dev : Incident(node)) {
+        if (Foldable(dev))
+            group.push_back(dev);
+    }
+    if (group.size() < 2)
+        return;
+
+    auto key = [this, node](int dev) {
+        return std::make_pair((int)m_devices[dev]->GetDeviceType(), OtherEnd(dev, node));
+    };
+    std::sort(group.begin(), group.end(), [this, &key](int a, int b) {
+        if (key(a) != key(b))
+            return key(a) < key(b);
+        return m_rank[a] < m_rank[b];
+    });
+
+    size_t begin = 0;
+    for (size_t i = 1; i <= group.size(); ++ i) {
+        if (i < group.size() AND key(group[i]) == key(group[begin]))
+            continue;
+        if (i - begin > 1) {
+            std::vector<int> pieces(group.begin() + begin, group.begin() + i);
+            DeviceList members;
+            for (int dev : pieces)
+                members.push_back(m_devices[dev]);
+            Fold(pieces, members, false, NodeOf(pieces[0], 0), NodeOf(pieces[0], 1));
+        }
+        begin = i;
+    }
+}
+
+/*
+ * The chain through node, walked to one end first and then to the other,
+ * so pieces are in chain order and the caps of a node follow the device
+ * that enters it. A stub end is ground, a ring of Through nodes is left
+ * alone.
+ */
+void Compressor::FoldSeries(int node)
+{
+    if (m_seen[node] == m_round)
+        return;
+
+    int first = 0, second = 0, a = 0, b = 0;
+    std::vector<int> caps;
+    ChainNode kind = Classify(node, &first, &second, &caps);
+    if (kind == Outside)
+        return;
+
+    int start = node, end0 = 0, cur = node, dev = first, next = 0;
+    if (kind == Through) {
+        while (true) {
+            m_seen[cur] = m_round;
+            next = OtherEnd(dev, cur);
+            if (next == node)
+                return;
+            kind = Classify(next, &a, &b, nullptr);
+            if (kind != Through)
+                break;
+            dev = (a == dev) ? b : a;
+            cur = next;
+        }
+        start = next;
+        end0 = (kind == Stub) ? 0 : next;
+    }
+
+    std::vector<int> pieces;
+    DeviceList members;
+    if (start != end0) {
+        Classify(start, &a, &b, &caps);
+        m_seen[start] = m_round;
+        for (int cap : caps) {
+            pieces.push_back(cap);
+            members.push_back(m_devices[cap]);
+        }
+    }
+
+    int end1 = 0;
+    cur = start;
+    while (true) {
+        pieces.push_back(dev);
+        AppendSeries(dev, cur, &members);
+        next = OtherEnd(dev, cur);
+        kind = Classify(next, &a, &b, &caps);
+        if (kind == Outside) {
+            end1 = next;
+            break;
+        }
+        m_seen[next] = m_round;
+        for (int cap : caps) {
+            pieces.push_back(cap);
+            members.push_back(m_devices[cap]);
+        }
+        if (kind == Stub)
+            break;
+        dev = (a == dev) ? b : a;
+        cur = next;
+    }
+
+    /* both ends on one node, the composite would be a loop */
+    if (end0 == end1)
+        return;
+
+    Fold(pieces, members, true, end0, end1);
+}
+
+/* a series composite in the chain gives its members, from node from on */
+void Compressor::AppendSeries(int dev, int from, DeviceList *members) const
+{
+    Device *device = m_devices[dev];
+    if (NOT device->IsComposite() || NOT device->Series()) {
+        members->push_back(device);
+        return;
+    }
+
+    const DeviceList &inner = device->Members();
+    if (NodeOf(dev, 0) == from) {
+        members->append(inner);
+    } else {
+        for (int i = inner.size() - 1; i >= 0; -- i)
+            members->push_back(inner.at(i));
+    }
+}
+
+/* pieces are the devices folded now, members what the composite keeps */
+void Compressor::Fold(const std::vector<int> &pieces, const DeviceList &members, bool series,
+                      int node0, int node1)
+{
+    int rank = m_rank[pieces[0]], leaves = 0;
+    Device *leaf = m_leaf[pieces[0]];
+    for (int dev : pieces) {
+        leaves += m_leaves[dev];
+        if (m_rank[dev] < rank) {
+            rank = m_rank[dev];
+            leaf = m_leaf[dev];
+        }
+    }
+
+    QString name = leaf->Name() + (series ? "+" : "|") + QString::number(leaves - 1);
+    if (m_expanded.contains(name)) {
+        for (int dev : pieces)
+            m_pinned[dev] = 1;
+        return;
+    }
+    /* never a netlist name */
+    while (m_ckt->GetDevice(name))
+        name += "'";
+
+    /* a chain with an R is an R, its value sums the R, caps are not in the way */
+    DeviceType type = m_devices[pieces[0]]->GetDeviceType();
+    if (series) {
+        type = INDUCTOR;
+        for (int dev : pieces) {
+            if (m_devices[dev]->GetDeviceType() == RESISTOR)
+                type = RESISTOR;
+        }
+    }
+    double value = 0, conductance = 0;
+    bool shorted = false;
+    if (series) {
+        foreach (Device *member, members) {
+            if (member->GetDeviceType() == type)
+                value += member->Value();
+        }
+    } else if (type == CAPACITOR) {
+        for (int dev : pieces)
+            value += m_devices[dev]->Value();
+    } else {
+        for (int dev : pieces) {
+            if (m_devices[dev]->Value() == 0)
+                shorted = true;
+            else
+                conductance += 1.0 / m_devices[dev]->Value();
+        }
+        value = (shorted || conductance == 0) ? 0 : 1.0 / conductance;
+    }
+
+    Node *nodes[MAX_DEVICE_TERMINALS] = { m_nodes[node0], m_nodes[node1] };
+    NameId nameId = m_ckt->InternName(name.toStdString());
+    if (m_ckt->InsertDevice(type, nameId, nodes, value))
+        return;
+
+    Device *composite = m_ckt->GetDevice(name);
+    Q_ASSERT(composite);
+    composite->SetMembers(members, series);
+    for (int dev : pieces) {
+        m_alive[dev] = 0;
+        m_devices[dev]->SetComposite(composite);
+    }
+    foreach (Device *member, members)
+        member->SetComposite(composite);
+
+    AddDevice(composite, rank, leaf, leaves);
+    MarkDirty(node0);
+    MarkDirty(node1);
+    m_foldCount++;
+}
@@ -0,0 +1,84 @@
+#ifndef NETLISTVIZ_CIRCUIT_COMPRESSOR_H
+#define NETLISTVIZ_CIRCUIT_COMPRESSOR_H
+
+/*
+ * @filename : Compressor.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Series-parallel reduction of a flat circuit, run by
+ *           : CircuitGraph::Compress(). R, L or C of one type on the same
+ *           : node pair fold into a parallel composite. A maximal chain
+ *           : of R and L folds into a series composite: a node inside it
+ *           : holds two of them and otherwise ground caps only, a node
+ *           : with one of them and ground caps ends it at ground (an RC
+ *           : load), the caps go into the chain. Folds repeat on the
+ *           : nodes they touch until none is left. A composite is an
+ *           : R/L/C of equivalent value (a chain with an R is an R, of
+ *           : its R sum), named after its first leaf and the count of
+ *           : the others (R1+8 in series, C3|2 in parallel), and keeps
+ *           : its members. A fold whose name is expanded is not done,
+ *           : its pieces stay as they are.
+ */
+
+#include <vector>
+#include <QSet>
+#include <QString>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class CircuitGraph;
+
+class Compressor
+{
+public:
+    Compressor(CircuitGraph *ckt, const QSet<QString> &expanded);
+    ~Compressor();
+
+    int        Run();
+    /* devices left, in netlist order of their first leaves */
+    DeviceList Devices() const;
+    int        FoldCount() const { return m_foldCount; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(Compressor);
+
+    /* what a node is to a series chain */
+    enum ChainNode { Outside = 0, Through, Stub };
+
+    void   AddDevice(Device *dev, int rank, Device *leaf, int leaves);
+    void   MarkDirty(int node);
+    int    NodeOf(int dev, int pin) const;
+    int    OtherEnd(int dev, int node) const;
+    bool   Foldable(int dev) const;
+    const std::vector<int>& Incident(int node);
+    ChainNode Classify(int node, int *first, int *second, std::vector<int> *caps);
+
+    void   FoldParallel(int node);
+    void   FoldSeries(int node);
+    void   AppendSeries(int dev, int from, DeviceList *members) const;
+    void   Fold(const std::vector<int> &pieces, const DeviceList &members, bool series,
+                int node0, int node1);
+
+    CircuitGraph          *m_ckt;
+    QSet<QString>          m_expanded;
+    int                    m_foldCount;
+
+    /* by working index, originals first, composites appended */
+    std::vector<Device*>   m_devices;
+    std::vector<quint8>    m_alive;
+    std::vector<quint8>    m_pinned;      // in an expanded fold, never folded again
+    std::vector<int>       m_rank;        // netlist position of the first leaf
+    std::vector<Device*>   m_leaf;
+    std::vector<int>       m_leaves;
+
+    /* by node id, ground is node 0 and has no list */
+    std::vector<Node*>             m_nodes;
+    std::vector<std::vector<int>>  m_incident;
+    std::vector<int>               m_dirty;
+    std::vector<quint8>            m_queued;
+    std::vector<int>               m_seen;    // round a chain walked the node
+    int                            m_round;
+};
+
+#endif // NETLISTVIZ_CIRCUIT_COMPRESSOR_H
@@ -9,6 +9,8 @@
  * @desp     : This structure is used to describe Connect Information between devices.
  */
 
+#include "CompactGraph.h"
+
 class Device;
 class Terminal;
 
@@ -23,9 +25,89 @@ struct Connector
 
     Connector(Terminal *thisTer, Terminal *cntTer, Device *cntDev)
         : thisTerminal(thisTer), connectTerminal(cntTer), connectDevice(cntDev) {} 
+};
+
+/*
+ * Connectors of a device, walked from the node CSR and never stored.
+ * Pin order first, then terminal id order on the node (ground included).
+ * A device sharing k terminal pairs with this one is met k times.
+ */
+class ConnectorView
+{
+public:
+    class Iterator
+    {
+    public:
+        Iterator(const CompactGraph *graph, quint32 dev, quint32 ter, quint32 terEnd)
+            : m_graph(graph), m_dev(dev), m_ter(ter), m_terEnd(terEnd), m_i(0), m_iEnd(0)
+        {
+            if (m_ter < m_terEnd)
+                EnterTerminal();
+            Settle();
+        }
+
+        Connector operator*() const
+        {
+            quint32 cntTer = m_graph->NodeTerminal(m_i);
+            return Connector(m_graph->GetTerminal(m_ter), m_graph->GetTerminal(cntTer),
+                             m_graph->GetDevice(m_graph->TerminalDevice(cntTer)));
+        }
+
+        Iterator& operator++()
+        {
+            ++ m_i;
+            Settle();
+            return *this;
+        }
+
+        bool operator!=(const Iterator &other) const
+        {
+            return (m_ter != other.m_ter) || (m_i != other.m_i);
+        }
+
+    private:
+        void EnterTerminal()
+        {
+            quint32 node = m_graph->TerminalNode(m_ter);
+            m_i = m_graph->NodeBegin(node);
+            m_iEnd = m_graph->NodeEnd(node);
+        }
+
+        /* move to the next terminal of another device, or to end */
+        void Settle()
+        {
+            while (m_ter < m_terEnd) {
+                for (; m_i < m_iEnd; ++ m_i) {
+                    if (m_graph->TerminalDevice(m_graph->NodeTerminal(m_i)) != m_dev)
+                        return;
+                }
+                if (++ m_ter < m_terEnd)
+                    EnterTerminal();
+            }
+            m_i = 0;
+        }
+
+        const CompactGraph *m_graph;
+        quint32             m_dev;
+        quint32             m_ter;
+        quint32             m_terEnd;
+        quint32             m_i;
+        quint32             m_iEnd;
+    };
+
+    /* connectors of terminals [terBegin, terEnd) of dev */
+    ConnectorView(const CompactGraph *graph, quint32 dev, quint32 terBegin, quint32 terEnd)
+        : m_graph(graph), m_dev(dev), m_terBegin(terBegin), m_terEnd(terEnd) {}
 
-    ~Connector() {}
+    Iterator begin() const { return Iterator(m_graph, m_dev, m_terBegin, m_terEnd); }
+    Iterator end() const   { return Iterator(m_graph, m_dev, m_terEnd, m_terEnd); }
+    bool     Empty() const { return NOT (begin() != end()); }
 
+private:
+    const CompactGraph *m_graph;
+    quint32             m_dev;
+    quint32             m_terBegin;
+    quint32             m_terEnd;
 };
 
 #endif //NETLISTVIZ_CIRCUIT_CONNECTOR_H
@@ -1,16 +1,24 @@
 #include "Device.h"
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <vector>
 #include <QtMath>
 #include <QDebug>
+#include <QtAlgorithms>
 #include "Node.h"
 #include "Terminal.h"
 #include "ASG/Wire.h"
 #include "Connector.h"
+#include "CompactGraph.h"
+#include "Utilities/Arena.h"
+#include "DeviceTraits.h"
+#include "ASG/NetIndex.h"
 
-Device::Device(DeviceType type, QString name)
+Device::Device(DeviceType type, NamePool *pool, NameId name)
+    : m_namePool(pool)
 {
-    m_name = name;
+    m_nameId = name;
     m_deviceType = type;
     m_id = 0;
     m_maybeAtFirstLevel = false;
@@ -23,72 +31,70 @@ Device::Device(DeviceType type, QString name)
     m_orien = Horizontal;
     m_geoRow = 0;
     m_geoCol = 0;
+    m_series = false;
+    m_composite = nullptr;
+    m_terminalCount = Traits(type).terminalCount;
+    for (int pin = 0; pin < MAX_DEVICE_TERMINALS; ++ pin)
+        m_terminals[pin] = nullptr;
 }
 
 Device::~Device()
 {
 #ifdef TRACEx
-    qInfo() << LINE_INFO << "deleting " << m_name << " and terminals" << endl;
+    qInfo() << LINE_INFO << "deleting " << Name() << " and terminals" << endl;
 #endif
-    TerminalTable::iterator it;
-    it = m_terminals.begin();
-    for (; it != m_terminals.end(); ++ it)
-        delete it.value();
-    m_terminals.clear();
-
-    m_connectors.clear();
-    m_predecessors.clear();
-    m_fellows.clear();
-    m_successors.clear();
-    ClearConnectors();
+    /* terminals are freed with CircuitGraph's arena */
 }
 
-int Device::AddTerminal(Terminal *terminal, TerminalType type)
+/* pin is the index in DeviceTraits::pins, which gives the terminal type */
+int Device::AddTerminal(Terminal *terminal, int pin)
 {
-    m_terminals[type] = terminal;
-    terminal->SetTerminalType(type);
+    Q_ASSERT(pin >= 0 && pin < m_terminalCount);
+    m_terminals[pin] = terminal;
+    terminal->SetTerminalType(Traits(m_deviceType).pins[pin]);
     return OKAY;
 }
 
+/* Positive/Negative of a MOSFET or BJT are its posPin/negPin (d/s, c/e) */
 Terminal* Device::GetTerminal(TerminalType type) const
 {
-    Terminal *terminal = nullptr;
-    TerminalTable::const_iterator finder;
-    finder = m_terminals.find(type);
-    if (finder != m_terminals.constEnd())
-        terminal = finder.value();
-    else
-        terminal = nullptr;
-    
-    return terminal;
+    const DeviceTraits &traits = Traits(m_deviceType);
+    if (type == Positive)
+        return m_terminals[traits.posPin];
+    if (type == Negative)
+        return m_terminals[traits.negPin];
+
+    for (int pin = 0; pin < m_terminalCount; ++ pin) {
+        if (traits.pins[pin] == type)
+            return m_terminals[pin];
+    }
+
+    return nullptr;
 }
 
 Terminal* Device::GetTerminal(Node *node) const
 {
-    Terminal *terminal = nullptr;
-    foreach (terminal, m_terminals.values()) {
-        if (terminal->GetNode()->Id() == node->Id())
-            return terminal;
+    for (int pin = 0; pin < m_terminalCount; ++ pin) {
+        if (m_terminals[pin]->GetNode()->Id() == node->Id())
+            return m_terminals[pin];
     }
 
     return nullptr;
 }
 
-void Device::AddConnectDevice(Device *dev)
+/* graph is the frozen form of the circuit this device is in */
+ConnectorView Device::Connectors(const CompactGraph *graph) const
 {
-    Q_ASSERT(dev);
-
-    TerminalTable::const_iterator thisCit, otherCit;
-    thisCit = m_terminals.constBegin();
-    for (; thisCit != m_terminals.constEnd(); ++ thisCit) {
-        otherCit = dev->m_terminals.constBegin();
-        for (; otherCit != dev->m_terminals.constEnd(); ++ otherCit) {
-            if (thisCit.value()->NodeId() == otherCit.value()->NodeId()) {
-                Connector *cd = new Connector(thisCit.value(), otherCit.value(), dev);
-                m_connectors.push_back(cd);
-            }
-        }
-    }
+    Q_ASSERT(graph && graph->GetDevice(m_id) == this);
+    return ConnectorView(graph, m_id, graph->TerminalBegin(m_id), graph->TerminalEnd(m_id));
+}
+
+ConnectorView Device::Connectors(const CompactGraph *graph, int pin) const
+{
+    Q_ASSERT(graph && graph->GetDevice(m_id) == this);
+    Q_ASSERT(pin >= 0 && pin < m_terminalCount);
+    quint32 ter = graph->TerminalBegin(m_id) + pin;
+    return ConnectorView(graph, m_id, ter, ter + 1);
 }
 
 bool Device::CoupledCap() const
@@ -99,44 +105,66 @@ bool Device::CoupledCap() const
     return coupled;
 }
 
-void Device::ClassifyConnectDeviceByLevel()
+/*
+ * Devices at level sharing a non-ground node with this one, each listed
+ * once per terminal pair the two share (ground pairs too), that is once
+ * per Connector between them. Devices on ground only are left out,
+ * HasConnection() ignores them anyway.
+ */
+DeviceList Device::NeighborsAt(const NetIndex *nets, int level) const
 {
-    m_predecessors.clear();
-    m_fellows.clear();
-    m_successors.clear();
+    const CompactGraph *graph = nets->Graph();
+    std::vector<quint32> neighbors;
+    quint32 node = 0;
+    int group = 0;
+
+    for (quint32 ter = graph->TerminalBegin(m_id); ter < graph->TerminalEnd(m_id); ++ ter) {
+        node = graph->TerminalNode(ter);
+        if (node == CompactGraph::GND_NODE) continue;
+        group = nets->FindGroup(node, level);
+        if (group < 0) continue;
+        for (quint32 i = nets->GroupBegin(group); i < nets->GroupEnd(group); ++ i)
+            neighbors.push_back(graph->TerminalDevice(nets->Entry(i)));
+    }
 
-    if (m_connectors.size() < 1)
-        return;
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
 
-    Device *cntDev = nullptr;
-    int cntDevLevelId = 0;
-    foreach (Connector *cd, m_connectors) {
-        cntDev = cd->connectDevice;
-        cntDevLevelId = cntDev->LevelId();
-        if (cntDevLevelId == m_levelId)
-            m_fellows.push_back(cntDev);
-        else if (cntDevLevelId == m_levelId - 1)
-            m_predecessors.push_back(cntDev);
-        else if (cntDevLevelId == m_levelId + 1)
-            m_successors.push_back(cntDev);
+    DeviceList result;
+    for (quint32 dev : neighbors) {
+        if (dev == (quint32)m_id) continue;
+        for (quint32 a = graph->TerminalBegin(m_id); a < graph->TerminalEnd(m_id); ++ a) {
+            for (quint32 b = graph->TerminalBegin(dev); b < graph->TerminalEnd(dev); ++ b) {
+                if (graph->TerminalNode(a) == graph->TerminalNode(b))
+                    result.push_back(graph->GetDevice(dev));
+            }
+        }
     }
+
+    return result;
 }
 
-WireList Device::WiresFromPredecessors() const
+WireList Device::WiresFromPredecessors(const NetIndex *nets, Arena *arena) const
 {
     WireList wires;
-    Terminal *thisTer = nullptr, *cntTer = nullptr;
-    Device *cntDev = nullptr;
-
-    foreach (Connector *ct, m_connectors) {
-        thisTer = ct->thisTerminal;
-        if (thisTer->NodeIsGnd()) continue;
-        cntDev = ct->connectDevice;
-        if ((cntDev->LevelId() + 1) != m_levelId) continue;
-        cntTer = ct->connectTerminal;
-        // new wire
-        Wire *newWire = new Wire(cntDev, cntTer, const_cast<Device*>(this), thisTer);
-        wires.push_back(newWire);
+    const CompactGraph *graph = nets->Graph();
+    Terminal *thisTer = nullptr;
+    quint32 node = 0, cntTer = 0;
+    int group = 0;
+
+    for (quint32 ter = graph->TerminalBegin(m_id); ter < graph->TerminalEnd(m_id); ++ ter) {
+        node = graph->TerminalNode(ter);
+        if (node == CompactGraph::GND_NODE) continue;
+        group = nets->FindGroup(node, m_levelId - 1);
+        if (group < 0) continue;
+        thisTer = graph->GetTerminal(ter);
+        for (quint32 i = nets->GroupBegin(group); i < nets->GroupEnd(group); ++ i) {
+            cntTer = nets->Entry(i);
+            // new wire
+            Wire *newWire = arena->New<Wire>(graph->GetDevice(graph->TerminalDevice(cntTer)),
+                    graph->GetTerminal(cntTer), const_cast<Device*>(this), thisTer);
+            wires.push_back(newWire);
+        }
     }
 
     return wires;
@@ -145,32 +173,31 @@ WireList Device::WiresFromPredecessors() const
 TerminalList Device::GetTerminalList() const
 {
     TerminalList result;
-    TerminalTable::const_iterator cit;
-    cit = m_terminals.constBegin();
-    for (; cit != m_terminals.constEnd(); ++ cit) {
-        result.push_back(cit.value());
-    }
+    result.reserve(m_terminalCount);
+    for (int pin = 0; pin < m_terminalCount; ++ pin)
+        result.push_back(m_terminals[pin]);
 
     return result;
 }
 
-void Device::CalLogicalRowByPredecessors()
+/* average row over terminal pairs with the previous level, ground included */
+void Device::CalLogicalRowByPredecessors(const NetIndex *nets)
 {
-    if (m_predecessors.size() < 1) {
-        m_logRow = 0;
-        return;
-    }
-
-    int sum = 0, count = 0;
-    foreach (Device *dev, m_predecessors) {
-        sum += dev->LogicalRow();
-        count++;
+    const CompactGraph *graph = nets->Graph();
+    qint64 sum = 0;
+    int count = 0;
+    quint32 node = 0;
+
+    for (quint32 ter = graph->TerminalBegin(m_id); ter < graph->TerminalEnd(m_id); ++ ter) {
+        node = graph->TerminalNode(ter);
+        sum += nets->RowSum(node, m_levelId - 1);
+        count += nets->Count(node, m_levelId - 1);
     }
 
     if (count == 0)
         m_logRow = 0;
     else
-        m_logRow = (sum / count);
+        m_logRow = (int)(sum / count);
 }
 
 #if 0
@@ -207,14 +234,15 @@ void Device::DecideReverseByPredecessors(IgnoreCap ignore)
 #endif
 
 /* Just consider R, L, C, V, I */
-void Device::DecideReverseByPredecessors()
+void Device::DecideReverseByPredecessors(const NetIndex *nets)
 {
     qreal reverseLen = 0, noReverseLen = 0;
     Device *dev = nullptr;
     Terminal *posTer = nullptr, *negTer = nullptr;
+    DeviceList predecessors = Predecessors(nets);
 
     if (m_orien == Horizontal) {
-        foreach (dev, m_predecessors) {
+        foreach (dev, predecessors) {
             posTer = dev->GetTerminal(Positive);
             if (HasConnection(posTer, Positive)) {
                 noReverseLen += 0.5;
@@ -244,7 +272,7 @@ void Device::DecideReverseByPredecessors()
     /* vertical */
     /* First, we assume no reverse */
     m_reverse = false;
-    foreach (dev, m_predecessors) {
+    foreach (dev, predecessors) {
         posTer = dev->GetTerminal(Positive);
         if (HasConnection(posTer, Positive)) {
             noReverseLen += RowDistance(posTer, Positive);
@@ -262,7 +290,7 @@ void Device::DecideReverseByPredecessors()
 
     /* Second, we assume reverse */
     m_reverse = true;
-    foreach (dev, m_predecessors) {
+    foreach (dev, predecessors) {
         posTer = dev->GetTerminal(Positive);
         if (HasConnection(posTer, Positive)) {
             reverseLen += RowDistance(posTer, Positive);
@@ -284,14 +312,15 @@ void Device::DecideReverseByPredecessors()
         m_reverse = false;
 }
 
-void Device::DecideReverseBySuccessors()
+void Device::DecideReverseBySuccessors(const NetIndex *nets)
 {
     qreal reverseLen = 0, noReverseLen = 0;
     Device *dev = nullptr;
     Terminal *posTer = nullptr, *negTer = nullptr;
+    DeviceList predecessors = Predecessors(nets);
 
     if (m_orien == Horizontal) {
-        foreach (dev, m_successors) {
+        foreach (dev, Successors(nets)) {
             posTer = dev->GetTerminal(Positive);
             if (HasConnection(posTer, Positive)) {
                 noReverseLen += 1.5;
@@ -321,7 +350,7 @@ void Device::DecideReverseBySuccessors()
     /* vertical */
     /* First, we assume no reverse */
     m_reverse = false;
-    foreach (dev, m_predecessors) {
+    foreach (dev, predecessors) {
         posTer = dev->GetTerminal(Positive);
         if (HasConnection(posTer, Positive)) {
             noReverseLen += RowDistance(posTer, Positive);
@@ -339,7 +368,7 @@ void Device::DecideReverseBySuccessors()
 
     /* Second, we assume reverse */
     m_reverse = true;
-    foreach (dev, m_predecessors) {
+    foreach (dev, predecessors) {
         posTer = dev->GetTerminal(Positive);
         if (HasConnection(posTer, Positive)) {
             reverseLen += RowDistance(posTer, Positive);
@@ -364,7 +393,7 @@ void Device::DecideReverseBySuccessors()
 bool Device::HasConnection(Terminal *otherTer, TerminalType thisType) const
 {
     bool has = false;
-    Terminal *thisTer = m_terminals[thisType];
+    Terminal *thisTer = GetTerminal(thisType);
     if (thisTer->NodeId() != 0 && otherTer->NodeId() != 0) {
         if (thisTer->NodeId() == otherTer->NodeId())
             has = true;
@@ -373,37 +402,31 @@ bool Device::HasConnection(Terminal *otherTer, TerminalType thisType) const
     return has;
 }
 
-void Device::ClearConnectors()
-{
-    foreach (Connector *cd, m_connectors)
-        delete cd;
-    m_connectors.clear();
-}
-
 /* R, L, V, V, I now */
-bool Device::MaybeVertical() const
+bool Device::MaybeVertical(const NetIndex *nets) const
 {
-    TerminalTable cntToPredTers;
-    Terminal *thisTer = nullptr;
-    Device *cntDev = nullptr;
-    int cntToGndCount = 0;
-
-    foreach (Connector *cd, m_connectors) {
-        cntDev = cd->connectDevice;
-        if ((cntDev->LevelId() + 1) != m_levelId) continue; // predecessor
-        thisTer = cd->thisTerminal;
-        if (thisTer->NodeIsGnd()) {
-            cntToGndCount++;
+    const CompactGraph *graph = nets->Graph();
+    quint32 cntToPredTypes = 0;   // a bit per TerminalType
+    int cntToGndCount = 0, predCount = 0;
+    quint32 node = 0, ter = 0;
+
+    for (int pin = 0; pin < m_terminalCount; ++ pin) {
+        ter = graph->TerminalBegin(m_id) + pin;
+        node = graph->TerminalNode(ter);
+        predCount = nets->Count(node, m_levelId - 1);
+        if (predCount == 0) continue;
+        if (node == CompactGraph::GND_NODE) {
+            cntToGndCount += predCount;
             continue;
         }
-        cntToPredTers.insert(thisTer->GetTerminalType(), thisTer);
+        cntToPredTypes |= (1u << m_terminals[pin]->GetTerminalType());
     }
 
 #ifdef DEBUGx
-    qDebug() << cntToPredTers;
+    qDebug() << Name() << cntToPredTypes;
 #endif
 
-    int count = cntToPredTers.size();
+    int count = qPopulationCount(cntToPredTypes);
     if (count >= 2)
         return true;
     
@@ -412,11 +435,12 @@ bool Device::MaybeVertical() const
         return false;
     
     bool nextRowFilled = false;
-    foreach (Device *dev, m_fellows)
-        if (dev->LogicalRow() == m_logRow + 1) {
+    for (ter = graph->TerminalBegin(m_id); ter < graph->TerminalEnd(m_id); ++ ter) {
+        if (nets->HasRow(graph->TerminalNode(ter), m_levelId, m_logRow + 1)) {
             nextRowFilled = true;
             break;
         }
+    }
     
     if (NOT nextRowFilled)
         return true;
@@ -424,9 +448,9 @@ bool Device::MaybeVertical() const
         return false;
 }
 
-void Device::DecideOrientationByPredecessors()
+void Device::DecideOrientationByPredecessors(const NetIndex *nets)
 {
-    if (MaybeVertical())
+    if (MaybeVertical(nets))
         m_orien = Vertical;
     else
         m_orien = Horizontal;
@@ -434,49 +458,41 @@ void Device::DecideOrientationByPredecessors()
 
 qreal Device::RowDistance(Terminal *otherTer, TerminalType thisType) const
 {
-    Terminal *thisTer = m_terminals[thisType];
+    Terminal *thisTer = GetTerminal(thisType);
     return qFabs(otherTer->LogicalRelRow() - thisTer->LogicalRelRow());
 }
 
-WireList Device::WiresToFellows() const
+/* only nets whose devices are all at this level */
+WireList Device::WiresToFellows(const NetIndex *nets, Arena *arena) const
 {
     WireList wires;
-    Terminal *thisTer = nullptr, *cntTer = nullptr;
-    Device *cntDev = nullptr;
-    Node *node = nullptr;
-
-    DeviceTable fellowTable;
-    foreach (Device *dev, m_fellows)
-        fellowTable.insert(dev->Name(), dev);
-    bool isFellow = false;
-
-    foreach (Connector *ct, m_connectors) {
-        thisTer = ct->thisTerminal;
-        if (thisTer->NodeIsGnd()) continue;
-        cntDev = ct->connectDevice;
-        if (cntDev->LevelId() != m_levelId) continue;
-
-        node = thisTer->GetNode();
-        isFellow = false;
-        foreach (Device *dev, node->ConnectDeviceList()) {
-            if (dev == this) continue;
-            isFellow = fellowTable.contains(dev->Name());
-            if (NOT isFellow)
-                break;
+    const CompactGraph *graph = nets->Graph();
+    Terminal *thisTer = nullptr;
+    quint32 node = 0, cntTer = 0, cntDev = 0;
+    int group = 0;
+
+    for (quint32 ter = graph->TerminalBegin(m_id); ter < graph->TerminalEnd(m_id); ++ ter) {
+        node = graph->TerminalNode(ter);
+        if (node == CompactGraph::GND_NODE) continue;
+        if (NOT nets->SingleLevel(node)) continue;
+        group = nets->FindGroup(node, m_levelId);
+        Q_ASSERT(group >= 0);
+        thisTer = graph->GetTerminal(ter);
+        for (quint32 i = nets->GroupBegin(group); i < nets->GroupEnd(group); ++ i) {
+            cntTer = nets->Entry(i);
+            cntDev = graph->TerminalDevice(cntTer);
+            if (cntDev == (quint32)m_id) continue;
+            // new wire
+            Wire *newWire = arena->New<Wire>(const_cast<Device*>(this), thisTer,
+                    graph->GetDevice(cntDev), graph->GetTerminal(cntTer));
+            wires.push_back(newWire);
         }
-
-        if (NOT isFellow) continue;
-
-        cntTer = ct->connectTerminal;
-        // new wire
-        Wire *newWire = new Wire(const_cast<Device*>(this), thisTer, cntDev, cntTer);
-        wires.push_back(newWire);
     }
 
 #ifdef DEBUGx
     printf("---------- Wires To Fellows ----------\n");
 
-    qInfo() << "Device " << m_name;
+    qInfo() << "Device " << Name();
     foreach (Wire *wire, wires) {
         qInfo() << wire->Name();
     }
@@ -487,19 +503,31 @@ WireList Device::WiresToFellows() const
     return wires;
 }
 
+void Device::SetMembers(const DeviceList &members, bool series)
+{
+    m_members = members;
+    m_series = series;
+}
+
 void Device::Print() const
 {
     std::stringstream ss;
     ss << "******************************\n";
-    ss << "Name(" << m_name.toStdString() << "), ";
+    ss << "Name(" << m_namePool->StdName(m_nameId) << "), ";
     ss << "type(" << m_deviceType << "), ";
     ss << "id(" << m_id << "), ";
     ss << "maybeAtFirstLevel(" << m_maybeAtFirstLevel << ")";
     if (m_deviceType == CAPACITOR) {
         ss << ", coupled(" << CoupledCap() << ")";
     }
+    if (IsComposite()) {
+        ss << ", " << (m_series ? "series" : "parallel") << "( ";
+        foreach (Device *member, m_members)
+            ss << member->Name().toStdString() << " ";
+        ss << ")";
+    }
     std::cout << ss.str() << std::endl;
-    foreach (Terminal *terminal, m_terminals.values())
-        terminal->Print();
+    for (int pin = 0; pin < m_terminalCount; ++ pin)
+        m_terminals[pin]->Print();
     std::cout << "******************************\n";
 }
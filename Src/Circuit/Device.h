@@ -13,10 +13,15 @@
 
 #include "Define/TypeDefine.h"
 #include "Define/Define.h"
+#include "Utilities/NamePool.h"
 
 class Terminal;
 class Wire;
 class SchematicDevice;
+class Arena;
+class CompactGraph;
+class ConnectorView;
+class NetIndex;
 
 /* defalut device orientation:
  * vertical :  +
@@ -31,47 +36,58 @@ class SchematicDevice;
 class Device
 {
 public:
-    Device(DeviceType, QString name);
+    Device(DeviceType, NamePool *pool, NameId name);
     ~Device();
 
-    int           AddTerminal(Terminal *terminal, TerminalType type);
+    int           AddTerminal(Terminal *terminal, int pin);
     void          SetValue(double value)    { m_value = value; }
+    double        Value() const             { return m_value; }
     void          SetId(int id)             { m_id = id; }
     int           Id() const                { return m_id; }
-    QString       Name() const              { return m_name; }
+    QString       Name() const              { return m_namePool->Name(m_nameId); }
+    NameId        GetNameId() const         { return m_nameId; }
+    NamePool*     GetNamePool() const       { return m_namePool.data(); }
     DeviceType    GetDeviceType() const     { return m_deviceType; }
-    void          AddConnectDevice(Device *dev);
     void          SetAsGroundCap(bool is)   { m_groundCap = is; }
     bool          GroundCap() const         { return m_groundCap; }
     bool          CoupledCap() const; 
     Terminal*     GetTerminal(TerminalType type) const;
     Terminal*     GetTerminal(Node *node) const;
-    void          DecideOrientationByPredecessors();
+    int           TerminalCount() const     { return m_terminalCount; }
+    Terminal*     TerminalAt(int pin) const { return m_terminals[pin]; }
+    void          DecideOrientationByPredecessors(const NetIndex *nets);
     Orientation   GetOrientation() const    { return m_orien; }
-    void          ClassifyConnectDeviceByLevel();
     void          SetLogicalRow(int row)    { m_logRow = row; }
     int           LogicalRow() const        { return m_logRow; }
     void          SetLevelId(int id)        { m_levelId = id; }
     int           LevelId() const           { return m_levelId; }
     int           LogicalCol() const        { return m_levelId; }
-    DeviceList    Predecessors() const      { return m_predecessors; }
-    DeviceList    Successors() const        { return m_successors; }
-    void          CalLogicalRowByPredecessors();
-    void          ClearConnectors();
+    DeviceList    Predecessors(const NetIndex *nets) const { return NeighborsAt(nets, m_levelId - 1); }
+    DeviceList    Successors(const NetIndex *nets) const   { return NeighborsAt(nets, m_levelId + 1); }
+    void          CalLogicalRowByPredecessors(const NetIndex *nets);
     void          SetMaybeAtFirstLevel(bool at) { m_maybeAtFirstLevel = at; }
     bool          MaybeAtFirstLevel() const     { return m_maybeAtFirstLevel; }
-    ConnectorList Connectors() const { return m_connectors; }
+    ConnectorView Connectors(const CompactGraph *graph) const;
+    ConnectorView Connectors(const CompactGraph *graph, int pin) const;
     bool          Reverse() const           { return m_reverse; }       
-    void          DecideReverseByPredecessors();
-    void          DecideReverseBySuccessors();
+    void          DecideReverseByPredecessors(const NetIndex *nets);
+    void          DecideReverseBySuccessors(const NetIndex *nets);
     void          SetGeometricalCol(int col) { m_geoCol = col; }
     int           GeometricalCol() const     { return m_geoCol; }
     void          SetGeometricalRow(int row) { m_geoRow = row; }
     int           GeometricalRow() const     { return m_geoRow; }
-    WireList      WiresFromPredecessors() const;
-    WireList      WiresToFellows() const;
+    WireList      WiresFromPredecessors(const NetIndex *nets, Arena *arena) const;
+    WireList      WiresToFellows(const NetIndex *nets, Arena *arena) const;
     TerminalList  GetTerminalList() const;
 
+    /* For CircuitGraph::Compress(), a composite stands for its members */
+    void          SetMembers(const DeviceList &members, bool series);
+    const DeviceList& Members() const       { return m_members; }
+    bool          IsComposite() const       { return NOT m_members.isEmpty(); }
+    bool          Series() const            { return m_series; }
+    void          SetComposite(Device *dev) { m_composite = dev; }
+    Device*       Composite() const         { return m_composite; }
+
     /* For creating SchematicWire */
     void                SetSchematicDevice(SchematicDevice *sDevice) { m_sDevice=sDevice;}
     SchematicDevice*    GetSchematicDevice() const { return m_sDevice; } 
@@ -82,10 +98,13 @@ private:
     DISALLOW_COPY_AND_ASSIGN(Device);
     bool    HasConnection(Terminal *otherTer, TerminalType thisType) const;
     qreal   RowDistance(Terminal *otherTer, TerminalType thisType) const;
-    bool    MaybeVertical() const;
+    bool    MaybeVertical(const NetIndex *nets) const;
+    DeviceList NeighborsAt(const NetIndex *nets, int level) const;
 
-    TerminalTable                     m_terminals;
-    QString                           m_name;
+    Terminal                         *m_terminals[MAX_DEVICE_TERMINALS]; // DeviceTraits pin order
+    int                               m_terminalCount;
+    NamePoolPtr                       m_namePool;
+    NameId                            m_nameId;
     double                            m_value;
     DeviceType                        m_deviceType;
     bool                              m_groundCap;
@@ -94,17 +113,18 @@ private:
     bool                              m_maybeAtFirstLevel;
     bool                              m_reverse; 
 
-    DeviceList                        m_predecessors; // previous level
-    DeviceList                        m_fellows;      // the same level
-    DeviceList                        m_successors;   // next level
     int                               m_levelId;
     int                               m_logRow;       // logical row, can be < 0
     int                               m_geoRow;
     int                               m_geoCol;
     Orientation                       m_orien;        // orientation : Horizontal/Vertical
-    ConnectorList                     m_connectors;
 
     SchematicDevice                  *m_sDevice; // For creating SchematicWire
+
+    /* members in chain order (series) or netlist order (parallel) */
+    DeviceList                        m_members;
+    bool                              m_series;
+    Device                           *m_composite;   // the composite holding it
 };
 
 #endif // NETLISTVIZ_CIRCUIT_DEVICE_H
@@ -0,0 +1,90 @@
+#ifndef NETLISTVIZ_CIRCUIT_DEVICETRAITS_H
+#define NETLISTVIZ_CIRCUIT_DEVICETRAITS_H
+
+/*
+ * @filename : DeviceTraits.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Compile-time table of what each DeviceType is, indexed by
+ *           : the enum. Pins are in netlist order (R n+ n-, M d g s b,
+ *           : Q c b e) and Device keeps terminals in that order. The two
+ *           : pins named by posPin/negPin are what the two-terminal ASG
+ *           : passes see as Positive/Negative, the others are wired only.
+ */
+
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+struct DeviceTraits
+{
+    char          letter;         // first letter of the netlist line, lower case
+    int           terminalCount;
+    TerminalType  pins[MAX_DEVICE_TERMINALS];
+    int           posPin;         // seen as Positive
+    int           negPin;         // seen as Negative
+    bool          hasValue;       // name nodes value, otherwise name nodes model
+    bool          expandsNets;    // the ASG level BFS goes on through its nets
+    bool          source;         // may be at first level if it is grounded
+};
+
+constexpr DeviceTraits DEVICE_TRAITS[] = {
+    /* RESISTOR */  { 'r', 2, { Positive, Negative },           0, 1, true,  true,  false },
+    /* CAPACITOR */ { 'c', 2, { Positive, Negative },           0, 1, true,  true,  false },
+    /* INDUCTOR */  { 'l', 2, { Positive, Negative },           0, 1, true,  true,  false },
+    /* ISRC */      { 'i', 2, { Positive, Negative },           0, 1, true,  true,  true  },
+    /* VSRC */      { 'v', 2, { Positive, Negative },           0, 1, true,  true,  true  },
+    /* MOSFET */    { 'm', 4, { Drain, Gate, Source, Bulk },    0, 2, false, true,  false },
+    /* BJT */       { 'q', 3, { Collector, Base, Emitter },     0, 2, false, true,  false },
+    /* GND */       { 0,   1, { General },                      0, 0, false, false, false },
+    /* Other */     { 0,   0, { },                              0, 0, false, false, false },
+};
+
+static_assert(sizeof(DEVICE_TRAITS) / sizeof(DEVICE_TRAITS[0]) == Other + 1,
+              "DEVICE_TRAITS must list every DeviceType");
+
+constexpr const DeviceTraits& Traits(DeviceType type)
+{
+    return DEVICE_TRAITS[type];
+}
+
+/* first letter (either case) of a netlist line to its device, Other if none */
+struct DeviceLetterTable
+{
+    DeviceType type[128];
+};
+
+constexpr DeviceLetterTable MakeDeviceLetterTable()
+{
+    DeviceLetterTable table = {};
+    for (int c = 0; c < 128; ++ c)
+        table.type[c] = Other;
+    for (int type = 0; type < Other; ++ type) {
+        char letter = DEVICE_TRAITS[type].letter;
+        if (letter == 0)
+            continue;
+        table.type[(int)letter] = static_cast<DeviceType>(type);
+        table.type[letter - 'a' + 'A'] = static_cast<DeviceType>(type);
+    }
+    return table;
+}
+
+constexpr DeviceLetterTable DEVICE_LETTERS = MakeDeviceLetterTable();
+
+constexpr DeviceType DeviceTypeByLetter(char c)
+{
+    return (c & 0x80) ? Other : DEVICE_LETTERS.type[(int)c];
+}
+
+/* Traits(T) as constants, for code sized by the device kind */
+template <DeviceType T>
+struct DeviceKind
+{
+    static constexpr int  TerminalCount = DEVICE_TRAITS[T].terminalCount;
+    static constexpr bool GroundCap = (T == CAPACITOR);
+    static constexpr bool Source = DEVICE_TRAITS[T].source;
+
+    static_assert(TerminalCount <= MAX_DEVICE_TERMINALS, "too many terminals");
+};
+
+#endif // NETLISTVIZ_CIRCUIT_DEVICETRAITS_H
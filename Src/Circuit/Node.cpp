@@ -4,9 +4,10 @@
 #include <QDebug>
 #include "Circuit/Device.h"
 
-Node::Node(QString name)
+Node::Node(NamePool *pool, NameId name)
+    : m_namePool(pool)
 {
-    m_name = name;
+    m_nameId = name;
     m_id = -1;
     m_isGnd = false;
 }
@@ -14,7 +15,7 @@ Node::Node(QString name)
 Node::~Node()
 {
 #ifdef TRACEx
-    qInfo() << LINE_INFO << "deleting node " << m_name << endl;
+    qInfo() << LINE_INFO << "deleting node " << Name() << endl;
 #endif
     m_deviceList.clear();
 }
@@ -27,7 +28,7 @@ void Node::AddDevice(Device *device)
 void Node::Print() const
 {
     std::stringstream ss;
-    ss << "Name(" << m_name.toStdString() << "), ";
+    ss << "Name(" << m_namePool->StdName(m_nameId) << "), ";
     ss << "id(" << m_id << "), ";
     ss << "Devices( ";
 
@@ -13,13 +13,14 @@
 #include "Define/Define.h"
 #include "Define/TypeDefine.h"
 #include <QString>
+#include "Utilities/NamePool.h"
 
 class Device;
 
 class Node
 {
 public:
-    explicit Node(QString name);
+    Node(NamePool *pool, NameId name);
     ~Node();
 
     void       SetId(int id)   { m_id = id; }
@@ -27,15 +28,18 @@ public:
     void       SetGnd(bool is) { m_isGnd = is; }
     bool       IsGnd() const   { return m_isGnd; }
     void       AddDevice(Device *device);
+    void       ClearDevices()  { m_deviceList.clear(); }
     DeviceList ConnectDeviceList() const { return m_deviceList; }
-    QString    Name() const    { return m_name; }
+    QString    Name() const    { return m_namePool->Name(m_nameId); }
+    NameId     GetNameId() const { return m_nameId; }
 
     void Print() const;
 
 private:
     DISALLOW_COPY_AND_ASSIGN(Node);
 
-    QString     m_name;
+    NamePoolPtr m_namePool;
+    NameId      m_nameId;
     int         m_id;
     bool        m_isGnd;
     DeviceList  m_deviceList;
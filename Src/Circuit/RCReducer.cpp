@@ -0,0 +1,309 @@
+#include "RCReducer.h"
+#include <algorithm>
+#include <cmath>
+#include <QDebug>
+#include <QSet>
+#include "CircuitGraph.h"
+#include "Device.h"
+#include "Node.h"
+#include "Terminal.h"
+
+RCReducer::RCReducer(CircuitGraph *ckt, double maxFrequency, double maxError)
+{
+    Q_ASSERT(ckt);
+    Q_ASSERT(maxFrequency > 0 AND maxError >= 0);
+    m_ckt = ckt;
+    m_maxTau = maxError / (2 * M_PI * maxFrequency);
+    m_eliminatedCount = 0;
+}
+
+RCReducer::~RCReducer()
+{
+}
+
+int RCReducer::Run()
+{
+    Build();
+
+    for (int node = 1; node < (int)m_nodes.size(); ++ node)
+        Evaluate(node);
+
+    /* quickest first, an entry is stale once its node is evaluated again */
+    while (NOT m_queue.empty()) {
+        QuickNode quick = m_queue.top();
+        m_queue.pop();
+        if (m_eliminated[quick.node] || quick.stamp != m_stamp[quick.node])
+            continue;
+        Eliminate(quick.node);
+    }
+
+    return CreateDevices();
+}
+
+DeviceList RCReducer::Devices() const
+{
+    DeviceList devList;
+    int edge = 0;
+    for (int dev = 0; dev < m_devices.size(); ++ dev) {
+        edge = m_deviceEdge[dev];
+        if (edge < 0 || (NOT m_edges[edge].dead AND NOT m_edges[edge].touched))
+            devList.push_back(m_devices.at(dev));
+    }
+    devList.append(m_created);
+    return devList;
+}
+
+int RCReducer::NodeOf(Device *device, int pin) const
+{
+    Terminal *terminal = device->TerminalAt(pin);
+    return terminal->NodeIsGnd() ? 0 : terminal->NodeId();
+}
+
+/*
+ * R and C are merged into one edge per node pair, by sorting, so a port of
+ * a million neighbours costs no more than a million small nodes. Other
+ * devices, first level devices and R or C of no value are kept as they
+ * are and their nodes are ports.
+ */
+void RCReducer::Build()
+{
+    m_devices = m_ckt->GetDeviceList();
+
+    int nodeCount = 1;
+    foreach (Node *node, m_ckt->GetNodeList())
+        nodeCount = qMax(nodeCount, node->Id() + 1);
+
+    m_nodes.assign(nodeCount, nullptr);
+    foreach (Node *node, m_ckt->GetNodeList()) {
+        if (NOT node->IsGnd())
+            m_nodes[node->Id()] = node;
+        else if (NOT m_nodes[0])
+            m_nodes[0] = node;
+    }
+    m_port.assign(nodeCount, 0);
+    m_eliminated.assign(nodeCount, 0);
+    m_degree.assign(nodeCount, 0);
+    m_groundEdge.assign(nodeCount, -1);
+    m_stamp.assign(nodeCount, 0);
+    m_neighbours.assign(nodeCount, std::vector<int>());
+
+    QSet<Device*> kept;
+    foreach (Device *device, m_ckt->FirstLevelDeviceList())
+        kept.insert(device);
+    foreach (NameId name, m_ckt->FirstLevelMarks()) {
+        Device *device = m_ckt->GetDevice(m_ckt->GetNamePool()->Name(name));
+        if (device)
+            kept.insert(device);
+    }
+
+    struct Branch { int node0, node1, dev; };
+    std::vector<Branch> branches;
+    m_deviceEdge.assign(m_devices.size(), -1);
+
+    int node0 = 0, node1 = 0;
+    for (int dev = 0; dev < m_devices.size(); ++ dev) {
+        Device *device = m_devices.at(dev);
+        DeviceType type = device->GetDeviceType();
+        bool rc = (type == RESISTOR || type == CAPACITOR) AND NOT device->IsComposite()
+                  AND device->Value() > 0 AND NOT kept.contains(device);
+        if (rc) {
+            node0 = NodeOf(device, 0);
+            node1 = NodeOf(device, 1);
+            if (node0 != node1) {
+                branches.push_back({qMin(node0, node1), qMax(node0, node1), dev});
+                continue;
+            }
+        }
+        for (int pin = 0; pin < device->TerminalCount(); ++ pin)
+            m_port[NodeOf(device, pin)] = 1;
+    }
+
+    std::sort(branches.begin(), branches.end(), [](const Branch &a, const Branch &b) {
+        return (a.node0 != b.node0) ? (a.node0 < b.node0) : (a.node1 < b.node1);
+    });
+
+    Device *device = nullptr;
+    for (size_t i = 0; i < branches.size(); ++ i) {
+        const Branch &branch = branches[i];
+        if (i == 0 || branch.node0 != branches[i - 1].node0 || branch.node1 != branches[i - 1].node1)
+            NewEdge(branch.node0, branch.node1, false);
+        Edge &edge = m_edges.back();
+        device = m_devices.at(branch.dev);
+        if (device->GetDeviceType() == RESISTOR)
+            edge.g += 1.0 / device->Value();
+        else
+            edge.c += device->Value();
+        m_deviceEdge[branch.dev] = m_edges.size() - 1;
+    }
+}
+
+/* ground has no list, the edge of a node to ground is kept aside */
+int RCReducer::FindEdge(int node0, int node1)
+{
+    if (node0 == 0)
+        return m_groundEdge[node1];
+    if (node1 == 0)
+        return m_groundEdge[node0];
+
+    if (m_neighbours[node1].size() < m_neighbours[node0].size())
+        std::swap(node0, node1);
+    for (int edge : Neighbours(node0)) {
+        if (m_edges[edge].node0 == node1 || m_edges[edge].node1 == node1)
+            return edge;
+    }
+    return -1;
+}
+
+int RCReducer::NewEdge(int node0, int node1, bool touched)
+{
+    int edge = m_edges.size();
+    m_edges.push_back({node0, node1, 0, 0, false, touched});
+    for (int node : {node0, node1}) {
+        if (node == 0) continue;
+        m_neighbours[node].push_back(edge);
+        m_degree[node]++;
+    }
+    if (node0 == 0)
+        m_groundEdge[node1] = edge;
+    else if (node1 == 0)
+        m_groundEdge[node0] = edge;
+    return edge;
+}
+
+/* an edge added to is rewired, its devices are created again */
+void RCReducer::AddEdge(int node0, int node1, double g, double c)
+{
+    int edge = FindEdge(node0, node1);
+    if (edge < 0)
+        edge = NewEdge(node0, node1, true);
+
+    Edge &e = m_edges[edge];
+    e.g += g;
+    e.c += c;
+    e.touched = true;
+}
+
+const std::vector<int>& RCReducer::Neighbours(int node)
+{
+    std::vector<int> &edges = m_neighbours[node];
+    edges.erase(std::remove_if(edges.begin(), edges.end(), [this](int edge) {
+        return m_edges[edge].dead;
+    }), edges.end());
+    return edges;
+}
+
+/* a quick node is queued with its tau, other nodes are only restamped */
+void RCReducer::Evaluate(int node)
+{
+    m_stamp[node]++;
+    if (node == 0 || NOT m_nodes[node] || m_port[node] || m_eliminated[node])
+        return;
+    if (m_degree[node] > TICER_MAX_DEGREE)
+        return;
+
+    double g = 0, c = 0;
+    for (int edge : Neighbours(node)) {
+        g += m_edges[edge].g;
+        c += m_edges[edge].c;
+    }
+    /* a node of caps only has no tau */
+    if (g <= 0 || c / g > m_maxTau)
+        return;
+    /* the circuit must not grow, new node pairs are at most the edges removed */
+    if (Fill(node) > m_degree[node])
+        return;
+
+    m_queue.push({c / g, node, m_stamp[node]});
+}
+
+/* node pairs Eliminate() would connect that are not connected yet */
+int RCReducer::Fill(int node)
+{
+    std::vector<int> edges = Neighbours(node);
+    std::vector<int> others;
+    for (int edge : edges)
+        others.push_back(m_edges[edge].node0 == node ? m_edges[edge].node1 : m_edges[edge].node0);
+
+    int fill = 0;
+    for (size_t a = 0; a < edges.size(); ++ a) {
+        for (size_t b = a + 1; b < edges.size(); ++ b) {
+            if (m_edges[edges[a]].g == 0 AND m_edges[edges[b]].g == 0)
+                continue;
+            if (FindEdge(others[a], others[b]) < 0)
+                fill++;
+        }
+    }
+    return fill;
+}
+
+void RCReducer::Eliminate(int node)
+{
+    std::vector<int> edges = Neighbours(node);
+    std::vector<int> others;
+    double total = 0;
+    for (int edge : edges) {
+        others.push_back(m_edges[edge].node0 == node ? m_edges[edge].node1 : m_edges[edge].node0);
+        total += m_edges[edge].g;
+    }
+    Q_ASSERT(total > 0);
+
+    double g = 0, c = 0;
+    for (size_t a = 0; a < edges.size(); ++ a) {
+        const Edge ea = m_edges[edges[a]];
+        for (size_t b = a + 1; b < edges.size(); ++ b) {
+            const Edge eb = m_edges[edges[b]];
+            g = ea.g * eb.g / total;
+            c = (ea.g * eb.c + eb.g * ea.c) / total;
+            if (g > 0 || c > 0)
+                AddEdge(others[a], others[b], g, c);
+        }
+    }
+
+    for (size_t a = 0; a < edges.size(); ++ a) {
+        m_edges[edges[a]].dead = true;
+        if (others[a] != 0)
+            m_degree[others[a]]--;
+        else
+            m_groundEdge[node] = -1;
+    }
+    m_eliminated[node] = 1;
+    m_degree[node] = 0;
+    m_eliminatedCount++;
+
+    for (int other : others)
+        Evaluate(other);
+}
+
+/* one R and one C per rewired node pair, named after the pair, i.e. R(n1,n2) */
+int RCReducer::CreateDevices()
+{
+    m_created.clear();
+
+    QString pair;
+    Node *nodes[MAX_DEVICE_TERMINALS] = { nullptr };
+    for (const Edge &edge : m_edges) {
+        if (edge.dead || NOT edge.touched)
+            continue;
+        nodes[0] = m_nodes[edge.node0];
+        nodes[1] = m_nodes[edge.node1];
+        Q_ASSERT(nodes[0] AND nodes[1]);
+        pair = "(" + nodes[0]->Name() + "," + nodes[1]->Name() + ")";
+
+        for (DeviceType type : {RESISTOR, CAPACITOR}) {
+            double value = (type == RESISTOR) ? edge.g : edge.c;
+            if (value <= 0) continue;
+            if (type == RESISTOR)
+                value = 1.0 / value;
+
+            QString name = ((type == RESISTOR) ? "R" : "C") + pair;
+            /* never a netlist name */
+            while (m_ckt->GetDevice(name))
+                name += "'";
+            if (m_ckt->InsertDevice(type, m_ckt->InternName(name.toStdString()), nodes, value))
+                return ERROR;
+            m_created.push_back(m_ckt->GetDevice(name));
+        }
+    }
+
+    return OKAY;
+}
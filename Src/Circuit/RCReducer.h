@@ -0,0 +1,96 @@
+#ifndef NETLISTVIZ_CIRCUIT_RCREDUCER_H
+#define NETLISTVIZ_CIRCUIT_RCREDUCER_H
+
+/*
+ * @filename : RCReducer.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : TICER node elimination of a flat RC circuit, run by
+ *           : CircuitGraph::ReduceRC(). A node touched by R and C only
+ *           : has time constant tau = C / G (its caps over its
+ *           : conductances). A quick node, tau <= error / (2 pi fmax),
+ *           : is eliminated quickest first: every pair (i, j) of its
+ *           : neighbours gets g_i g_j / G more conductance and
+ *           : (g_i c_j + g_j c_i) / G more capacitance, ground being a
+ *           : neighbour as any other. Nodes of other devices are ports
+ *           : and stay, so does a node whose elimination would connect
+ *           : more new node pairs than it has edges. Edges are merged per
+ *           : node pair and kept in sparse neighbour lists, nodes of more
+ *           : than TICER_MAX_DEGREE neighbours are not eliminated, so a
+ *           : step costs O(TICER_MAX_DEGREE^2) and the pass O(n log n).
+ */
+
+#include <vector>
+#include <queue>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class CircuitGraph;
+
+class RCReducer
+{
+public:
+    RCReducer(CircuitGraph *ckt, double maxFrequency, double maxError);
+    ~RCReducer();
+
+    int        Run();
+    /* devices left in netlist order, then the rewired R and C */
+    DeviceList Devices() const;
+    int        EliminatedCount() const { return m_eliminatedCount; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(RCReducer);
+
+    struct Edge
+    {
+        int     node0;
+        int     node1;
+        double  g;
+        double  c;
+        bool    dead;         // a node of it is eliminated
+        bool    touched;      // rewired, its devices are replaced
+    };
+
+    struct QuickNode
+    {
+        double  tau;
+        int     node;
+        int     stamp;
+        bool operator<(const QuickNode &other) const { return tau > other.tau; }
+    };
+
+    int    NodeOf(Device *device, int pin) const;
+    void   Build();
+    int    FindEdge(int node0, int node1);
+    int    NewEdge(int node0, int node1, bool touched);
+    void   AddEdge(int node0, int node1, double g, double c);
+    const std::vector<int>& Neighbours(int node);
+    void   Evaluate(int node);
+    int    Fill(int node);
+    void   Eliminate(int node);
+    int    CreateDevices();
+
+    CircuitGraph          *m_ckt;
+    double                 m_maxTau;
+    int                    m_eliminatedCount;
+
+    /* by device position in CircuitGraph::GetDeviceList() */
+    DeviceList             m_devices;
+    std::vector<int>       m_deviceEdge;     // -1, kept as it is
+
+    /* by node id, ground is node 0 and has no list */
+    std::vector<Node*>             m_nodes;
+    std::vector<quint8>            m_port;
+    std::vector<quint8>            m_eliminated;
+    std::vector<int>               m_degree;       // live edges, ground edge included
+    std::vector<int>               m_groundEdge;
+    std::vector<int>               m_stamp;
+    std::vector<std::vector<int>>  m_neighbours;   // edges, dead ones dropped when read
+
+    std::vector<Edge>              m_edges;
+    std::priority_queue<QuickNode> m_queue;
+    DeviceList                     m_created;
+};
+
+#endif // NETLISTVIZ_CIRCUIT_RCREDUCER_H
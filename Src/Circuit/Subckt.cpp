@@ -0,0 +1,66 @@
+#include "Subckt.h"
+#include "DeviceTraits.h"
+
+Subckt::Subckt(std::string_view name)
+    : m_name(name)
+{
+    m_portCount = 0;
+}
+
+Subckt::~Subckt()
+{
+}
+
+int Subckt::AddPort(std::string_view node)
+{
+    Q_ASSERT(m_elements.empty() && m_calls.empty());
+
+    if (m_nodeIndex.find(std::string(node)) != m_nodeIndex.end())
+        return ERROR;
+
+    NodeIndex(node);
+    m_portCount++;
+    return OKAY;
+}
+
+void Subckt::AddElement(DeviceType type, std::string_view name,
+        const std::string_view *nodeNames, double value)
+{
+    SubcktElement element;
+    element.name = name;
+    element.type = type;
+    for (int pin = 0; pin < Traits(type).terminalCount; ++ pin)
+        element.nodes[pin] = NodeIndex(nodeNames[pin]);
+    element.value = value;
+    m_elements.push_back(element);
+}
+
+void Subckt::AddCall(std::string_view name, std::string_view subckt,
+        const std::string_view *nodes, int nodeCount)
+{
+    SubcktCall call;
+    call.name = name;
+    call.subckt = subckt;
+    call.nodes.reserve(nodeCount);
+    for (int i = 0; i < nodeCount; ++ i)
+        call.nodes.push_back(NodeIndex(nodes[i]));
+    m_calls.push_back(call);
+}
+
+int Subckt::NodeIndex(std::string_view node)
+{
+    std::string key(node);
+    auto finder = m_nodeIndex.find(key);
+    if (finder != m_nodeIndex.end())
+        return finder->second;
+
+    int index = m_nodeNames.size();
+    m_nodeNames.push_back(key);
+    m_nodeIndex.emplace(key, index);
+    return index;
+}
+
+QString Subckt::Key(std::string_view name)
+{
+    return QString::fromUtf8(name.data(), name.size()).toLower();
+}
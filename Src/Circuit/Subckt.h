@@ -0,0 +1,78 @@
+#ifndef NETLISTVIZ_CIRCUIT_SUBCKT_H
+#define NETLISTVIZ_CIRCUIT_SUBCKT_H
+
+/*
+ * @filename : Subckt.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : One .subckt definition, parsed once and kept as a template.
+ *           : Element lines and X instance lines of the body are stored
+ *           : with definition-local node indexes, ports are nodes
+ *           : 0 .. PortCount()-1. CircuitGraph::Flatten() expands the
+ *           : instances into devices when ASG needs them.
+ */
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+/* R/C/L/I/V/M/Q line of the body, nodes in DeviceTraits pin order */
+struct SubcktElement
+{
+    std::string  name;
+    DeviceType   type;
+    int          nodes[MAX_DEVICE_TERMINALS];
+    double       value;
+};
+
+/* X line, nodes are local indexes of the calling definition */
+struct SubcktCall
+{
+    std::string       name;
+    std::string       subckt;
+    std::vector<int>  nodes;
+};
+
+class Subckt
+{
+public:
+    explicit Subckt(std::string_view name);
+    ~Subckt();
+
+    const std::string& Name() const { return m_name; }
+
+    /* ports must come before the body, ERROR if a port is repeated */
+    int  AddPort(std::string_view node);
+    void AddElement(DeviceType type, std::string_view name,
+                    const std::string_view *nodeNames, double value);
+    void AddCall(std::string_view name, std::string_view subckt,
+                 const std::string_view *nodes, int nodeCount);
+
+    int                 PortCount() const { return m_portCount; }
+    int                 NodeCount() const { return m_nodeNames.size(); }
+    const std::string&  NodeName(int index) const { return m_nodeNames.at(index); }
+    const std::vector<SubcktElement>& Elements() const { return m_elements; }
+    const std::vector<SubcktCall>&    Calls() const { return m_calls; }
+    void                ClearCalls() { m_calls.clear(); }
+
+    /* SPICE names are case-insensitive, the SubcktTable key */
+    static QString Key(std::string_view name);
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(Subckt);
+
+    int  NodeIndex(std::string_view node);
+
+    std::string                           m_name;
+    int                                   m_portCount;
+    std::vector<std::string>              m_nodeNames;
+    std::unordered_map<std::string, int>  m_nodeIndex;
+    std::vector<SubcktElement>            m_elements;
+    std::vector<SubcktCall>               m_calls;
+};
+
+#endif // NETLISTVIZ_CIRCUIT_SUBCKT_H
@@ -16,14 +16,6 @@ Terminal::Terminal(Node *node)
     m_sTerminal = nullptr;
 }
 
-Terminal::~Terminal()
-{
-#ifdef TRACEx
-    qInfo() << LINE_INFO << "deleting terminal" << endl;
-#endif
-    m_node = nullptr;
-}
-
 int Terminal::NodeId() const
 {
     return m_node->Id();
@@ -43,16 +35,19 @@ qreal Terminal::LogicalRelRow() const
         return row;
     }
 
+    /* the upper one is Positive, or what a MOSFET/BJT has as Positive */
+    bool positive = (m_device->GetTerminal(Positive) == this);
+
     /* vertical && not reverse */
     if (NOT m_device->Reverse()) {
-        if (m_type == Positive)
+        if (positive)
             return (row - 0.5);
         else
             return (row + 0.5);
     }
 
     /* vertical && reverse */
-    if (m_type == Positive)
+    if (positive)
         return (row + 0.5);
     else
         return (row - 0.5);
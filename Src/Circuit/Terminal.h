@@ -22,7 +22,6 @@ class Terminal
 {
 public:
     explicit Terminal(Node *node);
-    ~Terminal();
 
     void         SetId(int id)   { m_id = id; }
     int          Id() const      { return m_id; }
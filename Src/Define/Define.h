@@ -48,12 +48,81 @@ const static int Scene_H = Scene_Margin + 2 * Scene_Available;
 /* For SchematicWire */
 const static int DFT_Wire_W = 2; 
 
-/* For Simulated Annealing */
-// const static double SA_INIT_T = 1e3;
-// const static double SA_END_T = 0.01;
-// const static double SA_ALPHA = 0.98;
+/* For Simulated Annealing, the hottest replica cools from INIT_T by ALPHA a round, the coldest stays at END_T */
+const static double SA_INIT_T = 1e3;
+const static double SA_END_T = 0.01;
+const static double SA_ALPHA = 0.98;
+/* For Simulated Annealing, replicas at once (parallel tempering), their moves a round at most */
+const static int SA_REPLICAS = 8;
+const static int SA_MAX_ROUND_MOVES = 1 << 16;
+/* For Simulated Annealing, moves of a replica between two reads of the clock, a power of 2 */
+const static int SA_CLOCK_MOVES = 1 << 12;
+/* For Simulated Annealing, cost of one crossing in rows of wire, and time (ms) of a placement */
+const static double SA_CROSSING_COST = 8;
+const static int SA_TIME_BUDGET_MS = 5000;
+
+/* For Parser, netlists at least this big are scanned by MmapScanner */
+const static long long MMAP_SCAN_MIN_BYTES = 16LL << 20;
+/* For Parser, MmapScanner gives each thread at least this many bytes */
+const static long long MMAP_SCAN_CHUNK_BYTES = 4LL << 20;
+/* For Parser, netlists at least this big get a NetlistCache snapshot */
+const static long long NETLIST_CACHE_MIN_BYTES = 4LL << 20;
+
+/* For Parser, .include files nested deeper than this are rejected */
+const static int MAX_INCLUDE_DEPTH = 16;
+/* For CircuitGraph, .subckt instances nested deeper than this are recursive */
+const static int MAX_SUBCKT_DEPTH = 64;
+
+/* For Device, terminals are inline, MOSFET has the most (d g s b) */
+const static int MAX_DEVICE_TERMINALS = 4;
+
+/* For Arena, bytes of one block, bigger objects get a block of their own */
+const static long long ARENA_BLOCK_BYTES = 1LL << 20;
 
 /* For Channel */
 const static int MAX_ONE_COL_WIRE_COUNT = 10;
 
+/* For LevelBFS, a step over fewer terminals than this runs on one thread */
+const static long long BFS_PARALLEL_MIN_TERMINALS = 1LL << 15;
+/* For LevelBFS, bottom-up once terminals of claimed nets > unvisited terminals / ALPHA */
+const static int BFS_TOP_DOWN_ALPHA = 14;
+/* For LevelBFS, top-down again once frontier devices < devices / BETA */
+const static int BFS_BOTTOM_UP_BETA = 24;
+
+/* For Component, components with fewer devices than this run on one thread */
+const static int COMPONENT_PARALLEL_MIN_DEVICES = 1 << 12;
+/* For Component, empty cols and rows between packed components */
+const static int COMPONENT_PACK_GAP_COL = 1;
+const static int COMPONENT_PACK_GAP_ROW = 2;
+
+/* For GraphStats, predicted cost of one unit of an ASG stage, on one core */
+const static double STATS_NS_PER_BFS_TERMINAL = 5;
+const static double STATS_NS_PER_TERMINAL = 300;
+const static double STATS_NS_PER_ROW_WIDTH_SQUARE = 0.5;
+const static double STATS_NS_PER_TRACK_WIDTH_SQUARE = 30;
+const static double STATS_NS_PER_SCENE_ITEM = 5000;
+const static long long STATS_BYTES_PER_SCENE_ITEM = 1LL << 10;
+/* For GraphStats, ASG is stopped beyond this many bytes, warned beyond this many seconds */
+const static long long STATS_MAX_BYTES = 8LL << 30;
+const static double STATS_SLOW_SECONDS = 60;
+
+/* For RCReducer, nodes with more neighbours are not eliminated (fill-in) */
+const static int TICER_MAX_DEGREE = 8;
+/* For RCReducer, default bandwidth (Hz) and error of the node elimination */
+const static double TICER_DFT_FREQUENCY = 1e9;
+const static double TICER_DFT_ERROR = 0.05;
+
+/* For first levels, a component with more port devices than this starts at a peripheral device */
+const static int FL_MAX_PORT_DEVICES = 8;
+/* For first levels, BFS sweeps to find a peripheral device (George-Liu) */
+const static int FL_PERIPHERAL_SWEEPS = 4;
+
+/* For CrossingReducer, a net of more device pairs between two levels is no edge */
+const static long long CROSS_MAX_NET_PAIRS = 1LL << 10;
+/* For CrossingReducer, down and up sweeps of one component, and their time (ms) */
+const static int CROSS_MAX_SWEEPS = 8;
+const static int CROSS_TIME_BUDGET_MS = 2000;
+/* For CrossingReducer, keys of a level with fewer devices than this are on one thread */
+const static int CROSS_PARALLEL_MIN_DEVICES = 1 << 14;
+
 #endif //NETLISTVIZ_DEFINE_DEFINE_H
@@ -10,20 +10,24 @@
 #define NETLISTVIZ_DEFINE_TYPEDEFINE_H
 
 #include <QMap>
+#include <QHash>
 #include <QVector>
 #include <QString>
 
-/* For terminal */
-enum TerminalType { Positive = 0, Negative, General };
+/* For terminal, two-terminal devices have Positive/Negative, gnd has General */
+enum TerminalType { Positive = 0, Negative, General,
+                    Drain, Gate, Source, Bulk, Collector, Base, Emitter };
 
-/* Device Type */
-enum DeviceType { RESISTOR = 0, CAPACITOR, INDUCTOR, ISRC, VSRC, GND, Other };
+/* Device Type, see Circuit/DeviceTraits.h */
+enum DeviceType { RESISTOR = 0, CAPACITOR, INDUCTOR, ISRC, VSRC, MOSFET, BJT, GND, Other };
 
 /* Orientation */
 enum Orientation { Horizontal, Vertical };
 
 /* ASG Dialog */
 enum IgnoreCap { IgnoreGCap = 0, IgnoreCCap, IgnoreGCCap, IgnoreNoCap };
+/* ASG Dialog, device ids before ASG, see CircuitGraph::Renumber() */
+enum DeviceOrder { NetlistOrder = 0, RCMOrder, BFSOrder };
 
 /* Circuit Containers */
 class Device;
@@ -33,9 +37,12 @@ class Wire;
 struct Connector;
 class Channel;
 class Level;
+class Component;
 class Dot;
-typedef QMap<QString, Device*>          DeviceTable;
-typedef QMap<QString, Node*>            NodeTable;
+class Subckt;
+typedef QHash<quint32, Device*>         DeviceTable;   // by NameId
+typedef QHash<quint32, Node*>           NodeTable;     // by NameId
+typedef QHash<QString, Subckt*>         SubcktTable;   // by lower case name
 typedef QVector<Device*>                DeviceList;
 typedef QVector<Node*>                  NodeList;
 typedef QMap<TerminalType, Terminal*>   TerminalTable;
@@ -45,6 +52,7 @@ typedef QMap<QString, Wire*>            WireTable;
 typedef QVector<Connector*>             ConnectorList;
 typedef QVector<Channel*>               ChannelList;
 typedef QVector<Level*>                 LevelList;
+typedef QVector<Component*>             ComponentList;
 typedef QVector<Dot*>                   DotList;
 
 /* Schematic Containers */
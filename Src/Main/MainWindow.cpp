@@ -15,6 +15,9 @@
 #include "Schematic/NetlistDialog.h"
 #include "Parser/MyParser.h"
 #include "ASG/ASG.h"
+#include "ASG/GraphStats.h"
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/Device.h"
 #include "Schematic/ASGDialog.h"
 
 const int DEV_ICON_SIZE = 30;
@@ -65,6 +68,8 @@ void MainWindow::InitVariables()
     m_netlistDialog = new NetlistDialog();
 
     m_asgPropertySelected = false;
+    m_reduceFrequency = TICER_DFT_FREQUENCY;
+    m_reduceError = TICER_DFT_ERROR;
     m_asgDialog = nullptr;
 }
 
@@ -360,6 +365,10 @@ void MainWindow::CreateActions()
     m_deleteAction->setStatusTip(tr("Delete item from Scene"));
     connect(m_deleteAction, &QAction::triggered, this, &MainWindow::DeleteItem);
 
+    m_expandAction = new QAction(tr("&Expand Composite"), this);
+    m_expandAction->setStatusTip(tr("Lay out the members of the selected composites"));
+    connect(m_expandAction, &QAction::triggered, this, &MainWindow::ExpandCompositeTriggered);
+
     m_exitAction = new QAction(tr("E&xit"), this);
     m_exitAction->setShortcuts(QKeySequence::Quit);
     m_exitAction->setStatusTip(tr("Quit netlisviz"));
@@ -437,6 +446,22 @@ void MainWindow::CreateActions()
     m_asgPropertyAction->setEnabled(false);
     connect(m_asgPropertyAction, &QAction::triggered, this, &MainWindow::ASGPropertyTriggered);
 
+    m_compressAction = new QAction(tr("Compress Series/Parallel"), this);
+    m_compressAction->setCheckable(true);
+    m_compressAction->setChecked(false);
+    m_compressAction->setStatusTip(tr("Fold series chains and parallel bundles before ASG"));
+
+    m_reduceRCAction = new QAction(tr("Reduce RC Nodes..."), this);
+    m_reduceRCAction->setCheckable(true);
+    m_reduceRCAction->setChecked(false);
+    m_reduceRCAction->setStatusTip(tr("Eliminate quick internal RC nodes (TICER) before ASG"));
+    connect(m_reduceRCAction, &QAction::toggled, this, &MainWindow::ReduceRCToggled);
+
+    m_annealAction = new QAction(tr("Anneal Placement"), this);
+    m_annealAction->setCheckable(true);
+    m_annealAction->setChecked(false);
+    m_annealAction->setStatusTip(tr("Refine logical placement by simulated annealing"));
+
     m_logPlaceAction = new QAction(QIcon(":/images/log_place.png"), tr("Logical Placement"), this);
     m_logPlaceAction->setEnabled(false);
     connect(m_logPlaceAction, &QAction::triggered, this, &MainWindow::LogicalPlacement);
@@ -489,6 +514,8 @@ void MainWindow::CreateMenus()
     m_editMenu->addSeparator();
     m_editMenu->addAction(m_toFrontAction);
     m_editMenu->addAction(m_sendBackAction);
+    m_editMenu->addSeparator();
+    m_editMenu->addAction(m_expandAction);
 
     m_viewMenu = menuBar()->addMenu(tr("&View"));
     m_viewMenu->addAction(m_devicePanelDockWidget->toggleViewAction());
@@ -504,6 +531,9 @@ void MainWindow::CreateMenus()
 
     m_asgMenu = menuBar()->addMenu(tr("&ASG"));
     m_asgMenu->addAction(m_parseNetlistAction);
+    m_asgMenu->addAction(m_reduceRCAction);
+    m_asgMenu->addAction(m_compressAction);
+    m_asgMenu->addAction(m_annealAction);
     m_asgMenu->addAction(m_asgPropertyAction);
     m_asgMenu->addAction(m_logPlaceAction);
     m_asgMenu->addAction(m_logRouteAction);
@@ -685,7 +715,9 @@ void MainWindow::OpenNetlist()
 
     QString fileName;
     QString fileFilters;
-    fileFilters = tr("Netlist files (*.sp)\n" "All files (*)");
+    fileFilters = tr("Netlist files (*.sp)\n"
+                     "Parasitic files (*.spef *.dspf *.spf)\n"
+                     "All files (*)");
 
     fileName = QFileDialog::getOpenFileName(this, tr("Open Netlist..."),
                             m_curNetlistPath, fileFilters);
@@ -711,6 +743,8 @@ void MainWindow::NetlistChangedSlot()
     m_geoRouteAction->setEnabled(true);
 
     m_asgPropertySelected = false;
+    m_expandedNames.clear();
+    m_compositeNames.clear();
 }
 
 void MainWindow::OpenSchematic()
@@ -839,6 +873,15 @@ void MainWindow::ParseNetlist()
     qInfo() << LINE_INFO << endl;
 #endif
 
+    if (ParseNetlistFile())
+        return;
+
+    ShowInfoMsg(tr("Parse Netlist successfully."));
+}
+
+/* m_ckt is nullptr if parsing failed */
+int MainWindow::ParseNetlistFile()
+{
     /* After Geometrical Routing, the CircuitGraph had destroyed */
     // if (m_ckt) delete m_ckt;
 
@@ -850,14 +893,63 @@ void MainWindow::ParseNetlist()
     int error = parser.ParseNetlist(m_curNetlistFile.toStdString(), m_ckt);
     if (error) {
         delete m_ckt;
+        m_ckt = nullptr;
         ShowCriticalMsg(tr("Parse Netlist failed."));
-        return;
+        return ERROR;
     }
 
 #ifdef DEBUGx
     m_ckt->PrintCircuit();
 #endif
-    ShowInfoMsg(tr("Parse Netlist successfully."));
+    return OKAY;
+}
+
+/*
+ * after Flatten(), quick RC nodes are eliminated first, then composites not
+ * named in m_expandedNames are folded. Both run once per parse, opening
+ * ASGDialog again keeps the graph and takes the composites it has.
+ */
+int MainWindow::CompressCircuit()
+{
+    int error = OKAY;
+    if (m_reduceRCAction->isChecked()) {
+        error = m_ckt->ReduceRC(m_reduceFrequency, m_reduceError);
+        if (error)
+            return ERROR;
+    }
+
+    if (m_compressAction->isChecked()) {
+        error = m_ckt->Compress(m_expandedNames);
+        if (error)
+            return ERROR;
+    }
+
+    m_compositeNames.clear();
+    foreach (Device *dev, m_ckt->GetDeviceList()) {
+        if (dev->IsComposite())
+            m_compositeNames.insert(dev->Name());
+    }
+
+    return OKAY;
+}
+
+/* the error bound is asked for when turned on, cancel turns it off again */
+void MainWindow::ReduceRCToggled(bool checked)
+{
+    if (NOT checked)
+        return;
+
+    bool ok = false;
+    double frequency = QInputDialog::getDouble(this, tr("Reduce RC Nodes"),
+                           tr("Max frequency of interest (MHz):"), m_reduceFrequency / 1e6,
+                           1e-6, 1e9, 3, &ok);
+    if (ok) {
+        m_reduceFrequency = frequency * 1e6;
+        m_reduceError = QInputDialog::getDouble(this, tr("Reduce RC Nodes"),
+                            tr("Error bound (0.01 is 1%):"), m_reduceError, 0, 1, 4, &ok);
+    }
+    if (NOT ok)
+        m_reduceRCAction->setChecked(false);
 }
 
 void MainWindow::ShowCriticalMsg(const QString &msg)
@@ -870,6 +962,13 @@ void MainWindow::ShowInfoMsg(const QString &msg)
     QMessageBox::information(this, tr("Information"), msg);
 }
 
+/* the count of the level orders found, after annealing if it ran */
+void MainWindow::ShowCrossings()
+{
+    statusBar()->showMessage(tr("Crossings between levels : %1 -> %2")
+                             .arg(m_asg->CrossingsBefore()).arg(m_asg->CrossingsAfter()));
+}
+
 void MainWindow::ScrollActionToggled(bool checked)
 {
     if (checked) {
@@ -890,14 +989,26 @@ void MainWindow::ASGPropertyTriggered()
 #endif
 
     Q_ASSERT(m_ckt);
+
+    /* .subckt instances are expanded only now, ASG works on flat devices */
+    if (m_ckt->Flatten()) {
+        ShowCriticalMsg(tr("Flatten subcircuits failed."));
+        return;
+    }
+
+    if (CompressCircuit()) {
+        ShowCriticalMsg(tr("Compress circuit failed."));
+        return;
+    }
+
     if (m_asgDialog) delete m_asgDialog;
     m_asgDialog = new ASGDialog();
 
     if (m_asg) delete m_asg;
     m_asg = new ASG(m_ckt);
 
-    m_asgDialog->SetCircuitGraph(m_ckt);
     m_asgDialog->SetASG(m_asg);
+    m_asgDialog->SetCircuitGraph(m_ckt);
 
     m_asgDialog->show();
     m_asgPropertySelected = true;
@@ -909,26 +1020,154 @@ void MainWindow::LogicalPlacement()
     qInfo() << LINE_INFO << endl;
 #endif
 
+    /* without ASGDialog, take .FIRSTLEVEL devices, else ASG finds first levels */
+    bool destroyed = m_asg AND m_asg->DataDestroyed();
+    if (NOT m_asgPropertySelected AND m_ckt AND NOT destroyed) {
+        if (m_ckt->Flatten() || CompressCircuit()) {
+            ShowCriticalMsg(tr("Prepare circuit failed."));
+            return;
+        }
+        if (m_ckt->HasFirstLevelMarks() AND m_ckt->ApplyFirstLevelMarks()) {
+            ShowCriticalMsg(tr("Apply .FIRSTLEVEL devices failed."));
+            return;
+        }
+        if (m_asg) delete m_asg;
+        m_asg = new ASG(m_ckt);
+        m_asgPropertySelected = true;
+    }
+
+    if (NOT m_asg) {
+        ShowCriticalMsg(tr("Please Select ASG Properties firstly!"));
+        return;
+    }
+
     if (m_asg->DataDestroyed()) {
         ShowCriticalMsg(tr("[ERROR] Data has been destroyed, parse netlist again"));
         return;
     }
 
-    if (m_ckt->FirstLevelDeviceListSize() < 1) {
-        ShowCriticalMsg(tr("Please select first level device(s)"));
-        m_asgPropertySelected = false;
+    if (NOT m_asgPropertySelected) {
+        ShowCriticalMsg(tr("Please Select ASG Properties firstly!"));
+        return;
+    }
+
+    if (NOT ASGCostAccepted())
+        return;
+
+    /* kept for ExpandCompositeTriggered(), the circuit is gone after ASG */
+    m_firstLevelNames.clear();
+    foreach (Device *dev, m_ckt->FirstLevelDeviceList())
+        m_firstLevelNames << dev->Name();
+
+    int error = m_asg->LogicalPlacement();
+    if (NOT error AND m_annealAction->isChecked())
+        error = m_asg->AnnealPlacement(SA_TIME_BUDGET_MS);
+    if (error) {
+        ShowCriticalMsg(tr("[ERROR ASG] Logicl Placement failed."));
         return;
     }
+    ShowCrossings();
+}
 
-    if (NOT m_asgPropertySelected) {
+/* the circuit is parsed and laid out again, the selected composites stay open */
+void MainWindow::ExpandCompositeTriggered()
+{
+    bool expanded = false;
+    SchematicDevice *device = nullptr;
+    foreach (QGraphicsItem *item, m_scene->selectedItems()) {
+        if (item->type() != SchematicDevice::Type)
+            continue;
+        device = qgraphicsitem_cast<SchematicDevice *>(item);
+        if (m_compositeNames.contains(device->Name())) {
+            m_expandedNames.insert(device->Name());
+            expanded = true;
+        }
+    }
+
+    if (NOT expanded) {
+        ShowInfoMsg(tr("Please select composite device(s) to expand."));
+        return;
+    }
+
+    RerunASG();
+}
+
+/* parse, compress and lay out with the ASG properties of the last run */
+void MainWindow::RerunASG()
+{
+    if (NOT m_asg) {
         ShowCriticalMsg(tr("Please Select ASG Properties firstly!"));
         return;
     }
 
+    IgnoreCap ignore = m_asg->IgnoreCapType();
+    DeviceOrder order = m_asg->GetDeviceOrder();
+
+    if (ParseNetlistFile())
+        return;
+
+    if (m_ckt->Flatten()) {
+        ShowCriticalMsg(tr("Flatten subcircuits failed."));
+        return;
+    }
+
+    /* before compressing, a folded first level device is its composite */
+    DeviceList devList;
+    Device *dev = nullptr;
+    foreach (const QString &name, m_firstLevelNames) {
+        dev = m_ckt->GetDevice(name);
+        if (dev)
+            devList.push_back(dev);
+    }
+    m_ckt->SetFirstLevelDeviceList(devList);
+
+    if (CompressCircuit()) {
+        ShowCriticalMsg(tr("Compress circuit failed."));
+        return;
+    }
+
+    delete m_asg;
+    m_asg = new ASG(m_ckt);
+    m_asg->SetIgnoreCapType(ignore);
+    m_asg->SetDeviceOrder(order);
+    m_asgPropertySelected = true;
+
+    if (NOT ASGCostAccepted())
+        return;
+
     int error = m_asg->LogicalPlacement();
+    if (NOT error AND m_annealAction->isChecked())
+        error = m_asg->AnnealPlacement(SA_TIME_BUDGET_MS);
     if (error) {
         ShowCriticalMsg(tr("[ERROR ASG] Logicl Placement failed."));
+        return;
+    }
+    ShowCrossings();
+
+    LogicalRouting();
+    GeometricalPlacement();
+    GeometricalRouting();
+}
+
+/* too big is stopped, slow is asked */
+bool MainWindow::ASGCostAccepted()
+{
+    GraphStats stats;
+    if (m_asg->CollectStats(&stats))
+        return true;
+
+    if (stats.Verdict() == CostTooBig) {
+        ShowCriticalMsg(tr("[ERROR ASG] Predicted memory is over the limit.\n\n") + stats.Report());
+        return false;
     }
+
+    if (stats.Verdict() == CostSlow) {
+        QMessageBox::StandardButton button = QMessageBox::question(this, tr("ASG Cost"),
+                tr("The schematic may take long, continue?\n\n") + stats.Report());
+        return (button == QMessageBox::Yes);
+    }
+
+    return true;
 }
 
 void MainWindow::LogicalRouting()
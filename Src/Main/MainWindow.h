@@ -2,6 +2,8 @@
 #define NETLISTVIZ_SCHEMATIC_MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QSet>
+#include <QStringList>
 #include "Schematic/SchematicDevice.h"
 
 class SchematicScene;
@@ -136,6 +138,8 @@ private slots:
     void LogicalRouting();
     void GeometricalPlacement();
     void GeometricalRouting();
+    void ExpandCompositeTriggered();
+    void ReduceRCToggled(bool checked);
 
 
 signals:
@@ -181,10 +185,20 @@ private:
 
     void ShowNetlistFile(const QString &netlist);
 
+    /* GraphStats before LogicalPlacement, false stops ASG */
+    bool ASGCostAccepted();
+
+    /* For composites, see CircuitGraph::Compress() */
+    int  ParseNetlistFile();
+    int  CompressCircuit();
+    void RerunASG();
+
 
     /* Critical Dialog */
     void ShowCriticalMsg(const QString &msg);
     void ShowInfoMsg(const QString &msg);
+    /* in the status bar, after LogicalPlacement() */
+    void ShowCrossings();
 
 
 
@@ -198,6 +212,7 @@ private:
 
     QAction            *m_exitAction;
     QAction            *m_deleteAction;
+    QAction            *m_expandAction;
 
     QAction            *m_toFrontAction;
     QAction            *m_sendBackAction;
@@ -251,6 +266,9 @@ private:
 
     /* For ASG Actions */
     QAction            *m_asgPropertyAction;
+    QAction            *m_compressAction;
+    QAction            *m_reduceRCAction;
+    QAction            *m_annealAction;
     QAction            *m_logPlaceAction;
     QAction            *m_logRouteAction;
     QAction            *m_geoPlaceAction;
@@ -274,6 +292,15 @@ private:
     ASGDialog          *m_asgDialog;
     bool                m_asgPropertySelected;
 
+    /* For composites, names outlive the circuit, which ASG destroys */
+    QSet<QString>       m_expandedNames;
+    QSet<QString>       m_compositeNames;
+    QStringList         m_firstLevelNames;
+
+    /* For CircuitGraph::ReduceRC(), Hz and relative error */
+    double              m_reduceFrequency;
+    double              m_reduceError;
+
     /* for cursor image */
     SchematicDevice    *m_deviceBeingAdded;
 };
@@ -0,0 +1,94 @@
+#ifndef NETLISTVIZ_PARSER_CKTPARSESTATE_H
+#define NETLISTVIZ_PARSER_CKTPARSESTATE_H
+
+/*
+ * @filename : CktParseState.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Per-parse state shared by the reentrant scanner and parser.
+ *           : Each MyParser::ParseNetlist call owns one, so several
+ *           : netlists can be parsed at the same time.
+ *           : .include pushes a scanner buffer and its InputSource, the
+ *           : outer ones wait in includes until the included file ends.
+ */
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "InputSource.h"
+
+class CircuitGraph;
+class Subckt;
+
+/* the same typedef as flex generates for a reentrant scanner */
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void* yyscan_t;
+#endif
+
+struct OutputPara
+{
+    std::string otype;  // output type (V, VM, VR, VP, I)
+    std::string pos;    // positive node
+    std::string neg;    // negative node
+
+    OutputPara() {}
+    OutputPara(const char *o, const char *p, const char *n)
+        : otype(o), pos(p), neg(n) {}
+};
+
+struct CktParseState
+{
+    CircuitGraph             *ckt;
+    InputSource              *input;     // read by YY_INPUT
+    std::string               filename;  // for error location
+    Subckt                   *subckt;    // open .subckt, nullptr at top level
+    std::vector<InputSource*> includes;  // outer inputs of open .include files
+    std::vector<std::string>  files;     // netlist, then open .include files
+    int                       includeCount;
+    std::vector<char*>        nodes;     // node names of current line, malloc-ed
+    std::vector<OutputPara>   outs;      // outputs of current .print/.plot
+    int                       errors;
+
+    CktParseState(CircuitGraph *c, InputSource *in, const std::string &file)
+        : ckt(c), input(in), filename(file), subckt(nullptr), includeCount(0), errors(0)
+    {
+        files.push_back(file);
+    }
+
+    ~CktParseState()
+    {
+        ClearNodes();
+        /* stopped inside .include, give back the caller's input */
+        while (NOT includes.empty())
+            PopInclude();
+    }
+
+    void PushInclude(InputSource *in, const std::string &file)
+    {
+        includes.push_back(input);
+        files.push_back(file);
+        input = in;
+        includeCount++;
+    }
+
+    void PopInclude()
+    {
+        delete input;
+        input = includes.back();
+        includes.pop_back();
+        files.pop_back();
+    }
+
+    void ClearNodes()
+    {
+        for (size_t i = 0; i < nodes.size(); ++ i)
+            free(nodes.at(i));
+        nodes.clear();
+    }
+};
+
+#endif // NETLISTVIZ_PARSER_CKTPARSESTATE_H
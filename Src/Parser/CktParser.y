@@ -7,53 +7,38 @@
 
 %define api.parser.class {CktParser}
 
+%code requires {
+    #include "CktParseState.h"
+}
+
 %{
     /*************** parser using bison ***************/
     /*************** Parser for Netlist ***************/
+    /* lalr1.cc parsers are always pure, all the per-parse data lives in
+     * CktParseState, no globals here. */
     #include <stdio.h>
+    #include <stdlib.h>
     #include <iostream>
     #include <vector>
     #include "Define/Define.h"
     #include "Circuit/CircuitGraph.h"
+    #include "Circuit/Subckt.h"
+    #include "Circuit/DeviceTraits.h"
+    #include "SpiceValue.h"
 
     using std::cout;
     using std::endl;
     using std::vector;
     using std::string;
 
-    struct OutputPara
-    {
-        char *otype;  // output type (V, VM, VR, VP, I)
-        char *pos;    // positive node
-        char *neg;    // negative node
-        OutputPara()  { otype = NULL; pos = NULL; neg = NULL; }
-        OutputPara(char *o, char *p, char *n)
-        {
-            otype = new char[strlen(o) + 1];
-            strcpy(otype, o);
-            otype[strlen(o)] = '\0';
-
-            pos = new char[strlen(p) + 1];
-            strcpy(pos, p);
-            pos[strlen(p)] = '\0';
-
-            neg = new char[strlen(n) + 1];
-            strcpy(neg, n);
-            neg[strlen(n)] = '\0';
-        }
-    };
-
-    extern FILE       *yyin;
-    vector<char*>      nodes;
-    vector<OutputPara> outs;
-
     void PrintDevice(char*, const vector<char*> &, double);
 %}
 
 %output "CktParser.cpp"
 %verbose
 
-%parse-param { CircuitGraph *ckt }
+%lex-param   { yyscan_t scanner }
+%parse-param { yyscan_t scanner } { CktParseState *state }
 
 %union {
     int n;
@@ -61,30 +46,40 @@
     char *s;
 }
 
-%token<f> VALUE
-%token<s> STRING
-%token<s> CAPACITOR ISOURCE INDUCTOR RESISTOR VSOURCE COMMENT
-%token<n> INTEGER
+%token<s> VALUE STRING INTEGER
+%token<s> CAPACITOR ISOURCE INDUCTOR RESISTOR VSOURCE MOSFET BJT SUBCKTCALL COMMENT
 %token<s> VTYPE
 
 %type<s> node
 %type<f> value
 %type<n> nodeList outList
 
-%token DOTPRINT DOTPLOT LP RP COMMA DOTOP DOTEND EOL
-%token I AC DC TRAN
+%token DOTPRINT DOTPLOT LP RP COMMA DOTOP DOTEND DOTSUBCKT DOTENDS DOTFIRSTLEVEL EOL
+%token I AC DC TRAN PARAM
 
 %{
-    extern int yylex(yy::CktParser::semantic_type *yylval, yy::CktParser::location_type *yylloc);
+    extern int yylex(yy::CktParser::semantic_type *yylval, yy::CktParser::location_type *yylloc,
+                     yyscan_t yyscanner);
+
+    void InsertElement(CktParseState*, DeviceType, const char*, double);
+    bool InsertModelElement(CktParseState*, DeviceType, const char*);
+    void InsertInstance(CktParseState*, const char*);
+    bool TakeValue(char*, double*);
 %}
 
 %initial-action {
-    @$.begin.filename = @$.end.filename = new std::string("stdin");
+    @$.begin.filename = @$.end.filename = &state->filename;
 }
 
 %%
 
 spice: netlist end
+     {
+         if (state->subckt) {
+             error(@2, string("missing .ends of ") + state->subckt->Name());
+             YYABORT;
+         }
+     }
 ;
 
 end: DOTEND
@@ -96,9 +91,11 @@ netlist: line
 ;
 
 line: component EOL
+    | hierarchy EOL
     | analysis EOL
     | ignore EOL
     | output EOL
+    | firstlevel EOL
     | EOL
 ;
 
@@ -107,6 +104,13 @@ component: capacitor
          | inductor
          | resistor
          | vsource
+         | mosfet
+         | bjt
+;
+
+hierarchy: instance
+         | subckt
+         | ends
 ;
 
 analysis: op
@@ -121,175 +125,284 @@ output: print
 
 capacitor: CAPACITOR nodeList value
          {
-            if ($2 != 2 || nodes.size() != 2) {
-                printf("Parse %s failed.\n", $1);
-                EXIT;
+            if ($2 != 2 || state->nodes.size() != 2) {
+                error(@1, string("Parse ") + $1 + " failed.");
+                free($1);
+                YYABORT;
             }
 
-            ckt->InsertC($1, nodes.at(0), nodes.at(1), $3);
+            InsertElement(state, CAPACITOR, $1, $3);
 
-            nodes.clear();
+            free($1);
+            state->ClearNodes();
          }
 ;
 
 isource: ISOURCE nodeList value
        {
-            if ($2 != 2 || nodes.size() != 2) {
-                printf("Parse %s failed.\n", $1);
-                EXIT;
+            if ($2 != 2 || state->nodes.size() != 2) {
+                error(@1, string("Parse ") + $1 + " failed.");
+                free($1);
+                YYABORT;
             }
 
-            ckt->InsertI($1, nodes.at(0), nodes.at(1), $3);
+            InsertElement(state, ISRC, $1, $3);
 
-            nodes.clear();
+            free($1);
+            state->ClearNodes();
        }
 ;
 
 inductor: INDUCTOR nodeList value
         {
-            if ($2 != 2 || nodes.size() != 2) {
-                printf("Parse %s failed.\n", $1);
-                EXIT;
+            if ($2 != 2 || state->nodes.size() != 2) {
+                error(@1, string("Parse ") + $1 + " failed.");
+                free($1);
+                YYABORT;
             }
 
-            ckt->InsertL($1, nodes.at(0), nodes.at(1), $3);
+            InsertElement(state, INDUCTOR, $1, $3);
 
-            nodes.clear();
+            free($1);
+            state->ClearNodes();
         }
 
 resistor: RESISTOR nodeList value
         {
-            if ($2 != 2 || nodes.size() != 2) {
-                printf("Parse %s failed.\n", $1);
-                EXIT;
+            if ($2 != 2 || state->nodes.size() != 2) {
+                error(@1, string("Parse ") + $1 + " failed.");
+                free($1);
+                YYABORT;
             }
 
-            ckt->InsertR($1, nodes.at(0), nodes.at(1), $3);
+            InsertElement(state, RESISTOR, $1, $3);
 
-            nodes.clear();
+            free($1);
+            state->ClearNodes();
         }
 ;
 
 vsource: VSOURCE nodeList value
        {
-            if ($2 != 2 || nodes.size() != 2) {
-                printf("Parse %s failed.\n", $1);
-                EXIT;
+            if ($2 != 2 || state->nodes.size() != 2) {
+                error(@1, string("Parse ") + $1 + " failed.");
+                free($1);
+                YYABORT;
             }
 
-            ckt->InsertV($1, nodes.at(0), nodes.at(1), $3);
+            InsertElement(state, VSRC, $1, $3);
 
-            nodes.clear();
+            free($1);
+            state->ClearNodes();
        }
 ;
 
+mosfet: MOSFET nodeList params
+      {
+          /* M name d g s b model [w=1u l=0.18u ...] */
+          if (NOT InsertModelElement(state, MOSFET, $1)) {
+              error(@1, string("Parse ") + $1 + " failed.");
+              free($1);
+              YYABORT;
+          }
+
+          free($1);
+          state->ClearNodes();
+      }
+;
+
+bjt: BJT nodeList params
+   {
+       /* Q name c b e model [area=2 ...] */
+       if (NOT InsertModelElement(state, BJT, $1)) {
+           error(@1, string("Parse ") + $1 + " failed.");
+           free($1);
+           YYABORT;
+       }
+
+       free($1);
+       state->ClearNodes();
+   }
+;
+
+/* name=value instance params of M/Q, skipped as in MmapScanner */
+params: /* empty */
+      | params PARAM
+;
+
+instance: SUBCKTCALL nodeList
+        {
+            /* X name nodes... subckt */
+            if ($2 < 2) {
+                error(@1, string("Parse ") + $1 + " failed.");
+                free($1);
+                YYABORT;
+            }
+
+            InsertInstance(state, $1);
+
+            free($1);
+            state->ClearNodes();
+        }
+;
+
+subckt: DOTSUBCKT nodeList
+      {
+          /* .subckt name ports... */
+          if (state->subckt) {
+              error(@1, "nested .subckt");
+              YYABORT;
+          }
+
+          state->subckt = state->ckt->DefineSubckt(state->nodes.at(0));
+          if (NOT state->subckt) {
+              error(@1, string("Redefine subckt ") + state->nodes.at(0));
+              YYABORT;
+          }
+
+          for (size_t i = 1; i < state->nodes.size(); ++ i) {
+              if (state->subckt->AddPort(state->nodes.at(i))) {
+                  error(@1, string("Repeated port ") + state->nodes.at(i));
+                  YYABORT;
+              }
+          }
+
+          state->ClearNodes();
+      }
+;
+
+ends: DOTENDS
+    {
+        state->subckt = nullptr;
+    }
+    | DOTENDS STRING
+    {
+        free($2);
+        state->subckt = nullptr;
+    }
+;
+
 op: DOTOP
 ;
 
+firstlevel: DOTFIRSTLEVEL nodeList
+          {
+              /* sources for ASG, resolved after Flatten() */
+              for (char *name : state->nodes)
+                  state->ckt->MarkFirstLevel(name);
+
+              state->ClearNodes();
+          }
+;
+
 print: DOTPRINT outList
      {
-         outs.clear();
+         state->outs.clear();
      }
      | DOTPRINT DC outList
      {
-         outs.clear();
+         state->outs.clear();
      }
      | DOTPRINT AC outList
      {
-         outs.clear();
+         state->outs.clear();
      }
      | DOTPRINT TRAN outList
      {
-         outs.clear();
+         state->outs.clear();
      }
 ;
 
 plot: DOTPLOT outList
     {
-        outs.clear();
+        state->outs.clear();
     }
     | DOTPLOT DC outList
     {
-        outs.clear();
+        state->outs.clear();
     }
     | DOTPLOT AC outList
     {
-        outs.clear();
+        state->outs.clear();
     }
     | DOTPLOT TRAN outList
     {
-        outs.clear();
+        state->outs.clear();
     }
 ;
 
 nodeList: node
         {
             $$ = 1;
-            nodes.push_back($1);
+            state->nodes.push_back($1);
         }
         | nodeList node
         {
             $$ = $$ + 1;
-            nodes.push_back($2);
+            state->nodes.push_back($2);
         }
 ;
 
 outList: VTYPE LP node RP
        {
            $$ = 1;
-           outs.push_back(OutputPara($1, $3, "0"));
+           state->outs.push_back(OutputPara($1, $3, "0"));
        }
        | VTYPE LP node COMMA node RP
        {
            $$ = 1;
-           outs.push_back(OutputPara($1, $3, $5));
+           state->outs.push_back(OutputPara($1, $3, $5));
        }
        | I LP VSOURCE RP
        {
            $$ = 1;
-           outs.push_back(OutputPara("I", $3, "0"));
+           state->outs.push_back(OutputPara("I", $3, "0"));
        }
        | outList VTYPE LP node RP
        {
            $$ = $$ + 1;
-           outs.push_back(OutputPara($2, $4, "0"));
+           state->outs.push_back(OutputPara($2, $4, "0"));
        }
        | outList VTYPE LP node COMMA node RP
        {
            $$ = $$ + 1;
-           outs.push_back(OutputPara($2, $4, $6));
+           state->outs.push_back(OutputPara($2, $4, $6));
        }
        | outList I LP VSOURCE RP
        {
            $$ = $$ +1;
-           outs.push_back(OutputPara("I", $4, "0"));
+           state->outs.push_back(OutputPara("I", $4, "0"));
        }
 ;
 
 node: STRING
     {
-        $$ = new char[strlen($1) + 1];
-        strcpy($$, $1);
-        $$[strlen($1)] = '\0';
+        /* take the scanner's buffer, CircuitGraph interns the name */
+        $$ = $1;
     }
     | INTEGER
     {
-        char *s = new char[20];
-        sprintf(s, "%d", $1);
-        $$ = new char[strlen(s) + 1];
-        strcpy($$, s);
-        $$[strlen(s)] = '\0';
-        delete []s;
+        $$ = $1;
+    }
+    | VALUE
+    {
+        $$ = $1;
     }
 ;
 
 value: INTEGER
      {
-         $$ = $1;
+         if (NOT TakeValue($1, &$$)) {
+             error(@1, "bad value");
+             YYERROR;
+         }
      }
      | VALUE
      {
-         $$ = $1;
+         if (NOT TakeValue($1, &$$)) {
+             error(@1, "bad value");
+             YYERROR;
+         }
      }
 ;
 
@@ -299,12 +412,56 @@ namespace yy
 {
     void CktParser::error(const location_type &loc, const std::string &s)
     {
-        std::cerr << "Error : " << s << std::endl;
-        EXIT;
+        std::cerr << "Error : " << loc << " : " << s << std::endl;
+        state->errors++;
     }
 
 }
 
+/*
+ * INTEGER or VALUE text as MmapScanner reads it, freed. False if it is out
+ * of range (1e400, 1e-400), the caller's error() counts it in state->errors.
+ */
+bool TakeValue(char *text, double *value)
+{
+    bool okay = ParseSpiceValue(std::string_view(text), value);
+    free(text);
+    return okay;
+}
+
+/* element line, into the open .subckt or the top level */
+void InsertElement(CktParseState *state, DeviceType type, const char *name, double value)
+{
+    vector<std::string_view> nodes(state->nodes.begin(), state->nodes.end());
+
+    if (state->subckt)
+        state->subckt->AddElement(type, name, nodes.data(), value);
+    else
+        state->ckt->InsertDevice(type, name, nodes.data(), value);
+}
+
+/* M/Q line, the last of nodes is the model name, which is not kept */
+bool InsertModelElement(CktParseState *state, DeviceType type, const char *name)
+{
+    if ((int)state->nodes.size() != Traits(type).terminalCount + 1)
+        return false;
+
+    InsertElement(state, type, name, 0);
+    return true;
+}
+
+/* X line, the last of nodes is the subckt name */
+void InsertInstance(CktParseState *state, const char *name)
+{
+    vector<std::string_view> nodes(state->nodes.begin(), state->nodes.end() - 1);
+    const char *subckt = state->nodes.back();
+
+    if (state->subckt)
+        state->subckt->AddCall(name, subckt, nodes.data(), nodes.size());
+    else
+        state->ckt->InsertX(name, subckt, nodes.data(), nodes.size());
+}
+
 void PrintDevice(char *name, const vector<char*> &nodes, double value)
 {
     printf("%s ", name);
@@ -0,0 +1,293 @@
+#include "InputSource.h"
+#include <cstdio>
+#include <iostream>
+#include <cstring>
+#include <climits>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <QFileInfo>
+#include <QDir>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+/* decoded block size and how many blocks the prefetch thread runs ahead */
+static const qint64 PREFETCH_BLOCK_BYTES = 1LL << 20;
+static const int    PREFETCH_MAX_BLOCKS = 4;
+
+static const unsigned char GZIP_MAGIC[2] = { 0x1f, 0x8b };
+static const unsigned char ZSTD_MAGIC[4] = { 0x28, 0xb5, 0x2f, 0xfd };
+
+enum InputFormat { PlainInput = 0, GzipInput, ZstdInput };
+
+static InputFormat DetectFormat(FILE *fp)
+{
+    unsigned char magic[4] = { 0, 0, 0, 0 };
+    size_t n = fread(magic, 1, sizeof(magic), fp);
+    rewind(fp);
+
+    if (n >= sizeof(GZIP_MAGIC) AND memcmp(magic, GZIP_MAGIC, sizeof(GZIP_MAGIC)) == 0)
+        return GzipInput;
+    if (n >= sizeof(ZSTD_MAGIC) AND memcmp(magic, ZSTD_MAGIC, sizeof(ZSTD_MAGIC)) == 0)
+        return ZstdInput;
+    return PlainInput;
+}
+
+
+/* Plain netlist */
+class FileSource : public InputSource
+{
+public:
+    explicit FileSource(FILE *fp) : m_fp(fp) {}
+    ~FileSource() { fclose(m_fp); }
+
+    qint64 Read(char *buf, qint64 size) override
+    {
+        size_t n = fread(buf, 1, size, m_fp);
+        if (n == 0 AND ferror(m_fp))
+            return -1;
+        return n;
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(FileSource);
+
+    FILE *m_fp;
+};
+
+
+/* .gz, gzread also takes concatenated members */
+class GzipSource : public InputSource
+{
+public:
+    explicit GzipSource(gzFile gz) : m_gz(gz) {}
+    ~GzipSource() { gzclose(m_gz); }
+
+    qint64 Read(char *buf, qint64 size) override
+    {
+        unsigned len = (unsigned)qMin(size, (qint64)INT_MAX);
+        int n = gzread(m_gz, buf, len);
+        if (n < 0)
+            return -1;
+
+        /* a stream cut short ends with Z_BUF_ERROR, "unexpected end of file" */
+        int error = Z_OK;
+        if (n == 0)
+            gzerror(m_gz, &error);
+        return (error == Z_OK) ? n : -1;
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(GzipSource);
+
+    gzFile m_gz;
+};
+
+
+#ifdef HAVE_ZSTD
+/* .zst, frames are decoded one after another */
+class ZstdSource : public InputSource
+{
+public:
+    explicit ZstdSource(FILE *fp)
+        : m_fp(fp), m_stream(ZSTD_createDStream()), m_inBuf(ZSTD_DStreamInSize()), m_hint(1)
+    {
+        ZSTD_initDStream(m_stream);
+        m_in.src = m_inBuf.data();
+        m_in.size = 0;
+        m_in.pos = 0;
+    }
+
+    ~ZstdSource()
+    {
+        ZSTD_freeDStream(m_stream);
+        fclose(m_fp);
+    }
+
+    qint64 Read(char *buf, qint64 size) override
+    {
+        ZSTD_outBuffer out = { buf, (size_t)size, 0 };
+
+        while (out.pos == 0) {
+            if (m_in.pos == m_in.size) {
+                m_in.size = fread(m_inBuf.data(), 1, m_inBuf.size(), m_fp);
+                m_in.pos = 0;
+                /* the input ends inside a frame, the file is cut short */
+                if (m_in.size == 0)
+                    return (ferror(m_fp) || m_hint != 0) ? -1 : 0;
+            }
+            m_hint = ZSTD_decompressStream(m_stream, &out, &m_in);
+            if (ZSTD_isError(m_hint))
+                return -1;
+        }
+
+        return out.pos;
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(ZstdSource);
+
+    FILE              *m_fp;
+    ZSTD_DStream      *m_stream;
+    std::vector<char>  m_inBuf;
+    ZSTD_inBuffer      m_in;
+    size_t             m_hint;      // of ZSTD_decompressStream, 0 at a frame end
+};
+#endif
+
+
+/*
+ * Runs the wrapped (decompressing) source on its own thread, at most
+ * PREFETCH_MAX_BLOCKS ahead, so decoding overlaps with scanning.
+ */
+class PrefetchSource : public InputSource
+{
+public:
+    explicit PrefetchSource(InputSource *source)
+        : m_source(source), m_done(false), m_error(false), m_stop(false), m_offset(0)
+    {
+        m_worker = std::thread(&PrefetchSource::Fetch, this);
+    }
+
+    ~PrefetchSource()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_notFull.notify_all();
+        m_worker.join();
+        delete m_source;
+    }
+
+    qint64 Read(char *buf, qint64 size) override
+    {
+        if (m_current.size() == m_offset) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this] { return NOT m_blocks.empty() || m_done; });
+            if (m_blocks.empty())
+                return m_error ? -1 : 0;
+            m_current.swap(m_blocks.front());
+            m_blocks.pop_front();
+            m_offset = 0;
+            lock.unlock();
+            m_notFull.notify_one();
+        }
+
+        qint64 n = qMin(size, (qint64)(m_current.size() - m_offset));
+        memcpy(buf, m_current.data() + m_offset, n);
+        m_offset += n;
+        return n;
+    }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(PrefetchSource);
+
+    void Fetch()
+    {
+        while (true) {
+            std::vector<char> block(PREFETCH_BLOCK_BYTES);
+            qint64 filled = 0;
+            qint64 n = 0;
+            while (filled < PREFETCH_BLOCK_BYTES) {
+                n = m_source->Read(block.data() + filled, PREFETCH_BLOCK_BYTES - filled);
+                if (n <= 0) break;
+                filled += n;
+            }
+            block.resize(filled);
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notFull.wait(lock, [this] { return m_blocks.size() < (size_t)PREFETCH_MAX_BLOCKS || m_stop; });
+            if (m_stop)
+                return;
+            if (filled > 0)
+                m_blocks.push_back(std::move(block));
+            if (n <= 0) {
+                m_done = true;
+                m_error = (n < 0);
+                lock.unlock();
+                m_notEmpty.notify_one();
+                return;
+            }
+            lock.unlock();
+            m_notEmpty.notify_one();
+        }
+    }
+
+    InputSource                    *m_source;
+    std::thread                     m_worker;
+    std::mutex                      m_mutex;
+    std::condition_variable         m_notEmpty;
+    std::condition_variable         m_notFull;
+    std::deque<std::vector<char>>   m_blocks;
+    bool                            m_done;
+    bool                            m_error;
+    bool                            m_stop;
+
+    /* consumer side only */
+    std::vector<char>               m_current;
+    size_t                          m_offset;
+};
+
+
+InputSource* InputSource::Open(const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (NOT fp)
+        return nullptr;
+
+    InputFormat format = DetectFormat(fp);
+    if (format == PlainInput)
+        return new FileSource(fp);
+
+    if (format == GzipInput) {
+        fclose(fp);
+        gzFile gz = gzopen(path.c_str(), "rb");
+        if (NOT gz)
+            return nullptr;
+        gzbuffer(gz, 256 * 1024);
+        return new PrefetchSource(new GzipSource(gz));
+    }
+
+#ifdef HAVE_ZSTD
+    return new PrefetchSource(new ZstdSource(fp));
+#else
+    fclose(fp);
+    std::cerr << "Error : " << path << " : zstd input needs a build with CONFIG+=zstd" << std::endl;
+    return nullptr;
+#endif
+}
+
+bool InputSource::IsCompressed(const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (NOT fp)
+        return false;
+
+    InputFormat format = DetectFormat(fp);
+    fclose(fp);
+
+    return (format != PlainInput);
+}
+
+std::string InputSource::IncludePath(std::string_view card, const std::string &includer)
+{
+    /* skip .include / .inc, then blanks, quotes and a trailing \r */
+    size_t begin = card.find_first_of(" \t");
+    begin = (begin == std::string_view::npos) ? card.size() : card.find_first_not_of(" \t\"'", begin);
+    if (begin == std::string_view::npos)
+        return std::string();
+    size_t end = card.find_last_not_of(" \t\r\"'");
+    if (end == std::string_view::npos || end < begin)
+        return std::string();
+
+    QString path = QString::fromUtf8(card.data() + begin, end - begin + 1);
+    if (QFileInfo(path).isRelative())
+        path = QFileInfo(QString::fromStdString(includer)).dir().filePath(path);
+
+    return path.toStdString();
+}
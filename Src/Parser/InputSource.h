@@ -0,0 +1,36 @@
+#ifndef NETLISTVIZ_PARSER_INPUTSOURCE_H
+#define NETLISTVIZ_PARSER_INPUTSOURCE_H
+
+/*
+ * @filename : InputSource.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Where the scanners pull netlist bytes from. Plain files are
+ *           : read directly, .gz (zlib) and .zst (zstd, built with
+ *           : CONFIG+=zstd) are decompressed as a stream. Compressed
+ *           : inputs are decoded on a prefetch thread, one block ahead
+ *           : of the scanner. The format is detected by magic bytes.
+ */
+
+#include <string>
+#include <string_view>
+#include <QtGlobal>
+#include "Define/Define.h"
+
+class InputSource
+{
+public:
+    virtual ~InputSource() {}
+
+    /* bytes read into buf, 0 at end, -1 on error */
+    virtual qint64 Read(char *buf, qint64 size) = 0;
+
+    /* nullptr if path can not be opened or its format is not supported */
+    static InputSource* Open(const std::string &path);
+    static bool         IsCompressed(const std::string &path);
+    /* file of an ".include file" card, a relative one is next to includer */
+    static std::string  IncludePath(std::string_view card, const std::string &includer);
+};
+
+#endif // NETLISTVIZ_PARSER_INPUTSOURCE_H
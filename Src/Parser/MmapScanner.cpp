@@ -0,0 +1,585 @@
+#include "MmapScanner.h"
+#include <iostream>
+#include <thread>
+#include <QFile>
+#include <QThread>
+#include <QDebug>
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/Subckt.h"
+#include "Circuit/DeviceTraits.h"
+#include "SpiceValue.h"
+#include "InputSource.h"
+
+/* bytes pulled from an InputSource per ParseStream round */
+static const qint64 STREAM_BLOCK_BYTES = 1LL << 20;
+
+static inline bool IsBlank(char c)
+{
+    return (c == ' ' || c == '\t' || c == '\r');
+}
+
+static inline char ToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
+}
+
+/* name=value, as PARAM in CktScanner.l : [A-Za-z_][A-Za-z_0-9]*=[^ \t\r\n]+ */
+static bool IsInstanceParam(std::string_view token)
+{
+    size_t eq = token.find('=');
+    if (eq == 0 || eq == std::string_view::npos || eq + 1 >= token.size())
+        return false;
+    for (size_t i = 0; i < eq; ++ i) {
+        char c = ToLower(token[i]);
+        if (NOT ((c >= 'a' AND c <= 'z') || c == '_' || (i > 0 AND c >= '0' AND c <= '9')))
+            return false;
+    }
+    return true;
+}
+
+/* case-insensitive compare, word is lower case */
+static bool MatchWord(std::string_view token, const char *word)
+{
+    size_t len = strlen(word);
+    if (token.size() != len)
+        return false;
+    for (size_t i = 0; i < len; ++ i) {
+        if (ToLower(token[i]) != word[i])
+            return false;
+    }
+    return true;
+}
+
+
+MmapScanner::MmapScanner()
+{
+    m_threadCount = 0;
+    m_lineno = 0;
+    m_ended = false;
+    m_subckt = nullptr;
+    m_includeDepth = 0;
+    m_includeCount = 0;
+    m_bytes = 0;
+}
+
+MmapScanner::~MmapScanner()
+{
+}
+
+int MmapScanner::ParseNetlist(const std::string &netlist, CircuitGraph *ckt)
+{
+    assert(ckt);
+#ifdef TRACE
+    std::cout << LINE_INFO << std::endl;
+#endif
+
+    m_netlist = netlist;
+    m_lineno = 0;
+    m_ended = false;
+    m_subckt = nullptr;
+    m_includeCount = 0;
+    m_bytes = 0;
+
+    QFile file(QString::fromStdString(netlist));
+    if (NOT file.open(QIODevice::ReadOnly)) {
+        std::cout << "Open " << netlist << " failed.\n" << std::endl;
+        return ERROR;
+    }
+
+    qint64 size = file.size();
+    uchar *data = (size > 0) ? file.map(0, size) : nullptr;
+    if (NOT data) {
+        std::cout << "Map " << netlist << " failed.\n" << std::endl;
+        file.close();
+        return ERROR;
+    }
+
+    int threadCount = m_threadCount;
+    if (threadCount <= 0)
+        threadCount = QThread::idealThreadCount();
+    if (threadCount > size / MMAP_SCAN_CHUNK_BYTES)
+        threadCount = size / MMAP_SCAN_CHUNK_BYTES;
+
+    const char *begin = reinterpret_cast<const char*>(data);
+    int error = OKAY;
+    if (threadCount > 1)
+        error = ParseBufferParallel(begin, begin + size, ckt, threadCount);
+    else
+        error = ParseBuffer(begin, begin + size, ckt);
+
+    if (NOT error AND NOT m_ended) {
+        std::cerr << "Error : " << m_netlist << " : missing .end" << std::endl;
+        error = ERROR;
+    }
+    if (NOT error AND m_subckt) {
+        std::cerr << "Error : " << m_netlist << " : missing .ends" << std::endl;
+        error = ERROR;
+    }
+
+    file.unmap(data);
+    file.close();
+
+    return error;
+}
+
+int MmapScanner::ParseStream(const std::string &netlist, InputSource *input, CircuitGraph *ckt)
+{
+    assert(input AND ckt);
+#ifdef TRACE
+    std::cout << LINE_INFO << std::endl;
+#endif
+
+    m_netlist = netlist;
+    m_lineno = 0;
+    m_ended = false;
+    m_subckt = nullptr;
+    m_includeCount = 0;
+    m_bytes = 0;
+
+    if (ScanStream(input, ckt))
+        return ERROR;
+
+    if (NOT m_ended) {
+        std::cerr << "Error : " << m_netlist << " : missing .end" << std::endl;
+        return ERROR;
+    }
+    if (m_subckt) {
+        std::cerr << "Error : " << m_netlist << " : missing .ends" << std::endl;
+        return ERROR;
+    }
+
+    return OKAY;
+}
+
+/*
+ * Whole lines of each block go to ParseBuffer, the unfinished last line is
+ * carried to the next block. Names are interned by CircuitGraph at once,
+ * so no token outlives its block.
+ */
+int MmapScanner::ScanStream(InputSource *input, CircuitGraph *ckt)
+{
+    std::vector<char> buffer;
+    size_t carry = 0;
+
+    while (NOT m_ended) {
+        buffer.resize(carry + STREAM_BLOCK_BYTES);
+        qint64 n = input->Read(buffer.data() + carry, STREAM_BLOCK_BYTES);
+        if (n < 0) {
+            std::cerr << "Error : " << m_netlist << " : read failed" << std::endl;
+            return ERROR;
+        }
+
+        const char *begin = buffer.data();
+        const char *end = begin + carry + n;
+        const char *lineEnd = end;
+        if (n > 0) {
+            const char *last = end - 1;
+            while (last >= begin AND *last != '\n')
+                last--;
+            if (last < begin) {
+                carry = end - begin;   // one line longer than a block
+                continue;
+            }
+            lineEnd = last + 1;
+        }
+
+        if (ParseBuffer(begin, lineEnd, ckt))
+            return ERROR;
+
+        if (n == 0)
+            break;
+        carry = end - lineEnd;
+        memmove(buffer.data(), lineEnd, carry);
+    }
+
+    /* what follows .end is read too, as the flex scanner does, so a stream cut short is an error */
+    qint64 n = 1;
+    while (n > 0)
+        n = input->Read(buffer.data(), buffer.size());
+    if (n < 0) {
+        std::cerr << "Error : " << m_netlist << " : read failed" << std::endl;
+        return ERROR;
+    }
+
+    return OKAY;
+}
+
+int MmapScanner::ParseBuffer(const char *begin, const char *end, CircuitGraph *ckt)
+{
+    std::vector<std::string_view> tokens;
+    int count = 0;
+    DeviceType type = Other;
+    double value = 0;
+    const char *p = begin;
+
+    while (p < end AND NOT m_ended) {
+        const char *lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (NOT lineEnd)
+            lineEnd = end;
+        std::string_view line(p, lineEnd - p);
+        m_lineno++;
+        m_bytes += (lineEnd - p) + (lineEnd < end ? 1 : 0);
+        p = lineEnd + 1;
+
+        LineKind kind = ScanLine(line, &tokens, &count, &type, &value);
+        switch (kind) {
+            case ElementLine:
+                /* like CktParser.y, a redefined device is reported by CircuitGraph only */
+                if (m_subckt)
+                    m_subckt->AddElement(type, tokens[0], tokens.data() + 1, value);
+                else
+                    ckt->InsertDevice(type, tokens[0], tokens.data() + 1, value);
+                break;
+            case EndLine:
+                m_ended = true;
+                break;
+            case FirstLevelLine:
+                for (int i = 1; i < count; ++ i)
+                    ckt->MarkFirstLevel(tokens[i]);
+                break;
+            case BadLine:
+                PrintError("syntax error", line);
+                return ERROR;
+            case SkipLine:
+                break;
+            default:
+                if (ParseHierarchyLine(kind, line, tokens.data(), count, ckt))
+                    return ERROR;
+                break;
+        }
+    }
+
+    return OKAY;
+}
+
+/*
+ * Cut [begin, end) into threadCount chunks at line boundaries, scan them
+ * in parallel, then merge in file order. Workers never touch ckt, so the
+ * merge sees exactly the lines the serial scan would insert.
+ */
+int MmapScanner::ParseBufferParallel(const char *begin, const char *end,
+                                     CircuitGraph *ckt, int threadCount)
+{
+    std::vector<ScanChunk> chunks(threadCount);
+    qint64 size = end - begin;
+    const char *p = begin;
+    for (int i = 0; i < threadCount; ++ i) {
+        const char *cut = end;
+        if (i < threadCount - 1) {
+            cut = begin + size * (i + 1) / threadCount;
+            if (cut < p)
+                cut = p;
+            const char *lineEnd = static_cast<const char*>(memchr(cut, '\n', end - cut));
+            cut = lineEnd ? lineEnd + 1 : end;
+        }
+        chunks[i].begin = p;
+        chunks[i].end = cut;
+        p = cut;
+    }
+
+    std::vector<std::thread> workers;
+    for (int i = 1; i < threadCount; ++ i)
+        workers.emplace_back(&MmapScanner::ScanChunkLines, this, &chunks[i]);
+    ScanChunkLines(&chunks[0]);
+    for (std::thread &worker : workers)
+        worker.join();
+
+    for (const ScanChunk &chunk : chunks) {
+        if (MergeChunk(chunk, ckt))
+            return ERROR;
+        if (m_ended)
+            break;
+        /* definitions span chunks, the rest is scanned serially */
+        if (IsHierarchyLine(chunk.stop))
+            return ParseBuffer(chunk.stopLine.data(), end, ckt);
+    }
+
+    return OKAY;
+}
+
+/* Worker, stops at the first .end, bad or hierarchy line of its chunk */
+void MmapScanner::ScanChunkLines(ScanChunk *chunk) const
+{
+    std::vector<std::string_view> tokens;
+    std::unordered_map<std::string_view, int> localNodes;
+    int count = 0;
+    DeviceType type = Other;
+    double value = 0;
+    const char *p = chunk->begin;
+    const char *end = chunk->end;
+
+    chunk->lineCount = 0;
+    chunk->bytes = 0;
+    chunk->stop = SkipLine;
+
+    auto nodeIndex = [&](std::string_view token) {
+        auto finder = localNodes.find(token);
+        if (finder != localNodes.end())
+            return finder->second;
+        int index = chunk->nodeNames.size();
+        chunk->nodeNames.push_back(token);
+        localNodes.emplace(token, index);
+        return index;
+    };
+
+    while (p < end) {
+        const char *lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (NOT lineEnd)
+            lineEnd = end;
+        std::string_view line(p, lineEnd - p);
+        chunk->lineCount++;
+        chunk->bytes += (lineEnd - p) + (lineEnd < end ? 1 : 0);
+        p = lineEnd + 1;
+
+        LineKind kind = ScanLine(line, &tokens, &count, &type, &value);
+        if (kind == ElementLine) {
+            ElementRecord record;
+            record.name = tokens[0];
+            record.type = type;
+            for (int pin = 0; pin < Traits(type).terminalCount; ++ pin)
+                record.nodes[pin] = nodeIndex(tokens[1 + pin]);
+            record.value = value;
+            chunk->elements.push_back(record);
+        } else if (kind == FirstLevelLine) {
+            chunk->firstLevel.insert(chunk->firstLevel.end(), tokens.begin() + 1, tokens.begin() + count);
+        } else if (kind == EndLine || kind == BadLine) {
+            chunk->stop = kind;
+            chunk->stopLine = line;
+            return;
+        } else if (IsHierarchyLine(kind)) {
+            /* left to ParseBuffer, which counts it again */
+            chunk->lineCount--;
+            chunk->bytes -= (lineEnd - line.data()) + (lineEnd < end ? 1 : 0);
+            chunk->stop = kind;
+            chunk->stopLine = line;
+            return;
+        }
+    }
+}
+
+/*
+ * Chunk-local nodes are resolved lazily, when the first device using them
+ * is inserted, so nodes are created in the same order as ParseBuffer.
+ */
+int MmapScanner::MergeChunk(const ScanChunk &chunk, CircuitGraph *ckt)
+{
+    std::vector<Node*> nodes(chunk.nodeNames.size(), nullptr);
+
+    for (const ElementRecord &record : chunk.elements) {
+        NameId name = ckt->InternName(record.name);
+        if (ckt->Redefined(record.type, name)) {
+            qInfo() << "ERROR: Redefine " << ckt->GetNamePool()->Name(name) << endl;
+            continue;
+        }
+        Node *deviceNodes[MAX_DEVICE_TERMINALS];
+        for (int pin = 0; pin < Traits(record.type).terminalCount; ++ pin) {
+            Node *&node = nodes[record.nodes[pin]];
+            if (NOT node)
+                node = ckt->InsertNode(chunk.nodeNames[record.nodes[pin]]);
+            deviceNodes[pin] = node;
+        }
+        ckt->InsertDevice(record.type, name, deviceNodes, record.value);
+    }
+
+    for (std::string_view name : chunk.firstLevel)
+        ckt->MarkFirstLevel(name);
+
+    m_lineno += chunk.lineCount;
+    m_bytes += chunk.bytes;
+
+    if (chunk.stop == BadLine) {
+        PrintError("syntax error", chunk.stopLine);
+        return ERROR;
+    }
+    if (chunk.stop == EndLine)
+        m_ended = true;
+
+    return OKAY;
+}
+
+/*
+ * Split one line by blanks and classify it, element tokens are name nodes
+ * value (or model). tokens grows to the longest X or .subckt line and keeps
+ * its capacity, as the flex scanner has no limit either.
+ */
+MmapScanner::LineKind MmapScanner::ScanLine(std::string_view line, std::vector<std::string_view> *tokenList,
+                                            int *tokenCount, DeviceType *type, double *value) const
+{
+    tokenList->clear();
+    const char *q = line.data();
+    const char *lineEnd = q + line.size();
+    while (q < lineEnd) {
+        while (q < lineEnd AND IsBlank(*q)) q++;
+        if (q >= lineEnd) break;
+        const char *tokBegin = q;
+        while (q < lineEnd AND NOT IsBlank(*q)) q++;
+        tokenList->emplace_back(tokBegin, q - tokBegin);
+    }
+    int count = tokenList->size();
+    *tokenCount = count;
+    const std::string_view *tokens = tokenList->data();
+
+    /* empty line */
+    if (count == 0)
+        return SkipLine;
+
+    char first = tokens[0][0];
+
+    /* comment, only at line start (the same as CktScanner.l) */
+    if (first == '*' AND tokens[0].data() == line.data())
+        return SkipLine;
+
+    if (first == '.')
+        return ScanDotCard(tokens[0]);
+
+    /* name nodes... subckt */
+    if (ToLower(first) == 'x')
+        return (count >= 3 AND tokens[0].size() >= 2) ? InstanceLine : BadLine;
+
+    *type = DeviceTypeByLetter(first);
+    if (*type == Other || tokens[0].size() < 2)
+        return BadLine;
+
+    /* name nodes value (R/C/L/I/V) or name nodes model params (M/Q),
+     * the model and its name=value instance params (w=1u l=0.18u) are not kept */
+    const DeviceTraits &traits = Traits(*type);
+    int fixed = traits.terminalCount + 2;
+    if (count < fixed || (traits.hasValue AND count != fixed))
+        return BadLine;
+    if (NOT traits.hasValue AND IsInstanceParam(tokens[fixed - 1]))
+        return BadLine;
+    for (int i = fixed; i < count; ++ i) {
+        if (NOT IsInstanceParam(tokens[i]))
+            return BadLine;
+    }
+    count = fixed;
+    *tokenCount = count;
+
+    *value = 0;
+    if (traits.hasValue AND NOT ParseValue(tokens[count - 1], value))
+        return BadLine;
+
+    return ElementLine;
+}
+
+/* .op, .print, .plot are accepted and ignored, .end stops scanning */
+MmapScanner::LineKind MmapScanner::ScanDotCard(std::string_view card) const
+{
+    if (MatchWord(card, ".end"))
+        return EndLine;
+
+    if (MatchWord(card, ".subckt"))
+        return SubcktLine;
+    if (MatchWord(card, ".ends"))
+        return EndsLine;
+    if (MatchWord(card, ".include") || MatchWord(card, ".inc"))
+        return IncludeLine;
+
+    /* netlistgen marks the sources, so ASG can start without ASGDialog */
+    if (MatchWord(card, ".firstlevel"))
+        return FirstLevelLine;
+
+    if (MatchWord(card, ".op") || MatchWord(card, ".print") || MatchWord(card, ".plot"))
+        return SkipLine;
+
+    return BadLine;
+}
+
+/* .subckt name ports, .ends [name], .include file and X name nodes subckt */
+int MmapScanner::ParseHierarchyLine(LineKind kind, std::string_view line,
+        const std::string_view *tokens, int count, CircuitGraph *ckt)
+{
+    switch (kind) {
+        case InstanceLine:
+            if (m_subckt)
+                m_subckt->AddCall(tokens[0], tokens[count - 1], tokens + 1, count - 2);
+            else
+                ckt->InsertX(tokens[0], tokens[count - 1], tokens + 1, count - 2);
+            return OKAY;
+
+        case SubcktLine:
+            if (m_subckt) {
+                PrintError("nested .subckt", line);
+                return ERROR;
+            }
+            if (count < 2) {
+                PrintError("syntax error", line);
+                return ERROR;
+            }
+            m_subckt = ckt->DefineSubckt(tokens[1]);
+            if (NOT m_subckt) {
+                PrintError("redefined subckt", line);
+                return ERROR;
+            }
+            for (int i = 2; i < count; ++ i) {
+                if (m_subckt->AddPort(tokens[i])) {
+                    PrintError("repeated port", line);
+                    return ERROR;
+                }
+            }
+            return OKAY;
+
+        case EndsLine:
+            /* out of any .subckt, .ends ends the netlist as it always did */
+            if (NOT m_subckt)
+                m_ended = true;
+            m_subckt = nullptr;
+            return OKAY;
+
+        case IncludeLine:
+            return ParseInclude(line, ckt);
+
+        default:
+            break;
+    }
+
+    return ERROR;
+}
+
+/* the included file is streamed, an .end in it only ends that file */
+int MmapScanner::ParseInclude(std::string_view line, CircuitGraph *ckt)
+{
+    std::string path = InputSource::IncludePath(line, m_netlist);
+    if (path.empty()) {
+        PrintError("syntax error", line);
+        return ERROR;
+    }
+    if (m_includeDepth >= MAX_INCLUDE_DEPTH) {
+        PrintError(".include nested too deep", line);
+        return ERROR;
+    }
+
+    InputSource *input = InputSource::Open(path);
+    if (NOT input) {
+        PrintError("open include failed", line);
+        return ERROR;
+    }
+
+    std::string netlist = m_netlist;
+    int lineno = m_lineno;
+    m_netlist = path;
+    m_lineno = 0;
+    m_includeDepth++;
+    m_includeCount++;
+
+    int error = ScanStream(input, ckt);
+    delete input;
+
+    m_includeDepth--;
+    m_netlist = netlist;
+    m_lineno = lineno;
+    m_ended = false;
+
+    return error;
+}
+
+bool MmapScanner::ParseValue(std::string_view token, double *value) const
+{
+    return ParseSpiceValue(token, value);
+}
+
+void MmapScanner::PrintError(const char *msg, std::string_view line) const
+{
+    std::cerr << "Error : " << m_netlist << ":" << m_lineno << " : " << msg
+              << " : " << line << std::endl;
+}
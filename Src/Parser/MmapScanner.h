@@ -0,0 +1,106 @@
+#ifndef NETLISTVIZ_PARSER_MMAPSCANNER_H
+#define NETLISTVIZ_PARSER_MMAPSCANNER_H
+
+/*
+ * @filename : MmapScanner.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Hand-written scanner for big netlists. The file is mapped
+ *           : into memory and tokens are string_views into the mapping,
+ *           : so no token is copied to the heap. Accepts the same
+ *           : lines as CktParser.y (R/C/L/I/V/M/Q, X, comments, .op, .print,
+ *           : .plot, .subckt/.ends, .include, .firstlevel, .end).
+ *           : With more than one thread, the mapping is cut into chunks at
+ *           : line boundaries and scanned in parallel, then the chunks are
+ *           : merged into CircuitGraph in file order, so device and node ids
+ *           : are the same as the serial scan. From the first hierarchy
+ *           : card (.subckt, .ends, .include or X) on, the scan is serial.
+ *           : Compressed netlists are scanned block by block from an
+ *           : InputSource instead.
+ */
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class CircuitGraph;
+class InputSource;
+class Subckt;
+
+class MmapScanner
+{
+public:
+    MmapScanner();
+    ~MmapScanner();
+
+    /* 0 : QThread::idealThreadCount(), 1 : serial scan */
+    void   SetThreadCount(int count) { m_threadCount = count; }
+    int    ParseNetlist(const std::string &netlist, CircuitGraph *ckt);
+    /* serial scan of a stream that can not be mapped (gzip/zstd netlist) */
+    int    ParseStream(const std::string &netlist, InputSource *input, CircuitGraph *ckt);
+    qint64 BytesScanned() const { return m_bytes; }
+    int    IncludeCount() const { return m_includeCount; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(MmapScanner);
+
+    enum LineKind { SkipLine = 0, ElementLine, EndLine, BadLine, FirstLevelLine,
+                    InstanceLine, SubcktLine, EndsLine, IncludeLine };
+
+    /* One element line scanned by a worker, nodes are chunk-local indexes */
+    struct ElementRecord
+    {
+        std::string_view name;
+        DeviceType       type;
+        int              nodes[MAX_DEVICE_TERMINALS];
+        double           value;
+    };
+
+    /* Result of one chunk, filled by one worker thread */
+    struct ScanChunk
+    {
+        const char                 *begin;
+        const char                 *end;
+        std::vector<ElementRecord>  elements;
+        std::vector<std::string_view> nodeNames; // first appearance order
+        std::vector<std::string_view> firstLevel; // .FIRSTLEVEL names
+        int                         lineCount; // including the stop line
+        qint64                      bytes;
+        LineKind                    stop;      // SkipLine at chunk end, a hierarchy
+                                               // line is not counted
+        std::string_view            stopLine;
+    };
+
+    int      ScanStream(InputSource *input, CircuitGraph *ckt);
+    int      ParseBuffer(const char *begin, const char *end, CircuitGraph *ckt);
+    int      ParseBufferParallel(const char *begin, const char *end,
+                                 CircuitGraph *ckt, int threadCount);
+    void     ScanChunkLines(ScanChunk *chunk) const;
+    int      MergeChunk(const ScanChunk &chunk, CircuitGraph *ckt);
+
+    int      ParseHierarchyLine(LineKind kind, std::string_view line,
+                                const std::string_view *tokens, int count, CircuitGraph *ckt);
+    int      ParseInclude(std::string_view line, CircuitGraph *ckt);
+
+    LineKind ScanLine(std::string_view line, std::vector<std::string_view> *tokens, int *count,
+                      DeviceType *type, double *value) const;
+    LineKind ScanDotCard(std::string_view card) const;
+    bool     ParseValue(std::string_view token, double *value) const;
+    static bool IsHierarchyLine(LineKind kind) { return kind >= InstanceLine; }
+    void     PrintError(const char *msg, std::string_view line) const;
+
+    std::string                                  m_netlist;
+    int                                          m_threadCount;
+    int                                          m_lineno;
+    bool                                         m_ended;
+    Subckt                                      *m_subckt;       // open .subckt
+    int                                          m_includeDepth;
+    int                                          m_includeCount;
+    qint64                                       m_bytes;
+};
+
+#endif // NETLISTVIZ_PARSER_MMAPSCANNER_H
@@ -1,27 +1,30 @@
 #include "MyParser.h"
 #include <iostream>
+#include <QFileInfo>
+#include <QElapsedTimer>
 #include "Define/Define.h"
+#include "CktParseState.h"
+#include "CktParser.hpp"
+#include "MmapScanner.h"
+#include "NetlistCache.h"
+#include "InputSource.h"
+#include "ParasiticReader.h"
 
-extern FILE *yyin;
+/* reentrant scanner interface, defined in CktScanner.cpp */
+extern int  yylex_init_extra(CktParseState *state, yyscan_t *scanner);
+extern int  yylex_destroy(yyscan_t scanner);
 
 
 MyParser::MyParser()
 {
-    m_cktParser = nullptr;
-    yyin = NULL;
+    m_scanMode = AutoScan;
+    m_threadCount = 0;
+    m_useCache = true;
+    m_includeCount = 0;
 }
 
 MyParser::~MyParser()
 {
-    if (m_cktParser) {
-        delete m_cktParser;
-        m_cktParser = nullptr;
-    }
-
-    if (yyin) {
-        fclose(yyin);
-        yyin = NULL;
-    }
 }
 
 int MyParser::ParseNetlist(const std::string &netlist, CircuitGraph *ckt)
@@ -30,21 +33,114 @@ int MyParser::ParseNetlist(const std::string &netlist, CircuitGraph *ckt)
 #ifdef TRACE
     std::cout << LINE_INFO << std::endl;
 #endif
-    yyin = fopen(netlist.c_str(), "r");
-    if (NOT yyin) {
+
+    qint64 bytes = QFileInfo(QString::fromStdString(netlist)).size();
+    ScanMode mode = m_scanMode;
+    if (mode == AutoScan)
+        mode = (bytes >= MMAP_SCAN_MIN_BYTES) ? MmapScan : FlexScan;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    /* big netlists keep a binary snapshot next to them */
+    bool useCache = (m_useCache AND bytes >= NETLIST_CACHE_MIN_BYTES);
+    NetlistCache cache(netlist);
+    bool parasitic = ParasiticReader::IsParasitic(netlist);
+    const char *how = parasitic ? "[parasitic] " : (mode == MmapScan) ? "[mmap] " : "[flex] ";
+
+    int error = OKAY;
+    if (useCache AND cache.Load(ckt) == OKAY) {
+        how = "[cache] ";
+    } else {
+        if (parasitic)
+            error = ParseByParasitic(netlist, ckt);
+        else if (mode == MmapScan)
+            error = ParseByMmap(netlist, ckt);
+        else
+            error = ParseByFlex(netlist, ckt);
+
+        /*
+         * the snapshot is keyed by this file only and keeps flat devices,
+         * so netlists with .include or .subckt are not cached
+         */
+        if (useCache AND NOT error AND m_includeCount == 0 AND NOT ckt->Hierarchical())
+            cache.Save(ckt);
+    }
+    Q_UNUSED(how);
+
+#ifdef TRACE
+    qint64 ms = timer.elapsed();
+    double mb = bytes / (1024.0 * 1024.0);
+    std::cout << how << netlist << " : "
+              << mb << " MB in " << ms << " ms ("
+              << (ms > 0 ? mb * 1000.0 / ms : 0.0) << " MB/s)" << std::endl;
+    ckt->GetNamePool()->PrintMemoryUsage();
+#endif
+
+    return error;
+}
+
+int MyParser::ParseByFlex(const std::string &netlist, CircuitGraph *ckt)
+{
+    m_includeCount = 0;
+
+    InputSource *input = InputSource::Open(netlist);
+    if (NOT input) {
         std::cout << "Open " << netlist << " failed.\n" << std::endl;
-        fclose(yyin);
         return ERROR;
     }
 
-    if (m_cktParser) {
-        delete m_cktParser;
+    CktParseState state(ckt, input, netlist);
+    yyscan_t scanner = nullptr;
+    if (yylex_init_extra(&state, &scanner)) {
+        std::cout << "Init scanner for " << netlist << " failed.\n" << std::endl;
+        delete input;
+        return ERROR;
     }
 
-    m_cktParser = new yy::CktParser(ckt);
-    m_cktParser->parse();
+    yy::CktParser parser(scanner, &state);
+    int error = parser.parse();
+    m_includeCount = state.includeCount;
+
+    /* inputs of .include files left open by an error are freed by state */
+    yylex_destroy(scanner);
+    delete input;
+
+    if (error || state.errors)
+        return ERROR;
 
-    fclose(yyin);
-    yyin = NULL;
     return OKAY;
-}
\ No newline at end of file
+}
+
+int MyParser::ParseByMmap(const std::string &netlist, CircuitGraph *ckt)
+{
+    MmapScanner scanner;
+    scanner.SetThreadCount(m_threadCount);
+    m_includeCount = 0;
+
+    /* compressed netlists can not be mapped, scan the decoded stream */
+    if (InputSource::IsCompressed(netlist)) {
+        InputSource *input = InputSource::Open(netlist);
+        if (NOT input) {
+            std::cout << "Open " << netlist << " failed.\n" << std::endl;
+            return ERROR;
+        }
+        int error = scanner.ParseStream(netlist, input, ckt);
+        delete input;
+        m_includeCount = scanner.IncludeCount();
+        return error;
+    }
+
+    int error = scanner.ParseNetlist(netlist, ckt);
+    m_includeCount = scanner.IncludeCount();
+    return error;
+}
+
+/* DSPF/SPEF, ScanMode does not apply */
+int MyParser::ParseByParasitic(const std::string &netlist, CircuitGraph *ckt)
+{
+    m_includeCount = 0;
+
+    ParasiticReader reader;
+    return reader.ReadNetlist(netlist, ckt);
+}
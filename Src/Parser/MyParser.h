@@ -4,18 +4,38 @@
 #include <fstream>
 #include <string>
 #include "Circuit/CircuitGraph.h"
-#include "CktParser.hpp"
 
+/*
+ * MyParser keeps no global state, every ParseNetlist call uses its own
+ * scanner and CktParseState, so it is safe to fill several CircuitGraphs
+ * from different threads at the same time.
+ */
 class MyParser
 {
 public:
+    /* AutoScan : MmapScan for big netlists, FlexScan for the others,
+     * DSPF/SPEF files (ParasiticReader::IsParasitic) are always streamed */
+    enum ScanMode { AutoScan = 0, FlexScan, MmapScan };
+
     MyParser();
     ~MyParser();
 
-    int ParseNetlist(const std::string &netlist, CircuitGraph *ckt);
+    void SetScanMode(ScanMode mode) { m_scanMode = mode; }
+    /* threads for MmapScan, 0 : QThread::idealThreadCount() */
+    void SetThreadCount(int count) { m_threadCount = count; }
+    /* load/save NetlistCache snapshot for netlists >= NETLIST_CACHE_MIN_BYTES */
+    void SetUseCache(bool use) { m_useCache = use; }
+    int  ParseNetlist(const std::string &netlist, CircuitGraph *ckt);
 
 private:
-    yy::CktParser *m_cktParser;
+    int  ParseByFlex(const std::string &netlist, CircuitGraph *ckt);
+    int  ParseByMmap(const std::string &netlist, CircuitGraph *ckt);
+    int  ParseByParasitic(const std::string &netlist, CircuitGraph *ckt);
+
+    ScanMode m_scanMode;
+    int      m_threadCount;
+    bool     m_useCache;
+    int      m_includeCount;    // .include files read by the last parse
 };
 
-#endif // NETLISTVIZ_PARSER_MYPARSER_H
\ No newline at end of file
+#endif // NETLISTVIZ_PARSER_MYPARSER_H
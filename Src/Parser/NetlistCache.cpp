@@ -0,0 +1,294 @@
+#include "NetlistCache.h"
+#include <cstring>
+#include <iostream>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QCryptographicHash>
+#include <QHash>
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/Device.h"
+#include "Circuit/DeviceTraits.h"
+#include "Circuit/Node.h"
+#include "Circuit/Terminal.h"
+
+static const char   CACHE_MAGIC[8] = { 'N', 'V', 'Z', 'C', 'K', 'T', '\0', '\0' };
+static const quint32 CACHE_ENDIAN = 0x01020304;
+static const char   *CACHE_SUFFIX = ".nvc";
+
+/* hash the netlist in pieces, addData takes int length */
+static const qint64 HASH_PIECE_BYTES = 64LL << 20;
+
+/*
+ * Layout : CacheHeader | CacheDevice[deviceCount] | CacheNode[nodeCount]
+ *          | NameId[markCount] (padded to 8 bytes) | NamePool
+ * Nodes are in CircuitGraph::GetNodeList() order, devices in GetDeviceList()
+ * order, inserting them in the same order gives the same ids.
+ */
+struct CacheHeader
+{
+    char    magic[8];
+    quint32 version;
+    quint32 endian;
+    qint64  netlistSize;
+    char    hash[16];   // md5 of netlist content
+    quint32 deviceCount;
+    quint32 nodeCount;
+    quint32 markCount;  // .FIRSTLEVEL
+    quint32 reserved;
+    qint64  namesSize;
+};
+
+struct CacheDevice
+{
+    double  value;
+    NameId  name;
+    quint32 type;
+    quint32 nodes[MAX_DEVICE_TERMINALS];  // indexes into nodes, DeviceTraits pin order
+};
+
+struct CacheNode
+{
+    NameId  name;
+    quint32 gnd;
+};
+
+static inline qint64 MarksBytes(quint32 markCount)
+{
+    return ((qint64)markCount * sizeof(NameId) + 7) & ~7LL;
+}
+
+
+NetlistCache::NetlistCache(const std::string &netlist)
+{
+    m_netlist = netlist;
+    m_cachePath = QString::fromStdString(netlist + CACHE_SUFFIX);
+    m_netlistSize = QFileInfo(QString::fromStdString(netlist)).size();
+}
+
+NetlistCache::~NetlistCache()
+{
+}
+
+int NetlistCache::Load(CircuitGraph *ckt)
+{
+    assert(ckt);
+
+    if (ckt->DeviceCount() > 0 || ckt->GetNamePool()->Count() > 0)
+        return ERROR;
+
+    QFile file(m_cachePath);
+    if (NOT file.exists() || NOT file.open(QIODevice::ReadOnly))
+        return ERROR;
+
+    qint64 size = file.size();
+    if (size < (qint64)sizeof(CacheHeader)) {
+        file.close();
+        return ERROR;
+    }
+
+    uchar *data = file.map(0, size);
+    if (NOT data) {
+        file.close();
+        return ERROR;
+    }
+
+    int error = Restore(reinterpret_cast<const char*>(data), size, ckt);
+
+    file.unmap(data);
+    file.close();
+
+#ifdef TRACE
+    std::cout << "[cache] " << m_cachePath.toStdString()
+              << (error ? " rejected" : " loaded") << std::endl;
+#endif
+
+    return error;
+}
+
+/* validate everything before touching ckt, so a bad snapshot leaves it empty */
+int NetlistCache::Restore(const char *data, qint64 size, CircuitGraph *ckt)
+{
+    CacheHeader header;
+    memcpy(&header, data, sizeof(header));
+
+    if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0
+        || header.version != NETLIST_CACHE_VERSION
+        || header.endian != CACHE_ENDIAN
+        || header.netlistSize != m_netlistSize)
+        return ERROR;
+
+    qint64 devicesBytes = (qint64)header.deviceCount * sizeof(CacheDevice);
+    qint64 nodesBytes = (qint64)header.nodeCount * sizeof(CacheNode);
+    qint64 marksBytes = MarksBytes(header.markCount);
+    if (size != (qint64)sizeof(header) + devicesBytes + nodesBytes + marksBytes + header.namesSize)
+        return ERROR;
+
+    /* size matches, now the expensive check */
+    QByteArray hash;
+    if (ContentHash(&hash) || hash.size() != (int)sizeof(header.hash)
+        || memcmp(hash.constData(), header.hash, sizeof(header.hash)) != 0)
+        return ERROR;
+
+    /* sections are 8-byte aligned in the mapping, read them in place */
+    const CacheDevice *devices = reinterpret_cast<const CacheDevice*>(data + sizeof(header));
+    const CacheNode *nodes = reinterpret_cast<const CacheNode*>(data + sizeof(header) + devicesBytes);
+    const NameId *marks = reinterpret_cast<const NameId*>(data + sizeof(header) + devicesBytes + nodesBytes);
+    const char *names = data + sizeof(header) + devicesBytes + nodesBytes + marksBytes;
+
+    /* the first word of the names section is the entry count */
+    quint32 entryCount = 0;
+    if (header.namesSize < (qint64)sizeof(entryCount))
+        return ERROR;
+    memcpy(&entryCount, names, sizeof(entryCount));
+
+    for (quint32 i = 0; i < header.nodeCount; ++ i) {
+        if (nodes[i].name == NO_NAME || nodes[i].name >= entryCount)
+            return ERROR;
+    }
+    for (quint32 i = 0; i < header.deviceCount; ++ i) {
+        const CacheDevice &record = devices[i];
+        if (record.name == NO_NAME || record.name >= entryCount
+            || record.type >= GND)
+            return ERROR;
+        for (int pin = 0; pin < Traits(static_cast<DeviceType>(record.type)).terminalCount; ++ pin) {
+            if (record.nodes[pin] >= header.nodeCount)
+                return ERROR;
+        }
+    }
+    for (quint32 i = 0; i < header.markCount; ++ i) {
+        if (marks[i] == NO_NAME || marks[i] >= entryCount)
+            return ERROR;
+    }
+
+    if (NOT ckt->GetNamePool()->Deserialize(names, header.namesSize))
+        return ERROR;
+
+    ckt->Reserve(header.deviceCount, header.nodeCount);
+
+    NodeList nodeList;
+    nodeList.reserve(header.nodeCount);
+    for (quint32 i = 0; i < header.nodeCount; ++ i)
+        nodeList.push_back(ckt->InsertNode(nodes[i].name, nodes[i].gnd));
+
+    Node *deviceNodes[MAX_DEVICE_TERMINALS];
+    for (quint32 i = 0; i < header.deviceCount; ++ i) {
+        const CacheDevice &record = devices[i];
+        DeviceType type = static_cast<DeviceType>(record.type);
+        for (int pin = 0; pin < Traits(type).terminalCount; ++ pin)
+            deviceNodes[pin] = nodeList.at(record.nodes[pin]);
+        ckt->InsertDevice(type, record.name, deviceNodes, record.value);
+    }
+
+    for (quint32 i = 0; i < header.markCount; ++ i)
+        ckt->MarkFirstLevel(marks[i]);
+
+    return OKAY;
+}
+
+int NetlistCache::Save(const CircuitGraph *ckt)
+{
+    assert(ckt);
+
+    CacheHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = NETLIST_CACHE_VERSION;
+    header.endian = CACHE_ENDIAN;
+    header.netlistSize = m_netlistSize;
+
+    QByteArray hash;
+    if (ContentHash(&hash) || hash.size() != (int)sizeof(header.hash))
+        return ERROR;
+    memcpy(header.hash, hash.constData(), sizeof(header.hash));
+
+    NodeList nodeList = ckt->GetNodeList();
+    QHash<Node*, quint32> nodeIndex;
+    nodeIndex.reserve(nodeList.size());
+    std::vector<CacheNode> nodeRecords(nodeList.size());
+    for (int i = 0; i < nodeList.size(); ++ i) {
+        Node *node = nodeList.at(i);
+        nodeIndex.insert(node, i);
+        nodeRecords[i].name = node->GetNameId();
+        nodeRecords[i].gnd = node->IsGnd();
+    }
+
+    DeviceList deviceList = ckt->GetDeviceList();
+    std::vector<CacheDevice> deviceRecords(deviceList.size());
+    for (int i = 0; i < deviceList.size(); ++ i) {
+        Device *device = deviceList.at(i);
+        CacheDevice &record = deviceRecords[i];
+        memset(&record, 0, sizeof(record));
+        record.value = device->Value();
+        record.name = device->GetNameId();
+        record.type = device->GetDeviceType();
+        for (int pin = 0; pin < device->TerminalCount(); ++ pin)
+            record.nodes[pin] = nodeIndex.value(device->TerminalAt(pin)->GetNode());
+    }
+
+    QVector<NameId> marks = ckt->FirstLevelMarks();
+    marks.resize(MarksBytes(marks.size()) / sizeof(NameId));   // zero padded
+
+    QByteArray names = ckt->GetNamePool()->Serialize();
+    header.deviceCount = deviceRecords.size();
+    header.nodeCount = nodeRecords.size();
+    header.markCount = ckt->FirstLevelMarks().size();
+    header.namesSize = names.size();
+
+    /* QSaveFile, a half written snapshot never replaces the old one */
+    QSaveFile file(m_cachePath);
+    if (NOT file.open(QIODevice::WriteOnly))
+        return ERROR;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(deviceRecords.data()),
+               deviceRecords.size() * sizeof(CacheDevice));
+    file.write(reinterpret_cast<const char*>(nodeRecords.data()),
+               nodeRecords.size() * sizeof(CacheNode));
+    file.write(reinterpret_cast<const char*>(marks.constData()), marks.size() * sizeof(NameId));
+    file.write(names);
+    if (NOT file.commit())
+        return ERROR;
+
+#ifdef TRACE
+    std::cout << "[cache] " << m_cachePath.toStdString() << " saved" << std::endl;
+#endif
+
+    return OKAY;
+}
+
+int NetlistCache::ContentHash(QByteArray *hash)
+{
+    if (NOT m_hash.isEmpty()) {
+        *hash = m_hash;
+        return OKAY;
+    }
+
+    QFile file(QString::fromStdString(m_netlist));
+    if (NOT file.open(QIODevice::ReadOnly))
+        return ERROR;
+
+    qint64 size = file.size();
+    uchar *data = (size > 0) ? file.map(0, size) : nullptr;
+    if (size > 0 AND NOT data) {
+        file.close();
+        return ERROR;
+    }
+
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    for (qint64 offset = 0; offset < size; offset += HASH_PIECE_BYTES) {
+        qint64 piece = qMin(HASH_PIECE_BYTES, size - offset);
+        md5.addData(reinterpret_cast<const char*>(data) + offset, (int)piece);
+    }
+
+    if (data)
+        file.unmap(data);
+    file.close();
+
+    /* the file may change between QFileInfo and here */
+    if (size != m_netlistSize)
+        return ERROR;
+
+    m_hash = md5.result();
+    *hash = m_hash;
+    return OKAY;
+}
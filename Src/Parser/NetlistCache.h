@@ -0,0 +1,50 @@
+#ifndef NETLISTVIZ_PARSER_NETLISTCACHE_H
+#define NETLISTVIZ_PARSER_NETLISTCACHE_H
+
+/*
+ * @filename : NetlistCache.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Binary snapshot of a parsed CircuitGraph, written next to
+ *           : the netlist (xxx.sp -> xxx.sp.nvc). It keeps devices, their
+ *           : terminal nodes, values, .FIRSTLEVEL marks and the interned
+ *           : names, and is keyed
+ *           : by netlist content hash and NETLIST_CACHE_VERSION. Reopening
+ *           : maps the snapshot and rebuilds the graph without scanning.
+ */
+
+#include <string>
+#include <QString>
+#include <QByteArray>
+#include "Define/Define.h"
+
+class CircuitGraph;
+
+/* bump when the parser or the snapshot layout changes */
+const static quint32 NETLIST_CACHE_VERSION = 3;
+
+class NetlistCache
+{
+public:
+    explicit NetlistCache(const std::string &netlist);
+    ~NetlistCache();
+
+    /* OKAY if ckt (empty) is restored from a valid snapshot */
+    int     Load(CircuitGraph *ckt);
+    int     Save(const CircuitGraph *ckt);
+    QString CachePath() const { return m_cachePath; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(NetlistCache);
+
+    int     ContentHash(QByteArray *hash);
+    int     Restore(const char *data, qint64 size, CircuitGraph *ckt);
+
+    std::string  m_netlist;
+    QString      m_cachePath;
+    qint64       m_netlistSize;
+    QByteArray   m_hash;        // computed once, shared by Load and Save
+};
+
+#endif // NETLISTVIZ_PARSER_NETLISTCACHE_H
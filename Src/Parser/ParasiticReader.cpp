@@ -0,0 +1,453 @@
+#include "ParasiticReader.h"
+#include <iostream>
+#include <cstring>
+#include <climits>
+#include <charconv>
+#include <QDebug>
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/Node.h"
+#include "SpiceValue.h"
+#include "InputSource.h"
+
+/* bytes pulled from the InputSource per round */
+static const qint64 READ_BLOCK_BYTES = 1LL << 20;
+
+/* tokens looked at per line, the rest (i.e. DSPF $ comments) is ignored */
+static const int MAX_LINE_TOKENS = 8;
+
+/* *C_UNIT, *R_UNIT, *L_UNIT words */
+struct SpefUnit
+{
+    const char *name;   // lower case
+    double      scale;
+};
+
+static const SpefUnit SPEF_UNITS[] = {
+    { "ff", 1e-15 }, { "pf", 1e-12 },
+    { "ohm", 1.0 }, { "kohm", 1e3 },
+    { "henry", 1.0 }, { "mh", 1e-3 }, { "uh", 1e-6 },
+};
+
+static inline bool IsBlank(char c)
+{
+    return (c == ' ' || c == '\t' || c == '\r');
+}
+
+static inline char ToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
+}
+
+/* case-insensitive compare, word is lower case */
+static bool MatchWord(std::string_view token, const char *word)
+{
+    size_t len = strlen(word);
+    if (token.size() != len)
+        return false;
+    for (size_t i = 0; i < len; ++ i) {
+        if (ToLower(token[i]) != word[i])
+            return false;
+    }
+    return true;
+}
+
+static bool EndsWith(const std::string &text, const char *suffix)
+{
+    size_t len = strlen(suffix);
+    if (text.size() < len)
+        return false;
+    return MatchWord(std::string_view(text).substr(text.size() - len), suffix);
+}
+
+/* split by blanks, at most MAX_LINE_TOKENS */
+static int SplitLine(std::string_view line, std::string_view *tokens)
+{
+    int count = 0;
+    const char *q = line.data();
+    const char *lineEnd = q + line.size();
+    while (q < lineEnd AND count < MAX_LINE_TOKENS) {
+        while (q < lineEnd AND IsBlank(*q)) q++;
+        if (q >= lineEnd) break;
+        const char *tokBegin = q;
+        while (q < lineEnd AND NOT IsBlank(*q)) q++;
+        tokens[count++] = std::string_view(tokBegin, q - tokBegin);
+    }
+    return count;
+}
+
+
+ParasiticReader::ParasiticReader()
+{
+    m_format = UnknownFormat;
+    m_section = HeaderSection;
+    m_ended = false;
+    m_lineno = 0;
+    m_bytes = 0;
+    m_delimiter = ':';
+    m_capUnit = 1.0;
+    m_resUnit = 1.0;
+    m_inducUnit = 1.0;
+    m_netCount = 0;
+}
+
+ParasiticReader::~ParasiticReader()
+{
+}
+
+bool ParasiticReader::IsParasitic(const std::string &path)
+{
+    std::string name = path;
+    if (EndsWith(name, ".gz"))
+        name.resize(name.size() - 3);
+    else if (EndsWith(name, ".zst"))
+        name.resize(name.size() - 4);
+
+    return (EndsWith(name, ".spef") || EndsWith(name, ".dspf") || EndsWith(name, ".spf"));
+}
+
+/* The format is taken from the first line, "*SPEF" or anything else (DSPF) */
+int ParasiticReader::ReadNetlist(const std::string &path, CircuitGraph *ckt)
+{
+    assert(ckt);
+#ifdef TRACE
+    std::cout << LINE_INFO << std::endl;
+#endif
+
+    m_path = path;
+    m_format = UnknownFormat;
+    m_section = HeaderSection;
+    m_ended = false;
+    m_lineno = 0;
+    m_bytes = 0;
+    m_delimiter = ':';
+    m_capUnit = 1.0;
+    m_resUnit = 1.0;
+    m_inducUnit = 1.0;
+    m_netCount = 0;
+    m_nameMap.clear();
+    m_coupled.clear();
+
+    InputSource *input = InputSource::Open(path);
+    if (NOT input) {
+        std::cout << "Open " << path << " failed.\n" << std::endl;
+        return ERROR;
+    }
+
+    int error = ReadLines(input, ckt);
+    delete input;
+
+    /* the name map is only needed while reading */
+    m_nameMap.clear();
+    m_nameMap.shrink_to_fit();
+    m_coupled.clear();
+
+#ifdef TRACE
+    std::cout << (m_format == SpefFormat ? "[spef] " : "[dspf] ") << path
+              << " : " << ckt->DeviceCount() << " devices, "
+              << ckt->GetNodeList().size() << " nodes" << std::endl;
+#endif
+
+    return error;
+}
+
+/* the same block loop as MmapScanner::ScanStream, an unfinished line is carried */
+int ParasiticReader::ReadLines(InputSource *input, CircuitGraph *ckt)
+{
+    std::vector<char> buffer;
+    size_t carry = 0;
+
+    while (NOT m_ended) {
+        buffer.resize(carry + READ_BLOCK_BYTES);
+        qint64 n = input->Read(buffer.data() + carry, READ_BLOCK_BYTES);
+        if (n < 0) {
+            std::cerr << "Error : " << m_path << " : read failed" << std::endl;
+            return ERROR;
+        }
+
+        const char *p = buffer.data();
+        const char *end = p + carry + n;
+        while (p < end AND NOT m_ended) {
+            const char *lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+            if (NOT lineEnd) {
+                if (n > 0)
+                    break;      // wait for the rest of the line
+                lineEnd = end;
+            }
+            std::string_view line(p, lineEnd - p);
+            m_lineno++;
+            m_bytes += (lineEnd - p) + (lineEnd < end ? 1 : 0);
+            p = lineEnd + 1;
+
+            if (ParseLine(line, ckt))
+                return ERROR;
+        }
+
+        if (n == 0)
+            break;
+        carry = (p < end) ? end - p : 0;
+        memmove(buffer.data(), p, carry);
+    }
+
+    return OKAY;
+}
+
+int ParasiticReader::ParseLine(std::string_view line, CircuitGraph *ckt)
+{
+    if (m_format == UnknownFormat) {
+        std::string_view tokens[MAX_LINE_TOKENS];
+        if (SplitLine(line, tokens) == 0)
+            return OKAY;
+        m_format = MatchWord(tokens[0], "*spef") ? SpefFormat : DspfFormat;
+    }
+
+    if (m_format == SpefFormat)
+        return ParseSpefLine(line, ckt);
+
+    return ParseDspfLine(line, ckt);
+}
+
+/*
+ * DSPF is SPICE with *| comments : R/C/L lines are inserted, X and M lines
+ * (the cells), .subckt and continuation lines are skipped.
+ */
+int ParasiticReader::ParseDspfLine(std::string_view line, CircuitGraph *ckt)
+{
+    std::string_view tokens[MAX_LINE_TOKENS];
+    int count = SplitLine(line, tokens);
+    if (count == 0)
+        return OKAY;
+
+    char first = ToLower(tokens[0][0]);
+    if (first == '*' || first == '+' || first == '$')
+        return OKAY;
+
+    if (first == '.') {
+        if (MatchWord(tokens[0], ".end"))
+            m_ended = true;
+        return OKAY;
+    }
+
+    DeviceType type = Other;
+    switch (first) {
+        case 'r': type = RESISTOR;  break;
+        case 'c': type = CAPACITOR; break;
+        case 'l': type = INDUCTOR;  break;
+        default:
+            return OKAY;
+    }
+
+    double value = 0;
+    if (count < 4 || NOT ParseSpiceValue(tokens[3], &value)) {
+        PrintError("syntax error", line);
+        return ERROR;
+    }
+
+    /* a redefined device is reported by CircuitGraph, as in CktParser.y */
+    ckt->InsertDevice(type, tokens[0], tokens + 1, value);
+
+    return OKAY;
+}
+
+int ParasiticReader::ParseSpefLine(std::string_view line, CircuitGraph *ckt)
+{
+    std::string_view tokens[MAX_LINE_TOKENS];
+    int count = SplitLine(line, tokens);
+    if (count == 0)
+        return OKAY;
+
+    /* "//" comment */
+    if (tokens[0].size() >= 2 AND tokens[0][0] == '/' AND tokens[0][1] == '/')
+        return OKAY;
+
+    /* *KEYWORD, not a *123 name map index */
+    std::string_view head = tokens[0];
+    if (head[0] == '*' AND head.size() > 1 AND NOT (head[1] >= '0' AND head[1] <= '9'))
+        return ParseSpefKeyword(tokens, count);
+
+    switch (m_section) {
+        case NameMapSection: {
+            if (count < 2 || head[0] != '*')
+                break;
+            size_t index = 0;
+            auto result = std::from_chars(head.data() + 1, head.data() + head.size(), index);
+            if (result.ec != std::errc() || index > (size_t)INT_MAX) {
+                PrintError("bad name map index", line);
+                return ERROR;
+            }
+            if (index >= m_nameMap.size())
+                m_nameMap.resize(index + 1);
+            m_nameMap[index] = tokens[1];
+            break;
+        }
+        case CapSection:
+            return ParseSpefElement(CAPACITOR, tokens, count, ckt);
+        case ResSection:
+            return ParseSpefElement(RESISTOR, tokens, count, ckt);
+        case InducSection:
+            return ParseSpefElement(INDUCTOR, tokens, count, ckt);
+        default:
+            break;
+    }
+
+    return OKAY;
+}
+
+/* keywords not handled here (*P, *I, *N, *DESIGN, ...) keep the section */
+int ParasiticReader::ParseSpefKeyword(const std::string_view *tokens, int count)
+{
+    std::string_view keyword = tokens[0];
+
+    if (MatchWord(keyword, "*d_net")) {
+        if (count < 2) {
+            PrintError("syntax error", keyword);
+            return ERROR;
+        }
+        ResolveSpefName(tokens[1], &m_net);
+        m_netCount++;
+        m_section = NetSection;
+    } else if (MatchWord(keyword, "*cap")) {
+        m_section = (m_section == SkipSection) ? SkipSection : CapSection;
+    } else if (MatchWord(keyword, "*res")) {
+        m_section = (m_section == SkipSection) ? SkipSection : ResSection;
+    } else if (MatchWord(keyword, "*induc")) {
+        m_section = (m_section == SkipSection) ? SkipSection : InducSection;
+    } else if (MatchWord(keyword, "*conn")) {
+        m_section = (m_section == SkipSection) ? SkipSection : NetSection;
+    } else if (MatchWord(keyword, "*end")) {
+        m_section = HeaderSection;
+    } else if (MatchWord(keyword, "*name_map")) {
+        m_section = NameMapSection;
+    } else if (MatchWord(keyword, "*r_net") || MatchWord(keyword, "*ports")
+               || MatchWord(keyword, "*physical_ports") || MatchWord(keyword, "*define")
+               || MatchWord(keyword, "*pdefine") || MatchWord(keyword, "*power_nets")
+               || MatchWord(keyword, "*ground_nets") || MatchWord(keyword, "*variables")) {
+        /* reduced nets have no RC, the others no elements */
+        m_section = SkipSection;
+    } else if (MatchWord(keyword, "*c_unit")) {
+        return ParseSpefUnit(tokens, count, &m_capUnit);
+    } else if (MatchWord(keyword, "*r_unit")) {
+        return ParseSpefUnit(tokens, count, &m_resUnit);
+    } else if (MatchWord(keyword, "*l_unit")) {
+        return ParseSpefUnit(tokens, count, &m_inducUnit);
+    } else if (MatchWord(keyword, "*delimiter")) {
+        if (count >= 2 AND tokens[1].size() == 1)
+            m_delimiter = tokens[1][0];
+    }
+
+    return OKAY;
+}
+
+/* *C_UNIT 1 FF */
+int ParasiticReader::ParseSpefUnit(const std::string_view *tokens, int count, double *unit) const
+{
+    double number = 0;
+    if (count < 3 || NOT ParseSpiceValue(tokens[1], &number)) {
+        PrintError("bad unit", tokens[0]);
+        return ERROR;
+    }
+
+    for (const SpefUnit &spefUnit : SPEF_UNITS) {
+        if (MatchWord(tokens[2], spefUnit.name)) {
+            *unit = number * spefUnit.scale;
+            return OKAY;
+        }
+    }
+
+    PrintError("bad unit", tokens[2]);
+    return ERROR;
+}
+
+/* id node value (ground cap) or id node node value */
+int ParasiticReader::ParseSpefElement(DeviceType type, const std::string_view *tokens,
+                                      int count, CircuitGraph *ckt)
+{
+    bool toGnd = (type == CAPACITOR AND count == 3);
+    if (count < (toGnd ? 3 : 4)) {
+        PrintError("syntax error", tokens[0]);
+        return ERROR;
+    }
+
+    double unit = (type == CAPACITOR) ? m_capUnit : (type == RESISTOR) ? m_resUnit : m_inducUnit;
+    double value = 0;
+    if (NOT ParseSpefValue(tokens[toGnd ? 2 : 3], unit, &value)) {
+        PrintError("bad value", tokens[toGnd ? 2 : 3]);
+        return ERROR;
+    }
+
+    m_deviceName = m_net;
+    m_deviceName += '/';
+    m_deviceName += (type == CAPACITOR) ? 'C' : (type == RESISTOR) ? 'R' : 'L';
+    m_deviceName.append(tokens[0].data(), tokens[0].size());
+
+    ResolveSpefName(tokens[1], &m_posName);
+    if (toGnd)
+        m_negName = "0";
+    else
+        ResolveSpefName(tokens[2], &m_negName);
+
+    Node *posNode = ckt->InsertNode(m_posName);
+    Node *negNode = ckt->InsertNode(m_negName);
+
+    /*
+     * A coupled cap may be listed by both of its nets, each under its own
+     * id. The first net listing a node pair owns it: all its caps there
+     * are kept (two caps between the same nodes differ in id), the same
+     * caps listed again by another net are skipped, before any interning.
+     */
+    if (type == CAPACITOR AND NOT toGnd) {
+        quint64 low = qMin(posNode->Id(), negNode->Id());
+        quint64 high = qMax(posNode->Id(), negNode->Id());
+        auto owner = m_coupled.emplace((high << 32) | low, m_netCount);
+        if (owner.first->second != m_netCount)
+            return OKAY;    // the same cap, listed by the other net
+    }
+
+    NameId name = ckt->InternName(m_deviceName);
+    if (ckt->Redefined(type, name)) {
+        qInfo() << "ERROR: Redefine " << ckt->GetNamePool()->Name(name) << endl;
+        return OKAY;
+    }
+
+    Node *nodes[] = { posNode, negNode };
+    return ckt->InsertDevice(type, name, nodes, value);
+}
+
+/* plain or min:typ:max, the first one is taken */
+bool ParasiticReader::ParseSpefValue(std::string_view token, double unit, double *value) const
+{
+    size_t colon = token.find(':');
+    if (colon != std::string_view::npos)
+        token = token.substr(0, colon);
+
+    if (NOT ParseSpiceValue(token, value))
+        return false;
+
+    *value *= unit;
+    return true;
+}
+
+/* *12:A -> <name of *12>:A, names without a * index are taken as they are */
+void ParasiticReader::ResolveSpefName(std::string_view token, std::string *name) const
+{
+    if (token.size() > 1 AND token[0] == '*') {
+        size_t index = 0;
+        const char *begin = token.data() + 1;
+        const char *end = token.data() + token.size();
+        auto result = std::from_chars(begin, end, index);
+        if (result.ec == std::errc() AND index < m_nameMap.size()
+            AND NOT m_nameMap[index].empty()
+            AND (result.ptr == end || *result.ptr == m_delimiter)) {
+            name->assign(m_nameMap[index]);
+            name->append(result.ptr, end - result.ptr);
+            return;
+        }
+    }
+
+    name->assign(token.data(), token.size());
+}
+
+void ParasiticReader::PrintError(const char *msg, std::string_view line) const
+{
+    std::cerr << "Error : " << m_path << ":" << m_lineno << " : " << msg
+              << " : " << line << std::endl;
+}
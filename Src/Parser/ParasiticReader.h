@@ -0,0 +1,83 @@
+#ifndef NETLISTVIZ_PARSER_PARASITICREADER_H
+#define NETLISTVIZ_PARSER_PARASITICREADER_H
+
+/*
+ * @filename : ParasiticReader.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Streaming reader for extracted RC networks in DSPF or SPEF.
+ *           : Lines are read block by block from an InputSource (so .gz
+ *           : works too) and each R/C/L goes into CircuitGraph at once, no
+ *           : text is kept but one block, the SPEF name map and the node
+ *           : pairs of coupled caps. A cap to one node is a ground cap, a
+ *           : cap between two nets a coupled one.
+ *           : SPEF elements are named <net>/R<id>, <net>/C<id>.
+ */
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class CircuitGraph;
+class InputSource;
+
+class ParasiticReader
+{
+public:
+    ParasiticReader();
+    ~ParasiticReader();
+
+    /* by suffix (.spef, .dspf, .spf), a trailing .gz or .zst is skipped */
+    static bool IsParasitic(const std::string &path);
+
+    int    ReadNetlist(const std::string &path, CircuitGraph *ckt);
+    qint64 BytesRead() const { return m_bytes; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(ParasiticReader);
+
+    enum Format { UnknownFormat = 0, DspfFormat, SpefFormat };
+
+    /* SPEF sections that matter, everything else is skipped */
+    enum Section { HeaderSection = 0, NameMapSection, NetSection,
+                   CapSection, ResSection, InducSection, SkipSection };
+
+    int    ReadLines(InputSource *input, CircuitGraph *ckt);
+    int    ParseLine(std::string_view line, CircuitGraph *ckt);
+    int    ParseDspfLine(std::string_view line, CircuitGraph *ckt);
+    int    ParseSpefLine(std::string_view line, CircuitGraph *ckt);
+    int    ParseSpefKeyword(const std::string_view *tokens, int count);
+    int    ParseSpefUnit(const std::string_view *tokens, int count, double *unit) const;
+    int    ParseSpefElement(DeviceType type, const std::string_view *tokens,
+                            int count, CircuitGraph *ckt);
+    bool   ParseSpefValue(std::string_view token, double unit, double *value) const;
+    void   ResolveSpefName(std::string_view token, std::string *name) const;
+    void   PrintError(const char *msg, std::string_view line) const;
+
+    std::string              m_path;
+    Format                   m_format;
+    Section                  m_section;
+    bool                     m_ended;
+    int                      m_lineno;
+    qint64                   m_bytes;
+
+    /* SPEF state */
+    char                     m_delimiter;    // *DELIMITER, between net and pin
+    double                   m_capUnit;
+    double                   m_resUnit;
+    double                   m_inducUnit;
+    std::vector<std::string> m_nameMap;      // *NAME_MAP, *index -> name
+    std::string              m_net;          // current *D_NET
+    quint32                  m_netCount;     // *D_NETs so far
+    std::string              m_deviceName;   // scratch, reused for each line
+    std::string              m_posName;
+    std::string              m_negName;
+    /* node id pair of a coupled cap -> the *D_NET (count) listing it first */
+    std::unordered_map<quint64, quint32> m_coupled;
+};
+
+#endif // NETLISTVIZ_PARSER_PARASITICREADER_H
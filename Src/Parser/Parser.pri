@@ -0,0 +1,41 @@
+#####################
+# netlist parser and CircuitGraph, shared by the tests and tools that parse
+# run "make" in Src/Parser first, it generates CktScanner.cpp and CktParser.cpp
+#####################
+
+SRC = $$PWD/..
+
+INCLUDEPATH += $$SRC\
+               $$SRC/Define\
+               $$SRC/Parser\
+               $$SRC/Circuit\
+               $$SRC/ASG\
+               $$SRC/Utilities
+
+SOURCES += $$SRC/Parser/CktScanner.cpp\
+           $$SRC/Parser/CktParser.cpp\
+           $$SRC/Parser/MyParser.cpp\
+           $$SRC/Parser/MmapScanner.cpp\
+           $$SRC/Parser/SpiceValue.cpp\
+           $$SRC/Parser/NetlistCache.cpp\
+           $$SRC/Parser/InputSource.cpp\
+           $$SRC/Parser/ParasiticReader.cpp\
+           $$SRC/Circuit/Node.cpp\
+           $$SRC/Circuit/Terminal.cpp\
+           $$SRC/Circuit/CircuitGraph.cpp\
+           $$SRC/Circuit/Device.cpp\
+           $$SRC/Circuit/Subckt.cpp\
+           $$SRC/Circuit/CompactGraph.cpp\
+           $$SRC/Circuit/Compressor.cpp\
+           $$SRC/Circuit/RCReducer.cpp\
+           $$SRC/ASG/NetIndex.cpp\
+           $$SRC/ASG/Wire.cpp\
+           $$SRC/Utilities/MyString.cpp\
+           $$SRC/Utilities/NamePool.cpp\
+           $$SRC/Utilities/Arena.cpp
+
+# zstd netlists with "qmake CONFIG+=zstd", as Main.pro
+zstd {
+    DEFINES += HAVE_ZSTD
+    LIBS += -lzstd
+}
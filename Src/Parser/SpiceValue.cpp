@@ -0,0 +1,76 @@
+#include "SpiceValue.h"
+#include <charconv>
+#include "Define/Define.h"
+
+static inline char ToLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
+}
+
+static inline bool IsAlpha(char c)
+{
+    c = ToLower(c);
+    return (c >= 'a' && c <= 'z');
+}
+
+static inline bool IsDigit(char c)
+{
+    return (c >= '0' && c <= '9');
+}
+
+/* scale of the suffix starting at p, only its leading letters count */
+static double SuffixScale(const char *p, const char *end)
+{
+    switch (ToLower(*p)) {
+        case 'f': return 1e-15;
+        case 'p': return 1e-12;
+        case 'n': return 1e-9;
+        case 'u': return 1e-6;
+        case 'k': return 1e3;
+        case 'g': return 1e9;
+        case 't': return 1e12;
+        case 'm':
+            if (end - p >= 3 AND ToLower(p[1]) == 'e' AND ToLower(p[2]) == 'g')
+                return 1e6;
+            if (end - p >= 3 AND ToLower(p[1]) == 'i' AND ToLower(p[2]) == 'l')
+                return 25.4e-6;
+            return 1e-3;
+        default:
+            return 1;
+    }
+}
+
+bool ParseSpiceValue(std::string_view text, double *value)
+{
+    const char *p = text.data();
+    const char *end = p + text.size();
+
+    /* from_chars takes '-' but not '+' */
+    bool negative = false;
+    if (p < end AND (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        p++;
+    }
+
+    /* digits or '.' first, no inf/nan/hex */
+    if (p >= end || NOT (IsDigit(*p) || *p == '.'))
+        return false;
+
+    double number = 0;
+    std::from_chars_result result = std::from_chars(p, end, number, std::chars_format::general);
+    if (result.ec != std::errc())
+        return false;
+    p = result.ptr;
+
+    /* the suffix follows at once, as VALUE in CktScanner.l */
+    double scale = 1;
+    if (p < end)
+        scale = SuffixScale(p, end);
+    for (; p < end; ++ p) {
+        if (NOT IsAlpha(*p))
+            return false;
+    }
+
+    *value = (negative ? -number : number) * scale;
+    return true;
+}
@@ -0,0 +1,20 @@
+#ifndef NETLISTVIZ_PARSER_SPICEVALUE_H
+#define NETLISTVIZ_PARSER_SPICEVALUE_H
+
+/*
+ * @filename : SpiceValue.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : SPICE number with scale suffix, i.e. 1.5k, 10meg, 4.7uF.
+ *           : One pass, no locale, no terminating '\0' needed.
+ *           : Scale : f p n u m k meg g t mil (case-insensitive),
+ *           : other trailing letters are units and ignored (s, h, hz, F, ohm).
+ */
+
+#include <string_view>
+
+/* false if text is not a number followed by letters only */
+extern bool ParseSpiceValue(std::string_view text, double *value);
+
+#endif // NETLISTVIZ_PARSER_SPICEVALUE_H
@@ -2,21 +2,28 @@
 #include <QDialogButtonBox>
 #include <QButtonGroup>
 #include <QLabel>
-#include <QScrollArea>
-#include <QGridLayout>
 #include <QCheckBox>
 #include <QDebug>
 #include <QPushButton>
+#include <QFontDatabase>
+#include <QLineEdit>
+#include <QListView>
+#include <QSortFilterProxyModel>
 
 #include "Circuit/CircuitGraph.h"
 #include "Circuit/Device.h"
 #include "Define/TypeDefine.h"
 #include "ASG/ASG.h"
+#include "ASG/GraphStats.h"
+#include "DeviceListModel.h"
 
 ASGDialog::ASGDialog(QWidget *parent)
     : QDialog(parent)
 {
     m_mainLayout = new QVBoxLayout();
+    m_ckt = nullptr;
+    m_asg = nullptr;
+    m_stats = new GraphStats();
     setWindowTitle(tr("ASG Preferences"));
     resize(800, 600);
     setWindowFlag(Qt::WindowStaysOnTopHint);
@@ -25,7 +32,7 @@ ASGDialog::ASGDialog(QWidget *parent)
 
 ASGDialog::~ASGDialog()
 {
-
+    delete m_stats;
 }
 
 void ASGDialog::SetCircuitGraph(CircuitGraph *ckt)
@@ -42,11 +49,16 @@ void ASGDialog::SetASG(ASG *asg)
     m_asg = asg;
 } 
 
+/* SetASG() first, the stats are collected from it */
 void ASGDialog::CreatePropertyWidgets()
 {
+    if (m_asg)
+        m_asg->CollectStats(m_stats);
 
     CreateFLWidget();
     CreateICWidget();
+    CreateDOWidget();
+    CreateGSWidget();
 
     m_buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
     connect(m_buttonBox, SIGNAL(accepted()), this, SLOT(Accept()));
@@ -55,59 +67,84 @@ void ASGDialog::CreatePropertyWidgets()
     m_mainLayout->addWidget(m_buttonBox);
 }
 
+/*
+ * A searchable list instead of a checkbox per device, its cost does not
+ * grow with the netlist. .FIRSTLEVEL devices start checked, else the ones
+ * ASG would find itself.
+ */
 void ASGDialog::CreateFLWidget()
 {
-    m_flSelectButtonGroup = new QButtonGroup();
-    m_flSelectButtonGroup->setExclusive(false);
-
     QVBoxLayout *flSelectLayout = new QVBoxLayout;
-    QWidget *flSelectWidget = new QWidget;
-    flSelectWidget->setLayout(flSelectLayout);
+    QFrame *flSelectFrame = new QFrame();
 
     QHBoxLayout *flHeaderLayout = new QHBoxLayout;
-    QLabel *flSelectLabel = new QLabel(tr("Please select first level devices"));
-    flHeaderLayout->addWidget(flSelectLabel);
-    m_flSelectAllCheckBox = new QCheckBox(tr("Select All"));
-    m_flSelectAllCheckBox->setChecked(false);
-    connect(m_flSelectAllCheckBox, SIGNAL(clicked(bool)),
-            this, SLOT(FLSelectAllCheckBoxClicked(bool)));
-
-    QLabel *dummyLabel = new QLabel;
-    flHeaderLayout->addWidget(dummyLabel, 1);
-    flHeaderLayout->addWidget(m_flSelectAllCheckBox);
-
+    QLabel *flSelectLabel = new QLabel(tr("Please select first level devices (none: found automatically)"));
+    flHeaderLayout->addWidget(flSelectLabel, 1);
+    m_flCountLabel = new QLabel;
+    flHeaderLayout->addWidget(m_flCountLabel);
     flSelectLayout->addLayout(flHeaderLayout);
 
-    QGridLayout *flDeviceLayout = new QGridLayout;
-
-    int colIndex = 0, rowIndex = 0;
-    QCheckBox *ckBox = nullptr;
-
-    foreach (Device *dev, m_ckt->GetDeviceList()) {
-        DeviceType dtype = dev->GetDeviceType();
-        if (NOT dev->MaybeAtFirstLevel())  continue;
-
-        ckBox = new QCheckBox(dev->Name());
-        ckBox->setChecked(false);
-        ckBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        flDeviceLayout->addWidget(ckBox, rowIndex, colIndex);
+    QHBoxLayout *flSearchLayout = new QHBoxLayout;
+    QLineEdit *flSearchEdit = new QLineEdit;
+    flSearchEdit->setPlaceholderText(tr("Search device name"));
+    flSearchEdit->setClearButtonEnabled(true);
+    flSearchLayout->addWidget(flSearchEdit, 1);
+
+    QPushButton *checkButton = new QPushButton(tr("Check Shown"));
+    QPushButton *uncheckButton = new QPushButton(tr("Uncheck Shown"));
+    QPushButton *autoButton = new QPushButton(tr("Auto"));
+    autoButton->setToolTip(tr("Sources to ground, floating sources, ports, else a peripheral device"));
+    flSearchLayout->addWidget(checkButton);
+    flSearchLayout->addWidget(uncheckButton);
+    flSearchLayout->addWidget(autoButton);
+    flSelectLayout->addLayout(flSearchLayout);
+
+    m_flDeviceModel = new DeviceListModel(this);
+    connect(m_flDeviceModel, SIGNAL(CheckedCountChanged(int)),
+            this, SLOT(FLCheckedCountChanged(int)));
+    m_flDeviceModel->SetDevices(m_ckt->GetDeviceList());
+
+    m_flFilterModel = new QSortFilterProxyModel(this);
+    m_flFilterModel->setSourceModel(m_flDeviceModel);
+    m_flFilterModel->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    connect(flSearchEdit, SIGNAL(textChanged(QString)),
+            m_flFilterModel, SLOT(setFilterFixedString(QString)));
+
+    /* rows of one height, the view lays out only what it shows */
+    QListView *flDeviceView = new QListView;
+    flDeviceView->setModel(m_flFilterModel);
+    flDeviceView->setUniformItemSizes(true);
+    flDeviceView->setFlow(QListView::TopToBottom);
+    flDeviceView->setSelectionMode(QAbstractItemView::NoSelection);
+    flSelectLayout->addWidget(flDeviceView);
+
+    connect(checkButton, SIGNAL(clicked()), this, SLOT(FLCheckShownClicked()));
+    connect(uncheckButton, SIGNAL(clicked()), this, SLOT(FLUncheckShownClicked()));
+    connect(autoButton, SIGNAL(clicked()), this, SLOT(FLAutoClicked()));
+
+    DeviceList marked = FLMarkedDevices();
+    if (marked.isEmpty())
+        FLAutoClicked();
+    else
+        m_flDeviceModel->SetCheckedDevices(marked);
 
-        m_flSelectButtonGroup->addButton(ckBox, dev->Id());
+    flSelectFrame->setLayout(flSelectLayout);
+    m_mainLayout->addWidget(flSelectFrame, 1);
+}
 
-        colIndex++;
-        if (colIndex >= 5) {
-            colIndex = 0;
-            rowIndex++;
-        }
+/* .FIRSTLEVEL in netlist, a folded device is its composite */
+DeviceList ASGDialog::FLMarkedDevices() const
+{
+    DeviceList devList;
+    Device *device = nullptr;
+    foreach (NameId name, m_ckt->FirstLevelMarks()) {
+        device = m_ckt->GetDevice(m_ckt->GetNamePool()->Name(name));
+        if (NOT device) continue;
+        while (device->Composite())
+            device = device->Composite();
+        devList.push_back(device);
     }
-
-    connect(m_flSelectButtonGroup, SIGNAL(buttonClicked(int)),
-            this, SLOT(FLSelectDeviceButtonGroupClicked(int)));
-
-    flSelectLayout->addLayout(flDeviceLayout);
-    QScrollArea *flSelectArea = new QScrollArea();
-    flSelectArea->setWidget(flSelectWidget);
-    m_mainLayout->addWidget(flSelectArea);
+    return devList;
 }
 
 void ASGDialog::CreateICWidget()
@@ -145,77 +182,130 @@ void ASGDialog::CreateICWidget()
     m_mainLayout->addWidget(icFrame);
 }
 
+void ASGDialog::CreateDOWidget()
+{
+    m_doButtonGroup = new QButtonGroup();
+    m_doButtonGroup->setExclusive(true);
+
+    QVBoxLayout *doLayout = new QVBoxLayout;
+    QFrame *doFrame = new QFrame();
+    doFrame->setStyleSheet(tr("border:1px"));
+    QLabel *doLabel = new QLabel(tr("Please select device order (for large netlists)"));
+    doLayout->addWidget(doLabel);
+
+    /* add checkboxes, renumberbench shows no gain for RCM, netlist order stays */
+    QCheckBox *noCheckBox = new QCheckBox(tr("Netlist Order"));
+    noCheckBox->setChecked(true);
+    noCheckBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    m_doButtonGroup->addButton(noCheckBox, NetlistOrder);
+
+    QCheckBox *rcmCheckBox = new QCheckBox(tr("Reverse Cuthill-McKee"));
+    rcmCheckBox->setChecked(false);
+    rcmCheckBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    m_doButtonGroup->addButton(rcmCheckBox, RCMOrder);
+
+    QCheckBox *bfsCheckBox = new QCheckBox(tr("BFS from First Level Devices"));
+    bfsCheckBox->setChecked(false);
+    bfsCheckBox->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+    m_doButtonGroup->addButton(bfsCheckBox, BFSOrder);
+
+    doLayout->addWidget(noCheckBox);
+    doLayout->addWidget(rcmCheckBox);
+    doLayout->addWidget(bfsCheckBox);
+    doFrame->setLayout(doLayout);
+
+    m_mainLayout->addWidget(doFrame);
+}
+
+void ASGDialog::CreateGSWidget()
+{
+    QVBoxLayout *gsLayout = new QVBoxLayout;
+    QFrame *gsFrame = new QFrame();
+    gsFrame->setStyleSheet(tr("border:1px"));
+
+    QString verdict;
+    switch (m_stats->Verdict()) {
+        case CostTooBig:
+            verdict = tr("Predicted cost (too big, ASG will be stopped)");
+            break;
+        case CostSlow:
+            verdict = tr("Predicted cost (slow)");
+            break;
+        default:
+            verdict = tr("Predicted cost");
+            break;
+    }
+    QLabel *gsLabel = new QLabel(verdict);
+    gsLayout->addWidget(gsLabel);
+
+    QLabel *reportLabel = new QLabel(m_stats->Report());
+    reportLabel->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    reportLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+    gsLayout->addWidget(reportLabel);
+    gsFrame->setLayout(gsLayout);
+
+    m_mainLayout->addWidget(gsFrame);
+}
+
 void ASGDialog::Accept()
 {
 #ifdef TRACE
     qInfo() << LINE_INFO << endl;
 #endif
 
-    QAbstractButton *button = nullptr;
-    QCheckBox *ckBox = nullptr;
-
     /* For FirstLevelDeviceSelecion */
-    ProcessFLSelectDeviceButtonGroup();
+    ProcessFLDeviceModel();
 
     /* For IgnoreCap */
     ProcessICButtonGroup();
 
+    /* For DeviceOrder */
+    ProcessDOButtonGroup();
+
     accept();
 }
 
-void ASGDialog::FLSelectAllCheckBoxClicked(bool checked)
+QVector<int> ASGDialog::FLShownRows() const
 {
-#ifdef TRACEx
-    qInfo() << LINE_INFO << endl;
-#endif
-
-    QAbstractButton *button = nullptr;
-    QCheckBox *ckBox = nullptr;
-
-    foreach (button, m_flSelectButtonGroup->buttons()) {
-        ckBox = static_cast<QCheckBox*>(button);
-        ckBox->setChecked(checked);
-    }
+    QVector<int> rows;
+    int count = m_flFilterModel->rowCount();
+    rows.reserve(count);
+    for (int i = 0; i < count; ++ i)
+        rows.push_back(m_flFilterModel->mapToSource(m_flFilterModel->index(i, 0)).row());
+    return rows;
 }
 
-void ASGDialog::FLSelectDeviceButtonGroupClicked(int)
+void ASGDialog::FLCheckShownClicked()
 {
-    bool allSelected = true;
+    m_flDeviceModel->SetRowsChecked(FLShownRows(), true);
+}
 
-    QAbstractButton *button = nullptr;
-    QCheckBox *ckBox = nullptr;
+void ASGDialog::FLUncheckShownClicked()
+{
+    m_flDeviceModel->SetRowsChecked(FLShownRows(), false);
+}
 
-    foreach (button, m_flSelectButtonGroup->buttons()) {
-        ckBox = static_cast<QCheckBox*>(button);
-        if (NOT ckBox->isChecked()) {
-            allSelected = false;
-            break;
-        }
-    }
+/* the first levels ASG takes when none is checked */
+void ASGDialog::FLAutoClicked()
+{
+#ifdef TRACEx
+    qInfo() << LINE_INFO << endl;
+#endif
 
-    if (allSelected)
-        m_flSelectAllCheckBox->setChecked(true);
-    else
-        m_flSelectAllCheckBox->setChecked(false);
+    DeviceList devList;
+    if (m_asg)
+        m_asg->AutoFirstLevelDevices(&devList);
+    m_flDeviceModel->SetCheckedDevices(devList);
 }
 
-void ASGDialog::ProcessFLSelectDeviceButtonGroup()
+void ASGDialog::FLCheckedCountChanged(int count)
 {
-    QAbstractButton *button = nullptr;
-    QCheckBox *ckBox = nullptr;
-
-    Device *device = nullptr;
-    DeviceList  checkedDeviceList;
-
-    foreach (button, m_flSelectButtonGroup->buttons()) {
-        ckBox = static_cast<QCheckBox*>(button);
-        if (ckBox->isChecked()) {
-            device = m_ckt->GetDevice(ckBox->text());
-            checkedDeviceList.push_back(device);
-        }
-    }
+    m_flCountLabel->setText(tr("%1 of %2 checked").arg(count).arg(m_flDeviceModel->rowCount()));
+}
 
-    m_ckt->SetFirstLevelDeviceList(checkedDeviceList);
+void ASGDialog::ProcessFLDeviceModel()
+{
+    m_ckt->SetFirstLevelDeviceList(m_flDeviceModel->CheckedDevices());
 }
 
 void ASGDialog::ProcessICButtonGroup()
@@ -224,3 +314,10 @@ void ASGDialog::ProcessICButtonGroup()
     IgnoreCap ignore = (IgnoreCap)(id);
     m_asg->SetIgnoreCapType(ignore);
 }
+
+void ASGDialog::ProcessDOButtonGroup()
+{
+    int id = m_doButtonGroup->checkedId();
+    DeviceOrder order = (DeviceOrder)(id);
+    m_asg->SetDeviceOrder(order);
+}
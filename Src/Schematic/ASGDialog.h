@@ -17,20 +17,27 @@
  * IgnoreGroundCap        : IGC
  * IgnoreCoupledCap       : ICC 
  * IgnoreGroundCoupledCap : IGCC
+ * DeviceOrder            : DO
+ * GraphStats             : GS
  */
 
 #include <QDialog>
 #include <QVBoxLayout>
+#include <QVector>
+#include "Define/TypeDefine.h"
 
 QT_BEGIN_NAMESPACE
 class QDialogButtonBox;
 class QButtonGroup;
 class QLabel;
 class QCheckBox;
+class QSortFilterProxyModel;
 QT_END_NAMESPACE;
 
 class CircuitGraph;
 class ASG;
+class GraphStats;
+class DeviceListModel;
 
 
 class ASGDialog : public QDialog
@@ -46,26 +53,42 @@ public:
 
 private slots:
     void Accept();
-    void FLSelectAllCheckBoxClicked(bool checked);
-    void FLSelectDeviceButtonGroupClicked(int id);
+    void FLCheckShownClicked();
+    void FLUncheckShownClicked();
+    void FLAutoClicked();
+    void FLCheckedCountChanged(int count);
 
 private:
     void CreatePropertyWidgets();
     void CreateFLWidget();
     void CreateICWidget();
+    void CreateDOWidget();
+    void CreateGSWidget();
+
+    /* For FirstLevelDeviceSelection, rows the search shows */
+    QVector<int> FLShownRows() const;
+    DeviceList   FLMarkedDevices() const;
 
     /* called in Accept */
-    void ProcessFLSelectDeviceButtonGroup();
+    void ProcessFLDeviceModel();
     void ProcessICButtonGroup();
+    void ProcessDOButtonGroup();
 
-    /* For FirstLevelDeviceSelection */
+    /* For FirstLevelDeviceSelection, none checked is found by ASG */
     QVBoxLayout      *m_mainLayout;
-    QButtonGroup     *m_flSelectButtonGroup;
-    QCheckBox        *m_flSelectAllCheckBox;
+    DeviceListModel  *m_flDeviceModel;
+    QSortFilterProxyModel *m_flFilterModel;
+    QLabel           *m_flCountLabel;
 
     /* For GroundCap and CoupledCap */
     QButtonGroup     *m_icButtonGroup;
 
+    /* For device renumbering */
+    QButtonGroup     *m_doButtonGroup;
+
+    /* For predicted ASG cost, before the dialog is accepted */
+    GraphStats       *m_stats;
+
     QDialogButtonBox *m_buttonBox;
 
     /* Cicuit Graph */
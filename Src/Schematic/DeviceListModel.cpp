@@ -0,0 +1,144 @@
+#include "DeviceListModel.h"
+#include <algorithm>
+#include <QDebug>
+#include "Circuit/Device.h"
+
+DeviceListModel::DeviceListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+    m_checkedCount = 0;
+}
+
+DeviceListModel::~DeviceListModel()
+{
+}
+
+void DeviceListModel::SetDevices(const DeviceList &devList)
+{
+    beginResetModel();
+
+    auto rank = [](Device *dev) {
+        if (dev->MaybeAtFirstLevel())
+            return 0;
+        DeviceType type = dev->GetDeviceType();
+        return (type == VSRC || type == ISRC) ? 1 : 2;
+    };
+    m_devices = devList;
+    std::stable_sort(m_devices.begin(), m_devices.end(), [&rank](Device *a, Device *b) {
+        return rank(a) < rank(b);
+    });
+
+    int maxId = -1;
+    foreach (Device *dev, m_devices)
+        maxId = qMax(maxId, dev->Id());
+    m_rowOfId.assign(maxId + 1, -1);
+    for (int row = 0; row < m_devices.size(); ++ row)
+        m_rowOfId[m_devices.at(row)->Id()] = row;
+
+    m_checked.assign(m_devices.size(), 0);
+    m_checkedCount = 0;
+
+    endResetModel();
+    emit CheckedCountChanged(m_checkedCount);
+}
+
+void DeviceListModel::SetCheckedDevices(const DeviceList &devList)
+{
+    std::fill(m_checked.begin(), m_checked.end(), 0);
+    m_checkedCount = 0;
+
+    int id = 0, row = 0;
+    foreach (Device *dev, devList) {
+        id = dev->Id();
+        if (id < 0 || id >= (int)m_rowOfId.size()) continue;
+        row = m_rowOfId[id];
+        if (row < 0 || m_checked[row]) continue;
+        m_checked[row] = 1;
+        m_checkedCount++;
+    }
+
+    AllRowsChanged();
+}
+
+/* one signal for all rows, a view repaints only what it shows */
+void DeviceListModel::SetRowsChecked(const QVector<int> &rows, bool checked)
+{
+    foreach (int row, rows) {
+        if (m_checked[row] == (quint8)checked) continue;
+        m_checked[row] = checked;
+        m_checkedCount += checked ? 1 : -1;
+    }
+
+    AllRowsChanged();
+}
+
+void DeviceListModel::AllRowsChanged()
+{
+    if (NOT m_devices.isEmpty())
+        emit dataChanged(index(0), index(m_devices.size() - 1), {Qt::CheckStateRole});
+    emit CheckedCountChanged(m_checkedCount);
+}
+
+/* in row order, sources first */
+DeviceList DeviceListModel::CheckedDevices() const
+{
+    DeviceList devList;
+    for (int row = 0; row < m_devices.size(); ++ row) {
+        if (m_checked[row])
+            devList.push_back(m_devices.at(row));
+    }
+    return devList;
+}
+
+int DeviceListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_devices.size();
+}
+
+QVariant DeviceListModel::data(const QModelIndex &index, int role) const
+{
+    if (NOT index.isValid() || index.row() >= m_devices.size())
+        return QVariant();
+
+    Device *dev = m_devices.at(index.row());
+    switch (role) {
+        case Qt::DisplayRole:
+            return dev->Name();
+        case Qt::CheckStateRole:
+            return m_checked[index.row()] ? Qt::Checked : Qt::Unchecked;
+        case Qt::ToolTipRole:
+            if (dev->MaybeAtFirstLevel())
+                return tr("source to ground");
+            if (dev->GetDeviceType() == VSRC || dev->GetDeviceType() == ISRC)
+                return tr("floating source");
+            return QVariant();
+        default:
+            return QVariant();
+    }
+}
+
+bool DeviceListModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (NOT index.isValid() || role != Qt::CheckStateRole)
+        return false;
+
+    bool checked = (value.toInt() == Qt::Checked);
+    int row = index.row();
+    if (m_checked[row] == (quint8)checked)
+        return true;
+
+    m_checked[row] = checked;
+    m_checkedCount += checked ? 1 : -1;
+    emit dataChanged(index, index, {Qt::CheckStateRole});
+    emit CheckedCountChanged(m_checkedCount);
+    return true;
+}
+
+Qt::ItemFlags DeviceListModel::flags(const QModelIndex &index) const
+{
+    if (NOT index.isValid())
+        return Qt::NoItemFlags;
+    return Qt::ItemIsEnabled | Qt::ItemIsSelectable | Qt::ItemIsUserCheckable;
+}
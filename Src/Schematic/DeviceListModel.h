@@ -0,0 +1,54 @@
+#ifndef NETLISTVIZ_SCHEMATIC_DEVICELISTMODEL_H
+#define NETLISTVIZ_SCHEMATIC_DEVICELISTMODEL_H
+
+/*
+ * @filename : DeviceListModel.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Checkable list of devices for the first level selection of
+ *           : ASGDialog. A row is a Device* and a check flag, no widget,
+ *           : so a QListView draws only the rows it shows and a
+ *           : QSortFilterProxyModel searches by name. Sources to ground
+ *           : come first, then floating sources, then the other devices.
+ */
+
+#include <vector>
+#include <QAbstractListModel>
+#include <QVector>
+#include "Define/Define.h"
+#include "Define/TypeDefine.h"
+
+class DeviceListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceListModel(QObject *parent = 0);
+    ~DeviceListModel();
+
+    void        SetDevices(const DeviceList &devList);
+    /* exactly these are checked */
+    void        SetCheckedDevices(const DeviceList &devList);
+    void        SetRowsChecked(const QVector<int> &rows, bool checked);
+    DeviceList  CheckedDevices() const;
+    int         CheckedCount() const { return m_checkedCount; }
+
+    int           rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant      data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool          setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+signals:
+    void CheckedCountChanged(int count);
+
+private:
+    void        AllRowsChanged();
+
+    DeviceList            m_devices;
+    std::vector<quint8>   m_checked;      // by row
+    std::vector<int>      m_rowOfId;      // by Device::Id()
+    int                   m_checkedCount;
+};
+
+#endif // NETLISTVIZ_SCHEMATIC_DEVICELISTMODEL_H
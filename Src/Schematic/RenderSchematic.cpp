@@ -37,6 +37,8 @@ int SchematicScene::RenderSchematicDevices(const SDeviceList &devices, int colCo
     int sceneCol = 0, sceneRow = 0;
     SchematicDevice *device = nullptr;
     foreach (device, devices) {
+        /* i.e. Expand Composite */
+        device->SetContextMenu(m_itemMenu);
         if (device->GroundCap()) {
             m_gCapDeviceList.push_back(device);
             if ((ignore == IgnoreGCap) || (ignore == IgnoreGCCap)) continue;
@@ -166,78 +168,39 @@ void SchematicScene::RenderFixedGnds(const SDeviceList &devices)
     m_gndList.clear();
     m_hasGndWireList.clear();
 
+    /* every grounded terminal gets a gnd, in terminal type order (+ before -, d g s b) */
     foreach (SchematicDevice *device, devices) {
-        switch (device->GetDeviceType()) {
-            case RESISTOR:
-            case CAPACITOR:
-            case INDUCTOR:
-            case ISRC:
-            case VSRC:
-                terminal = device->GetTerminal(Positive);
-                if (terminal->ConnectToGnd()) {
-                    devTerPos = terminal->ScenePos();
-
-                    if (device->GetOrientation() == Vertical && device->Reverse()) {
-                        gndPos.rx() = devTerPos.x();
-                        gndPos.ry() = devTerPos.y() - DFT_GND_DIS * m_itemScale;
-                        reverse = true;
-                    } else {
-                        gndPos.rx() = devTerPos.x();
-                        gndPos.ry() = devTerPos.y() + DFT_GND_DIS * m_itemScale;
-                        reverse = false;
-                    }
-
-                    gnd = InsertSchematicDevice(GND, gndPos);
-
-                    scd = new SConnector(terminal, gnd->GetTerminal(General), gnd);
-                    device->AddConnector(scd);
-                    scd = new SConnector(gnd->GetTerminal(General), terminal, device);
-                    gnd->AddConnector(scd);
-
-                    gnd->SetOrientation(Vertical);
-                    gnd->SetReverse(reverse);
-                    gnd->SetScenePos(device->SceneCol(), 0);
-
-                    gndTer = gnd->GetTerminal(General);
-                    wire = new SchematicWire(device, gnd, terminal, gndTer);
-                    wire->SetTrack(-1);
-                    m_gndList.push_back(gnd);
-                    m_hasGndWireList.push_back(wire);
-                }
-
-                terminal = device->GetTerminal(Negative);
-                if (terminal->ConnectToGnd()) {
-                    devTerPos = terminal->ScenePos();
-
-                    if (device->GetOrientation() == Vertical && device->Reverse()) {
-                        gndPos.rx() = devTerPos.x();
-                        gndPos.ry() = devTerPos.y() - DFT_GND_DIS * m_itemScale;
-                        reverse = true;
-                    } else {
-                        gndPos.rx() = devTerPos.x();
-                        gndPos.ry() = devTerPos.y() + DFT_GND_DIS * m_itemScale;
-                        reverse = false;
-                    }
-
-                    gnd = InsertSchematicDevice(GND, gndPos);
-
-                    scd = new SConnector(terminal, gnd->GetTerminal(General), gnd);
-                    device->AddConnector(scd);
-                    scd = new SConnector(gnd->GetTerminal(General), terminal, device);
-                    gnd->AddConnector(scd);
-
-                    gnd->SetOrientation(Vertical);
-                    gnd->SetReverse(reverse);
-                    gnd->SetScenePos(device->SceneCol(), 0);
-
-                    gndTer = gnd->GetTerminal(General);
-                    wire = new SchematicWire(device, gnd, terminal, gndTer);
-                    wire->SetTrack(-1);
-                    m_gndList.push_back(gnd);
-                    m_hasGndWireList.push_back(wire);
-                }
-                break;
-            default:;
+        foreach (terminal, device->GetTerminalTable()) {
+            if (NOT terminal->ConnectToGnd())
+                continue;
+            devTerPos = terminal->ScenePos();
+
+            if (device->GetOrientation() == Vertical && device->Reverse()) {
+                gndPos.rx() = devTerPos.x();
+                gndPos.ry() = devTerPos.y() - DFT_GND_DIS * m_itemScale;
+                reverse = true;
+            } else {
+                gndPos.rx() = devTerPos.x();
+                gndPos.ry() = devTerPos.y() + DFT_GND_DIS * m_itemScale;
+                reverse = false;
+            }
+
+            gnd = InsertSchematicDevice(GND, gndPos);
+
+            scd = new SConnector(terminal, gnd->GetTerminal(General), gnd);
+            device->AddConnector(scd);
+            scd = new SConnector(gnd->GetTerminal(General), terminal, device);
+            gnd->AddConnector(scd);
+
+            gnd->SetOrientation(Vertical);
+            gnd->SetReverse(reverse);
+            gnd->SetScenePos(device->SceneCol(), 0);
+
+            gndTer = gnd->GetTerminal(General);
+            wire = new SchematicWire(device, gnd, terminal, gndTer);
+            wire->SetTrack(-1);
+            m_gndList.push_back(gnd);
+            m_hasGndWireList.push_back(wire);
         }
     }
 }
@@ -3,9 +3,12 @@
 #include <QPen>
 #include <QDebug>
 #include <QGraphicsScene>
+#include <QGraphicsSceneContextMenuEvent>
+#include <QMenu>
 #include "SchematicTerminal.h"
 #include "SchematicWire.h"
 #include "SConnector.h"
+#include "Circuit/DeviceTraits.h"
 
 static const int TerminalSize = 8;
 static const int IMAG_LEN = 25;
@@ -19,7 +22,7 @@ SchematicDevice::SchematicDevice()
 
     m_deviceType = RESISTOR;
     m_id = 0;
-    m_name = "";
+    m_nameId = NO_NAME;
     m_reverse = false;
     m_geoCol = 0;
     m_geoRow = 0;
@@ -38,7 +41,7 @@ SchematicDevice::SchematicDevice(DeviceType type, QMenu *contextMenu,
 
     m_deviceType = type;
     m_id = 0;
-    m_name = "";
+    m_nameId = NO_NAME;
     m_reverse = false;
     m_geoCol = 0;
     m_geoRow = 0;
@@ -90,6 +93,14 @@ void SchematicDevice::Initialize()
             DrawVsrc();
             m_isDevice = true;
             break;
+        case MOSFET:
+            DrawMosfet();
+            m_isDevice = true;
+            break;
+        case BJT:
+            DrawBjt();
+            m_isDevice = true;
+            break;
         case GND:
             DrawGnd();
             // DrawSmallGnd();
@@ -117,29 +128,25 @@ void SchematicDevice::CreateTerminalsBySelf()
 {
     m_terminals.clear();
     SchematicTerminal *terminal = nullptr;
-    switch (m_deviceType) {
-        case RESISTOR:
-        case CAPACITOR:
-        case INDUCTOR:
-        case ISRC:
-        case VSRC:
-            terminal = new SchematicTerminal(Positive, this);
-            m_terminals.insert(Positive, terminal);
-            terminal = new SchematicTerminal(Negative, this);
-            m_terminals.insert(Negative, terminal);
-            break;
-        case GND:
-            terminal = new SchematicTerminal(General, this);
-            m_terminals.insert(General, terminal);
-            break;
-        default:;
+    const DeviceTraits &traits = Traits(m_deviceType);
+    for (int pin = 0; pin < traits.terminalCount; ++ pin) {
+        terminal = new SchematicTerminal(traits.pins[pin], this);
+        m_terminals.insert(traits.pins[pin], terminal);
     }
 }
 
-void SchematicDevice::SetName(const QString &name)
+void SchematicDevice::SetName(NamePool *pool, NameId name)
+{
+    m_namePool = pool;
+    m_nameId = name;
+    CreateAnnotation(Name());
+}
+
+QString SchematicDevice::Name() const
 {
-    m_name = name;
-    CreateAnnotation(name);
+    if (NOT m_namePool)
+        return QString();
+    return m_namePool->Name(m_nameId);
 }
 
 QPixmap SchematicDevice::Image()
@@ -161,7 +168,12 @@ QPixmap SchematicDevice::Image()
 
 void SchematicDevice::contextMenuEvent(QGraphicsSceneContextMenuEvent *event)
 {
-    // do nothing now.
+    if (NOT m_contextMenu)
+        return;
+
+    scene()->clearSelection();
+    setSelected(true);
+    m_contextMenu->exec(event->screenPos());
 }
 
 void SchematicDevice::SetAnnotationVisible(bool show)
@@ -280,7 +292,7 @@ void SchematicDevice::AddTerminal(TerminalType type, SchematicTerminal *terminal
 void SchematicDevice::SetTerminalRect(TerminalType type, const QRectF &rect)
 {
     if (NOT m_terminals.contains(type)) {
-        qDebug() << m_name << " doesn't contain " << QString::number(type);
+        qDebug() << Name() << " doesn't contain " << QString::number(type);
         EXIT;
     }
 
@@ -522,6 +534,84 @@ void SchematicDevice::DrawVsrc()
     SetTerminalRect(Negative, QRectF(-halfTerSize, BASE_LEN, width, width));
 }
 
+/*
+ *       | d
+ *   | |-
+ * g-| |-- b
+ *   | |-
+ *       | s
+ */
+void SchematicDevice::DrawMosfet()
+{
+    QPainterPath path;
+    int halfTerSize = TerminalSize / 2;
+    int chX = -4;   // channel x-coord
+    int gateX = -9; // gate plate x-coord
+    int sdY = 8;    // drain/source y-coord on the channel
+
+    path.moveTo(0, -BASE_LEN - halfTerSize);
+    path.lineTo(0, -sdY);
+    path.lineTo(chX, -sdY);
+    path.moveTo(chX, -12);
+    path.lineTo(chX, 12);
+    path.moveTo(chX, sdY);
+    path.lineTo(0, sdY);
+    path.lineTo(0, BASE_LEN + halfTerSize);
+
+    path.moveTo(gateX, -10);
+    path.lineTo(gateX, 10);
+    path.moveTo(gateX, 0);
+    path.lineTo(-BASE_LEN - halfTerSize, 0);
+
+    path.moveTo(chX, 0);
+    path.lineTo(BASE_LEN + halfTerSize, 0);
+    setPath(path);
+
+    int width = TerminalSize;
+    SetTerminalRect(Drain, QRectF(-halfTerSize, -BASE_LEN-TerminalSize, width, width));
+    SetTerminalRect(Source, QRectF(-halfTerSize, BASE_LEN, width, width));
+    SetTerminalRect(Gate, QRectF(-BASE_LEN-TerminalSize, -halfTerSize, width, width));
+    SetTerminalRect(Bulk, QRectF(BASE_LEN, -halfTerSize, width, width));
+}
+
+/*
+ *      | c
+ *    |/
+ * b--|
+ *    |\
+ *      | e
+ */
+void SchematicDevice::DrawBjt()
+{
+    QPainterPath path;
+    int halfTerSize = TerminalSize / 2;
+    int baseX = -6; // base bar x-coord
+
+    path.moveTo(0, -BASE_LEN - halfTerSize);
+    path.lineTo(0, -10);
+    path.lineTo(baseX, -4);
+    path.moveTo(baseX, -10);
+    path.lineTo(baseX, 10);
+    path.moveTo(baseX, 4);
+    path.lineTo(0, 10);
+    path.lineTo(0, BASE_LEN + halfTerSize);
+
+    /* emitter arrow */
+    path.moveTo(0, 10);
+    path.lineTo(-4, 9);
+    path.moveTo(0, 10);
+    path.lineTo(-1, 6);
+
+    path.moveTo(baseX, 0);
+    path.lineTo(-BASE_LEN - halfTerSize, 0);
+    setPath(path);
+
+    int width = TerminalSize;
+    SetTerminalRect(Collector, QRectF(-halfTerSize, -BASE_LEN-TerminalSize, width, width));
+    SetTerminalRect(Emitter, QRectF(-halfTerSize, BASE_LEN, width, width));
+    SetTerminalRect(Base, QRectF(-BASE_LEN-TerminalSize, -halfTerSize, width, width));
+}
+
 QRectF SchematicDevice::GndTerminalRect(bool smallGnd) const
 {
     if (smallGnd) {
@@ -751,7 +841,7 @@ void SchematicDevice::Print() const
 {
     printf("-------------------------\n");
     QString tmp;
-    tmp += (m_name + " " + "type(" + QString::number(m_deviceType) + "), ");
+    tmp += (Name() + " " + "type(" + QString::number(m_deviceType) + "), ");
     tmp += ("id(" + QString::number(m_id) + "), ");
     tmp += ("geoCol(" + QString::number(m_geoCol) + "), ");
     tmp += ("geoRow(" + QString::number(m_geoRow) + "), ");
@@ -4,6 +4,7 @@
 #include <QGraphicsPathItem>
 #include "Define/TypeDefine.h"
 #include "Define/Define.h"
+#include "Utilities/NamePool.h"
 
 QT_BEGIN_NAMESPACE
 class QGraphicsPixmapItem;
@@ -38,8 +39,8 @@ public:
     DeviceType   GetDeviceType() const { return m_deviceType; }
     void         SetContextMenu(QMenu *contextMenu) { m_contextMenu = contextMenu; }
     void         AddTerminal(TerminalType type, SchematicTerminal *terminal);
-    void         SetName(const QString &name);
-    QString      Name() const { return m_name; }
+    void         SetName(NamePool *pool, NameId name);
+    QString      Name() const;
     void         SetId(int id) { m_id = id; }
     void         SetShowTerminal(bool show) { m_showTerminal = show; }
 	void         SetOrientation(Orientation orien);
@@ -97,6 +98,8 @@ private:
     void         DrawInductor();
     void         DrawIsrc();
     void         DrawVsrc();
+    void         DrawMosfet();
+    void         DrawBjt();
     void         DrawGnd();
     void         DrawSmallGnd();
 
@@ -114,7 +117,8 @@ private:
     /* Copy from Circuit Device */
     int                m_id;
     DeviceType         m_deviceType;
-    QString            m_name;
+    NamePoolPtr        m_namePool;     // shared with CircuitGraph
+    NameId             m_nameId;
     bool               m_reverse;
     /* Geometrical Position */
     int                m_geoCol; // geometrical column
@@ -7,7 +7,7 @@ SchematicTerminal::SchematicTerminal()
 {
     m_type = Positive;
     m_device = nullptr;
-    m_node = nullptr;
+    m_nodeId = -1;
     m_id = 0;
 }
 
@@ -16,15 +16,19 @@ SchematicTerminal::SchematicTerminal(TerminalType type, SchematicDevice *device)
     Q_ASSERT(device);
     m_type = type;
     m_device = device;
-    m_node = nullptr;
+    m_nodeId = -1;
     m_id = 0;
 }
 
 SchematicTerminal::~SchematicTerminal()
 {
-    /* delete node here */
-    // if (m_node)
-    //     delete m_node;
+}
+
+void SchematicTerminal::SetNode(const Node *node)
+{
+    Q_ASSERT(node);
+    m_nodeId = node->Id();
+    m_nodeName = node->Name();
 }
 
 void SchematicTerminal::SetDevice(SchematicDevice *device)
@@ -34,15 +38,7 @@ void SchematicTerminal::SetDevice(SchematicDevice *device)
 
 bool SchematicTerminal::ConnectToGnd() const
 {
-    bool is = false;
-    if (m_node) {
-        if (m_node->Id() == 0)
-           is = true; 
-    } else {
-        is = false;
-    }
-
-    return is;
+    return (m_nodeId == 0);
 }
 
 QPointF SchematicTerminal::ScenePos() const
@@ -71,7 +67,7 @@ QString SchematicTerminal::PrintString() const
     QString result;
     result += ("id(" + QString::number(m_id) + "), ");
     result += ("type(" + QString::number(m_type) + "), ");
-    result += ("nodeName(" + m_node->Name() + "), ");
+    result += ("nodeName(" + m_nodeName + "), ");
     result += ("belongTo(" + m_device->Name() + ")");
     return result;
 }
@@ -31,8 +31,9 @@ public:
     void         SetDevice(SchematicDevice *device);
     void         SetTerminalType(TerminalType type) { m_type = type; }
     TerminalType GetTerminalType() const { return m_type; }
-    void         SetNode(Node *node) { m_node = node; }
-    Node*        GetNode() const { return m_node; }
+    void         SetNode(const Node *node);
+    int          NodeId() const { return m_nodeId; }
+    QString      NodeName() const { return m_nodeName; }
     void         SetId(int id) { m_id = id; }
     int          Id() const { return m_id; }
     void         SetRect(const QRectF &rect) { m_rect = rect; }
@@ -53,8 +54,9 @@ public:
 private:
     DISALLOW_COPY_AND_ASSIGN(SchematicTerminal);
 
-    /* Copy from Terminal */
-    Node              *m_node;
+    /* Copy from Terminal, the Node is freed with CircuitGraph */
+    int                m_nodeId;       // -1 : no node
+    QString            m_nodeName;
     int                m_id;
     TerminalType       m_type; 
     SchematicDevice   *m_device;
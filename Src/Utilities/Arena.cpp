@@ -0,0 +1,55 @@
+#include "Arena.h"
+#include <cstdlib>
+
+Arena::Arena(size_t blockBytes)
+{
+    m_blockBytes = blockBytes;
+    m_cur = nullptr;
+    m_end = nullptr;
+    m_bytes = 0;
+}
+
+Arena::~Arena()
+{
+    Reset();
+}
+
+/* last created, first destroyed, like members of one object */
+void Arena::Reset()
+{
+    for (auto it = m_finalizers.rbegin(); it != m_finalizers.rend(); ++ it)
+        it->destroy(it->object);
+    m_finalizers.clear();
+
+    for (char *block : m_blocks)
+        free(block);
+    m_blocks.clear();
+
+    m_cur = nullptr;
+    m_end = nullptr;
+    m_bytes = 0;
+}
+
+/* the current block is full, malloc aligns to max_align_t */
+void* Arena::AllocateBlock(size_t bytes, size_t align)
+{
+    assert(align <= alignof(std::max_align_t));
+    (void)align;
+
+    size_t size = (bytes > m_blockBytes) ? bytes : m_blockBytes;
+    char *block = static_cast<char*>(malloc(size));
+    if (NOT block)
+        throw std::bad_alloc();
+    m_blocks.push_back(block);
+
+    /* a big object has its block alone, the current block goes on */
+    if (bytes > m_blockBytes) {
+        m_bytes += bytes;
+        return block;
+    }
+
+    m_cur = block + bytes;
+    m_end = block + size;
+    m_bytes += bytes;
+    return block;
+}
@@ -0,0 +1,78 @@
+#ifndef NETLISTVIZ_UTILITIES_ARENA_H
+#define NETLISTVIZ_UTILITIES_ARENA_H
+
+/*
+ * @filename : Arena.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Bump allocator for objects that die together. New<T>() takes
+ *           : the next aligned bytes of the current block, Reset() and the
+ *           : destructor free whole blocks. Destructors run only for types
+ *           : that have one (Device, Node, Dot hold Qt containers), so
+ *           : Terminal and Wire cost nothing to free. Objects from
+ *           : New<T>() must never be deleted.
+ *           : CircuitGraph has one per parse, ASG one per run and thread.
+ */
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Define/Define.h"
+
+class Arena
+{
+public:
+    explicit Arena(size_t blockBytes = ARENA_BLOCK_BYTES);
+    ~Arena();
+
+    template <typename T, typename... Args>
+    T* New(Args&&... args)
+    {
+        void *memory = Allocate(sizeof(T), alignof(T));
+        T *object = new (memory) T(std::forward<Args>(args)...);
+        if (NOT std::is_trivially_destructible<T>::value)
+            m_finalizers.push_back(Finalizer{ &Destroy<T>, object });
+        return object;
+    }
+
+    /* destroy all objects, the arena can be used again */
+    void      Reset();
+    long long BytesAllocated() const { return m_bytes; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(Arena);
+
+    struct Finalizer
+    {
+        void (*destroy)(void *object);
+        void  *object;
+    };
+
+    template <typename T>
+    static void Destroy(void *object) { static_cast<T*>(object)->~T(); }
+
+    void* Allocate(size_t bytes, size_t align)
+    {
+        size_t pad = (align - reinterpret_cast<size_t>(m_cur) % align) % align;
+        if (m_cur AND pad + bytes <= static_cast<size_t>(m_end - m_cur)) {
+            char *memory = m_cur + pad;
+            m_cur = memory + bytes;
+            m_bytes += bytes;
+            return memory;
+        }
+        return AllocateBlock(bytes, align);
+    }
+    void* AllocateBlock(size_t bytes, size_t align);
+
+    size_t                  m_blockBytes;
+    char                   *m_cur;
+    char                   *m_end;
+    long long               m_bytes;
+    std::vector<char*>      m_blocks;
+    std::vector<Finalizer>  m_finalizers;
+};
+
+#endif // NETLISTVIZ_UTILITIES_ARENA_H
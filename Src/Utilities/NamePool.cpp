@@ -0,0 +1,262 @@
+#include "NamePool.h"
+#include <cstring>
+#include <iostream>
+
+/* hierarchy separator of extracted netlists */
+static const char NAME_SEPARATOR = '/';
+
+/* initial open addressing slots, always a power of 2 */
+static const size_t NAME_POOL_INIT_SLOTS = 1024;
+
+
+NamePool::NamePool()
+{
+    Entry none = { NO_NAME, 0, 0, 0, 0 };
+    m_entries.push_back(none);
+    m_slots.assign(NAME_POOL_INIT_SLOTS, NO_NAME);
+    m_fullBytes = 0;
+    m_fullNames = 0;
+}
+
+NamePool::~NamePool()
+{
+}
+
+NameId NamePool::Intern(std::string_view name)
+{
+    NameId id = NO_NAME;
+    size_t begin = 0;
+
+    while (true) {
+        size_t end = name.find(NAME_SEPARATOR, begin);
+        if (end == std::string_view::npos) {
+            id = InternSegment(id, name.substr(begin));
+            break;
+        }
+        id = InternSegment(id, name.substr(begin, end - begin));
+        begin = end + 1;
+    }
+
+    Entry &entry = m_entries[id];
+    if (NOT entry.full) {
+        entry.full = 1;
+        m_fullBytes += name.size();
+        m_fullNames++;
+    }
+
+    return id;
+}
+
+NameId NamePool::Intern(const QString &name)
+{
+    QByteArray bytes = name.toUtf8();
+    return Intern(std::string_view(bytes.constData(), bytes.size()));
+}
+
+NameId NamePool::Find(std::string_view name) const
+{
+    NameId id = NO_NAME;
+    size_t begin = 0;
+
+    while (true) {
+        size_t end = name.find(NAME_SEPARATOR, begin);
+        std::string_view segment = (end == std::string_view::npos) ?
+                                   name.substr(begin) : name.substr(begin, end - begin);
+        id = FindSegment(id, segment, Hash(id, segment));
+        if (id == NO_NAME || end == std::string_view::npos)
+            break;
+        begin = end + 1;
+    }
+
+    if (id != NO_NAME AND NOT m_entries[id].full)
+        return NO_NAME;
+
+    return id;
+}
+
+NameId NamePool::Find(const QString &name) const
+{
+    QByteArray bytes = name.toUtf8();
+    return Find(std::string_view(bytes.constData(), bytes.size()));
+}
+
+QString NamePool::Name(NameId id) const
+{
+    return QString::fromStdString(StdName(id));
+}
+
+std::string NamePool::StdName(NameId id) const
+{
+    if (id == NO_NAME)
+        return std::string();
+
+    size_t length = 0;
+    for (NameId i = id; i != NO_NAME; i = m_entries[i].parent)
+        length += m_entries[i].length + 1;
+    length -= 1;
+
+    /* fill from the back, segments are walked from leaf to root */
+    std::string name(length, NAME_SEPARATOR);
+    size_t end = length;
+    for (NameId i = id; i != NO_NAME; i = m_entries[i].parent) {
+        const Entry &entry = m_entries[i];
+        end -= entry.length;
+        memcpy(&name[end], m_chars.data() + entry.offset, entry.length);
+        if (end > 0)
+            end -= 1;
+    }
+
+    return name;
+}
+
+NameId NamePool::InternSegment(NameId parent, std::string_view segment)
+{
+    quint32 hash = Hash(parent, segment);
+    NameId id = FindSegment(parent, segment, hash);
+    if (id != NO_NAME)
+        return id;
+
+    /* keep load factor under 1/2 */
+    if ((m_entries.size() + 1) * 2 > m_slots.size())
+        Rehash(m_slots.size() * 2);
+
+    Entry entry;
+    entry.parent = parent;
+    entry.offset = m_chars.size();
+    entry.length = segment.size();
+    entry.hash = hash;
+    entry.full = 0;
+    m_chars.insert(m_chars.end(), segment.begin(), segment.end());
+
+    id = m_entries.size();
+    m_entries.push_back(entry);
+
+    size_t mask = m_slots.size() - 1;
+    size_t slot = hash & mask;
+    while (m_slots[slot] != NO_NAME)
+        slot = (slot + 1) & mask;
+    m_slots[slot] = id;
+
+    return id;
+}
+
+NameId NamePool::FindSegment(NameId parent, std::string_view segment, quint32 hash) const
+{
+    size_t mask = m_slots.size() - 1;
+    size_t slot = hash & mask;
+
+    while (m_slots[slot] != NO_NAME) {
+        const Entry &entry = m_entries[m_slots[slot]];
+        if (entry.hash == hash AND entry.parent == parent AND entry.length == segment.size()
+            AND memcmp(m_chars.data() + entry.offset, segment.data(), segment.size()) == 0)
+            return m_slots[slot];
+        slot = (slot + 1) & mask;
+    }
+
+    return NO_NAME;
+}
+
+/* FNV-1a over the segment, seeded by parent */
+quint32 NamePool::Hash(NameId parent, std::string_view segment) const
+{
+    quint32 hash = 2166136261u ^ (parent * 2654435761u);
+    for (char c : segment) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+void NamePool::Rehash(size_t slotCount)
+{
+    m_slots.assign(slotCount, NO_NAME);
+    size_t mask = slotCount - 1;
+
+    for (NameId id = 1; id < m_entries.size(); ++ id) {
+        size_t slot = m_entries[id].hash & mask;
+        while (m_slots[slot] != NO_NAME)
+            slot = (slot + 1) & mask;
+        m_slots[slot] = id;
+    }
+}
+
+qint64 NamePool::MemoryUsage() const
+{
+    return sizeof(NamePool)
+           + m_entries.capacity() * sizeof(Entry)
+           + m_chars.capacity()
+           + m_slots.capacity() * sizeof(NameId);
+}
+
+/* one QString per name : d pointer + QArrayData header + utf16 chars */
+qint64 NamePool::FlatQStringUsage() const
+{
+    const qint64 header = sizeof(void*) + 24;
+    return m_fullNames * (header + 2) + m_fullBytes * 2;
+}
+
+/* entry count, char count, entries, chars */
+QByteArray NamePool::Serialize() const
+{
+    quint32 counts[2] = { (quint32)m_entries.size(), (quint32)m_chars.size() };
+
+    QByteArray data;
+    data.reserve(sizeof(counts) + m_entries.size() * sizeof(Entry) + m_chars.size());
+    data.append(reinterpret_cast<const char*>(counts), sizeof(counts));
+    data.append(reinterpret_cast<const char*>(m_entries.data()), m_entries.size() * sizeof(Entry));
+    data.append(m_chars.data(), m_chars.size());
+
+    return data;
+}
+
+bool NamePool::Deserialize(const char *data, qint64 size)
+{
+    if (m_entries.size() != 1)
+        return false;
+
+    quint32 counts[2];
+    if (size < (qint64)sizeof(counts))
+        return false;
+    memcpy(counts, data, sizeof(counts));
+    quint32 entryCount = counts[0];
+    quint32 charCount = counts[1];
+    if (entryCount < 1 || size != (qint64)(sizeof(counts) + (qint64)entryCount * sizeof(Entry) + charCount))
+        return false;
+
+    std::vector<Entry> entries(entryCount);
+    memcpy(entries.data(), data + sizeof(counts), entryCount * sizeof(Entry));
+
+    /* parents come first, segments stay inside chars */
+    qint64 fullBytes = 0, fullNames = 0;
+    for (quint32 id = 1; id < entryCount; ++ id) {
+        const Entry &entry = entries[id];
+        if (entry.parent >= id || (qint64)entry.offset + entry.length > charCount)
+            return false;
+        if (entry.full) {
+            fullNames++;
+            for (NameId i = id; i != NO_NAME; i = entries[i].parent)
+                fullBytes += entries[i].length + 1;
+            fullBytes -= 1;
+        }
+    }
+
+    m_entries.swap(entries);
+    m_chars.assign(data + sizeof(counts) + entryCount * sizeof(Entry),
+                   data + sizeof(counts) + entryCount * sizeof(Entry) + charCount);
+    m_fullBytes = fullBytes;
+    m_fullNames = fullNames;
+
+    size_t slotCount = NAME_POOL_INIT_SLOTS;
+    while (slotCount < (m_entries.size() + 1) * 2)
+        slotCount *= 2;
+    Rehash(slotCount);
+
+    return true;
+}
+
+void NamePool::PrintMemoryUsage() const
+{
+    std::cout << "[names] " << m_fullNames << " names, " << Count() << " segments, "
+              << MemoryUsage() / 1024 << " KB pooled ("
+              << FlatQStringUsage() / 1024 << " KB per QString copy)" << std::endl;
+}
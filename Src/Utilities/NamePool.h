@@ -0,0 +1,82 @@
+#ifndef NETLISTVIZ_UTILITIES_NAMEPOOL_H
+#define NETLISTVIZ_UTILITIES_NAMEPOOL_H
+
+/*
+ * @filename : NamePool.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Interned device and node names. Each name is stored once
+ *           : and handed out as a small integer NameId. Hierarchical
+ *           : names ("x1/x2/net123") are split at '/', each segment is
+ *           : stored under its parent prefix, so x1/x2/... is shared.
+ *           : Shared by CircuitGraph, Device, Node and SchematicDevice,
+ *           : the pool lives until the last of them is destroyed.
+ */
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <QString>
+#include <QByteArray>
+#include <QSharedData>
+#include <QExplicitlySharedDataPointer>
+#include "Define/Define.h"
+
+/* 0 : no name */
+typedef quint32 NameId;
+const static NameId NO_NAME = 0;
+
+class NamePool : public QSharedData
+{
+public:
+    NamePool();
+    ~NamePool();
+
+    NameId      Intern(std::string_view name);
+    NameId      Intern(const QString &name);
+    /* NO_NAME if name was never interned */
+    NameId      Find(std::string_view name) const;
+    NameId      Find(const QString &name) const;
+
+    QString     Name(NameId id) const;
+    std::string StdName(NameId id) const;
+
+    int         Count() const { return m_entries.size() - 1; }
+    /* bytes held by the pool, and bytes the same names take as flat QStrings */
+    qint64      MemoryUsage() const;
+    qint64      FlatQStringUsage() const;
+    void        PrintMemoryUsage() const;
+
+    /* For NetlistCache, ids are kept, Deserialize needs an empty pool */
+    QByteArray  Serialize() const;
+    bool        Deserialize(const char *data, qint64 size);
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(NamePool);
+
+    /* one '/' separated segment under its parent prefix */
+    struct Entry
+    {
+        NameId  parent;
+        quint32 offset;  // into m_chars
+        quint32 hash;
+        quint32 length : 31;
+        quint32 full   : 1;  // interned as a whole name, not only a prefix
+    };
+
+    NameId      InternSegment(NameId parent, std::string_view segment);
+    NameId      FindSegment(NameId parent, std::string_view segment, quint32 hash) const;
+    quint32     Hash(NameId parent, std::string_view segment) const;
+    void        Rehash(size_t slotCount);
+
+    std::vector<Entry>   m_entries;  // m_entries[0] is NO_NAME
+    std::vector<char>    m_chars;
+    std::vector<NameId>  m_slots;    // open addressing, NO_NAME is empty
+    qint64               m_fullBytes;  // sum of whole name lengths
+    qint64               m_fullNames;
+};
+
+typedef QExplicitlySharedDataPointer<NamePool> NamePoolPtr;
+
+#endif // NETLISTVIZ_UTILITIES_NAMEPOOL_H
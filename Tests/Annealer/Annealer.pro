@@ -0,0 +1,28 @@
+#####################
+# annealer, costs kept by the moves of Annealer against a fresh count,
+# and the rows Apply() gives keep the row gap and order of every level
+#####################
+
+TEMPLATE = app
+TARGET = annealer
+
+QMAKE_CXXFLAGS += -std=c++17
+
+# ASG::PlotLevels() links TablePlotter, nothing is shown
+QT += widgets
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+include(../../Src/ASG/ASG.pri)
+
+INCLUDEPATH += ../../Tools/NetlistGen
+
+HEADERS += ../../Tools/NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ../../Tools/NetlistGen/NetlistGen.cpp
@@ -0,0 +1,206 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : annealer, devices of small netlistgen netlists are put at
+ *           : random levels with a fixed seed, each level a row gap of
+ *           : its own and rows at least that far apart. Annealer runs all
+ *           : its rounds. The wirelength, crossings and cost every
+ *           : replica kept move by move must be those Evaluate() gives
+ *           : for its rows, and the rows Apply() gives must keep each
+ *           : level's devices, row gap and order, and count to the cost
+ *           : and crossings the Annealer reports.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include "Parser/MmapScanner.h"
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/CompactGraph.h"
+#include "Circuit/Device.h"
+#include "Level.h"
+#include "LevelGraph.h"
+#include "Annealer.h"
+#include "NetIndex.h"
+#include "NetlistGen.h"
+
+static const struct { NetlistGen::Family family; long long devices; } GENERATED[] = {
+    { NetlistGen::LadderRLC,       400 },
+    { NetlistGen::MeshR,           400 },
+    { NetlistGen::ClockTreeRCRand, 400 },
+    { NetlistGen::CoupledTreeRC,   400 },
+};
+
+static const int LEVELS = 5;
+static const unsigned SEED = 25;
+/* long enough for every round, SA_END_T ends the run */
+static const qint64 DEADLINE_MS = 600000;
+
+static bool ById(const Device *a, const Device *b)
+{
+    return a->Id() < b->Id();
+}
+
+/* rows, row gaps and orders of the levels Apply() gave, and their cost */
+static int CheckApplied(const NetIndex *nets, const LevelList &levels, const std::vector<DeviceList> &devices,
+                        const std::vector<int> &gaps, const Annealer &annealer, const std::string &name)
+{
+    int failures = 0;
+    DeviceList devList;
+    for (int l = 0; l < levels.size(); ++ l) {
+        devList = levels[l]->AllDevices();
+        if (levels[l]->RowGap() != gaps[l]) {
+            fprintf(stderr, "FAIL %s : level %d row gap %d, was %d\n", name.c_str(), l,
+                    levels[l]->RowGap(), gaps[l]);
+            failures++;
+        }
+        for (int i = 1; i < devList.size(); ++ i) {
+            if (devList[i]->LogicalRow() - devList[i - 1]->LogicalRow() < gaps[l]) {
+                fprintf(stderr, "FAIL %s : level %d rows %d and %d, gap %d\n", name.c_str(), l,
+                        devList[i - 1]->LogicalRow(), devList[i]->LogicalRow(), gaps[l]);
+                failures++;
+                break;
+            }
+        }
+        std::sort(devList.begin(), devList.end(), ById);
+        if (devList != devices[l]) {
+            fprintf(stderr, "FAIL %s : level %d has other devices\n", name.c_str(), l);
+            failures++;
+        }
+    }
+
+    LevelGraph graph(nets, levels);
+    graph.Build();
+    qint64 wirelength = 0, crossings = 0;
+    std::vector<int> order, pos;
+    for (int l = 0; l + 1 < graph.LevelCount(); ++ l) {
+        const LevelGraph::Adjacency &down = graph.Down(l);
+        for (int i = 0; i < graph.DeviceCount(l); ++ i) {
+            for (int k = down.begin[i]; k < down.begin[i + 1]; ++ k)
+                wirelength += qAbs(graph.Devices(l).at(i)->LogicalRow()
+                                   - graph.Devices(l + 1).at(down.other[k])->LogicalRow());
+        }
+        order.resize(graph.DeviceCount(l));
+        for (size_t i = 0; i < order.size(); ++ i)
+            order[i] = i;
+        pos.resize(graph.DeviceCount(l + 1));
+        for (size_t i = 0; i < pos.size(); ++ i)
+            pos[i] = i;
+        crossings += graph.Crossings(l, order, pos);
+    }
+    double cost = wirelength + SA_CROSSING_COST * crossings;
+    if (crossings != annealer.CrossingsAfter() || cost != annealer.CostAfter()) {
+        fprintf(stderr, "FAIL %s : applied rows cost %g with %lld crossings, annealer %g with %lld\n",
+                name.c_str(), cost, (long long)crossings, annealer.CostAfter(),
+                (long long)annealer.CrossingsAfter());
+        failures++;
+    }
+    return failures;
+}
+
+static int Check(const std::string &netlist, const std::string &name)
+{
+    CircuitGraph ckt;
+    MmapScanner scanner;
+    if (scanner.ParseNetlist(netlist, &ckt) || ckt.Flatten()) {
+        fprintf(stderr, "FAIL %s : not parsed\n", name.c_str());
+        return 1;
+    }
+    const CompactGraph *compact = ckt.Freeze();
+
+    std::mt19937 random(SEED);
+    LevelList levels;
+    std::vector<int> gaps;
+    for (int l = 0; l < LEVELS; ++ l) {
+        levels.push_back(new Level(l));
+        gaps.push_back(1 + l % 3);
+        levels.back()->SetRowGap(gaps.back());
+    }
+    DeviceList devList = ckt.GetDeviceList();
+    std::shuffle(devList.begin(), devList.end(), random);
+    foreach (Device *dev, devList)
+        levels[random() % LEVELS]->AddDevice(dev);
+
+    /* rows in level order, a gap or a little more apart */
+    std::vector<DeviceList> devices;
+    int row = 0;
+    for (int l = 0; l < LEVELS; ++ l) {
+        row = 0;
+        foreach (Device *dev, levels[l]->AllDevices()) {
+            dev->SetLogicalRow(row);
+            row += gaps[l] + random() % 3;
+        }
+        devices.push_back(levels[l]->AllDevices());
+        std::sort(devices.back().begin(), devices.back().end(), ById);
+    }
+
+    NetIndex nets(compact);
+    nets.Build();
+
+    int failures = 0;
+    Annealer annealer(&nets, levels);
+    QElapsedTimer clock;
+    clock.start();
+    if (annealer.Run(clock, DEADLINE_MS) || annealer.Rounds() == 0) {
+        fprintf(stderr, "FAIL %s : Annealer does not run\n", name.c_str());
+        failures++;
+    }
+    if (annealer.CheckCosts()) {
+        fprintf(stderr, "FAIL %s : a replica kept a cost Evaluate() does not give\n", name.c_str());
+        failures++;
+    }
+    if (annealer.CostAfter() > annealer.CostBefore()) {
+        fprintf(stderr, "FAIL %s : cost %g -> %g\n", name.c_str(), annealer.CostBefore(), annealer.CostAfter());
+        failures++;
+    }
+    annealer.Apply();
+    failures += CheckApplied(&nets, levels, devices, gaps, annealer, name);
+    qDeleteAll(levels);
+
+    if (NOT failures)
+        printf("%-19s : %d rounds, same costs, cost %g -> %g\n", name.c_str(), annealer.Rounds(),
+               annealer.CostBefore(), annealer.CostAfter());
+    return failures;
+}
+
+static bool Generate(NetlistGen::Family family, long long devices, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return false;
+    NetlistGen gen;
+    gen.SetDevices(devices);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    return error == OKAY;
+}
+
+int main()
+{
+    int failures = 0;
+    const std::string path = QDir::temp().filePath("annealer.sp").toStdString();
+    for (const auto &gen : GENERATED) {
+        std::string name = std::string(NetlistGen::FamilyName(gen.family)) + " " + std::to_string(gen.devices);
+        if (NOT Generate(gen.family, gen.devices, path)) {
+            fprintf(stderr, "FAIL %s : generate %s failed\n", name.c_str(), path.c_str());
+            failures++;
+            continue;
+        }
+        failures += Check(path, name);
+    }
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "annealer : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("annealer : kept costs and applied rows, PASS\n");
+    return 0;
+}
@@ -0,0 +1,87 @@
+#ifndef NETLISTVIZ_TESTS_CIRCUITDUMP_H
+#define NETLISTVIZ_TESTS_CIRCUITDUMP_H
+
+/*
+ * @filename : CircuitDump.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Text of a parsed CircuitGraph for the parser tests, one line
+ *           : per device in list order: id, name, type, value and the
+ *           : node of every terminal with its id. Two parses of one
+ *           : netlist must give the same text, whatever scanner or thread
+ *           : filled the graph.
+ */
+
+#include <cstdio>
+#include <string>
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/Device.h"
+#include "Circuit/Node.h"
+#include "Circuit/Terminal.h"
+
+static inline std::string DumpDevices(const CircuitGraph *ckt)
+{
+    std::string text;
+    char value[32];
+    Terminal *terminal = nullptr;
+    foreach (Device *dev, ckt->GetDeviceList()) {
+        snprintf(value, sizeof(value), "%.12g", dev->Value());
+        text += std::to_string(dev->Id()) + " " + dev->Name().toStdString() + " " + std::to_string(dev->GetDeviceType()) + " " + value;
+        for (int pin = 0; pin < dev->TerminalCount(); ++ pin) {
+            terminal = dev->TerminalAt(pin);
+            text += " ";
+            if (terminal->NodeIsGnd())
+                text += "0";
+            else
+                text += terminal->GetNode()->Name().toStdString() + "#" + std::to_string(terminal->GetNode()->Id());
+        }
+        text += "\n";
+    }
+    return text;
+}
+
+/* one line per node in list order: id, name and its devices in order */
+static inline std::string DumpNodes(const CircuitGraph *ckt)
+{
+    std::string text;
+    foreach (Node *node, ckt->GetNodeList()) {
+        text += std::to_string(node->Id()) + " " + node->Name().toStdString() + " :";
+        foreach (Device *dev, node->ConnectDeviceList())
+            text += " " + std::to_string(dev->Id());
+        text += "\n";
+    }
+    return text;
+}
+
+/* .FIRSTLEVEL marks and the first level devices they resolve to */
+static inline std::string DumpFirstLevel(CircuitGraph *ckt)
+{
+    std::string text;
+    foreach (NameId name, ckt->FirstLevelMarks())
+        text += "mark " + ckt->GetNamePool()->StdName(name) + "\n";
+    if (ckt->HasFirstLevelMarks())
+        ckt->ApplyFirstLevelMarks();
+    foreach (Device *dev, ckt->FirstLevelDeviceList())
+        text += "first " + std::to_string(dev->Id()) + " " + dev->Name().toStdString() + "\n";
+    return text;
+}
+
+/* first differing line, for the failure message */
+static inline std::string FirstDifference(const std::string &a, const std::string &b)
+{
+    size_t line = 0, begin = 0;
+    for (size_t i = 0; i < a.size() AND i < b.size(); ++ i) {
+        if (a[i] != b[i])
+            break;
+        if (a[i] == '\n') {
+            line++;
+            begin = i + 1;
+        }
+    }
+    size_t endA = a.find('\n', begin), endB = b.find('\n', begin);
+    return "line " + std::to_string(line + 1) + ": \"" + a.substr(begin, endA - begin)
+           + "\" vs \"" + b.substr(begin, endB - begin) + "\"";
+}
+
+#endif // NETLISTVIZ_TESTS_CIRCUITDUMP_H
@@ -0,0 +1,20 @@
+#####################
+# compressor, series and parallel folds of CircuitGraph::Compress()
+#####################
+
+TEMPLATE = app
+TARGET = compressor
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+SOURCES += ./Main.cpp
@@ -0,0 +1,305 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : compressor, small netlists through CircuitGraph::Compress().
+ *           : R, L or C on one node pair fold in parallel, R and L chains
+ *           : in series, with the documented lossy folds: a chain with
+ *           : an R is an R of its R sum (the L is dropped) and a stub R
+ *           : to an RC load is an R to ground. Sources stay, an expanded
+ *           : fold is not done, and a first level device or .FIRSTLEVEL
+ *           : mark goes to its composite, as does its name. ReduceRC()
+ *           : and Compress() run once per parse: the second time ASGDialog
+ *           : is opened they keep the devices of the first.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Circuit/Device.h"
+#include "Circuit/Terminal.h"
+#include "Circuit/Node.h"
+#include "../Common/CircuitDump.h"
+
+struct Case
+{
+    const char               *name;
+    const char               *netlist;
+    std::vector<const char*>  expanded;
+    std::vector<const char*>  devices;     // name value nodes, in list order
+};
+
+static const Case CASES[] = {
+    { "parallel",
+      "* parallel R and C\n"
+      "V1 in 0 1\n"
+      "R1 in out 2k\n"
+      "R2 in out 2k\n"
+      "C1 out 0 1p\n"
+      "C2 out 0 2p\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      {},
+      { "V1 1 in 0", "R1|1 1000 in out", "C1|1 3e-12 out 0", "M1 0 out in 0 0" } },
+
+    { "series",
+      "* R chain between two ports, the caps inside go in\n"
+      "V1 in 0 1\n"
+      "R1 in a 1k\n"
+      "R2 a b 2k\n"
+      "C1 b 0 1p\n"
+      "R3 b out 3k\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      {},
+      { "V1 1 in 0", "R1+3 6000 in out", "M1 0 out in 0 0" } },
+
+    { "series of parallel",
+      "* the parallel fold makes the chain\n"
+      "V1 in 0 1\n"
+      "R1 in a 1k\n"
+      "R2 a out 2k\n"
+      "R3 a out 2k\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      {},
+      { "V1 1 in 0", "R1+2 2000 in out", "M1 0 out in 0 0" } },
+
+    { "lossy rl",
+      "* an R and L chain is an R, the L is dropped\n"
+      "V1 in 0 1\n"
+      "R1 in a 1k\n"
+      "L1 a out 1u\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      {},
+      { "V1 1 in 0", "R1+1 1000 in out", "M1 0 out in 0 0" } },
+
+    { "lossy stub",
+      "* a stub R to an RC load is an R to ground\n"
+      "V1 in 0 1\n"
+      "R1 in a 1k\n"
+      "C1 a 0 1p\n"
+      ".end\n",
+      {},
+      { "V1 1 in 0", "R1+1 1000 0 in" } },
+
+    { "expanded",
+      "* the fold is expanded, nothing is folded\n"
+      "V1 in 0 1\n"
+      "R1 in a 1k\n"
+      "R2 a out 2k\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      { "R1+1" },
+      { "V1 1 in 0", "R1 1000 in a", "R2 2000 a out", "M1 0 out in 0 0" } },
+
+    { "sources",
+      "* a source is never folded, its nodes end the chain\n"
+      "V1 in 0 1\n"
+      "R1 in a 1k\n"
+      "I1 a 0 1m\n"
+      "R2 a out 2k\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      {},
+      { "V1 1 in 0", "R1 1000 in a", "I1 0.001 a 0", "R2 2000 a out", "M1 0 out in 0 0" } },
+};
+
+static bool WriteNetlist(const std::string &path, const std::string &text)
+{
+    QFile file(QString::fromStdString(path));
+    if (NOT file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(text.data(), text.size()) == (qint64)text.size();
+}
+
+static std::string DumpDevice(const Device *dev)
+{
+    char value[32];
+    snprintf(value, sizeof(value), "%.12g", dev->Value());
+    std::string text = dev->Name().toStdString() + " " + value;
+    for (int pin = 0; pin < dev->TerminalCount(); ++ pin) {
+        Terminal *terminal = dev->TerminalAt(pin);
+        text += " ";
+        text += terminal->NodeIsGnd() ? std::string("0") : terminal->GetNode()->Name().toStdString();
+    }
+    return text;
+}
+
+static int Parse(const std::string &path, const char *netlist, CircuitGraph *ckt)
+{
+    MyParser parser;
+    parser.SetUseCache(false);
+    if (NOT WriteNetlist(path, netlist) || parser.ParseNetlist(path, ckt) || ckt->Flatten())
+        return ERROR;
+    return OKAY;
+}
+
+static int CheckCase(const std::string &path, const Case &test)
+{
+    CircuitGraph ckt;
+    QSet<QString> expanded;
+    for (const char *name : test.expanded)
+        expanded.insert(name);
+    if (Parse(path, test.netlist, &ckt) || ckt.Compress(expanded)) {
+        fprintf(stderr, "FAIL %s : does not compress\n", test.name);
+        return 1;
+    }
+
+    int failures = 0;
+    DeviceList devList = ckt.GetDeviceList();
+    if (devList.size() != (int)test.devices.size()) {
+        fprintf(stderr, "FAIL %s : %d devices, %zu expected\n", test.name, (int)devList.size(), test.devices.size());
+        failures++;
+    }
+    for (int i = 0; i < devList.size() AND i < (int)test.devices.size(); ++ i) {
+        std::string text = DumpDevice(devList.at(i));
+        if (text != test.devices[i]) {
+            fprintf(stderr, "FAIL %s : %s, %s expected\n", test.name, text.c_str(), test.devices[i]);
+            failures++;
+        }
+        if (devList.at(i)->Id() != i) {
+            fprintf(stderr, "FAIL %s : %s has id %d\n", test.name, text.c_str(), devList.at(i)->Id());
+            failures++;
+        }
+    }
+    return failures;
+}
+
+/* R2 is at first level and .FIRSTLEVEL R3, both are folded into R1+2 */
+static int CheckFirstLevel(const std::string &path)
+{
+    static const char *NETLIST =
+        "* first level devices in a chain\n"
+        "V1 in 0 1\n"
+        "R1 in a 1k\n"
+        "R2 a b 2k\n"
+        "R3 b out 3k\n"
+        "M1 out in 0 0 nmos\n"
+        ".FIRSTLEVEL R3\n"
+        ".end\n";
+
+    CircuitGraph ckt;
+    if (Parse(path, NETLIST, &ckt)) {
+        fprintf(stderr, "FAIL first level : does not parse\n");
+        return 1;
+    }
+    DeviceList firstLevels;
+    firstLevels.push_back(ckt.GetDevice("V1"));
+    firstLevels.push_back(ckt.GetDevice("R2"));
+    ckt.SetFirstLevelDeviceList(firstLevels);
+    Device *source = ckt.GetDevice("V1");
+    Device *leaf = ckt.GetDevice("R1");
+    if (ckt.Compress()) {
+        fprintf(stderr, "FAIL first level : does not compress\n");
+        return 1;
+    }
+
+    int failures = 0;
+    Device *composite = ckt.GetDevice("R1+2");
+    DeviceList kept = ckt.FirstLevelDeviceList();
+    if (NOT composite || kept.size() != 2 || kept.at(0) != source || kept.at(1) != composite) {
+        fprintf(stderr, "FAIL first level : V1 and R1+2 are not at first level\n");
+        failures++;
+    }
+    if (composite AND NOT composite->Members().contains(leaf)) {
+        fprintf(stderr, "FAIL first level : R1 is not a member of R1+2\n");
+        failures++;
+    }
+    for (const char *name : { "R1", "R2", "R3" }) {
+        if (ckt.GetDevice(name) != composite) {
+            fprintf(stderr, "FAIL first level : %s is not R1+2 by name\n", name);
+            failures++;
+        }
+    }
+    std::string marks = DumpFirstLevel(&ckt);
+    if (marks != "mark R3\nfirst 1 R1+2\n") {
+        fprintf(stderr, "FAIL first level : .FIRSTLEVEL R3 gives\n%s", marks.c_str());
+        failures++;
+    }
+    return failures;
+}
+
+/* MainWindow::CompressCircuit() as each opening of ASGDialog runs it */
+static int PrepareForDialog(CircuitGraph *ckt, bool compress)
+{
+    if (ckt->Flatten() || ckt->ReduceRC(TICER_DFT_FREQUENCY, TICER_DFT_ERROR))
+        return ERROR;
+    if (compress AND ckt->Compress())
+        return ERROR;
+    ckt->Freeze();
+    return OKAY;
+}
+
+/*
+ * n3 is quick, R(n2,n5) it leaves would let a second ReduceRC() take n4
+ * too, and R3, R8 fold in parallel
+ */
+static int CheckDialogTwice(const std::string &path, bool compress)
+{
+    static const char *NETLIST =
+        "* reduced, then compressed\n"
+        "V1 n0 0 1\n"
+        "R0 n1 n2 10k\n"
+        "C1 n2 n4 10f\n"
+        "C2 n4 0 10f\n"
+        "R3 n4 n5 3k\n"
+        "C4 n1 0 10f\n"
+        "R5 n5 n3 1k\n"
+        "R6 n4 n0 100\n"
+        "R7 n2 n3 3k\n"
+        "R8 n4 n5 3k\n"
+        "M1 n5 n0 0 0 nmos\n"
+        ".end\n";
+    const char *name = compress ? "dialog twice" : "dialog twice, rc";
+
+    CircuitGraph ckt;
+    if (Parse(path, NETLIST, &ckt) || PrepareForDialog(&ckt, compress)) {
+        fprintf(stderr, "FAIL %s : does not reduce\n", name);
+        return 1;
+    }
+    std::string first = DumpDevices(&ckt) + DumpNodes(&ckt);
+
+    int failures = 0;
+    Device *folded = ckt.GetDevice("R3");
+    bool composite = folded AND folded->IsComposite();
+    if (NOT ckt.Reduced() || ckt.Compressed() != compress || ckt.GetDevice("R5") || composite != compress) {
+        fprintf(stderr, "FAIL %s : not reduced%s\n%s", name, compress ? " and folded" : "", first.c_str());
+        failures++;
+    }
+    if (PrepareForDialog(&ckt, compress)) {
+        fprintf(stderr, "FAIL %s : the second opening fails\n", name);
+        return failures + 1;
+    }
+    std::string second = DumpDevices(&ckt) + DumpNodes(&ckt);
+    if (second != first) {
+        fprintf(stderr, "FAIL %s : %s\n", name, FirstDifference(first, second).c_str());
+        failures++;
+    }
+    return failures;
+}
+
+int main()
+{
+    const std::string path = QDir::temp().filePath("compressor.sp").toStdString();
+
+    int failures = 0;
+    for (const Case &test : CASES)
+        failures += CheckCase(path, test);
+    failures += CheckFirstLevel(path);
+    failures += CheckDialogTwice(path, false);
+    failures += CheckDialogTwice(path, true);
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "compressor : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("compressor : %zu netlists, first level and the dialog twice, PASS\n", sizeof(CASES) / sizeof(CASES[0]));
+    return 0;
+}
@@ -0,0 +1,30 @@
+#####################
+# crossings, LevelGraph::Crossings against a count of edge pairs, and
+# CrossingReducer::Run never adds crossings
+#####################
+
+TEMPLATE = app
+TARGET = crossings
+
+QMAKE_CXXFLAGS += -std=c++17
+
+# ASG::PlotLevels() links TablePlotter, nothing is shown
+QT += widgets
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+DEFINES += NETLIST_DIR=\\\"$$PWD/../../Netlist\\\"
+
+include(../../Src/Parser/Parser.pri)
+include(../../Src/ASG/ASG.pri)
+
+INCLUDEPATH += ../../Tools/NetlistGen
+
+HEADERS += ../../Tools/NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ../../Tools/NetlistGen/NetlistGen.cpp
@@ -0,0 +1,213 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : crossings, devices of a netlist are put at random levels,
+ *           : in random order. LevelGraph::Crossings (a Fenwick tree over
+ *           : the positions of the next level) must give the count of
+ *           : edge pairs that cross, for random orders of both levels.
+ *           : CrossingReducer::Run must never end with more crossings
+ *           : than it started with, and its counts must be those of the
+ *           : levels before and after Apply(). Netlists are those of
+ *           : Netlist/ and small netlistgen ones, each with a fixed seed.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include "Parser/MmapScanner.h"
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/CompactGraph.h"
+#include "Circuit/Device.h"
+#include "Level.h"
+#include "LevelGraph.h"
+#include "CrossingReducer.h"
+#include "NetIndex.h"
+#include "NetlistGen.h"
+
+static const struct { NetlistGen::Family family; long long devices; } GENERATED[] = {
+    { NetlistGen::LadderRLC,       2000 },
+    { NetlistGen::MeshR,           2000 },
+    { NetlistGen::ClockTreeRCRand, 2000 },
+    { NetlistGen::CoupledTreeRC,   2000 },
+};
+
+static const int LEVELS = 6;
+static const int ORDERS = 3;
+static const unsigned SEED = 17;
+
+/* position of every entry of order */
+static std::vector<int> Positions(const std::vector<int> &order)
+{
+    std::vector<int> pos(order.size());
+    for (size_t i = 0; i < order.size(); ++ i)
+        pos[order[i]] = i;
+    return pos;
+}
+
+/* every pair of edges between level and level + 1, those whose ends swap sides cross */
+static qint64 BruteCrossings(const LevelGraph &graph, int level, const std::vector<int> &pos,
+                             const std::vector<int> &nextPos)
+{
+    const LevelGraph::Adjacency &down = graph.Down(level);
+    std::vector<std::pair<int, int>> edges;
+    for (int dev = 0; dev < graph.DeviceCount(level); ++ dev) {
+        for (int i = down.begin[dev]; i < down.begin[dev + 1]; ++ i)
+            edges.push_back({pos[dev], nextPos[down.other[i]]});
+    }
+
+    qint64 crossings = 0;
+    for (size_t a = 0; a < edges.size(); ++ a) {
+        for (size_t b = a + 1; b < edges.size(); ++ b) {
+            if ((qint64)(edges[a].first - edges[b].first) * (edges[a].second - edges[b].second) < 0)
+                crossings++;
+        }
+    }
+    return crossings;
+}
+
+/* all levels in the order AllDevices() gives */
+static qint64 BruteTotal(const NetIndex *nets, const LevelList &levels)
+{
+    LevelGraph graph(nets, levels);
+    graph.Build();
+    qint64 crossings = 0;
+    std::vector<int> pos, nextPos;
+    for (int l = 0; l + 1 < graph.LevelCount(); ++ l) {
+        pos.resize(graph.DeviceCount(l));
+        nextPos.resize(graph.DeviceCount(l + 1));
+        for (size_t i = 0; i < pos.size(); ++ i)
+            pos[i] = i;
+        for (size_t i = 0; i < nextPos.size(); ++ i)
+            nextPos[i] = i;
+        crossings += BruteCrossings(graph, l, pos, nextPos);
+    }
+    return crossings;
+}
+
+static int Check(const std::string &netlist, const std::string &name)
+{
+    CircuitGraph ckt;
+    MmapScanner scanner;
+    if (scanner.ParseNetlist(netlist, &ckt) || ckt.Flatten()) {
+        fprintf(stderr, "FAIL %s : not parsed\n", name.c_str());
+        return 1;
+    }
+    const CompactGraph *compact = ckt.Freeze();
+
+    std::mt19937 random(SEED);
+    LevelList levels;
+    for (int l = 0; l < LEVELS; ++ l)
+        levels.push_back(new Level(l));
+    DeviceList devList = ckt.GetDeviceList();
+    std::shuffle(devList.begin(), devList.end(), random);
+    foreach (Device *dev, devList)
+        levels[random() % LEVELS]->AddDevice(dev);
+
+    NetIndex nets(compact);
+    nets.Build();
+
+    int failures = 0;
+    qint64 edges = 0, expected = 0, crossings = 0;
+    LevelGraph graph(&nets, levels);
+    graph.Build();
+    std::vector<int> order, nextOrder;
+    for (int l = 0; l + 1 < graph.LevelCount(); ++ l) {
+        edges += graph.Down(l).other.size();
+        for (int o = 0; o < ORDERS; ++ o) {
+            order.resize(graph.DeviceCount(l));
+            nextOrder.resize(graph.DeviceCount(l + 1));
+            for (size_t i = 0; i < order.size(); ++ i)
+                order[i] = i;
+            for (size_t i = 0; i < nextOrder.size(); ++ i)
+                nextOrder[i] = i;
+            std::shuffle(order.begin(), order.end(), random);
+            std::shuffle(nextOrder.begin(), nextOrder.end(), random);
+
+            crossings = graph.Crossings(l, order, Positions(nextOrder));
+            expected = BruteCrossings(graph, l, Positions(order), Positions(nextOrder));
+            if (crossings != expected) {
+                fprintf(stderr, "FAIL %s : level %d, %lld crossings, %lld edge pairs cross\n",
+                        name.c_str(), l, (long long)crossings, (long long)expected);
+                failures++;
+            }
+        }
+    }
+
+    qint64 before = BruteTotal(&nets, levels);
+    CrossingReducer reducer(&nets, levels);
+    reducer.SetThreadCount(1);
+    QElapsedTimer clock;
+    clock.start();
+    if (reducer.Run(clock)) {
+        fprintf(stderr, "FAIL %s : CrossingReducer does not run\n", name.c_str());
+        failures++;
+    }
+    reducer.Apply();
+    qint64 after = BruteTotal(&nets, levels);
+    if (reducer.CrossingsBefore() != before || reducer.CrossingsAfter() != after) {
+        fprintf(stderr, "FAIL %s : reducer counts %lld -> %lld, levels have %lld -> %lld\n", name.c_str(),
+                (long long)reducer.CrossingsBefore(), (long long)reducer.CrossingsAfter(),
+                (long long)before, (long long)after);
+        failures++;
+    }
+    if (after > before) {
+        fprintf(stderr, "FAIL %s : reducer goes from %lld to %lld crossings\n", name.c_str(),
+                (long long)before, (long long)after);
+        failures++;
+    }
+    qDeleteAll(levels);
+
+    if (NOT failures)
+        printf("%-22s : %lld edges, same count, %lld -> %lld crossings\n", name.c_str(),
+               (long long)edges, (long long)before, (long long)after);
+    return failures;
+}
+
+static bool Generate(NetlistGen::Family family, long long devices, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return false;
+    NetlistGen gen;
+    gen.SetDevices(devices);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    return error == OKAY;
+}
+
+int main()
+{
+    int failures = 0;
+    QDirIterator it(NETLIST_DIR, QStringList() << "*.sp", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        std::string netlist = it.next().toStdString();
+        failures += Check(netlist, netlist.substr(netlist.rfind('/') + 1));
+    }
+
+    const std::string path = QDir::temp().filePath("crossings.sp").toStdString();
+    for (const auto &gen : GENERATED) {
+        std::string name = std::string(NetlistGen::FamilyName(gen.family)) + " " + std::to_string(gen.devices);
+        if (NOT Generate(gen.family, gen.devices, path)) {
+            fprintf(stderr, "FAIL %s : generate %s failed\n", name.c_str(), path.c_str());
+            failures++;
+            continue;
+        }
+        failures += Check(path, name);
+    }
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "crossings : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("crossings : Fenwick count and CrossingReducer, PASS\n");
+    return 0;
+}
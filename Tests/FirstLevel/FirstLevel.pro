@@ -0,0 +1,22 @@
+#####################
+# firstlevel, first level devices ASG takes per connected component
+#####################
+
+TEMPLATE = app
+TARGET = firstlevel
+
+QMAKE_CXXFLAGS += -std=c++17
+
+# ASG::PlotLevels() links TablePlotter, nothing is shown
+QT += widgets
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+include(../../Src/ASG/ASG.pri)
+
+SOURCES += ./Main.cpp
@@ -0,0 +1,162 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : firstlevel, the first level ASG takes per connected
+ *           : component, one case per kind: sources to ground, floating
+ *           : sources, port devices (FL_MAX_PORT_DEVICES of them, and one
+ *           : more falling back to the peripheral device), the peripheral
+ *           : device of a component with none of these, and chosen
+ *           : devices, one of them listed twice. The components together
+ *           : must keep the kind each one has alone.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/Device.h"
+#include "ASG.h"
+
+/* V1 and V2 beat the port R2 */
+static const char *GROUNDED_SOURCE =
+    "V1 a 0 1\n"
+    "V2 b 0 1\n"
+    "R1 a b 1k\n"
+    "R2 b p1 1k\n";
+
+/* V3 beats the port R4 */
+static const char *FLOATING_SOURCE =
+    "R3 c d 1k\n"
+    "V3 c d 1\n"
+    "R4 d p2 1k\n";
+
+static const char *PORT =
+    "R5 e f 1k\n"
+    "R6 f g 1k\n"
+    "R7 f h 1k\n"
+    "C1 f 0 1p\n";
+
+/* C2 and C3 are both ends, the BFS from C3 is not deeper, C2 stays */
+static const char *PERIPHERAL =
+    "C2 t1 0 1p\n"
+    "R8 t1 t2 1k\n"
+    "R9 t2 t3 1k\n"
+    "C3 t3 0 1p\n";
+
+/* FL_MAX_PORT_DEVICES ports */
+static const char *MAX_PORT =
+    "R10 m m0 1k\n"
+    "R11 m m1 1k\n"
+    "R12 m m2 1k\n"
+    "R13 m m3 1k\n"
+    "R14 m m4 1k\n"
+    "R15 m m5 1k\n"
+    "R16 m m6 1k\n"
+    "R17 m m7 1k\n";
+
+/* one port more, the star falls back to its peripheral device, any one is as deep */
+static const char *PORT_FALLBACK =
+    "R20 n n0 1k\n"
+    "R21 n n1 1k\n"
+    "R22 n n2 1k\n"
+    "R23 n n3 1k\n"
+    "R24 n n4 1k\n"
+    "R25 n n5 1k\n"
+    "R26 n n6 1k\n"
+    "R27 n n7 1k\n"
+    "R28 n n8 1k\n";
+
+struct Case
+{
+    const char              *name;
+    std::string              netlist;
+    std::vector<std::string> chosen;
+    std::string              expected;    // names in component order
+};
+
+static bool WriteNetlist(const std::string &path, const std::string &text)
+{
+    QFile file(QString::fromStdString(path));
+    if (NOT file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(text.data(), text.size()) == (qint64)text.size();
+}
+
+static int FirstLevel(const std::string &path, const Case &test, std::string *names)
+{
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetUseCache(false);
+    if (NOT WriteNetlist(path, test.netlist + ".end\n") || parser.ParseNetlist(path, &ckt) || ckt.Flatten())
+        return ERROR;
+
+    DeviceList chosen, devList;
+    for (const std::string &name : test.chosen) {
+        Device *dev = ckt.GetDevice(QString::fromStdString(name));
+        if (NOT dev)
+            return ERROR;
+        chosen.push_back(dev);
+    }
+
+    ASG asg(&ckt);
+    if (asg.ResolveFirstLevelDevices(chosen, &devList))
+        return ERROR;
+
+    names->clear();
+    foreach (Device *dev, devList)
+        *names += (names->empty() ? "" : " ") + dev->Name().toStdString();
+    return OKAY;
+}
+
+static int CheckCase(const std::string &path, const Case &test)
+{
+    std::string names;
+    if (FirstLevel(path, test, &names)) {
+        fprintf(stderr, "FAIL %s : not parsed\n", test.name);
+        return 1;
+    }
+    if (names != test.expected) {
+        fprintf(stderr, "FAIL %s : first level \"%s\", expected \"%s\"\n",
+                test.name, names.c_str(), test.expected.c_str());
+        return 1;
+    }
+    printf("%-16s : %s\n", test.name, names.c_str());
+    return 0;
+}
+
+int main()
+{
+    const std::string all = std::string(GROUNDED_SOURCE) + FLOATING_SOURCE + PORT + PERIPHERAL
+                            + MAX_PORT + PORT_FALLBACK;
+    const std::string allExpected = "V1 V2 V3 R5 R6 R7 C2 R10 R11 R12 R13 R14 R15 R16 R17 R20";
+    const Case cases[] = {
+        { "grounded source", GROUNDED_SOURCE, {}, "V1 V2" },
+        { "floating source", FLOATING_SOURCE, {}, "V3" },
+        { "port",            PORT,            {}, "R5 R6 R7" },
+        { "peripheral",      PERIPHERAL,      {}, "C2" },
+        { "max ports",       MAX_PORT,        {}, "R10 R11 R12 R13 R14 R15 R16 R17" },
+        { "port fallback",   PORT_FALLBACK,   {}, "R20" },
+        { "components",      all,             {}, allExpected },
+        /* chosen ones keep their order, R7 once, the other components keep their kind */
+        { "chosen twice",    all, { "R7", "R4", "R5", "R7" },
+          "V1 V2 R4 R7 R5 C2 R10 R11 R12 R13 R14 R15 R16 R17 R20" },
+    };
+
+    const std::string path = QDir::temp().filePath("firstlevel.sp").toStdString();
+    int failures = 0;
+    for (const Case &test : cases)
+        failures += CheckCase(path, test);
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "firstlevel : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("firstlevel : %zu cases, PASS\n", sizeof(cases) / sizeof(cases[0]));
+    return 0;
+}
@@ -0,0 +1,121 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : hiernames, extracted netlists name devices and nodes by
+ *           : hierarchy (x1/x2/net, top.out, bus[3], d<1>). Both scanners
+ *           : must take them and give the same devices and nodes, and
+ *           : both must reject a value that only looks like a name.
+ */
+
+#include <cstdio>
+#include <string>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Circuit/Device.h"
+#include "../Common/CircuitDump.h"
+
+static const char *GOOD =
+    "* hiernames test\n"
+    "V1 x1/in 0 1\n"
+    "Rx1/r1 x1/in x1/x2/net 1k\n"
+    "Rx1/x2/r2 x1/x2/net top.out 2k\n"
+    "C1 top.out bus[3] 1p\n"
+    "C2 bus[3] 0 1f\n"
+    "Ltop:l1 top:a<0> d<1> 1n\n"
+    "R3 d<1> net#1 50\n"
+    "R4 net#1 a-b 1meg\n"
+    "R5 a-b 0 10\n"
+    "M1 x1/x2/net top.out 0 0 nmos w=1u\n"
+    ".end\n";
+
+static const char *DEVICES[] = { "V1", "Rx1/r1", "Rx1/x2/r2", "C1", "C2", "Ltop:l1",
+                                 "R3", "R4", "R5", "M1" };
+
+static const char *NODES[] = { "x1/in", "x1/x2/net", "top.out", "bus[3]", "top:a<0>",
+                               "d<1>", "net#1", "a-b" };
+
+static const char *BAD[] = {
+    "R1 a/b c.d 1k%\n",               // a value with a name tail
+    "R1 a/b c.d 1.5.3\n",
+    "R1 a/b c.d x1/1k\n",
+    "R1 a/b c.d (1k)\n",
+};
+
+static bool WriteNetlist(const std::string &path, const std::string &text)
+{
+    QFile file(QString::fromStdString(path));
+    if (NOT file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(text.data(), text.size()) == (qint64)text.size();
+}
+
+static int Parse(const std::string &path, MyParser::ScanMode mode, CircuitGraph *ckt)
+{
+    MyParser parser;
+    parser.SetScanMode(mode);
+    parser.SetUseCache(false);
+    return parser.ParseNetlist(path, ckt);
+}
+
+static int Check(const std::string &path, MyParser::ScanMode mode, const char *how, std::string *text)
+{
+    int failures = 0;
+
+    CircuitGraph ckt;
+    if (NOT WriteNetlist(path, GOOD) || Parse(path, mode, &ckt)) {
+        fprintf(stderr, "FAIL %s : the hierarchical names do not parse\n", how);
+        return 1;
+    }
+    for (const char *name : DEVICES) {
+        if (NOT ckt.GetDevice(name)) {
+            fprintf(stderr, "FAIL %s : no device %s\n", how, name);
+            failures++;
+        }
+    }
+    if (ckt.DeviceCount() != (int)(sizeof(DEVICES) / sizeof(DEVICES[0]))) {
+        fprintf(stderr, "FAIL %s : %d devices\n", how, ckt.DeviceCount());
+        failures++;
+    }
+    *text = DumpDevices(&ckt) + DumpNodes(&ckt);
+    for (const char *name : NODES) {
+        if (text->find(std::string(" ") + name + " :") == std::string::npos) {
+            fprintf(stderr, "FAIL %s : no node %s\n", how, name);
+            failures++;
+        }
+    }
+
+    for (const char *line : BAD) {
+        CircuitGraph bad;
+        std::string netlist = std::string("* bad\n") + line + ".end\n";
+        if (NOT WriteNetlist(path, netlist) || NOT Parse(path, mode, &bad)) {
+            fprintf(stderr, "FAIL %s : takes %s", how, line);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main()
+{
+    const std::string path = QDir::temp().filePath("hiernames.sp").toStdString();
+
+    std::string flex, mmap;
+    int failures = Check(path, MyParser::FlexScan, "flex", &flex);
+    failures += Check(path, MyParser::MmapScan, "mmap", &mmap);
+    if (NOT failures AND flex != mmap) {
+        fprintf(stderr, "FAIL flex and mmap differ, %s\n", FirstDifference(flex, mmap).c_str());
+        failures++;
+    }
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "hiernames : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("hiernames : %zu devices, %zu bad lines, flex and mmap, PASS\n",
+           sizeof(DEVICES) / sizeof(DEVICES[0]), sizeof(BAD) / sizeof(BAD[0]));
+    return 0;
+}
@@ -0,0 +1,20 @@
+#####################
+# include, .include, .subckt and .end across files in both scanners
+#####################
+
+TEMPLATE = app
+TARGET = include
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+SOURCES += ./Main.cpp
@@ -0,0 +1,113 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : include, a top netlist includes a cell library and a file
+ *           : that stops at .end. Both scanners must ignore the lines after
+ *           : an included .end, scan on after the .include line and give
+ *           : the same flattened devices.
+ */
+
+#include <cstdio>
+#include <string>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "../Common/CircuitDump.h"
+
+struct File
+{
+    const char *name;
+    const char *text;
+};
+
+static const File FILES[] = {
+    { "include_top.sp",
+      "* include test\n"
+      "V1 in 0 1\n"
+      ".include \"include_cells.inc\"\n"
+      ".include \"include_ended.inc\"\n"
+      "X1 in n1 rcell\n"
+      "X2 n1 out RCELL\n"
+      "R9 out 0 10k\n"
+      ".end\n"
+      "R_AFTER_TOP out 0 1\n" },
+    { "include_cells.inc",
+      ".subckt rcell a b\n"
+      "R1 a m 1k\n"
+      "C1 m 0 1p\n"
+      "R2 m b 1k\n"
+      ".ends\n" },
+    { "include_ended.inc",
+      "R8 in out 5k\n"
+      ".END\n"
+      "R_AFTER_END in 0 1\n" },
+};
+
+/* devices in insertion order, X lines expanded last */
+static const char *DEVICES[] = { "V1", "R8", "R9", "X1/R1", "X1/C1", "X1/R2", "X2/R1", "X2/C1", "X2/R2" };
+
+static int Check(const std::string &top, MyParser::ScanMode mode, const char *how, std::string *text)
+{
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetScanMode(mode);
+    parser.SetUseCache(false);
+    if (parser.ParseNetlist(top, &ckt) || ckt.Flatten()) {
+        fprintf(stderr, "FAIL %s : %s does not parse\n", how, top.c_str());
+        return 1;
+    }
+
+    int failures = 0;
+    for (const char *name : DEVICES) {
+        if (NOT ckt.GetDevice(name)) {
+            fprintf(stderr, "FAIL %s : no device %s\n", how, name);
+            failures++;
+        }
+    }
+    for (const char *name : { "R_AFTER_END", "R_AFTER_TOP" }) {
+        if (ckt.GetDevice(name)) {
+            fprintf(stderr, "FAIL %s : %s is after .end\n", how, name);
+            failures++;
+        }
+    }
+    if (ckt.DeviceCount() != (int)(sizeof(DEVICES) / sizeof(DEVICES[0]))) {
+        fprintf(stderr, "FAIL %s : %d devices\n", how, ckt.DeviceCount());
+        failures++;
+    }
+    *text = DumpDevices(&ckt);
+    return failures;
+}
+
+int main()
+{
+    QDir dir = QDir::temp();
+    for (const File &file : FILES) {
+        QFile out(dir.filePath(file.name));
+        std::string text = file.text;
+        if (NOT out.open(QIODevice::WriteOnly) || out.write(text.data(), text.size()) != (qint64)text.size()) {
+            fprintf(stderr, "FAIL write %s\n", file.name);
+            return 1;
+        }
+    }
+
+    std::string top = dir.filePath(FILES[0].name).toStdString();
+    std::string flex, mmap;
+    int failures = Check(top, MyParser::FlexScan, "flex", &flex);
+    failures += Check(top, MyParser::MmapScan, "mmap", &mmap);
+    if (NOT failures AND flex != mmap) {
+        fprintf(stderr, "FAIL flex and mmap differ, %s\n", FirstDifference(flex, mmap).c_str());
+        failures++;
+    }
+
+    for (const File &file : FILES)
+        QFile::remove(dir.filePath(file.name));
+
+    if (failures) {
+        fprintf(stderr, "include : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("include : flex and mmap, PASS\n");
+    return 0;
+}
@@ -0,0 +1,212 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : inputsource, a netlistgen netlist of several prefetch blocks
+ *           : is written plain, gzip and (built with CONFIG+=zstd) zstd.
+ *           : Read back through InputSource in odd sizes, the compressed
+ *           : ones must give the plain bytes, lines split by the blocks
+ *           : of PrefetchSource included, and the flex scanner and
+ *           : MmapScanner must give the graph of the plain netlist. A
+ *           : compressed netlist cut short, in its data or its trailer,
+ *           : must end in a read error, not in a shorter netlist.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QFile>
+#include <zlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#include "Parser/MyParser.h"
+#include "Parser/InputSource.h"
+#include "NetlistGen.h"
+#include "../Common/CircuitDump.h"
+
+/* PREFETCH_BLOCK_BYTES of InputSource.cpp */
+static const qint64 BLOCK_BYTES = 1LL << 20;
+static const int BLOCKS = 3;
+/* odd, so reads never line up with blocks or lines */
+static const qint64 READ_BYTES = 4093;
+
+struct Form
+{
+    const char  *name;
+    std::string  path;
+    std::string  bytes;     // on disk
+};
+
+static bool ReadFile(const std::string &path, std::string *text)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    *text = out.str();
+    return in.good() || in.eof();
+}
+
+static bool WriteFile(const std::string &path, const std::string &text)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+    return out.good();
+}
+
+static bool Gzip(const std::string &text, const std::string &path)
+{
+    gzFile gz = gzopen(path.c_str(), "wb");
+    if (NOT gz)
+        return false;
+    bool okay = gzwrite(gz, text.data(), text.size()) == (int)text.size();
+    return (gzclose(gz) == Z_OK) AND okay;
+}
+
+#ifdef HAVE_ZSTD
+static bool Zstd(const std::string &text, const std::string &path)
+{
+    std::string frame(ZSTD_compressBound(text.size()), '\0');
+    size_t n = ZSTD_compress(&frame[0], frame.size(), text.data(), text.size(), 3);
+    if (ZSTD_isError(n))
+        return false;
+    frame.resize(n);
+    return WriteFile(path, frame);
+}
+#endif
+
+/* OKAY and the bytes if the whole input reads, ERROR at the first failed Read */
+static int ReadAll(const std::string &path, std::string *text)
+{
+    text->clear();
+    InputSource *input = InputSource::Open(path);
+    if (NOT input)
+        return ERROR;
+    std::vector<char> buf(READ_BYTES);
+    qint64 n = 0;
+    while ((n = input->Read(buf.data(), READ_BYTES)) > 0)
+        text->append(buf.data(), n);
+    delete input;
+    return (n < 0) ? ERROR : OKAY;
+}
+
+static int Parse(const std::string &path, MyParser::ScanMode mode, std::string *text)
+{
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetScanMode(mode);
+    parser.SetUseCache(false);
+    int error = parser.ParseNetlist(path, &ckt);
+    *text = DumpDevices(&ckt) + DumpNodes(&ckt) + DumpFirstLevel(&ckt);
+    return error;
+}
+
+static int CheckForm(const Form &form, const std::string &plain,
+                     const std::string &flexGraph, const std::string &mmapGraph)
+{
+    int failures = 0;
+    std::string text;
+    if (ReadAll(form.path, &text) || text != plain) {
+        fprintf(stderr, "FAIL %s : InputSource gives %zu bytes, not the %zu plain ones\n",
+                form.name, text.size(), plain.size());
+        failures++;
+    }
+    if (Parse(form.path, MyParser::FlexScan, &text) || text != flexGraph) {
+        fprintf(stderr, "FAIL %s : the flex scanner gives another graph\n", form.name);
+        failures++;
+    }
+    if (Parse(form.path, MyParser::MmapScan, &text) || text != mmapGraph) {
+        fprintf(stderr, "FAIL %s : MmapScanner gives another graph\n", form.name);
+        failures++;
+    }
+    if (NOT failures)
+        printf("%-12s : same bytes, same graph\n", form.name);
+    return failures;
+}
+
+/* cut in the middle of the data and before the last 4 bytes (the end of the frame or gzip trailer) */
+static int CheckCut(const Form &form, const std::string &cutPath)
+{
+    int failures = 0;
+    std::string text;
+    const size_t cuts[] = { form.bytes.size() / 2, form.bytes.size() - 4 };
+    for (size_t cut : cuts) {
+        WriteFile(cutPath, form.bytes.substr(0, cut));
+        if (ReadAll(cutPath, &text) == OKAY) {
+            fprintf(stderr, "FAIL %s cut at %zu : reads as %zu bytes\n", form.name, cut, text.size());
+            failures++;
+        }
+        if (Parse(cutPath, MyParser::FlexScan, &text) == OKAY
+            || Parse(cutPath, MyParser::MmapScan, &text) == OKAY) {
+            fprintf(stderr, "FAIL %s cut at %zu : parses\n", form.name, cut);
+            failures++;
+        }
+    }
+    QFile::remove(QString::fromStdString(cutPath));
+    if (NOT failures)
+        printf("%-12s : cut short, read error\n", form.name);
+    return failures;
+}
+
+int main()
+{
+    const std::string path = QDir::temp().filePath("inputsource.sp").toStdString();
+    const std::string cutPath = path + ".cut";
+
+    /* about 20 bytes a line, BLOCKS prefetch blocks */
+    FILE *fp = fopen(path.c_str(), "w");
+    NetlistGen gen;
+    gen.SetDevices(BLOCKS * BLOCK_BYTES / 16);
+    int error = fp ? gen.Generate(NetlistGen::LadderRC, fp) : ERROR;
+    if (fp)
+        error |= (fclose(fp) != 0);
+
+    std::string plain, flexGraph, mmapGraph;
+    if (error || NOT ReadFile(path, &plain) || Parse(path, MyParser::FlexScan, &flexGraph)
+        || Parse(path, MyParser::MmapScan, &mmapGraph)) {
+        fprintf(stderr, "FAIL inputsource : %s is not written and parsed\n", path.c_str());
+        return 1;
+    }
+
+    /* a block that ends inside a line, or the merge of blocks is not covered */
+    int splitLines = 0;
+    for (qint64 end = BLOCK_BYTES; end < (qint64)plain.size(); end += BLOCK_BYTES)
+        splitLines += (plain[end - 1] != '\n');
+    if (splitLines == 0) {
+        fprintf(stderr, "FAIL inputsource : no prefetch block splits a line\n");
+        return 1;
+    }
+
+    std::vector<Form> forms;
+    forms.push_back({ "gzip", path + ".gz", std::string() });
+    int failures = NOT Gzip(plain, forms.back().path);
+#ifdef HAVE_ZSTD
+    forms.push_back({ "zstd", path + ".zst", std::string() });
+    failures += NOT Zstd(plain, forms.back().path);
+#else
+    printf("%-12s : not built, qmake CONFIG+=zstd\n", "zstd");
+#endif
+    if (failures) {
+        fprintf(stderr, "FAIL inputsource : the compressed netlists are not written\n");
+        return 1;
+    }
+
+    for (Form &form : forms) {
+        ReadFile(form.path, &form.bytes);
+        failures += CheckForm(form, plain, flexGraph, mmapGraph);
+        failures += CheckCut(form, cutPath);
+        QFile::remove(QString::fromStdString(form.path));
+    }
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "inputsource : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("inputsource : %d split lines, %zu compressed form(s), PASS\n", splitLines, forms.size());
+    return 0;
+}
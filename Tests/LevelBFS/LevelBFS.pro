@@ -0,0 +1,29 @@
+#####################
+# levelbfs, LevelBFS over nets against a queue BFS over device pairs
+#####################
+
+TEMPLATE = app
+TARGET = levelbfs
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+DEFINES += NETLIST_DIR=\\\"$$PWD/../../Netlist\\\"
+
+include(../../Src/Parser/Parser.pri)
+
+INCLUDEPATH += ../../Tools/NetlistGen
+
+HEADERS += $$SRC/ASG/LevelBFS.h\
+           ../../Tools/NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           $$SRC/ASG/LevelBFS.cpp\
+           ../../Tools/NetlistGen/NetlistGen.cpp
@@ -0,0 +1,201 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : levelbfs, LevelBFS expands every net once and builds no
+ *           : device pairs. Its levels must be those of a queue BFS that
+ *           : walks the device pairs (CompactGraph::Neighbors) of every
+ *           : R, L, C, V, I, M and Q device, in the same order, on one
+ *           : thread and on several. Netlists are those of Netlist/,
+ *           : netlistgen ones and a star with one big net. Sources are
+ *           : the first level, then every third of the last 60000
+ *           : devices: a frontier wide enough for the threads, bottom-up
+ *           : in small circuits and top-down in the 10^6 device ladder.
+ *           : Each LevelBFS runs twice, a second Run() must start clean.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include "Parser/MmapScanner.h"
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/CompactGraph.h"
+#include "Circuit/Device.h"
+#include "Circuit/DeviceTraits.h"
+#include "LevelBFS.h"
+#include "NetlistGen.h"
+
+typedef std::vector<std::vector<int>> Levels;
+
+static const int THREADS[] = { 1, 2, 4 };
+static const int RUNS = 2;
+static const int STAR_TAPS = 5000;
+static const int WIDE_STRIDE = 3;
+static const int WIDE_DEVICES = 60000;
+
+static const struct { NetlistGen::Family family; long long devices; } GENERATED[] = {
+    { NetlistGen::LadderRC,        60000 },
+    { NetlistGen::MeshR,           60000 },
+    { NetlistGen::ClockTreeRCRand, 60000 },
+    { NetlistGen::CoupledTreeRC,   60000 },
+    { NetlistGen::LadderRC,        1000000 },
+};
+
+/* what the incidence matrix BFS gave, each device pair listed */
+static void QueueBFS(const CompactGraph *graph, const std::vector<int> &sources, Levels *levels)
+{
+    std::vector<quint8> visited(graph->DeviceCount(), 0);
+    std::vector<quint32> neighbors;
+    std::vector<int> frontier = sources, next;
+    for (int dev : sources)
+        visited[dev] = 1;
+
+    levels->clear();
+    while (NOT frontier.empty()) {
+        next.clear();
+        for (int dev : frontier) {
+            if (NOT Traits(graph->Type(dev)).expandsNets) continue;
+            graph->Neighbors(dev, &neighbors);
+            for (quint32 other : neighbors) {
+                if (visited[other]) continue;
+                visited[other] = 1;
+                next.push_back(other);
+            }
+        }
+        if (NOT next.empty())
+            levels->push_back(next);
+        frontier.swap(next);
+    }
+}
+
+/* the chosen first level and a peripheral device per component (some twice), or a wide one */
+static std::vector<int> Sources(CircuitGraph *ckt, const CompactGraph *graph, bool wide)
+{
+    std::vector<int> sources;
+    if (wide) {
+        int last = qMax(graph->DeviceCount() - WIDE_DEVICES, 0);
+        for (int dev = graph->DeviceCount() - 1; dev >= last; dev -= WIDE_STRIDE)
+            sources.push_back(dev);
+        return sources;
+    }
+    foreach (Device *dev, ckt->FirstLevelDeviceList())
+        sources.push_back(dev->Id());
+    std::vector<quint32> peripheral;
+    graph->PeripheralDevices(&peripheral);
+    sources.insert(sources.end(), peripheral.begin(), peripheral.end());
+    return sources;
+}
+
+static int CheckSources(const CompactGraph *graph, const std::string &name,
+                        const std::vector<int> &sources)
+{
+    Levels expected, levels;
+    QueueBFS(graph, sources, &expected);
+
+    int failures = 0, topDown = 0, bottomUp = 0;
+    double ms = 0;
+    for (int threads : THREADS) {
+        LevelBFS bfs(graph);
+        bfs.SetThreadCount(threads);
+        /* the second run starts new workers on the same object */
+        for (int run = 0; run < RUNS; ++ run) {
+            auto start = std::chrono::steady_clock::now();
+            int error = bfs.Run(sources, &levels);
+            ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            topDown = bfs.TopDownSteps();
+            bottomUp = bfs.BottomUpSteps();
+            if (error || levels != expected) {
+                size_t level = 0;
+                while (level < levels.size() AND level < expected.size() AND levels[level] == expected[level])
+                    level++;
+                fprintf(stderr, "FAIL %s : %d threads, run %d, level %zu of %zu differs\n", name.c_str(),
+                        threads, run + 1, level, expected.size());
+                failures++;
+            }
+        }
+    }
+    printf("%-22s : %6d devices, %5zu levels, %5d top-down %4d bottom-up steps, %7.2f ms\n",
+           name.c_str(), graph->DeviceCount(), expected.size(), topDown, bottomUp, ms);
+    return failures;
+}
+
+static int Check(const std::string &netlist, const std::string &name)
+{
+    CircuitGraph ckt;
+    MmapScanner scanner;
+    if (scanner.ParseNetlist(netlist, &ckt) || ckt.Flatten()) {
+        fprintf(stderr, "FAIL %s : does not parse\n", name.c_str());
+        return 1;
+    }
+    const CompactGraph *graph = ckt.Freeze();
+
+    int failures = 0;
+    for (bool wide : { false, true })
+        failures += CheckSources(graph, name + (wide ? " wide" : ""), Sources(&ckt, graph, wide));
+    return failures;
+}
+
+static bool Generate(NetlistGen::Family family, long long devices, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return false;
+    NetlistGen gen;
+    gen.SetDevices(devices);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    return error == OKAY;
+}
+
+/* a source, then taps on one net, STAR_TAPS^2 device pairs */
+static bool WriteStar(const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return false;
+    fprintf(fp, "* levelbfs star\nV1 hub 0 1\n");
+    for (int i = 0; i < STAR_TAPS; ++ i)
+        fprintf(fp, "R%d hub m%d 1k\nC%d m%d 0 1p\n", i, i, i, i);
+    fprintf(fp, ".END\n");
+    return fclose(fp) == 0;
+}
+
+int main()
+{
+    int failures = 0;
+    QDirIterator it(NETLIST_DIR, QStringList() << "*.sp", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        std::string netlist = it.next().toStdString();
+        failures += Check(netlist, netlist.substr(netlist.rfind('/') + 1));
+    }
+
+    const std::string path = QDir::temp().filePath("levelbfs.sp").toStdString();
+    for (const auto &gen : GENERATED) {
+        std::string name = std::string(NetlistGen::FamilyName(gen.family)) + " " + std::to_string(gen.devices);
+        if (NOT Generate(gen.family, gen.devices, path)) {
+            fprintf(stderr, "FAIL %s : generate %s failed\n", name.c_str(), path.c_str());
+            failures++;
+            continue;
+        }
+        failures += Check(path, name);
+    }
+    if (WriteStar(path)) {
+        failures += Check(path, "star");
+    } else {
+        fprintf(stderr, "FAIL star : write %s failed\n", path.c_str());
+        failures++;
+    }
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "levelbfs : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("levelbfs : 1, 2 and 4 threads, %d runs, PASS\n", RUNS);
+    return 0;
+}
@@ -0,0 +1,113 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : modellines, M and Q lines may end with name=value instance
+ *           : params after the model name (w=1u l=0.18u m=2). Both
+ *           : scanners must skip them and give the same devices, and both
+ *           : must reject params that are not name=value or follow a value.
+ */
+
+#include <cstdio>
+#include <string>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Circuit/Device.h"
+#include "../Common/CircuitDump.h"
+
+static const char *GOOD =
+    "* modellines test\n"
+    "V1 vdd 0 1.8\n"
+    "M1 out in 0 0 nmos\n"
+    "M2 out in vdd vdd pmos w=2u l=0.18u\n"
+    "M3 out in 0 0 nmos W=1u L=180n AS=1p PD=2.5u m=2\n"
+    "Q1 c b 0 npn\n"
+    "Q2 c b 0 npn area=2\n"
+    "Q3 c b 0 npn area=2 _m=1\n"
+    "R1 vdd out 10k\n"
+    "R2 vdd c 1k\n"
+    ".end\n";
+
+static const char *DEVICES[] = { "V1", "M1", "M2", "M3", "Q1", "Q2", "Q3", "R1", "R2" };
+
+static const char *BAD[] = {
+    "M1 out in 0 0 nmos 1u\n",        // not name=value
+    "M1 out in 0 0 nmos w=\n",        // no value
+    "M1 out in 0 0 nmos =1u\n",       // no name
+    "M1 out in 0 0 nmos 2w=1u\n",     // name starts with a digit
+    "M1 out in 0 w=1u\n",             // too few nodes before the params
+    "M1 out in 0 0 w=1u\n",           // no model name
+    "Q1 c b 0 npn area\n",
+    "R1 a b 1k tc1=0.1\n",            // only M/Q take params
+};
+
+static bool WriteNetlist(const std::string &path, const std::string &text)
+{
+    QFile file(QString::fromStdString(path));
+    if (NOT file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(text.data(), text.size()) == (qint64)text.size();
+}
+
+static int Parse(const std::string &path, MyParser::ScanMode mode, CircuitGraph *ckt)
+{
+    MyParser parser;
+    parser.SetScanMode(mode);
+    parser.SetUseCache(false);
+    return parser.ParseNetlist(path, ckt);
+}
+
+static int Check(const std::string &path, MyParser::ScanMode mode, const char *how, std::string *text)
+{
+    int failures = 0;
+
+    CircuitGraph ckt;
+    if (NOT WriteNetlist(path, GOOD) || Parse(path, mode, &ckt)) {
+        fprintf(stderr, "FAIL %s : the M/Q lines with params do not parse\n", how);
+        return 1;
+    }
+    for (const char *name : DEVICES) {
+        if (NOT ckt.GetDevice(name)) {
+            fprintf(stderr, "FAIL %s : no device %s\n", how, name);
+            failures++;
+        }
+    }
+    if (ckt.DeviceCount() != (int)(sizeof(DEVICES) / sizeof(DEVICES[0]))) {
+        fprintf(stderr, "FAIL %s : %d devices\n", how, ckt.DeviceCount());
+        failures++;
+    }
+    *text = DumpDevices(&ckt) + DumpNodes(&ckt);
+
+    for (const char *line : BAD) {
+        CircuitGraph bad;
+        std::string netlist = std::string("* bad\n") + line + ".end\n";
+        if (NOT WriteNetlist(path, netlist) || NOT Parse(path, mode, &bad)) {
+            fprintf(stderr, "FAIL %s : takes %s", how, line);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main()
+{
+    const std::string path = QDir::temp().filePath("modellines.sp").toStdString();
+
+    std::string flex, mmap;
+    int failures = Check(path, MyParser::FlexScan, "flex", &flex);
+    failures += Check(path, MyParser::MmapScan, "mmap", &mmap);
+    if (NOT failures AND flex != mmap) {
+        fprintf(stderr, "FAIL flex and mmap differ, %s\n", FirstDifference(flex, mmap).c_str());
+        failures++;
+    }
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "modellines : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("modellines : %zu bad lines, flex and mmap, PASS\n", sizeof(BAD) / sizeof(BAD[0]));
+    return 0;
+}
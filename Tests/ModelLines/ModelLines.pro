@@ -0,0 +1,20 @@
+#####################
+# modellines, M/Q lines with instance params in both scanners
+#####################
+
+TEMPLATE = app
+TARGET = modellines
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+SOURCES += ./Main.cpp
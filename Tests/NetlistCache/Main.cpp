@@ -0,0 +1,221 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : netlistcache, a netlistgen netlist big enough to be cached
+ *           : is parsed, saved as .nvc and reloaded. The reload must give
+ *           : the devices, nodes and first level marks of the parse. A
+ *           : netlist edited in place (same size, other hash) or another
+ *           : NETLIST_CACHE_VERSION is parsed again, and a corrupted
+ *           : snapshot is rejected with the graph left empty.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Parser/NetlistCache.h"
+#include "NetlistGen.h"
+#include "../Common/CircuitDump.h"
+
+/* CacheHeader of NetlistCache.cpp, byte offsets of the fields patched here */
+static const size_t VERSION_OFFSET = 8;
+static const size_t NAMES_SIZE_OFFSET = 56;
+static const size_t HEADER_BYTES = 64;
+/* CacheDevice : value, name, type, then the node indexes */
+static const size_t DEVICE_NAME_OFFSET = 8;
+static const size_t DEVICE_NODES_OFFSET = 16;
+
+static bool ReadFile(const std::string &path, std::string *text)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    *text = out.str();
+    return in.good() || in.eof();
+}
+
+static bool WriteFile(const std::string &path, const std::string &text)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+    return out.good();
+}
+
+static void Patch(std::string *bytes, size_t offset, quint32 word)
+{
+    if (offset + sizeof(word) <= bytes->size())
+        memcpy(&(*bytes)[offset], &word, sizeof(word));
+}
+
+static std::string Dump(CircuitGraph *ckt)
+{
+    return DumpDevices(ckt) + DumpNodes(ckt) + DumpFirstLevel(ckt);
+}
+
+static int Parse(const std::string &path, bool useCache, std::string *text)
+{
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetUseCache(useCache);
+    int error = parser.ParseNetlist(path, &ckt);
+    *text = Dump(&ckt);
+    return error;
+}
+
+/* OKAY if the snapshot loads, an empty graph is checked for if not */
+static int Load(const std::string &path, std::string *text, bool *empty)
+{
+    CircuitGraph ckt;
+    NetlistCache cache(path);
+    int error = cache.Load(&ckt);
+    *empty = (ckt.DeviceCount() == 0 AND ckt.GetNodeList().isEmpty() AND ckt.GetNamePool()->Count() == 0);
+    *text = Dump(&ckt);
+    return error;
+}
+
+static int CheckReload(const std::string &path, const std::string &parsed)
+{
+    std::string loaded, reparsed;
+    bool empty = false;
+    if (Load(path, &loaded, &empty)) {
+        fprintf(stderr, "FAIL reload : the snapshot does not load\n");
+        return 1;
+    }
+    if (loaded != parsed) {
+        fprintf(stderr, "FAIL reload : %s\n", FirstDifference(parsed, loaded).c_str());
+        return 1;
+    }
+    if (Parse(path, true, &reparsed) || reparsed != parsed) {
+        fprintf(stderr, "FAIL reload : MyParser with the cache gives another graph\n");
+        return 1;
+    }
+    printf("%-20s : same graph\n", "reload");
+    return 0;
+}
+
+/* one byte of a value changed, the size stays and the hash does not */
+static int CheckStaleHash(const std::string &path, const std::string &netlist, const std::string &parsed)
+{
+    std::string edited = netlist;
+    size_t value = edited.find(" 100\n");
+    if (value == std::string::npos) {
+        fprintf(stderr, "FAIL stale hash : no 100 ohm value to edit\n");
+        return 1;
+    }
+    edited[value + 1] = '2';
+    WriteFile(path, edited);
+
+    std::string loaded, cached, uncached;
+    bool empty = false;
+    int failures = 0;
+    if (NOT Load(path, &loaded, &empty) || NOT empty) {
+        fprintf(stderr, "FAIL stale hash : the snapshot of the old netlist loads\n");
+        failures++;
+    }
+    if (Parse(path, true, &cached) || Parse(path, false, &uncached) || cached != uncached || cached == parsed) {
+        fprintf(stderr, "FAIL stale hash : the edited netlist is not parsed again\n");
+        failures++;
+    }
+    WriteFile(path, netlist);
+    if (NOT failures)
+        printf("%-20s : parsed again\n", "stale hash");
+    return failures;
+}
+
+/* bytes is a good snapshot of path, it is restored after each case */
+static int CheckRejected(const std::string &path, const std::string &bytes,
+                         const std::string &corrupted, const char *name)
+{
+    std::string cachePath = path + ".nvc", loaded;
+    bool empty = false;
+    WriteFile(cachePath, corrupted);
+    int error = Load(path, &loaded, &empty);
+    WriteFile(cachePath, bytes);
+    if (NOT error || NOT empty) {
+        fprintf(stderr, "FAIL %s : %s\n", name, error ? "the graph is not empty" : "the snapshot loads");
+        return 1;
+    }
+    printf("%-20s : rejected\n", name);
+    return 0;
+}
+
+static int CheckCorrupted(const std::string &path)
+{
+    std::string bytes;
+    if (NOT ReadFile(path + ".nvc", &bytes) || bytes.size() < HEADER_BYTES + 64) {
+        fprintf(stderr, "FAIL corrupted : no snapshot to corrupt\n");
+        return 1;
+    }
+    qint64 namesSize = 0;
+    memcpy(&namesSize, &bytes[NAMES_SIZE_OFFSET], sizeof(namesSize));
+
+    int failures = 0;
+    std::string corrupted = bytes;
+    Patch(&corrupted, VERSION_OFFSET, NETLIST_CACHE_VERSION + 1);
+    failures += CheckRejected(path, bytes, corrupted, "other version");
+
+    corrupted = bytes;
+    corrupted[0] = 'X';
+    failures += CheckRejected(path, bytes, corrupted, "bad magic");
+
+    failures += CheckRejected(path, bytes, bytes.substr(0, bytes.size() - 1), "truncated");
+    failures += CheckRejected(path, bytes, bytes + '\0', "trailing byte");
+
+    corrupted = bytes;
+    Patch(&corrupted, HEADER_BYTES + DEVICE_NAME_OFFSET, 0xffffffff);
+    failures += CheckRejected(path, bytes, corrupted, "device name");
+
+    corrupted = bytes;
+    Patch(&corrupted, HEADER_BYTES + DEVICE_NODES_OFFSET, 0xffffffff);
+    failures += CheckRejected(path, bytes, corrupted, "device node");
+
+    /* the first word of the names section is the entry count */
+    corrupted = bytes;
+    Patch(&corrupted, bytes.size() - namesSize, 1);
+    failures += CheckRejected(path, bytes, corrupted, "name count");
+    return failures;
+}
+
+int main()
+{
+    const std::string path = QDir::temp().filePath("netlistcache.sp").toStdString();
+    QFile::remove(QString::fromStdString(path + ".nvc"));
+
+    /* about 20 bytes a line, past NETLIST_CACHE_MIN_BYTES */
+    FILE *fp = fopen(path.c_str(), "w");
+    NetlistGen gen;
+    gen.SetDevices(NETLIST_CACHE_MIN_BYTES / 16);
+    int error = fp ? gen.Generate(NetlistGen::LadderRC, fp) : ERROR;
+    if (fp)
+        error |= (fclose(fp) != 0);
+
+    std::string netlist, parsed;
+    if (error || NOT ReadFile(path, &netlist) || Parse(path, true, &parsed)
+        || NOT QFile::exists(QString::fromStdString(path + ".nvc"))) {
+        fprintf(stderr, "FAIL netlistcache : %s is not parsed and saved\n", path.c_str());
+        return 1;
+    }
+
+    int failures = CheckReload(path, parsed);
+    failures += CheckStaleHash(path, netlist, parsed);
+    /* the stale parse saved the edited netlist, save the restored one */
+    if (Parse(path, true, &parsed))
+        failures++;
+    failures += CheckCorrupted(path);
+    QFile::remove(QString::fromStdString(path));
+    QFile::remove(QString::fromStdString(path + ".nvc"));
+
+    if (failures) {
+        fprintf(stderr, "netlistcache : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("netlistcache : %lld devices, reload, stale hash, other version and 6 corruptions, PASS\n",
+           gen.DeviceCount());
+    return 0;
+}
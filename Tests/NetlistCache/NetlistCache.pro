@@ -0,0 +1,25 @@
+#####################
+# netlistcache, a snapshot reload against the parse it was saved from
+#####################
+
+TEMPLATE = app
+TARGET = netlistcache
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+INCLUDEPATH += ../../Tools/NetlistGen
+
+HEADERS += ../../Tools/NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ../../Tools/NetlistGen/NetlistGen.cpp
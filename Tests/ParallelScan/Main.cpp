@@ -0,0 +1,188 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : parallelscan, MmapScanner cuts big netlists into chunks and
+ *           : merges them in file order. For netlistgen netlists large
+ *           : enough for every thread to get a chunk, and for copies with
+ *           : lines after .end, a bad line or no .end, the chunked scan
+ *           : must give the serial result: same error, same device and
+ *           : node ids, same node device lists and first level devices.
+ *           : A .subckt and X line of LONG_LINE_PORTS nodes takes the
+ *           : mmap path as it takes the flex one.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <QDir>
+#include <QFile>
+#include "Parser/MmapScanner.h"
+#include "Parser/MyParser.h"
+#include "NetlistGen.h"
+#include "../Common/CircuitDump.h"
+
+static const int THREADS = 2;
+/* ports of the long .subckt line, far more tokens than any element line */
+static const int LONG_LINE_PORTS = 1000;
+
+struct Result
+{
+    int         error;
+    std::string text;
+};
+
+static Result Scan(const std::string &netlist, int threads)
+{
+    Result result;
+    CircuitGraph ckt;
+    MmapScanner scanner;
+    scanner.SetThreadCount(threads);
+    result.error = scanner.ParseNetlist(netlist, &ckt);
+    result.text = DumpDevices(&ckt) + DumpNodes(&ckt) + DumpFirstLevel(&ckt);
+    return result;
+}
+
+static bool ReadFile(const std::string &path, std::string *text)
+{
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream out;
+    out << in.rdbuf();
+    *text = out.str();
+    return in.good() || in.eof();
+}
+
+static bool WriteFile(const std::string &path, const std::string &text)
+{
+    std::ofstream out(path, std::ios::binary);
+    out << text;
+    return out.good();
+}
+
+/* enough devices for THREADS chunks of MMAP_SCAN_CHUNK_BYTES, about 20 bytes a line */
+static std::string Generate(NetlistGen::Family family, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return std::string();
+    NetlistGen gen;
+    gen.SetDevices(THREADS * MMAP_SCAN_CHUNK_BYTES / 16);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    std::string text;
+    if (error || NOT ReadFile(path, &text))
+        return std::string();
+    return text;
+}
+
+static int Check(const std::string &name, const std::string &path, bool parseOkay)
+{
+    Result serial = Scan(path, 1);
+    Result chunked = Scan(path, THREADS);
+    if ((serial.error == OKAY) != parseOkay) {
+        fprintf(stderr, "FAIL %s : serial scan returns %d\n", name.c_str(), serial.error);
+        return 1;
+    }
+    if (chunked.error != serial.error) {
+        fprintf(stderr, "FAIL %s : chunked scan returns %d, serial %d\n",
+                name.c_str(), chunked.error, serial.error);
+        return 1;
+    }
+    if (chunked.text != serial.text) {
+        fprintf(stderr, "FAIL %s : chunked scan differs, %s\n", name.c_str(),
+                FirstDifference(serial.text, chunked.text).c_str());
+        return 1;
+    }
+    printf("%-26s : %s\n", name.c_str(), parseOkay ? "same graph" : "same error");
+    return 0;
+}
+
+/* a chain of LONG_LINE_PORTS - 1 resistors behind one port list */
+static std::string LongLineNetlist()
+{
+    std::string ports, nodes, body;
+    for (int i = 0; i < LONG_LINE_PORTS; ++ i) {
+        ports += " p" + std::to_string(i);
+        nodes += " n" + std::to_string(i);
+        if (i > 0)
+            body += "R" + std::to_string(i) + " p" + std::to_string(i - 1) + " p" + std::to_string(i) + " 1k\n";
+    }
+    return "* long lines\n.subckt chain" + ports + "\n" + body + ".ends chain\n"
+           + "V1 n0 0 1\nX1" + nodes + " chain\n.end\n";
+}
+
+static int CheckLongLine(const std::string &path)
+{
+    Result results[2];
+    const MyParser::ScanMode modes[2] = { MyParser::FlexScan, MyParser::MmapScan };
+    WriteFile(path, LongLineNetlist());
+    for (int i = 0; i < 2; ++ i) {
+        CircuitGraph ckt;
+        MyParser parser;
+        parser.SetScanMode(modes[i]);
+        parser.SetUseCache(false);
+        results[i].error = parser.ParseNetlist(path, &ckt);
+        if (results[i].error == OKAY)
+            results[i].error = ckt.Flatten();
+        results[i].text = DumpDevices(&ckt) + DumpNodes(&ckt);
+    }
+    if (results[0].error || results[1].error) {
+        fprintf(stderr, "FAIL long line : flex returns %d, mmap %d\n", results[0].error, results[1].error);
+        return 1;
+    }
+    if (results[0].text != results[1].text) {
+        fprintf(stderr, "FAIL long line : mmap differs from flex, %s\n",
+                FirstDifference(results[0].text, results[1].text).c_str());
+        return 1;
+    }
+    printf("%-26s : same graph\n", (std::to_string(LONG_LINE_PORTS) + " port line").c_str());
+    return 0;
+}
+
+int main()
+{
+    const NetlistGen::Family families[] = { NetlistGen::LadderRC, NetlistGen::MeshR,
+                                            NetlistGen::ClockTreeRCRand, NetlistGen::CoupledTreeRC };
+    const std::string path = QDir::temp().filePath("parallelscan.sp").toStdString();
+
+    int failures = 0;
+    for (NetlistGen::Family family : families) {
+        std::string name = NetlistGen::FamilyName(family);
+        std::string text = Generate(family, path);
+        if (text.empty()) {
+            fprintf(stderr, "FAIL %s : generate %s failed\n", name.c_str(), path.c_str());
+            failures++;
+            continue;
+        }
+        failures += Check(name, path, true);
+
+        /* lines after .END are ignored */
+        WriteFile(path, text + "R_AFTER 1 0 1k\nthis is not a line\n");
+        failures += Check(name + " after .end", path, true);
+
+        /* no .END is an error, after the whole file is scanned */
+        size_t end = text.rfind(".END");
+        if (end != std::string::npos) {
+            WriteFile(path, text.substr(0, end));
+            failures += Check(name + " no .end", path, false);
+        }
+
+        /* a bad line in the last chunk stops the scan there */
+        size_t line = text.find('\n', text.size() * 3 / 4);
+        if (line != std::string::npos) {
+            WriteFile(path, text.substr(0, line + 1) + "R_BAD 1\n" + text.substr(line + 1));
+            failures += Check(name + " bad line", path, false);
+        }
+    }
+    failures += CheckLongLine(path);
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "parallelscan : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("parallelscan : %d threads, PASS\n", THREADS);
+    return 0;
+}
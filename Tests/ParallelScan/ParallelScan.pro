@@ -0,0 +1,25 @@
+#####################
+# parallelscan, chunked MmapScanner against the serial scan
+#####################
+
+TEMPLATE = app
+TARGET = parallelscan
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+INCLUDEPATH += ../../Tools/NetlistGen
+
+HEADERS += ../../Tools/NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ../../Tools/NetlistGen/NetlistGen.cpp
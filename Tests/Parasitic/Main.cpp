@@ -0,0 +1,156 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : parasitic, a SPEF and a DSPF netlist go through MyParser to
+ *           : ParasiticReader. Ground caps go to gnd, coupled caps join
+ *           : two nets, *NAME_MAP indices resolve to names, and a coupled
+ *           : cap listed by both nets is kept once while two caps between
+ *           : the same nodes are both kept.
+ */
+
+#include <cstdio>
+#include <string>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Circuit/Device.h"
+#include "Circuit/Terminal.h"
+#include "Circuit/Node.h"
+
+static const char *SPEF =
+    "*SPEF \"IEEE 1481-1998\"\n"
+    "*DESIGN \"parasitic\"\n"
+    "*DIVIDER /\n"
+    "*DELIMITER :\n"
+    "*C_UNIT 1 FF\n"
+    "*R_UNIT 1 KOHM\n"
+    "*L_UNIT 1 HENRY\n"
+    "\n"
+    "*NAME_MAP\n"
+    "*1 net_a\n"
+    "*2 net_b\n"
+    "*3 u1\n"
+    "\n"
+    "*D_NET *1 1.0\n"
+    "*CONN\n"
+    "*I *3:Z O\n"
+    "*CAP\n"
+    "1 *1:1 0.5\n"
+    "2 *1:1 *2:1 0.2\n"
+    "3 *1:1 *2:1 0.3\n"
+    "*RES\n"
+    "1 *3:Z *1:1 0.01\n"
+    "*END\n"
+    "\n"
+    "// net_b lists the two coupled caps again, under its own ids\n"
+    "*D_NET *2 0.7\n"
+    "*CAP\n"
+    "1 *2:1 0.4:0.4:0.4\n"
+    "2 *2:1 *1:1 0.3\n"
+    "3 *2:1 *1:1 0.2\n"
+    "*RES\n"
+    "1 *2:1 net_b:2 0.005\n"
+    "*END\n";
+
+/* name value pos neg, in netlist order */
+static const char *SPEF_DEVICES[] = {
+    "net_a/C1 5e-16 net_a:1 0 ground",
+    "net_a/C2 2e-16 net_a:1 net_b:1 coupled",
+    "net_a/C3 3e-16 net_a:1 net_b:1 coupled",
+    "net_a/R1 10 u1:Z net_a:1",
+    "net_b/C1 4e-16 net_b:1 0 ground",
+    "net_b/R1 5 net_b:1 net_b:2",
+};
+
+static const char *DSPF =
+    "*|DSPF 1.0\n"
+    "*|DESIGN \"parasitic\"\n"
+    ".SUBCKT top a b\n"
+    "*|NET a 1PF\n"
+    "*|P (a O 0 0 0)\n"
+    "Cg1 a:1 0 0.5f\n"
+    "Cc1 a:1 b:1 0.2f $ coupled\n"
+    "Cc2 a:1 b:1 0.3f\n"
+    "R1 a a:1 10\n"
+    "+ $l=1u\n"
+    "Xi1 a:1 b inv\n"
+    ".ENDS\n"
+    ".end\n"
+    "R2 a b 1\n";
+
+static const char *DSPF_DEVICES[] = {
+    "Cg1 5e-16 a:1 0 ground",
+    "Cc1 2e-16 a:1 b:1 coupled",
+    "Cc2 3e-16 a:1 b:1 coupled",
+    "R1 10 a a:1",
+};
+
+static bool WriteNetlist(const std::string &path, const std::string &text)
+{
+    QFile file(QString::fromStdString(path));
+    if (NOT file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(text.data(), text.size()) == (qint64)text.size();
+}
+
+static std::string DumpDevice(const Device *dev)
+{
+    char value[32];
+    snprintf(value, sizeof(value), "%.12g", dev->Value());
+    std::string text = dev->Name().toStdString() + " " + value;
+    for (int pin = 0; pin < dev->TerminalCount(); ++ pin) {
+        Terminal *terminal = dev->TerminalAt(pin);
+        text += " ";
+        text += terminal->NodeIsGnd() ? std::string("0") : terminal->GetNode()->Name().toStdString();
+    }
+    if (dev->GetDeviceType() == CAPACITOR)
+        text += dev->GroundCap() ? " ground" : " coupled";
+    return text;
+}
+
+static int Check(const std::string &path, const char *netlist,
+                 const char *const *devices, int count, const char *how)
+{
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetUseCache(false);
+    if (NOT WriteNetlist(path, netlist) || parser.ParseNetlist(path, &ckt)) {
+        fprintf(stderr, "FAIL %s : does not parse\n", how);
+        return 1;
+    }
+
+    int failures = 0;
+    DeviceList devList = ckt.GetDeviceList();
+    if (devList.size() != count) {
+        fprintf(stderr, "FAIL %s : %d devices, %d expected\n", how, (int)devList.size(), count);
+        failures++;
+    }
+    for (int i = 0; i < devList.size() AND i < count; ++ i) {
+        std::string text = DumpDevice(devList.at(i));
+        if (text != devices[i]) {
+            fprintf(stderr, "FAIL %s : %s, %s expected\n", how, text.c_str(), devices[i]);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main()
+{
+    const std::string spef = QDir::temp().filePath("parasitic.spef").toStdString();
+    const std::string dspf = QDir::temp().filePath("parasitic.dspf").toStdString();
+
+    int failures = Check(spef, SPEF, SPEF_DEVICES, sizeof(SPEF_DEVICES) / sizeof(SPEF_DEVICES[0]), "spef");
+    failures += Check(dspf, DSPF, DSPF_DEVICES, sizeof(DSPF_DEVICES) / sizeof(DSPF_DEVICES[0]), "dspf");
+    QFile::remove(QString::fromStdString(spef));
+    QFile::remove(QString::fromStdString(dspf));
+
+    if (failures) {
+        fprintf(stderr, "parasitic : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("parasitic : spef and dspf, PASS\n");
+    return 0;
+}
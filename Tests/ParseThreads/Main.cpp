@@ -0,0 +1,94 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : parsethreads, MyParser is reentrant. Every pair of netlists
+ *           : is parsed at once on two threads, by flex and by mmap, and
+ *           : each device list must equal the one of a serial parse.
+ *           : Netlists are the arguments, or those of Netlist/.
+ */
+
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include <QDir>
+#include <QDirIterator>
+#include "Parser/MyParser.h"
+#include "../Common/CircuitDump.h"
+
+static const int ROUNDS = 4;
+
+static int Parse(const std::string &netlist, MyParser::ScanMode mode, std::string *text)
+{
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetScanMode(mode);
+    parser.SetThreadCount(1);
+    parser.SetUseCache(false);
+    if (parser.ParseNetlist(netlist, &ckt))
+        return ERROR;
+    *text = DumpDevices(&ckt);
+    return OKAY;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> netlists;
+    for (int i = 1; i < argc; ++ i)
+        netlists.push_back(argv[i]);
+    if (netlists.empty()) {
+        QDirIterator it(NETLIST_DIR, QStringList() << "*.sp", QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            netlists.push_back(it.next().toStdString());
+    }
+    if (netlists.size() < 2) {
+        fprintf(stderr, "parsethreads : need two netlists at least\n");
+        return 1;
+    }
+
+    int failures = 0;
+    for (MyParser::ScanMode mode : {MyParser::FlexScan, MyParser::MmapScan}) {
+        const char *how = (mode == MyParser::FlexScan) ? "flex" : "mmap";
+
+        std::vector<std::string> serial(netlists.size());
+        for (size_t i = 0; i < netlists.size(); ++ i) {
+            if (Parse(netlists[i], mode, &serial[i])) {
+                fprintf(stderr, "FAIL %s : %s does not parse\n", how, netlists[i].c_str());
+                return 1;
+            }
+        }
+
+        for (int round = 0; round < ROUNDS; ++ round) {
+            for (size_t i = 0; i < netlists.size(); ++ i) {
+                size_t j = (i + 1 + round) % netlists.size();
+                std::string texts[2];
+                int errors[2] = {OKAY, OKAY};
+                std::thread other([&]() { errors[1] = Parse(netlists[j], mode, &texts[1]); });
+                errors[0] = Parse(netlists[i], mode, &texts[0]);
+                other.join();
+
+                size_t which[2] = {i, j};
+                for (int k = 0; k < 2; ++ k) {
+                    const std::string &name = netlists[which[k]];
+                    if (errors[k]) {
+                        fprintf(stderr, "FAIL %s : %s does not parse on a thread\n", how, name.c_str());
+                        failures++;
+                    } else if (texts[k] != serial[which[k]]) {
+                        fprintf(stderr, "FAIL %s : %s differs on a thread, %s\n", how, name.c_str(),
+                                FirstDifference(serial[which[k]], texts[k]).c_str());
+                        failures++;
+                    }
+                }
+            }
+        }
+    }
+
+    if (failures) {
+        fprintf(stderr, "parsethreads : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("parsethreads : %zu netlists, %d rounds, flex and mmap, PASS\n", netlists.size(), ROUNDS);
+    return 0;
+}
@@ -0,0 +1,21 @@
+#####################
+# parsethreads, netlists parsed at once on threads
+#####################
+
+TEMPLATE = app
+TARGET = parsethreads
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+DEFINES += NETLIST_DIR=\\\"$$PWD/../../Netlist\\\"
+LIBS += -lz
+
+OBJECTS_DIR = ./build
+
+include(../../Src/Parser/Parser.pri)
+
+SOURCES += ./Main.cpp
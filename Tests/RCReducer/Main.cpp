@@ -0,0 +1,201 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : rcreducer, small netlists through CircuitGraph::ReduceRC()
+ *           : at the default 1 GHz and 5% (tau up to 7.96 ps). A quick
+ *           : node gives its neighbours i, j a conductance g_i g_j / G
+ *           : and a cap (g_i c_j + g_j c_i) / G, a slow one stays. A node
+ *           : stays if it would connect more new node pairs than it has
+ *           : edges, or has more than TICER_MAX_DEGREE of them. Sources
+ *           : and first level devices stay, so do their nodes, and the
+ *           : names of eliminated devices are gone.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Circuit/Device.h"
+#include "Circuit/Terminal.h"
+#include "Circuit/Node.h"
+
+struct Case
+{
+    const char               *name;
+    std::string               netlist;
+    std::vector<std::string>  devices;     // name value nodes, in list order
+};
+
+static bool WriteNetlist(const std::string &path, const std::string &text)
+{
+    QFile file(QString::fromStdString(path));
+    if (NOT file.open(QIODevice::WriteOnly))
+        return false;
+    return file.write(text.data(), text.size()) == (qint64)text.size();
+}
+
+static std::string DumpDevice(const Device *dev)
+{
+    char value[32];
+    snprintf(value, sizeof(value), "%.6g", dev->Value());
+    std::string text = dev->Name().toStdString() + " " + value;
+    for (int pin = 0; pin < dev->TerminalCount(); ++ pin) {
+        Terminal *terminal = dev->TerminalAt(pin);
+        text += " ";
+        text += terminal->NodeIsGnd() ? std::string("0") : terminal->GetNode()->Name().toStdString();
+    }
+    return text;
+}
+
+/* a node p to n by a 100 ohm R, n to q1..qk by 1f caps, p to every q too */
+static std::string DegreeNetlist(int caps)
+{
+    std::string netlist = "* degree\nVP p 0 1\nRN p n 100\n";
+    for (int i = 1; i <= caps; ++ i) {
+        std::string q = "q" + std::to_string(i);
+        netlist += "V" + q + " " + q + " 0 1\n";
+        netlist += "CN" + q + " n " + q + " 1f\n";
+        netlist += "CP" + q + " p " + q + " 1f\n";
+    }
+    return netlist + ".end\n";
+}
+
+static std::vector<std::string> DegreeDevices(int caps, bool eliminated)
+{
+    std::vector<std::string> devices = { "VP 1 p 0" };
+    if (NOT eliminated)
+        devices.push_back("RN 100 p n");
+    for (int i = 1; i <= caps; ++ i) {
+        std::string q = "q" + std::to_string(i);
+        devices.push_back("V" + q + " 1 " + q + " 0");
+        if (NOT eliminated) {
+            devices.push_back("CN" + q + " 1e-15 n " + q);
+            devices.push_back("CP" + q + " 1e-15 p " + q);
+        }
+    }
+    /* a cap to q_i over n is g_p c_i / g_p, one more 1f */
+    for (int i = 1; eliminated AND i <= caps; ++ i)
+        devices.push_back("C(p,q" + std::to_string(i) + ") 2e-15 p q" + std::to_string(i));
+    return devices;
+}
+
+static const Case CASES[] = {
+    { "ticer",
+      "* n is quick, tau = 1f / (1/1k + 1/3k) = 0.75 ps\n"
+      "V1 in 0 1\n"
+      "R1 in n 1k\n"
+      "R2 n out 3k\n"
+      "C1 n 0 1f\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      /* R = G / (g_in g_out) = R1 + R2, C to in = g_in c / G = 3/4 of C1 */
+      { "V1 1 in 0", "M1 0 out in 0 0",
+        "C(0,in) 7.5e-16 0 in", "C(0,out) 2.5e-16 0 out", "R(in,out) 4000 in out" } },
+
+    { "slow",
+      "* n is slow, tau = 0.75 ns\n"
+      "V1 in 0 1\n"
+      "R1 in n 1k\n"
+      "R2 n out 3k\n"
+      "C1 n 0 1p\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      { "V1 1 in 0", "R1 1000 in n", "R2 3000 n out", "C1 1e-12 n 0", "M1 0 out in 0 0" } },
+
+    { "chain",
+      "* a quick chain, quickest first, down to one R\n"
+      "V1 in 0 1\n"
+      "R1 in a 1k\n"
+      "R2 a b 1k\n"
+      "R3 b c 1k\n"
+      "R4 c out 1k\n"
+      "M1 out in 0 0 nmos\n"
+      ".end\n",
+      { "V1 1 in 0", "M1 0 out in 0 0", "R(in,out) 4000 in out" } },
+
+    { "fill",
+      "* s would connect 6 new pairs with 4 edges\n"
+      "VA a 0 1\n"
+      "VB b 0 1\n"
+      "VC c 0 1\n"
+      "RA a s 1k\n"
+      "RB b s 1k\n"
+      "RC c s 1k\n"
+      "CS s 0 1f\n"
+      ".end\n",
+      { "VA 1 a 0", "VB 1 b 0", "VC 1 c 0", "RA 1000 a s", "RB 1000 b s", "RC 1000 c s", "CS 1e-15 s 0" } },
+
+    { "first level",
+      "* n is a node of a first level R\n"
+      "V1 in 0 1\n"
+      "R1 in n 1k\n"
+      "R2 n out 3k\n"
+      "C1 n 0 1f\n"
+      "M1 out in 0 0 nmos\n"
+      ".FIRSTLEVEL R2\n"
+      ".end\n",
+      { "V1 1 in 0", "R1 1000 in n", "R2 3000 n out", "C1 1e-15 n 0", "M1 0 out in 0 0" } },
+
+    { "degree 8", DegreeNetlist(TICER_MAX_DEGREE - 1), DegreeDevices(TICER_MAX_DEGREE - 1, true) },
+    { "degree 9", DegreeNetlist(TICER_MAX_DEGREE), DegreeDevices(TICER_MAX_DEGREE, false) },
+};
+
+static int CheckCase(const std::string &path, const Case &test)
+{
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetUseCache(false);
+    if (NOT WriteNetlist(path, test.netlist) || parser.ParseNetlist(path, &ckt) || ckt.Flatten()
+        || ckt.ReduceRC(TICER_DFT_FREQUENCY, TICER_DFT_ERROR)) {
+        fprintf(stderr, "FAIL %s : does not reduce\n", test.name);
+        return 1;
+    }
+
+    int failures = 0;
+    DeviceList devList = ckt.GetDeviceList();
+    if (devList.size() != (int)test.devices.size()) {
+        fprintf(stderr, "FAIL %s : %d devices, %zu expected\n", test.name, (int)devList.size(), test.devices.size());
+        failures++;
+    }
+    for (int i = 0; i < devList.size() AND i < (int)test.devices.size(); ++ i) {
+        std::string text = DumpDevice(devList.at(i));
+        if (text != test.devices[i]) {
+            fprintf(stderr, "FAIL %s : %s, %s expected\n", test.name, text.c_str(), test.devices[i].c_str());
+            failures++;
+        }
+    }
+
+    /* every name resolves to a device of the list, or to none */
+    QSet<Device*> alive;
+    foreach (Device *dev, devList)
+        alive.insert(dev);
+    for (const char *name : { "R1", "R2", "C1", "RN", "CNq1" }) {
+        Device *dev = ckt.GetDevice(name);
+        if (dev AND NOT alive.contains(dev)) {
+            fprintf(stderr, "FAIL %s : %s is eliminated but found by name\n", test.name, name);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main()
+{
+    const std::string path = QDir::temp().filePath("rcreducer.sp").toStdString();
+
+    int failures = 0;
+    for (const Case &test : CASES)
+        failures += CheckCase(path, test);
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "rcreducer : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("rcreducer : %zu netlists, PASS\n", sizeof(CASES) / sizeof(CASES[0]));
+    return 0;
+}
@@ -0,0 +1,20 @@
+#####################
+# rcreducer, TICER node elimination of CircuitGraph::ReduceRC()
+#####################
+
+TEMPLATE = app
+TARGET = rcreducer
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+SOURCES += ./Main.cpp
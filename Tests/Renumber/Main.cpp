@@ -0,0 +1,159 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : renumber, CircuitGraph::Renumber only changes ids, so the
+ *           : levels of ASG::LogicalPlacement must hold the same devices
+ *           : in netlist, RCM and BFS order. A device is taken by name
+ *           : with its level counted from the first one of its connected
+ *           : component (component bases move with the ids). Netlists
+ *           : are those of Netlist/ and netlistgen clock trees, ladders
+ *           : and coupled trees, the netlistgen ones big enough that the
+ *           : orders move most devices.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include "Parser/MmapScanner.h"
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/CompactGraph.h"
+#include "Circuit/Device.h"
+#include "ASG.h"
+#include "NetlistGen.h"
+#include "../Common/CircuitDump.h"
+
+static const struct { NetlistGen::Family family; long long devices; } GENERATED[] = {
+    { NetlistGen::ClockTreeRCRand, 60000 },
+    { NetlistGen::ClockTreeRRand,  60000 },
+    { NetlistGen::LadderRLC,       60000 },
+    { NetlistGen::CoupledTreeRC,   60000 },
+};
+
+static const struct { const char *name; DeviceOrder order; } ORDERS[] = {
+    { "netlist", NetlistOrder },
+    { "rcm",     RCMOrder },
+    { "bfs",     BFSOrder },
+};
+
+/* "name level" per device, sorted, the level counted in its component */
+static std::string DumpLevels(CircuitGraph *ckt)
+{
+    const CompactGraph *graph = ckt->Freeze();
+    std::vector<int> component;
+    int count = graph->Components(&component);
+
+    std::vector<int> base(count, -1);
+    int dev = 0, level = 0;
+    for (dev = 0; dev < graph->DeviceCount(); ++ dev) {
+        level = graph->GetDevice(dev)->LevelId();
+        if (base[component[dev]] < 0 || level < base[component[dev]])
+            base[component[dev]] = level;
+    }
+
+    std::vector<std::string> lines;
+    lines.reserve(graph->DeviceCount());
+    for (dev = 0; dev < graph->DeviceCount(); ++ dev) {
+        level = graph->GetDevice(dev)->LevelId() - base[component[dev]];
+        lines.push_back(graph->GetDevice(dev)->Name().toStdString() + " " + std::to_string(level) + "\n");
+    }
+    std::sort(lines.begin(), lines.end());
+
+    std::string text;
+    for (const std::string &line : lines)
+        text += line;
+    return text;
+}
+
+/* the levels, and how many devices the order moved from their netlist id */
+static int Place(const std::string &netlist, DeviceOrder order, std::string *levels, int *moved)
+{
+    CircuitGraph ckt;
+    MmapScanner scanner;
+    if (scanner.ParseNetlist(netlist, &ckt) || ckt.Flatten())
+        return ERROR;
+
+    DeviceList before = ckt.GetDeviceList();
+    ASG asg(&ckt);
+    asg.SetDeviceOrder(order);
+    if (asg.LogicalPlacement())
+        return ERROR;
+
+    *moved = 0;
+    for (int id = 0; id < before.size(); ++ id)
+        *moved += (before[id]->Id() != id);
+    *levels = DumpLevels(&ckt);
+    return OKAY;
+}
+
+static int Check(const std::string &netlist, const std::string &name)
+{
+    std::string expected, levels;
+    int moved = 0, failures = 0;
+    std::string report;
+    for (const auto &order : ORDERS) {
+        if (Place(netlist, order.order, &levels, &moved)) {
+            fprintf(stderr, "FAIL %s : %s order does not place\n", name.c_str(), order.name);
+            failures++;
+            continue;
+        }
+        if (order.order == NetlistOrder)
+            expected = levels;
+        else if (levels != expected) {
+            fprintf(stderr, "FAIL %s : %s order, %s\n", name.c_str(), order.name,
+                    FirstDifference(expected, levels).c_str());
+            failures++;
+        }
+        if (order.order != NetlistOrder)
+            report += ", " + std::string(order.name) + " moved " + std::to_string(moved);
+    }
+    if (NOT failures)
+        printf("%-22s : same levels%s\n", name.c_str(), report.c_str());
+    return failures;
+}
+
+static bool Generate(NetlistGen::Family family, long long devices, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return false;
+    NetlistGen gen;
+    gen.SetDevices(devices);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    return error == OKAY;
+}
+
+int main()
+{
+    int failures = 0;
+    QDirIterator it(NETLIST_DIR, QStringList() << "*.sp", QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        std::string netlist = it.next().toStdString();
+        failures += Check(netlist, netlist.substr(netlist.rfind('/') + 1));
+    }
+
+    const std::string path = QDir::temp().filePath("renumber.sp").toStdString();
+    for (const auto &gen : GENERATED) {
+        std::string name = std::string(NetlistGen::FamilyName(gen.family)) + " " + std::to_string(gen.devices);
+        if (NOT Generate(gen.family, gen.devices, path)) {
+            fprintf(stderr, "FAIL %s : generate %s failed\n", name.c_str(), path.c_str());
+            failures++;
+            continue;
+        }
+        failures += Check(path, name);
+    }
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "renumber : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("renumber : netlist, RCM and BFS order, PASS\n");
+    return 0;
+}
@@ -0,0 +1,29 @@
+#####################
+# renumber, ASG levels in netlist, RCM and BFS device order
+#####################
+
+TEMPLATE = app
+TARGET = renumber
+
+QMAKE_CXXFLAGS += -std=c++17
+
+# ASG::PlotLevels() links TablePlotter, nothing is shown
+QT += widgets
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+DEFINES += NETLIST_DIR=\\\"$$PWD/../../Netlist\\\"
+
+include(../../Src/Parser/Parser.pri)
+include(../../Src/ASG/ASG.pri)
+
+INCLUDEPATH += ../../Tools/NetlistGen
+
+HEADERS += ../../Tools/NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ../../Tools/NetlistGen/NetlistGen.cpp
@@ -0,0 +1,113 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : reparse, a netlist is parsed, flattened and dumped, the graph
+ *           : is Clear()ed and the netlist parsed into it again. Clear()
+ *           : must leave an empty graph, and the second parse must give
+ *           : the same ids, devices, nodes and first level devices.
+ *           : Netlists are the arguments, or those of Netlist/ and one
+ *           : with .subckt and .FIRSTLEVEL written to the temp dir.
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "../Common/CircuitDump.h"
+
+static const char *HIERARCHY =
+    "* reparse test\n"
+    "V1 in 0 1\n"
+    ".subckt rcell a b\n"
+    "R1 a m 1k\n"
+    "C1 m 0 1p\n"
+    "R2 m b 1k\n"
+    ".ends\n"
+    "X1 in n1 rcell\n"
+    "X2 n1 out rcell\n"
+    "R9 out 0 10k\n"
+    ".FIRSTLEVEL V1 X1/R1\n"
+    ".end\n";
+
+static int Parse(const std::string &netlist, MyParser::ScanMode mode, CircuitGraph *ckt, std::string *text)
+{
+    MyParser parser;
+    parser.SetScanMode(mode);
+    parser.SetUseCache(false);
+    if (parser.ParseNetlist(netlist, ckt) || ckt->Flatten())
+        return ERROR;
+    ckt->Freeze();
+    *text = DumpDevices(ckt) + DumpNodes(ckt) + DumpFirstLevel(ckt);
+    return OKAY;
+}
+
+static bool Empty(const CircuitGraph &ckt)
+{
+    return ckt.DeviceCount() == 0 AND ckt.GetNodeList().isEmpty()
+           AND ckt.FirstLevelDeviceListSize() == 0 AND NOT ckt.HasFirstLevelMarks()
+           AND NOT ckt.Hierarchical() AND ckt.PendingInstanceCount() == 0;
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<std::string> netlists;
+    for (int i = 1; i < argc; ++ i)
+        netlists.push_back(argv[i]);
+
+    std::string hierarchy = QDir::temp().filePath("reparse.sp").toStdString();
+    if (netlists.empty()) {
+        QDirIterator it(NETLIST_DIR, QStringList() << "*.sp", QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            netlists.push_back(it.next().toStdString());
+
+        QFile file(QString::fromStdString(hierarchy));
+        std::string text = HIERARCHY;
+        if (NOT file.open(QIODevice::WriteOnly) || file.write(text.data(), text.size()) != (qint64)text.size()) {
+            fprintf(stderr, "FAIL write %s\n", hierarchy.c_str());
+            return 1;
+        }
+        file.close();
+        netlists.push_back(hierarchy);
+    }
+
+    int failures = 0;
+    for (MyParser::ScanMode mode : {MyParser::FlexScan, MyParser::MmapScan}) {
+        const char *how = (mode == MyParser::FlexScan) ? "flex" : "mmap";
+        for (const std::string &netlist : netlists) {
+            CircuitGraph ckt;
+            std::string first, second;
+            if (Parse(netlist, mode, &ckt, &first)) {
+                fprintf(stderr, "FAIL %s : %s does not parse\n", how, netlist.c_str());
+                failures++;
+                continue;
+            }
+            ckt.Clear();
+            if (NOT Empty(ckt)) {
+                fprintf(stderr, "FAIL %s : %s, the graph is not empty after Clear()\n", how, netlist.c_str());
+                failures++;
+                continue;
+            }
+            if (Parse(netlist, mode, &ckt, &second)) {
+                fprintf(stderr, "FAIL %s : %s does not parse after Clear()\n", how, netlist.c_str());
+                failures++;
+            } else if (second != first) {
+                fprintf(stderr, "FAIL %s : %s differs after Clear(), %s\n", how, netlist.c_str(),
+                        FirstDifference(first, second).c_str());
+                failures++;
+            }
+        }
+    }
+    QFile::remove(QString::fromStdString(hierarchy));
+
+    if (failures) {
+        fprintf(stderr, "reparse : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("reparse : %zu netlists, flex and mmap, PASS\n", netlists.size());
+    return 0;
+}
@@ -0,0 +1,22 @@
+#####################
+# reparse, CircuitGraph::Clear() and a second parse into the same graph
+#####################
+
+TEMPLATE = app
+TARGET = reparse
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+DEFINES += NETLIST_DIR=\\\"$$PWD/../../Netlist\\\"
+
+SOURCES += ./Main.cpp
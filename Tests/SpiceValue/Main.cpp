@@ -0,0 +1,161 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : spicevalue, every number form with every scale suffix and
+ *           : unit tail through ParseSpiceValue, then the same values as
+ *           : resistor values through the flex scanner and MmapScanner.
+ *           : Bad values, out of range ones too, must be rejected by all
+ *           : three, and integers past an int are values like any other.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QFile>
+#include "Parser/MyParser.h"
+#include "Parser/SpiceValue.h"
+#include "Circuit/Device.h"
+
+struct Case
+{
+    std::string text;
+    double      value;
+};
+
+static const char *NUMBERS[] = { "1", "+1", "-1", "0", "007", "1.", "1.5", ".5", "-.25",
+                                 "1e3", "1E-3", "1.5e+2", "-2.5e-1", "12345678",
+                                 "10000000000", "-10000000000" };
+
+/* suffix, scale : SPICE reads the leading letters only, the rest is a unit */
+static const struct { const char *suffix; double scale; } SUFFIXES[] = {
+    { "",       1 },       { "f",      1e-15 },   { "p",      1e-12 },   { "n",      1e-9 },
+    { "u",      1e-6 },    { "m",      1e-3 },    { "k",      1e3 },     { "meg",    1e6 },
+    { "g",      1e9 },     { "t",      1e12 },    { "mil",    25.4e-6 }, { "F",      1e-15 },
+    { "K",      1e3 },     { "MEG",    1e6 },     { "Meg",    1e6 },     { "MIL",    25.4e-6 },
+    { "pF",     1e-12 },   { "uF",     1e-6 },    { "nH",     1e-9 },    { "uH",     1e-6 },
+    { "mH",     1e-3 },    { "ns",     1e-9 },    { "ps",     1e-12 },   { "kHz",    1e3 },
+    { "megHz",  1e6 },     { "GHz",    1e9 },     { "kohm",   1e3 },     { "megohm", 1e6 },
+    { "mohm",   1e-3 },    { "ohm",    1 },       { "V",      1 },       { "A",      1 },
+    { "s",      1 },       { "Hz",     1 },       { "mA",     1e-3 },    { "uA",     1e-6 },
+    { "e",      1 },       { "x",      1 },       { "milli",  25.4e-6 },
+};
+
+/* not a number followed by letters only */
+static const char *BAD[] = { "", "k", "meg", "+", "-", ".", "e3", "+.", "1k2", "1%", "1 k",
+                             "1.5.3", "1e3.5", "1-2", "inf", "nan", "0x10", "1,5", "1k_",
+                             "1e400", "1e-400", "-1e400" };
+
+static bool Same(double a, double b)
+{
+    return a == b || std::fabs(a - b) <= 1e-14 * std::fmax(std::fabs(a), std::fabs(b));
+}
+
+static std::vector<Case> GoodCases()
+{
+    std::vector<Case> cases;
+    for (const char *number : NUMBERS) {
+        for (const auto &suffix : SUFFIXES)
+            cases.push_back({ std::string(number) + suffix.suffix, atof(number) * suffix.scale });
+    }
+    return cases;
+}
+
+static int CheckParseSpiceValue(const std::vector<Case> &cases)
+{
+    int failures = 0;
+    double value = 0;
+    for (const Case &c : cases) {
+        if (NOT ParseSpiceValue(c.text, &value) || NOT Same(value, c.value)) {
+            fprintf(stderr, "FAIL ParseSpiceValue(\"%s\") = %.17g, not %.17g\n",
+                    c.text.c_str(), value, c.value);
+            failures++;
+        }
+    }
+    for (const char *text : BAD) {
+        if (ParseSpiceValue(text, &value)) {
+            fprintf(stderr, "FAIL ParseSpiceValue(\"%s\") takes a bad value\n", text);
+            failures++;
+        }
+    }
+    /* no '\0' needed, only the view is read */
+    if (NOT ParseSpiceValue(std::string_view("1.5k2", 4), &value) || value != 1.5e3) {
+        fprintf(stderr, "FAIL ParseSpiceValue reads past the view\n");
+        failures++;
+    }
+    return failures;
+}
+
+static bool WriteNetlist(const std::string &path, const std::string &body)
+{
+    QFile file(QString::fromStdString(path));
+    if (NOT file.open(QIODevice::WriteOnly))
+        return false;
+    std::string text = "*spicevalue\n" + body + ".END\n";
+    return file.write(text.data(), text.size()) == (qint64)text.size();
+}
+
+static int Parse(const std::string &path, MyParser::ScanMode mode, CircuitGraph *ckt)
+{
+    MyParser parser;
+    parser.SetScanMode(mode);
+    parser.SetUseCache(false);
+    return parser.ParseNetlist(path, ckt);
+}
+
+static int CheckScanner(const std::vector<Case> &cases, const std::string &path,
+                        MyParser::ScanMode mode, const char *how)
+{
+    int failures = 0;
+
+    /* one resistor per case, node names that look like values are nodes */
+    std::string body = "R_NODE 1n 2meg 1\n";
+    for (size_t i = 0; i < cases.size(); ++ i)
+        body += "R" + std::to_string(i) + " n" + std::to_string(i) + " 0 " + cases[i].text + "\n";
+    CircuitGraph ckt;
+    if (NOT WriteNetlist(path, body) || Parse(path, mode, &ckt)) {
+        fprintf(stderr, "FAIL %s : the good values do not parse\n", how);
+        return 1;
+    }
+    for (size_t i = 0; i < cases.size(); ++ i) {
+        Device *dev = ckt.GetDevice(QString::fromStdString("R" + std::to_string(i)));
+        if (NOT dev || NOT Same(dev->Value(), cases[i].value)) {
+            fprintf(stderr, "FAIL %s : \"%s\" is %.17g, not %.17g\n", how, cases[i].text.c_str(),
+                    dev ? dev->Value() : NAN, cases[i].value);
+            failures++;
+        }
+    }
+
+    /* BAD[0] is empty, a resistor without value is another error */
+    for (size_t i = 1; i < sizeof(BAD) / sizeof(BAD[0]); ++ i) {
+        CircuitGraph bad;
+        if (NOT WriteNetlist(path, std::string("R1 1 0 ") + BAD[i] + "\n") || NOT Parse(path, mode, &bad)) {
+            fprintf(stderr, "FAIL %s : takes the bad value \"%s\"\n", how, BAD[i]);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main()
+{
+    std::vector<Case> cases = GoodCases();
+    const std::string path = QDir::temp().filePath("spicevalue.sp").toStdString();
+
+    int failures = CheckParseSpiceValue(cases);
+    failures += CheckScanner(cases, path, MyParser::FlexScan, "flex");
+    failures += CheckScanner(cases, path, MyParser::MmapScan, "mmap");
+    QFile::remove(QString::fromStdString(path));
+
+    if (failures) {
+        fprintf(stderr, "spicevalue : %d failure(s)\n", failures);
+        return 1;
+    }
+    printf("spicevalue : %zu values, %zu bad ones, ParseSpiceValue, flex and mmap, PASS\n",
+           cases.size(), sizeof(BAD) / sizeof(BAD[0]));
+    return 0;
+}
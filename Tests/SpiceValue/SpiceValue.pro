@@ -0,0 +1,20 @@
+#####################
+# spicevalue, ParseSpiceValue and the VALUE token of both scanners
+#####################
+
+TEMPLATE = app
+TARGET = spicevalue
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+SOURCES += ./Main.cpp
@@ -0,0 +1,23 @@
+#####################
+# netlistviz tests, each one is a console program that returns 0 on PASS
+#####################
+
+TEMPLATE = subdirs
+
+SUBDIRS += ParseThreads\
+           ParallelScan\
+           SpiceValue\
+           Include\
+           Reparse\
+           ModelLines\
+           HierNames\
+           Parasitic\
+           Compressor\
+           RCReducer\
+           LevelBFS\
+           NetlistCache\
+           InputSource\
+           Renumber\
+           FirstLevel\
+           Crossings\
+           Annealer
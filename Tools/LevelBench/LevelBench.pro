@@ -0,0 +1,23 @@
+#####################
+# levelbench, Level::FitRows against the row shifting it replaced
+#####################
+
+TEMPLATE = app
+TARGET = levelbench
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+HEADERS += $$SRC/ASG/Level.h
+
+SOURCES += ./Main.cpp\
+           $$SRC/ASG/Level.cpp
@@ -0,0 +1,233 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : levelbench, the rows of one wide level: Level::FitRows (pool
+ *           : adjacent violators) against the placement that shifted
+ *           : earlier rows up by RowsFlexibleShiftUpBy before it, on
+ *           : sorted predecessor rows of 10^5 to 10^6 devices. Time, the
+ *           : distance of the rows to the wanted ones and the pairs closer
+ *           : than the gap. The old placement walks back through earlier
+ *           : rows on every collision, it is stopped past a time budget.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "Level.h"
+
+static const int DEFAULT_REPEATS = 3;
+static const double DEFAULT_BUDGET = 10.0;
+static const int DEFAULT_SIZES[] = { 100000, 300000, 1000000 };
+/* the clock is read once per this many rows walked back */
+static const qint64 CLOCK_STEPS = 1 << 22;
+
+enum Workload { Spread = 0, Buses, Clustered, OneNet };
+
+static const char *WORKLOAD_NAMES[] = { "spread", "buses", "clustered", "one net" };
+
+struct Quality
+{
+    double seconds;
+    double rms;          // of row - wanted
+    qint64 maxShift;
+    qint64 gapMisses;    // neighbours closer than the gap
+    int    placed;       // < devices if stopped
+};
+
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage : %s [-n devices] [-g gap] [-r repeats] [-t budget]\n", program);
+    fprintf(stderr, "  -n : devices of the level (10^5, 3 10^5 and 10^6)\n");
+    fprintf(stderr, "  -g : row gap (%d)\n", DFT_MAX_DEVICE_ROW_GAP);
+    fprintf(stderr, "  -r : runs of FitRows, the best one is reported (%d)\n", DEFAULT_REPEATS);
+    fprintf(stderr, "  -t : seconds the old placement may take per level (%.0f)\n", DEFAULT_BUDGET);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> used = std::chrono::steady_clock::now() - start;
+    return used.count();
+}
+
+/*
+ * Predecessor rows as AssignDeviceLogicalRow() sorts them. spread : no
+ * collision. buses : 64 devices on each predecessor row, 16 gaps apart.
+ * clustered : seeded uniform rows, 16 devices per gap. one net : every
+ * device has the same predecessor row.
+ */
+static QVector<int> Wanted(Workload workload, int devices, int gap)
+{
+    QVector<int> wanted(devices, 0);
+    std::mt19937 random(12345);
+    std::uniform_int_distribution<int> row(0, qMax(devices / 16 * gap, 1));
+    for (int i = 0; i < devices; ++ i) {
+        switch (workload) {
+            case Spread:    wanted[i] = 2 * i * gap;          break;
+            case Buses:     wanted[i] = (i / 64) * 16 * gap;  break;
+            case Clustered: wanted[i] = row(random);          break;
+            case OneNet:    wanted[i] = 0;                    break;
+        }
+    }
+    std::sort(wanted.begin(), wanted.end());
+    return wanted;
+}
+
+/* Level::RowsFlexibleShiftUpBy of 2020.09.12, steps counts the rows walked */
+static void RowsFlexibleShiftUpBy(QVector<int> &rows, int n, qint64 *steps)
+{
+    if (rows.size() == 0)
+        return;
+
+    int curr = 0, prev = 0;
+
+    for (int i = rows.size() - 1; i > 0; -- i) {
+        (*steps)++;
+        curr = rows.at(i);
+        prev = rows.at(i - 1);
+        if (curr - prev >= (n + 1)) {
+            rows[i] -= n;
+            return;
+        }
+        rows[i] -= n;
+    }
+
+    rows[0] -= n;
+}
+
+/* steps 3 and 4 of Level::AssignDeviceLogicalRow of 2020.09.12, stopped past budget */
+static void ShiftRows(const QVector<int> &wanted, int gap, double budget, QVector<int> &rows)
+{
+    auto start = std::chrono::steady_clock::now();
+    qint64 steps = 0, nextClock = CLOCK_STEPS;
+
+    rows.clear();
+    rows.push_back(wanted.front());
+
+    int row = 0, currMaxRow = 0;
+    for (int i = 1; i < wanted.size(); ++ i) {
+        if (steps >= nextClock) {
+            nextClock = steps + CLOCK_STEPS;
+            if (Seconds(start) > budget)
+                return;
+        }
+        row = wanted.at(i);
+        currMaxRow = rows.back();
+
+        if (row < currMaxRow) {
+            RowsFlexibleShiftUpBy(rows, (currMaxRow - row) / 2, &steps);
+            row = rows.back() + gap;
+            currMaxRow = row;
+            rows.push_back(currMaxRow);
+            continue;
+        }
+
+        if (row > currMaxRow) {
+            currMaxRow = row;
+            rows.push_back(currMaxRow);
+            continue;
+        }
+
+        RowsFlexibleShiftUpBy(rows, gap, &steps);
+        row = currMaxRow + gap;
+        currMaxRow = row;
+        rows.push_back(currMaxRow);
+    }
+}
+
+static void Measure(const QVector<int> &wanted, const QVector<int> &rows, int gap, Quality *quality)
+{
+    double squares = 0;
+    qint64 shift = 0;
+    quality->maxShift = 0;
+    quality->gapMisses = 0;
+    quality->placed = rows.size();
+    for (int i = 0; i < rows.size(); ++ i) {
+        shift = qAbs((qint64)rows.at(i) - wanted.at(i));
+        squares += double(shift) * shift;
+        quality->maxShift = qMax(quality->maxShift, shift);
+        if (i > 0 AND rows.at(i) - rows.at(i - 1) < gap)
+            quality->gapMisses++;
+    }
+    quality->rms = rows.isEmpty() ? 0 : std::sqrt(squares / rows.size());
+}
+
+static void Print(const char *name, Workload workload, int devices, const Quality &quality)
+{
+    if (quality.placed < devices) {
+        printf("%-9s %8d %-10s : stopped after %7.3f s at %d devices\n", WORKLOAD_NAMES[workload],
+               devices, name, quality.seconds, quality.placed);
+        return;
+    }
+    printf("%-9s %8d %-10s : %7.3f s, rms shift %10.1f, max shift %8lld, %lld gap misses\n",
+           WORKLOAD_NAMES[workload], devices, name, quality.seconds, quality.rms,
+           (long long)quality.maxShift, (long long)quality.gapMisses);
+}
+
+static void Bench(Workload workload, int devices, int gap, int repeats, double budget)
+{
+    QVector<int> wanted = Wanted(workload, devices, gap);
+    QVector<int> rows;
+    Quality quality;
+
+    double best = -1;
+    for (int i = 0; i < repeats; ++ i) {
+        auto start = std::chrono::steady_clock::now();
+        Level::FitRows(wanted, gap, rows);
+        double seconds = Seconds(start);
+        best = (best < 0) ? seconds : qMin(best, seconds);
+    }
+    Measure(wanted, rows, gap, &quality);
+    quality.seconds = best;
+    Print("fit rows", workload, devices, quality);
+
+    auto start = std::chrono::steady_clock::now();
+    ShiftRows(wanted, gap, budget, rows);
+    quality.seconds = Seconds(start);
+    double seconds = quality.seconds;
+    Measure(wanted, rows, gap, &quality);
+    quality.seconds = seconds;
+    Print("shift rows", workload, devices, quality);
+}
+
+int main(int argc, char *argv[])
+{
+    std::vector<int> sizes(std::begin(DEFAULT_SIZES), std::end(DEFAULT_SIZES));
+    int gap = DFT_MAX_DEVICE_ROW_GAP;
+    int repeats = DEFAULT_REPEATS;
+    double budget = DEFAULT_BUDGET;
+
+    for (int i = 1; i < argc; ++ i) {
+        if (i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        const char *arg = argv[i];
+        const char *value = argv[++ i];
+        if (strcmp(arg, "-n") == 0) {
+            sizes.assign(1, qMax(atoi(value), 1));
+        } else if (strcmp(arg, "-g") == 0) {
+            gap = qMax(atoi(value), 1);
+        } else if (strcmp(arg, "-r") == 0) {
+            repeats = qMax(atoi(value), 1);
+        } else if (strcmp(arg, "-t") == 0) {
+            budget = atof(value);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    for (Workload workload : { Spread, Buses, Clustered, OneNet }) {
+        for (int devices : sizes)
+            Bench(workload, devices, gap, repeats, budget);
+        printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,376 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : matrixbench, the incidence matrix as the linked lists ASG
+ *           : built before (a heap element per device pair, inserted in
+ *           : order) against the CSR Matrix built in bulk, the time to
+ *           : build each and a queue BFS over it, and the LevelBFS that
+ *           : walks the nets of the CompactGraph with no matrix at all.
+ *           : The netlist is the argument, or netlistgen ladderrc and
+ *           : meshr ones written to the temp dir.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include "Parser/MmapScanner.h"
+#include "Circuit/CircuitGraph.h"
+#include "Circuit/CompactGraph.h"
+#include "Circuit/DeviceTraits.h"
+#include "Matrix.h"
+#include "LevelBFS.h"
+#include "NetlistGen.h"
+
+typedef std::vector<std::vector<int>> Levels;
+
+static const int DEFAULT_REPEATS = 3;
+static const long long DEFAULT_DEVICES = 1000000;
+/* the matrices are not built past this many pairs, the list one takes 56 bytes a pair */
+static const long long MAX_MATRIX_PAIRS = 1LL << 24;
+
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage : %s [-i netlist | -g family] [-n devices] [-r repeats]\n", program);
+    fprintf(stderr, "  -i : netlist to read\n");
+    fprintf(stderr, "  -g : netlistgen family to generate (ladderrc and meshr)\n");
+    fprintf(stderr, "  -n : devices of the generated netlist (%lld)\n", DEFAULT_DEVICES);
+    fprintf(stderr, "  -r : runs per structure, the best one is reported (%d)\n", DEFAULT_REPEATS);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> used = std::chrono::steady_clock::now() - start;
+    return used.count();
+}
+
+/* the Matrix of 2020.09.12, sorted row and column lists of heap elements */
+struct ListElement
+{
+    int          row;
+    int          col;
+    Device      *fromDevice;
+    Terminal    *fromTerminal;
+    Device      *toDevice;
+    Terminal    *toTerminal;
+    ListElement *nextInRow;
+    ListElement *nextInCol;
+};
+
+struct ListHead
+{
+    ListElement *head;
+    int          seqElementNum;
+    Device      *device;
+};
+
+class ListMatrix
+{
+public:
+    explicit ListMatrix(int size) : m_rowHead(size, ListHead()), m_colHead(size, ListHead()), m_total(0) {}
+    ~ListMatrix()
+    {
+        ListElement *front = nullptr, *rear = nullptr;
+        for (const ListHead &row : m_rowHead) {
+            for (front = row.head; front; front = rear) {
+                rear = front->nextInRow;
+                delete front;
+            }
+        }
+    }
+
+    /* a walk of the row for a duplicate, then of the row and the column to insert */
+    void InsertElement(int row, int col, Device *fromDevice, Terminal *fromTerminal,
+                       Device *toDevice, Terminal *toTerminal)
+    {
+        for (ListElement *e = m_rowHead[row].head; e; e = e->nextInRow) {
+            if (e->col == col)
+                return;
+        }
+
+        ListElement *element = new ListElement { row, col, fromDevice, fromTerminal,
+                                                 toDevice, toTerminal, nullptr, nullptr };
+        ListElement **rowPtr = &m_rowHead[row].head;
+        while (*rowPtr AND (*rowPtr)->col < col)
+            rowPtr = &(*rowPtr)->nextInRow;
+        element->nextInRow = *rowPtr;
+        *rowPtr = element;
+        m_rowHead[row].seqElementNum++;
+
+        ListElement **colPtr = &m_colHead[col].head;
+        while (*colPtr AND (*colPtr)->row < row)
+            colPtr = &(*colPtr)->nextInCol;
+        element->nextInCol = *colPtr;
+        *colPtr = element;
+        m_colHead[col].seqElementNum++;
+        m_total++;
+    }
+
+    const ListElement* RowHead(int row) const { return m_rowHead[row].head; }
+    qint64 TotalElement() const { return m_total; }
+    qint64 MemoryBytes() const
+    { return m_total * sizeof(ListElement) + 2 * m_rowHead.size() * sizeof(ListHead); }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(ListMatrix);
+
+    std::vector<ListHead>  m_rowHead;
+    std::vector<ListHead>  m_colHead;
+    qint64                 m_total;
+};
+
+/* both directions of a pair, ground excluded, duplicates included */
+static qint64 PairCount(const CompactGraph *graph)
+{
+    qint64 pairs = 0, degree = 0;
+    for (int node = CompactGraph::GND_NODE + 1; node < graph->NodeCount(); ++ node) {
+        degree = graph->NodeDegree(node);
+        pairs += degree * (degree - 1);
+    }
+    return pairs;
+}
+
+/* what ASG inserted: both directions of every pair on a non-ground net */
+template <typename Insert>
+static void ForEachPair(const CompactGraph *graph, Insert insert)
+{
+    quint32 node = 0, toTer = 0, toDev = 0;
+    for (int dev = 0; dev < graph->DeviceCount(); ++ dev) {
+        if (NOT Traits(graph->Type(dev)).expandsNets) continue;
+        for (quint32 ter = graph->TerminalBegin(dev); ter < graph->TerminalEnd(dev); ++ ter) {
+            node = graph->TerminalNode(ter);
+            if (node == CompactGraph::GND_NODE) continue;
+            for (quint32 i = graph->NodeBegin(node); i < graph->NodeEnd(node); ++ i) {
+                toTer = graph->NodeTerminal(i);
+                toDev = graph->TerminalDevice(toTer);
+                if (toDev != (quint32)dev)
+                    insert(dev, ter, toDev, toTer);
+            }
+        }
+    }
+}
+
+/* the BFS of CalLogicalCol over matrix rows, Row(dev, visit) calls visit per column */
+template <typename Row>
+static void QueueBFS(int size, const std::vector<int> &sources, Row row, Levels *levels)
+{
+    std::vector<quint8> visited(size, 0);
+    std::vector<int> frontier = sources, next;
+    for (int dev : sources)
+        visited[dev] = 1;
+
+    levels->clear();
+    while (NOT frontier.empty()) {
+        next.clear();
+        for (int dev : frontier) {
+            row(dev, [&](int col) {
+                if (visited[col]) return;
+                visited[col] = 1;
+                next.push_back(col);
+            });
+        }
+        if (NOT next.empty())
+            levels->push_back(next);
+        frontier.swap(next);
+    }
+}
+
+struct Timing
+{
+    double build;
+    double bfs;
+    qint64 bytes;
+};
+
+static void Best(const Timing &run, Timing *best)
+{
+    if (best->build < 0 || run.build < best->build) best->build = run.build;
+    if (best->bfs < 0 || run.bfs < best->bfs)       best->bfs = run.bfs;
+    best->bytes = run.bytes;
+}
+
+static Timing BenchList(const CompactGraph *graph, const std::vector<int> &sources, Levels *levels)
+{
+    Timing timing;
+    auto start = std::chrono::steady_clock::now();
+    ListMatrix matrix(graph->DeviceCount());
+    ForEachPair(graph, [&](int dev, quint32 ter, quint32 toDev, quint32 toTer) {
+        matrix.InsertElement(dev, toDev, graph->GetDevice(dev), graph->GetTerminal(ter),
+                             graph->GetDevice(toDev), graph->GetTerminal(toTer));
+    });
+    timing.build = Seconds(start);
+    timing.bytes = matrix.MemoryBytes();
+
+    start = std::chrono::steady_clock::now();
+    QueueBFS(graph->DeviceCount(), sources, [&](int dev, auto visit) {
+        for (const ListElement *e = matrix.RowHead(dev); e; e = e->nextInRow)
+            visit(e->col);
+    }, levels);
+    timing.bfs = Seconds(start);
+    return timing;
+}
+
+static Timing BenchCSR(const CompactGraph *graph, const std::vector<int> &sources, Levels *levels)
+{
+    Timing timing;
+    auto start = std::chrono::steady_clock::now();
+    Matrix matrix(graph->DeviceCount());
+    matrix.Reserve(PairCount(graph));
+    ForEachPair(graph, [&](int dev, quint32, quint32 toDev, quint32) {
+        matrix.InsertElement(dev, toDev);
+    });
+    matrix.Compress();
+    timing.build = Seconds(start);
+    timing.bytes = matrix.MemoryBytes();
+
+    start = std::chrono::steady_clock::now();
+    QueueBFS(graph->DeviceCount(), sources, [&](int dev, auto visit) {
+        for (qint64 i = matrix.RowBegin(dev); i < matrix.RowEnd(dev); ++ i)
+            visit(matrix.Col(i));
+    }, levels);
+    timing.bfs = Seconds(start);
+    return timing;
+}
+
+static Timing BenchNets(const CompactGraph *graph, const std::vector<int> &sources, int threads,
+                        Levels *levels)
+{
+    Timing timing;
+    timing.build = 0;
+    timing.bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    LevelBFS bfs(graph);
+    bfs.SetThreadCount(threads);
+    bfs.Run(sources, levels);
+    timing.bfs = Seconds(start);
+    return timing;
+}
+
+static int Bench(const std::string &netlist, int repeats)
+{
+    CircuitGraph ckt;
+    MmapScanner scanner;
+    if (scanner.ParseNetlist(netlist, &ckt) || ckt.Flatten()) {
+        fprintf(stderr, "Parse %s failed.\n", netlist.c_str());
+        return ERROR;
+    }
+    const CompactGraph *graph = ckt.Freeze();
+
+    std::vector<quint32> peripheral;
+    graph->PeripheralDevices(&peripheral);
+    std::vector<int> sources(peripheral.begin(), peripheral.end());
+
+    qint64 pairs = PairCount(graph);
+    printf("circuit     : %d devices, %d nodes, %d terminals, %lld pairs at most\n",
+           graph->DeviceCount(), graph->NodeCount(), graph->TerminalCount(), (long long)pairs);
+
+    int threads = QThread::idealThreadCount();
+    struct { const char *name; int which; int threads; } runs[] = {
+        { "list matrix", 0, 1 },
+        { "csr matrix",  1, 1 },
+        { "nets 1",      2, 1 },
+        { "nets all",    2, threads },
+    };
+
+    Levels expected, levels;
+    bool first = true;
+    int error = OKAY;
+    for (const auto &run : runs) {
+        if (run.which < 2 AND pairs > MAX_MATRIX_PAIRS) {
+            printf("%-11s : skipped, more than %lld pairs\n", run.name, MAX_MATRIX_PAIRS);
+            continue;
+        }
+        Timing best = { -1, -1, 0 }, timing;
+        for (int i = 0; i < repeats; ++ i) {
+            if (run.which == 0)
+                timing = BenchList(graph, sources, &levels);
+            else if (run.which == 1)
+                timing = BenchCSR(graph, sources, &levels);
+            else
+                timing = BenchNets(graph, sources, run.threads, &levels);
+            Best(timing, &best);
+        }
+        if (first)
+            expected = levels;
+        else if (levels != expected)
+            error = ERROR;
+        first = false;
+
+        printf("%-11s : build %8.3f s, bfs %8.3f s, %8.1f MB, %zu levels%s\n", run.name,
+               best.build, best.bfs, best.bytes / 1048576.0, levels.size(),
+               levels == expected ? "" : ", NOT THE SAME LEVELS");
+    }
+    printf("compact     : %.1f MB, shared by every ASG pass\n", graph->MemoryBytes() / 1048576.0);
+    return error;
+}
+
+static int Generate(NetlistGen::Family family, long long devices, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return ERROR;
+    NetlistGen gen;
+    gen.SetDevices(devices);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    if (NOT error)
+        printf("netlist     : %s, %lld devices\n", NetlistGen::FamilyName(family), gen.DeviceCount());
+    return error ? ERROR : OKAY;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string netlist;
+    std::vector<NetlistGen::Family> families = { NetlistGen::LadderRC, NetlistGen::MeshR };
+    NetlistGen::Family family = NetlistGen::LadderRC;
+    long long devices = DEFAULT_DEVICES;
+    int repeats = DEFAULT_REPEATS;
+
+    for (int i = 1; i < argc; ++ i) {
+        if (i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        const char *arg = argv[i];
+        const char *value = argv[++ i];
+        if (strcmp(arg, "-i") == 0) {
+            netlist = value;
+        } else if (strcmp(arg, "-g") == 0) {
+            if (NOT NetlistGen::FamilyByName(value, &family)) {
+                fprintf(stderr, "Unknown family %s\n", value);
+                return 1;
+            }
+            families.assign(1, family);
+        } else if (strcmp(arg, "-n") == 0) {
+            devices = atoll(value);
+        } else if (strcmp(arg, "-r") == 0) {
+            repeats = qMax(atoi(value), 1);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (NOT netlist.empty())
+        return Bench(netlist, repeats) ? 1 : 0;
+
+    int error = OKAY;
+    netlist = QDir::temp().filePath("matrixbench.sp").toStdString();
+    for (NetlistGen::Family gen : families) {
+        if (Generate(gen, devices, netlist)) {
+            fprintf(stderr, "Generate %s failed.\n", netlist.c_str());
+            return 1;
+        }
+        error |= Bench(netlist, repeats);
+        printf("\n");
+    }
+    QFile::remove(QString::fromStdString(netlist));
+    return error ? 1 : 0;
+}
@@ -0,0 +1,209 @@
+#include "Matrix.h"
+#include <QDebug>
+#include <algorithm>
+#include "Circuit/Device.h"
+#include "Utilities/MyString.h"
+#include "TablePlotter.h"
+
+
+Matrix::Matrix(int size)
+{
+    m_size = size;
+    m_compressed = false;
+    m_rowsInOrder = true;
+
+    m_rowDevice.assign(size, nullptr);
+    m_colDevice.assign(size, nullptr);
+    m_rowOffset.assign(size + 1, 0);
+
+    m_plotter = nullptr;
+}
+
+Matrix::~Matrix()
+{
+    if (m_plotter)  delete m_plotter;
+}
+
+/* elements to be inserted, duplicates included */
+void Matrix::Reserve(qint64 elements)
+{
+    m_row.reserve(elements);
+    m_col.reserve(elements);
+}
+
+/* recorded only, duplicates are dropped by Compress() */
+void Matrix::InsertElement(int row, int col)
+{
+    if ((row >= m_size) || (col >= m_size) || (row < 0) || (col < 0)) {
+#ifdef TRACE
+        qInfo() << LINE_INFO << endl;
+#endif
+        qDebug() << QObject::tr("[ERROR] : Matrix out of bound.") << endl;
+        return;
+    }
+
+    Q_ASSERT(NOT m_compressed);
+    if (m_row.size() > 0 && row < m_row.back())
+        m_rowsInOrder = false;
+    m_row.push_back(row);
+    m_col.push_back(col);
+    m_rowOffset[row + 1]++;
+}
+
+void Matrix::Compress()
+{
+    if (m_compressed)
+        return;
+
+    for (int row = 0; row < m_size; ++ row)
+        m_rowOffset[row + 1] += m_rowOffset[row];
+
+    /* counting sort by row, unless rows came in order */
+    if (NOT m_rowsInOrder) {
+        std::vector<qint64> next(m_rowOffset.begin(), m_rowOffset.end() - 1);
+        std::vector<int> cols(m_col.size());
+        for (size_t i = 0; i < m_col.size(); ++ i)
+            cols[next[m_row[i]]++] = m_col[i];
+        m_col.swap(cols);
+    }
+    std::vector<int>().swap(m_row);
+
+    /* sort a row by column and drop duplicates, in place */
+    qint64 begin = 0, end = 0, out = 0;
+    for (int row = 0; row < m_size; ++ row) {
+        end = m_rowOffset[row + 1];
+        if (end - begin > 16) {
+            std::sort(m_col.begin() + begin, m_col.begin() + end);
+        } else {
+            /* rows are short */
+            for (qint64 i = begin + 1; i < end; ++ i) {
+                int col = m_col[i];
+                qint64 j = i;
+                for (; j > begin && col < m_col[j - 1]; -- j)
+                    m_col[j] = m_col[j - 1];
+                m_col[j] = col;
+            }
+        }
+
+        m_rowOffset[row] = out;
+        for (qint64 i = begin; i < end; ++ i) {
+            if (i > begin && m_col[i] == m_col[i - 1])
+                continue;
+            m_col[out++] = m_col[i];
+        }
+        begin = end;
+    }
+    m_rowOffset[m_size] = out;
+    m_col.resize(out);
+    m_col.shrink_to_fit();
+
+    m_compressed = true;
+}
+
+void Matrix::SetRowHeadDevice(int row, Device *device)
+{
+    assert(row >= 0 && row < m_size);
+    m_rowDevice[row] = device;
+}
+
+void Matrix::SetColHeadDevice(int col, Device *device)
+{
+    assert(col >= 0 && col < m_size);
+    m_colDevice[col] = device;
+}
+
+qint64 Matrix::MemoryBytes() const
+{
+    return sizeof(*this)
+           + m_rowDevice.capacity() * sizeof(Device*)
+           + m_colDevice.capacity() * sizeof(Device*)
+           + m_row.capacity() * sizeof(int)
+           + m_rowOffset.capacity() * sizeof(qint64)
+           + m_col.capacity() * sizeof(int);
+}
+
+void Matrix::Print() const
+{
+    printf("---------------- Incidence Matrix ---------------\n");
+    /* Print Row Head String */
+    printf("%-8s", " ");
+
+    Device *device = nullptr;
+    for (int i = 0; i < m_size; ++ i) {
+        device = m_colDevice[i];
+        assert(device->Id() == i);
+        printf("%-8s", CString(device->Name()));
+    }
+    printf("\n");
+
+    int printCounter = -1;
+    int id = 0;
+    for (int i = 0; i < m_size; ++ i) {
+        device = m_rowDevice[i];
+        assert(device->Id() == i);
+        printf("%-8s", CString(device->Name()));
+
+        printCounter = -1;
+        for (qint64 e = RowBegin(i); e < RowEnd(i); ++ e) {
+            id = m_col[e];
+            PrintNEmptyElement(id - printCounter - 1);
+            printf("%-8s", "1");
+            printCounter = id;
+        }
+        PrintNEmptyElement(m_size - printCounter - 1);
+        printf("\n");
+    }
+
+    printf("-------------------------------------------------\n\n");
+}
+
+void Matrix::PrintNEmptyElement(int n) const
+{
+    if (n <= 0)  return;
+    for (int i = 0; i < n; ++ i) {
+        printf("%-8s", "0");
+    }
+}
+
+void Matrix::Plot()
+{
+    if (m_plotter) {
+        m_plotter->close();
+        m_plotter->Clear();
+    } else {
+        m_plotter = new TablePlotter;
+    }
+
+    m_plotter->SetTableRowColCount(m_size, m_size);
+
+    QStringList headerText;
+    Device *device = nullptr;
+
+    /* row header text */
+    for (int i = 0; i < m_size; ++ i) {
+        device = m_rowDevice[i];
+        Q_ASSERT(device);
+        headerText << device->Name();
+    }
+    m_plotter->SetRowHeaderText(headerText);
+
+    headerText.clear();
+    /* col header text */
+    for (int i = 0; i < m_size; ++ i) {
+        device = m_colDevice[i];
+        Q_ASSERT(device);
+        headerText << device->Name();
+    }
+    m_plotter->SetColHeaderText(headerText);
+
+    /* table content */
+    for (int row = 0; row < m_size; ++ row) {
+        for (qint64 e = RowBegin(row); e < RowEnd(row); ++ e)
+            m_plotter->AddItem(row, m_col[e]);
+    }
+
+    /* window title */
+    m_plotter->setWindowTitle(QObject::tr("Incidence Matrix"));
+
+    m_plotter->Display();
+}
@@ -0,0 +1,77 @@
+#ifndef NETLIST_ASG_MATRIX_H
+#define NETLIST_ASG_MATRIX_H
+
+/*
+ * @filename : Matrix.h
+ * @author   : Hao Limin
+ * @date     : 2020.07.30
+ * @desp     : Incidence Matrix. Square. Sparse, CSR built in bulk.
+ *           : InsertElement() only records (row, col), Compress() sorts
+ *           : rows by column and drops duplicates, then a row is a range
+ *           : of the column array. Rows inserted in order skip the row
+ *           : sort. Callers insert both directions of a pair, so a
+ *           : column is read as its row and no CSC is kept. Element
+ *           : offsets are 64 bits, a net of k terminals gives k*(k-1)
+ *           : elements. The ASG walks nets (LevelBFS) and builds none,
+ *           : it is kept here as the baseline of matrixbench only.
+ * @modified : Hao Limin, 2020.09.12
+ */
+
+#include <vector>
+#include <QtGlobal>
+#include "Define/Define.h"
+
+class Device;
+class TablePlotter;
+
+class Matrix
+{
+public:
+    explicit Matrix(int size);
+    ~Matrix();
+
+public:
+    int    Size() const { return m_size; }
+    qint64 TotalElement() const { return m_col.size(); }
+
+    void   SetRowHeadDevice(int row, Device *device);
+    void   SetColHeadDevice(int col, Device *device);
+    Device* RowHeadDevice(int row) const { return m_rowDevice[row]; }
+    Device* ColHeadDevice(int col) const { return m_colDevice[col]; }
+
+    void   Reserve(qint64 elements);
+    void   InsertElement(int row, int col);
+    void   Compress();
+    bool   Compressed() const { return m_compressed; }
+
+    /* after Compress(), elements of row are [RowBegin, RowEnd), by column */
+    qint64 RowBegin(int row) const { return m_rowOffset[row]; }
+    qint64 RowEnd(int row) const   { return m_rowOffset[row + 1]; }
+    int    RowCount(int row) const { return m_rowOffset[row + 1] - m_rowOffset[row]; }
+    int    Col(qint64 i) const     { return m_col[i]; }
+
+    qint64 MemoryBytes() const;
+
+    void   Print() const;
+    void   Plot();
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(Matrix);
+
+    void PrintNEmptyElement(int n) const;
+
+    int    m_size;
+    bool   m_compressed;
+    bool   m_rowsInOrder;
+
+    std::vector<Device*>    m_rowDevice;
+    std::vector<Device*>    m_colDevice;
+    std::vector<int>        m_row;          // of m_col, until Compress()
+    std::vector<qint64>     m_rowOffset;    // Size() + 1
+    std::vector<int>        m_col;
+
+    TablePlotter *m_plotter;
+};
+
+
+#endif // NETLIST_ASG_MATRIX_H
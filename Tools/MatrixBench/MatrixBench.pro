@@ -0,0 +1,32 @@
+#####################
+# matrixbench, incidence matrix builds and the level BFS on big circuits
+#####################
+
+TEMPLATE = app
+TARGET = matrixbench
+
+QMAKE_CXXFLAGS += -std=c++17
+
+# Matrix::Plot() links TablePlotter, nothing is shown
+QT += widgets
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+INCLUDEPATH += ../NetlistGen
+
+HEADERS += ./Matrix.h\
+           $$SRC/ASG/TablePlotter.h\
+           $$SRC/ASG/LevelBFS.h\
+           ../NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ./Matrix.cpp\
+           $$SRC/ASG/TablePlotter.cpp\
+           $$SRC/ASG/LevelBFS.cpp\
+           ../NetlistGen/NetlistGen.cpp
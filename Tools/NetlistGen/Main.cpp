@@ -0,0 +1,89 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : netlistgen, writes a synthetic netlist to a file or stdout.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "NetlistGen.h"
+
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage : %s <family> [-s scale | -n devices] [-f fanout] [-seed N] [-o file]\n",
+            program);
+    fprintf(stderr, "  family : ");
+    for (int i = 0; i < NetlistGen::FamilyCount; ++ i)
+        fprintf(stderr, "%s ", NetlistGen::FamilyName(static_cast<NetlistGen::Family>(i)));
+    fprintf(stderr, "\n");
+    fprintf(stderr, "  -s     : stages (ladder, coupled), grid side (mesh), levels (trees)\n");
+    fprintf(stderr, "  -n     : about this many devices, 10 .. 10^7\n");
+    fprintf(stderr, "  -f     : tree fanout, the largest one for rand trees (2)\n");
+    fprintf(stderr, "  -seed  : seed of rand trees (1)\n");
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    NetlistGen::Family family;
+    if (NOT NetlistGen::FamilyByName(argv[1], &family)) {
+        fprintf(stderr, "Unknown family %s\n", argv[1]);
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    NetlistGen gen;
+    const char *output = nullptr;
+    for (int i = 2; i < argc; ++ i) {
+        if (i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        const char *arg = argv[i];
+        const char *value = argv[++ i];
+        if (strcmp(arg, "-s") == 0) {
+            gen.SetScale(atoll(value));
+        } else if (strcmp(arg, "-n") == 0) {
+            gen.SetDevices(atoll(value));
+        } else if (strcmp(arg, "-f") == 0) {
+            gen.SetFanout(atoi(value));
+        } else if (strcmp(arg, "-seed") == 0) {
+            gen.SetSeed(strtoull(value, nullptr, 10));
+        } else if (strcmp(arg, "-o") == 0) {
+            output = value;
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    FILE *fp = output ? fopen(output, "w") : stdout;
+    if (NOT fp) {
+        fprintf(stderr, "Open %s failed.\n", output);
+        return 1;
+    }
+    static char buffer[1 << 20];
+    setvbuf(fp, buffer, _IOFBF, sizeof(buffer));
+
+    int error = gen.Generate(family, fp);
+    if (output)
+        error |= (fclose(fp) != 0);
+    else
+        error |= (fflush(fp) != 0);
+
+    if (error) {
+        fprintf(stderr, "Generate %s failed.\n", NetlistGen::FamilyName(family));
+        return 1;
+    }
+
+    fprintf(stderr, "%s : %lld devices\n", NetlistGen::FamilyName(family), gen.DeviceCount());
+    return 0;
+}
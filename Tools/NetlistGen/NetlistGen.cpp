@@ -0,0 +1,252 @@
+#include "NetlistGen.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+/* the values used by the bundled netlists */
+static const char *R_VALUE = "100";
+static const char *C_VALUE = "1p";
+static const char *L_VALUE = "1m";
+
+/* bundled trees have 5 levels below the root, fanout 2 or 3 */
+static const int DFT_TREE_LEVELS = 5;
+static const int DFT_TREE_FANOUT = 2;
+
+struct FamilyInfo
+{
+    const char *name;   // command line name, lower case
+    const char *type;   // "circuit type" of the header comment
+};
+
+static const FamilyInfo FAMILIES[NetlistGen::FamilyCount] = {
+    { "ladderrc",        "ladderrc" },
+    { "ladderrlc",       "ladderrlc" },
+    { "meshr",           "Mesh R" },
+    { "clocktreer",      "Clock R tree" },
+    { "clocktreerc",     "Clock RC tree" },
+    { "clocktreerrand",  "Clock R tree (random fanout)" },
+    { "clocktreercrand", "Clock RC tree (random fanout)" },
+    { "coupledtreerc",   "Coupled RC tree" },
+};
+
+
+NetlistGen::NetlistGen()
+{
+    m_fp = nullptr;
+    m_scale = 0;
+    m_devices = 0;
+    m_fanout = DFT_TREE_FANOUT;
+    m_seed = 1;
+    m_deviceCount = 0;
+}
+
+NetlistGen::~NetlistGen()
+{
+}
+
+bool NetlistGen::FamilyByName(const std::string &name, Family *family)
+{
+    for (int i = 0; i < FamilyCount; ++ i) {
+        if (name == FAMILIES[i].name) {
+            *family = static_cast<Family>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* NetlistGen::FamilyName(Family family)
+{
+    return FAMILIES[family].name;
+}
+
+int NetlistGen::Generate(Family family, FILE *fp)
+{
+    assert(fp);
+    if (m_fanout < 1)
+        return ERROR;
+
+    m_fp = fp;
+    m_deviceCount = 0;
+    m_rand.seed(m_seed);
+
+    switch (family) {
+        case LadderRC:        GenLadder(false);      break;
+        case LadderRLC:       GenLadder(true);       break;
+        case MeshR:           GenMesh();             break;
+        case ClockTreeR:      GenTree(false, false); break;
+        case ClockTreeRC:     GenTree(true, false);  break;
+        case ClockTreeRRand:  GenTree(false, true);  break;
+        case ClockTreeRCRand: GenTree(true, true);   break;
+        case CoupledTreeRC:   GenCoupledTree();      break;
+        default:
+            return ERROR;
+    }
+
+    return ferror(m_fp) ? ERROR : OKAY;
+}
+
+/* VIN, then R/C (or R/L/C) stages to ground */
+void NetlistGen::GenLadder(bool withL)
+{
+    long long stages = m_scale;
+    if (m_devices > 0)
+        stages = withL ? (m_devices - 2) / 3 : (m_devices - 1) / 2;
+    stages = std::max(stages, 1LL);
+
+    Header(withL ? FAMILIES[LadderRLC].type : FAMILIES[LadderRC].type, stages);
+    fprintf(m_fp, "VIN 1 0 1\n");
+    m_deviceCount++;
+
+    long long node = 1;
+    if (withL) {
+        Device('C', 0, 1, 0, C_VALUE);
+        for (long long i = 1; i <= stages; ++ i) {
+            Device('R', i, node, node + 1, R_VALUE);
+            Device('L', i, node + 1, node + 2, L_VALUE);
+            Device('C', i, node + 2, 0, C_VALUE);
+            node += 2;
+        }
+    } else {
+        for (long long i = 1; i <= stages; ++ i) {
+            Device('R', i, node, node + 1, R_VALUE);
+            Device('C', i, node + 1, 0, C_VALUE);
+            node += 1;
+        }
+    }
+
+    char print[32];
+    snprintf(print, sizeof(print), "V(%lld)", node);
+    Footer(print);
+}
+
+/* (side+1)^2 grid, row by row : horizontal R, then R down to the next row */
+void NetlistGen::GenMesh()
+{
+    long long side = m_scale;
+    if (m_devices > 0) {
+        /* devices = 2 * side * (side + 1) + 2 */
+        double half = std::max(m_devices - 2, 4LL) / 2.0;
+        side = (long long)((std::sqrt(1.0 + 4.0 * half) - 1.0) / 2.0);
+    }
+    side = std::max(side, 1LL);
+
+    Header(FAMILIES[MeshR].type, side);
+    fprintf(m_fp, "VIN 1 0 1\n");
+    m_deviceCount++;
+
+    long long width = side + 1;
+    long long id = 1;
+    for (long long row = 0; row < width; ++ row) {
+        long long first = row * width + 1;
+        for (long long col = 0; col < side; ++ col)
+            Device('R', id++, first + col, first + col + 1, R_VALUE);
+        if (row == side)
+            break;
+        for (long long col = 0; col < width; ++ col)
+            Device('R', id++, first + col, first + col + width, R_VALUE);
+    }
+
+    long long corner = side * width + 1;
+    Device('R', id, corner, 0, R_VALUE);
+
+    char print[32];
+    snprintf(print, sizeof(print), "V(%lld)", corner);
+    Footer(print);
+}
+
+/*
+ * Breadth first, tree node t is netlist node t + 2 and is driven by R<t>
+ * (and loaded by C<t>), node 1 is VIN. Children are numbered as they are
+ * created, so nothing but the level boundary is remembered.
+ */
+void NetlistGen::GenTree(bool withC, bool random)
+{
+    Family family = withC ? (random ? ClockTreeRCRand : ClockTreeRC)
+                          : (random ? ClockTreeRRand : ClockTreeR);
+
+    long long budget = LLONG_MAX;
+    long long levels = (m_scale > 0) ? m_scale : DFT_TREE_LEVELS;
+    if (m_devices > 0) {
+        budget = withC ? (m_devices - 1) / 2 : m_devices - 2;
+        budget = std::max(budget, 1LL);
+        levels = LLONG_MAX;
+    }
+
+    Header(FAMILIES[family].type, (m_devices > 0) ? budget : levels);
+    fprintf(m_fp, "VIN 1 0 1\n");
+    m_deviceCount++;
+
+    Device('R', 0, 1, 2, R_VALUE);
+    if (withC)
+        Device('C', 0, 2, 0, C_VALUE);
+
+    long long next = 1;
+    long long levelEnd = 0;
+    long long level = 0;
+    for (long long parent = 0; parent < next AND next < budget; ++ parent) {
+        if (parent > levelEnd) {
+            level++;
+            levelEnd = next - 1;
+        }
+        if (level >= levels)
+            break;
+
+        int fanout = random ? (int)(1 + m_rand() % m_fanout) : m_fanout;
+        for (int i = 0; i < fanout AND next < budget; ++ i, ++ next) {
+            Device('R', next, parent + 2, next + 2, R_VALUE);
+            if (withC)
+                Device('C', next, next + 2, 0, C_VALUE);
+        }
+    }
+
+    long long last = next + 1;
+    if (NOT withC)
+        Device('R', next, last, 0, R_VALUE);
+
+    char print[32];
+    snprintf(print, sizeof(print), "V(%lld)", last);
+    Footer(print);
+}
+
+/* two RC lines driven by VIN0/VIN1, a coupled C between them at each stage */
+void NetlistGen::GenCoupledTree()
+{
+    long long stages = m_scale;
+    if (m_devices > 0)
+        stages = (m_devices - 2) / 5;
+    stages = std::max(stages, 1LL);
+
+    Header(FAMILIES[CoupledTreeRC].type, stages);
+    fprintf(m_fp, "VIN0 10 0 0\nVIN1 11 0 1\n");
+    m_deviceCount += 2;
+
+    for (long long i = 1; i <= stages; ++ i) {
+        for (int line = 0; line < 2; ++ line) {
+            fprintf(m_fp, "R%lld%d %lld%d %lld%d %s\n", i, line, i, line, i + 1, line, R_VALUE);
+            fprintf(m_fp, "C%lld%d %lld%d 0 %s\n", i, line, i + 1, line, C_VALUE);
+        }
+        fprintf(m_fp, "C%lldC %lld0 %lld1 %s\n", i, i + 1, i + 1, C_VALUE);
+        m_deviceCount += 5;
+    }
+
+    fprintf(m_fp, "\n.FIRSTLEVEL VIN0 VIN1\n.OP\n.PRINT V(%lld0) V(%lld1)\n.END\n",
+            stages + 1, stages + 1);
+}
+
+void NetlistGen::Header(const char *type, long long scale)
+{
+    fprintf(m_fp, "*scale(%lld)\tcircuit type(%s)\n\n", scale, type);
+}
+
+void NetlistGen::Footer(const char *print)
+{
+    fprintf(m_fp, "\n.FIRSTLEVEL VIN\n.OP\n.PRINT %s\n.END\n", print);
+}
+
+void NetlistGen::Device(char kind, long long id, long long pos, long long neg, const char *value)
+{
+    fprintf(m_fp, "%c%lld %lld %lld %s\n", kind, id, pos, neg, value);
+    m_deviceCount++;
+}
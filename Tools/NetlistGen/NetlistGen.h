@@ -0,0 +1,69 @@
+#ifndef NETLISTVIZ_TOOLS_NETLISTGEN_H
+#define NETLISTVIZ_TOOLS_NETLISTGEN_H
+
+/*
+ * @filename : NetlistGen.h
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : Synthetic netlists of the Netlist/ families (Ladder, Mesh,
+ *           : ClockTree, ClockTreeRand, CoupledTree) at any size. Lines
+ *           : are written as they are generated, so 10^7 devices need no
+ *           : more memory than 10. Rand trees draw their fanout from a
+ *           : seeded mt19937_64, the same seed gives the same netlist.
+ *           : The sources are listed in a .FIRSTLEVEL card.
+ */
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include "Define/Define.h"
+
+class NetlistGen
+{
+public:
+    enum Family { LadderRC = 0, LadderRLC, MeshR, ClockTreeR, ClockTreeRC,
+                  ClockTreeRRand, ClockTreeRCRand, CoupledTreeRC, FamilyCount };
+
+    NetlistGen();
+    ~NetlistGen();
+
+    /* ladderrc, meshr, clocktreercrand, ..., false if unknown */
+    static bool        FamilyByName(const std::string &name, Family *family);
+    static const char* FamilyName(Family family);
+
+    /*
+     * scale : stages (ladder, coupled), grid side (mesh), levels (trees)
+     * devices : the scale is chosen to reach about this many devices,
+     *           trees stop at exactly this many
+     */
+    void SetScale(long long scale)     { m_scale = scale; }
+    void SetDevices(long long devices) { m_devices = devices; }
+    void SetFanout(int fanout)         { m_fanout = fanout; }
+    void SetSeed(unsigned long long seed) { m_seed = seed; }
+
+    int       Generate(Family family, FILE *fp);
+    long long DeviceCount() const { return m_deviceCount; }
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(NetlistGen);
+
+    void GenLadder(bool withL);
+    void GenMesh();
+    void GenTree(bool withC, bool random);
+    void GenCoupledTree();
+
+    void      Header(const char *type, long long scale);
+    void      Footer(const char *print);
+    void      Device(char kind, long long id, long long pos, long long neg, const char *value);
+
+    FILE               *m_fp;
+    long long           m_scale;
+    long long           m_devices;
+    int                 m_fanout;
+    unsigned long long  m_seed;
+    long long           m_deviceCount;
+    std::mt19937_64     m_rand;
+};
+
+#endif // NETLISTVIZ_TOOLS_NETLISTGEN_H
@@ -0,0 +1,21 @@
+#####################
+# netlistgen, synthetic netlists for profiling netlistviz
+#####################
+
+TEMPLATE = app
+TARGET = netlistgen
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= core gui
+CONFIG += console release
+CONFIG -= app_bundle qt
+
+OBJECTS_DIR = ./build
+
+INCLUDEPATH += ../../Src
+
+HEADERS += ./NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ./NetlistGen.cpp
@@ -0,0 +1,225 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : parsebench, parse throughput in MB/s of the flex scanner and
+ *           : of MmapScanner on one and on all threads, and the memory of
+ *           : the NamePool against one QString per name, and the reload
+ *           : of its NetlistCache snapshot with the md5 of the netlist that
+ *           : every reload computes. The netlist is the argument, or a
+ *           : netlistgen one written to the temp dir.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+#include "Parser/MyParser.h"
+#include "Parser/NetlistCache.h"
+#include "NetlistGen.h"
+
+static const int DEFAULT_REPEATS = 3;
+static const long long DEFAULT_DEVICES = 1000000;
+/* as NetlistCache, addData takes int length */
+static const qint64 HASH_PIECE_BYTES = 64LL << 20;
+
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage : %s [-i netlist | -g family] [-n devices] [-r repeats]\n", program);
+    fprintf(stderr, "  -i : netlist to parse\n");
+    fprintf(stderr, "  -g : netlistgen family to generate (ladderrc)\n");
+    fprintf(stderr, "  -n : devices of the generated netlist (%lld)\n", DEFAULT_DEVICES);
+    fprintf(stderr, "  -r : parses per scanner, the best one is reported (%d)\n", DEFAULT_REPEATS);
+}
+
+/* resident set size in bytes, from /proc/self/statm */
+static qint64 ResidentBytes()
+{
+    long long pages = 0, resident = 0;
+    FILE *fp = fopen("/proc/self/statm", "r");
+    if (NOT fp)
+        return 0;
+    if (fscanf(fp, "%lld %lld", &pages, &resident) != 2)
+        resident = 0;
+    fclose(fp);
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+static int Generate(NetlistGen::Family family, long long devices, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return ERROR;
+    NetlistGen gen;
+    gen.SetDevices(devices);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    if (NOT error)
+        printf("netlist     : %s, %lld devices\n", NetlistGen::FamilyName(family), gen.DeviceCount());
+    return error ? ERROR : OKAY;
+}
+
+/* best of repeats in seconds, < 0 if the netlist does not parse */
+static double Bench(const std::string &netlist, MyParser::ScanMode mode, int threads, int repeats)
+{
+    double best = -1;
+    for (int i = 0; i < repeats; ++ i) {
+        CircuitGraph ckt;
+        MyParser parser;
+        parser.SetScanMode(mode);
+        parser.SetThreadCount(threads);
+        parser.SetUseCache(false);
+        auto start = std::chrono::steady_clock::now();
+        if (parser.ParseNetlist(netlist, &ckt))
+            return -1;
+        std::chrono::duration<double> used = std::chrono::steady_clock::now() - start;
+        if (best < 0 || used.count() < best)
+            best = used.count();
+    }
+    return best;
+}
+
+/* the md5 NetlistCache::Load() checks the snapshot by, in seconds */
+static double HashSeconds(const std::string &netlist)
+{
+    QFile file(QString::fromStdString(netlist));
+    if (NOT file.open(QIODevice::ReadOnly))
+        return -1;
+    auto start = std::chrono::steady_clock::now();
+    qint64 size = file.size();
+    uchar *data = (size > 0) ? file.map(0, size) : nullptr;
+    QCryptographicHash md5(QCryptographicHash::Md5);
+    for (qint64 offset = 0; data AND offset < size; offset += HASH_PIECE_BYTES)
+        md5.addData(reinterpret_cast<const char*>(data) + offset, (int)qMin(HASH_PIECE_BYTES, size - offset));
+    md5.result();
+    std::chrono::duration<double> used = std::chrono::steady_clock::now() - start;
+    if (data)
+        file.unmap(data);
+    return used.count();
+}
+
+/* best reload of the snapshot in seconds, saved first by a parse, < 0 if there is none */
+static double BenchCache(const std::string &netlist, int repeats)
+{
+    CircuitGraph parsed;
+    MyParser parser;
+    parser.SetScanMode(MyParser::MmapScan);
+    if (parser.ParseNetlist(netlist, &parsed))
+        return -1;
+
+    double best = -1;
+    for (int i = 0; i < repeats; ++ i) {
+        CircuitGraph ckt;
+        NetlistCache cache(netlist);
+        auto start = std::chrono::steady_clock::now();
+        if (cache.Load(&ckt))
+            return -1;
+        std::chrono::duration<double> used = std::chrono::steady_clock::now() - start;
+        if (best < 0 || used.count() < best)
+            best = used.count();
+    }
+    return best;
+}
+
+static void PrintMemory(const std::string &netlist)
+{
+    qint64 before = ResidentBytes();
+    CircuitGraph ckt;
+    MyParser parser;
+    parser.SetScanMode(MyParser::MmapScan);
+    parser.SetUseCache(false);
+    if (parser.ParseNetlist(netlist, &ckt))
+        return;
+    qint64 resident = ResidentBytes() - before;
+
+    const NamePool *pool = ckt.GetNamePool();
+    printf("graph       : %d devices, %d nodes, %.1f MB resident\n",
+           ckt.DeviceCount(), ckt.GetNodeList().size(), resident / 1048576.0);
+    printf("NamePool    : %d segments, %.1f MB, %.1f MB as one QString per name\n",
+           pool->Count(), pool->MemoryUsage() / 1048576.0, pool->FlatQStringUsage() / 1048576.0);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string netlist;
+    NetlistGen::Family family = NetlistGen::LadderRC;
+    long long devices = DEFAULT_DEVICES;
+    int repeats = DEFAULT_REPEATS;
+
+    for (int i = 1; i < argc; ++ i) {
+        if (i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        const char *arg = argv[i];
+        const char *value = argv[++ i];
+        if (strcmp(arg, "-i") == 0) {
+            netlist = value;
+        } else if (strcmp(arg, "-g") == 0) {
+            if (NOT NetlistGen::FamilyByName(value, &family)) {
+                fprintf(stderr, "Unknown family %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "-n") == 0) {
+            devices = atoll(value);
+        } else if (strcmp(arg, "-r") == 0) {
+            repeats = qMax(atoi(value), 1);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    bool generated = netlist.empty();
+    if (generated) {
+        netlist = QDir::temp().filePath("parsebench.sp").toStdString();
+        if (Generate(family, devices, netlist)) {
+            fprintf(stderr, "Generate %s failed.\n", netlist.c_str());
+            return 1;
+        }
+    }
+
+    double mb = QFileInfo(QString::fromStdString(netlist)).size() / 1048576.0;
+    int threads = QThread::idealThreadCount();
+    printf("size        : %.1f MB, best of %d\n", mb, repeats);
+
+    /* first, before the heap is grown by the timed parses */
+    PrintMemory(netlist);
+
+    struct { const char *name; MyParser::ScanMode mode; int threads; } runs[] = {
+        { "flex",        MyParser::FlexScan, 1 },
+        { "mmap 1",      MyParser::MmapScan, 1 },
+        { "mmap all",    MyParser::MmapScan, threads },
+    };
+    for (const auto &run : runs) {
+        double seconds = Bench(netlist, run.mode, run.threads, repeats);
+        if (seconds < 0)
+            printf("%-11s : parse failed\n", run.name);
+        else
+            printf("%-11s : %8.3f s, %8.1f MB/s (%d thread(s))\n",
+                   run.name, seconds, mb / seconds, run.threads);
+    }
+
+    /* the snapshot is kept next to a netlist given by -i, as MyParser keeps it */
+    QString cachePath = QString::fromStdString(netlist) + ".nvc";
+    bool cached = QFile::exists(cachePath);
+    double seconds = BenchCache(netlist, repeats);
+    if (seconds < 0)
+        printf("%-11s : no snapshot, netlists below %lld MB are not cached\n", "cache", NETLIST_CACHE_MIN_BYTES >> 20);
+    else
+        printf("%-11s : %8.3f s, of which %.3f s md5 of the netlist\n", "cache", seconds, HashSeconds(netlist));
+    if (generated || NOT cached)
+        QFile::remove(cachePath);
+
+    if (generated)
+        QFile::remove(QString::fromStdString(netlist));
+    return 0;
+}
@@ -0,0 +1,25 @@
+#####################
+# parsebench, parse throughput and name memory of the scanners
+#####################
+
+TEMPLATE = app
+TARGET = parsebench
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= gui
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+
+INCLUDEPATH += ../NetlistGen
+
+HEADERS += ../NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ../NetlistGen/NetlistGen.cpp
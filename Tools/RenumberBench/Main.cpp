@@ -0,0 +1,177 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : renumberbench, the ASG logical passes end to end in each
+ *           : DeviceOrder: the ASG and its frozen arrays, LogicalPlacement
+ *           : (CircuitGraph::Renumber and the arrays again when the order
+ *           : is not the netlist one, the level BFS, the rows) and
+ *           : LogicalRouting, skipped past MAX_ROUTING_DEVICES as its
+ *           : track assignment is quadratic in the wires of a channel.
+ *           : The netlist is parsed again for each run, parsing is not
+ *           : timed. It is the argument, or a netlistgen clocktreercrand
+ *           : one written to the temp dir.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <QDir>
+#include <QFile>
+#include "Parser/MmapScanner.h"
+#include "Circuit/CircuitGraph.h"
+#include "ASG.h"
+#include "NetlistGen.h"
+
+static const int DEFAULT_REPEATS = 3;
+static const long long DEFAULT_DEVICES = 1000000;
+/* Channel::AssignTrackNumber() takes about a second at 20000 clock tree devices */
+static const int MAX_ROUTING_DEVICES = 50000;
+
+static void PrintUsage(const char *program)
+{
+    fprintf(stderr, "Usage : %s [-i netlist | -g family] [-n devices] [-r repeats]\n", program);
+    fprintf(stderr, "  -i : netlist to read\n");
+    fprintf(stderr, "  -g : netlistgen family to generate (clocktreercrand)\n");
+    fprintf(stderr, "  -n : devices of the generated netlist (%lld)\n", DEFAULT_DEVICES);
+    fprintf(stderr, "  -r : runs per order, the best one is reported (%d)\n", DEFAULT_REPEATS);
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> used = std::chrono::steady_clock::now() - start;
+    return used.count();
+}
+
+struct Timing
+{
+    double prepare;     // ASG(ckt), Freeze() and the NetIndex
+    double placement;
+    double routing;     // < 0 if skipped
+    qint64 crossings;
+};
+
+static double Total(const Timing &timing)
+{
+    return timing.prepare + timing.placement + qMax(timing.routing, 0.0);
+}
+
+static int Run(const std::string &netlist, DeviceOrder order, Timing *timing)
+{
+    CircuitGraph ckt;
+    MmapScanner scanner;
+    if (scanner.ParseNetlist(netlist, &ckt) || ckt.Flatten()) {
+        fprintf(stderr, "Parse %s failed.\n", netlist.c_str());
+        return ERROR;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    ASG asg(&ckt);
+    asg.SetDeviceOrder(order);
+    timing->prepare = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    int error = asg.LogicalPlacement();
+    timing->placement = Seconds(start);
+
+    timing->routing = -1;
+    if (ckt.DeviceCount() <= MAX_ROUTING_DEVICES) {
+        start = std::chrono::steady_clock::now();
+        error |= asg.LogicalRouting();
+        timing->routing = Seconds(start);
+    }
+    timing->crossings = asg.CrossingsAfter();
+    return error ? ERROR : OKAY;
+}
+
+static int Bench(const std::string &netlist, int repeats)
+{
+    struct { const char *name; DeviceOrder order; } orders[] = {
+        { "netlist order", NetlistOrder },
+        { "rcm order",     RCMOrder },
+        { "bfs order",     BFSOrder },
+    };
+
+    int error = OKAY;
+    double baseline = 0;
+    for (const auto &order : orders) {
+        Timing best = { -1, -1, -1, 0 }, timing;
+        for (int i = 0; i < repeats; ++ i) {
+            if (Run(netlist, order.order, &timing))
+                return ERROR;
+            if (best.prepare < 0 || Total(timing) < Total(best))
+                best = timing;
+        }
+        if (order.order == NetlistOrder)
+            baseline = Total(best);
+        printf("%-13s : asg %7.3f s, placement %7.3f s, ", order.name, best.prepare, best.placement);
+        if (best.routing < 0)
+            printf("routing skipped, ");
+        else
+            printf("routing %7.3f s, ", best.routing);
+        printf("total %7.3f s (%5.2fx), %lld crossings\n", Total(best), baseline / Total(best),
+               (long long)best.crossings);
+    }
+    return error;
+}
+
+static int Generate(NetlistGen::Family family, long long devices, const std::string &path)
+{
+    FILE *fp = fopen(path.c_str(), "w");
+    if (NOT fp)
+        return ERROR;
+    NetlistGen gen;
+    gen.SetDevices(devices);
+    int error = gen.Generate(family, fp);
+    error |= (fclose(fp) != 0);
+    if (NOT error)
+        printf("%-13s : %s, %lld devices\n", "netlist", NetlistGen::FamilyName(family), gen.DeviceCount());
+    return error ? ERROR : OKAY;
+}
+
+int main(int argc, char *argv[])
+{
+    std::string netlist;
+    NetlistGen::Family family = NetlistGen::ClockTreeRCRand;
+    long long devices = DEFAULT_DEVICES;
+    int repeats = DEFAULT_REPEATS;
+
+    for (int i = 1; i < argc; ++ i) {
+        if (i + 1 >= argc) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        const char *arg = argv[i];
+        const char *value = argv[++ i];
+        if (strcmp(arg, "-i") == 0) {
+            netlist = value;
+        } else if (strcmp(arg, "-g") == 0) {
+            if (NOT NetlistGen::FamilyByName(value, &family)) {
+                fprintf(stderr, "Unknown family %s\n", value);
+                return 1;
+            }
+        } else if (strcmp(arg, "-n") == 0) {
+            devices = atoll(value);
+        } else if (strcmp(arg, "-r") == 0) {
+            repeats = qMax(atoi(value), 1);
+        } else {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (NOT netlist.empty())
+        return Bench(netlist, repeats) ? 1 : 0;
+
+    netlist = QDir::temp().filePath("renumberbench.sp").toStdString();
+    if (Generate(family, devices, netlist)) {
+        fprintf(stderr, "Generate %s failed.\n", netlist.c_str());
+        return 1;
+    }
+    int error = Bench(netlist, repeats);
+    QFile::remove(QString::fromStdString(netlist));
+    return error ? 1 : 0;
+}
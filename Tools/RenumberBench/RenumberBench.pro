@@ -0,0 +1,27 @@
+#####################
+# renumberbench, the ASG logical passes in netlist, RCM and BFS device order
+#####################
+
+TEMPLATE = app
+TARGET = renumberbench
+
+QMAKE_CXXFLAGS += -std=c++17
+
+# ASG::PlotLevels() links TablePlotter, nothing is shown
+QT += widgets
+CONFIG += console release
+CONFIG -= app_bundle
+
+OBJECTS_DIR = ./build
+
+LIBS += -lz
+
+include(../../Src/Parser/Parser.pri)
+include(../../Src/ASG/ASG.pri)
+
+INCLUDEPATH += ../NetlistGen
+
+HEADERS += ../NetlistGen/NetlistGen.h
+
+SOURCES += ./Main.cpp\
+           ../NetlistGen/NetlistGen.cpp
@@ -0,0 +1,12 @@
+#####################
+# netlistviz tools, netlist generator and benchmarks
+#####################
+
+TEMPLATE = subdirs
+
+SUBDIRS += LevelBench\
+           MatrixBench\
+           NetlistGen\
+           ParseBench\
+           RenumberBench\
+           ValueBench
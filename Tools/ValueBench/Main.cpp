@@ -0,0 +1,117 @@
+/*
+ * @filename : Main.cpp
+ * @author   : agent
+ * @date     : 2026.10.17
+ * @email    : agent@local
+ * @desp     : valuebench, ns per value of ParseSpiceValue against the
+ *           : CvtStrToValue that CktScanner.l used before it, on a seeded
+ *           : mix of SPICE values, and how many values the two disagree on.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "Parser/SpiceValue.h"
+
+static const int DEFAULT_VALUES = 1000000;
+static const int ROUNDS = 5;
+
+static const char *NUMBERS[] = { "1", "47", "-1", "0.5", "2.2", "100", "1.5e3", "4.7E-2", "33", ".1" };
+static const char *SUFFIXES[] = { "", "", "", "f", "p", "n", "u", "m", "k", "meg", "g",
+                                  "pF", "uF", "nH", "ns", "kHz", "ohm", "kohm" };
+
+/* the CktScanner.l one, scans the suffix backwards after atof */
+static double CvtStrToValue(const char *str)
+{
+    double value;
+    value = atof(str);
+    int len = strlen(str);
+    char u;
+
+    for (int i = len - 1; i >= 0; -- i) {
+        u = str[i];
+        if (u == 'S' || u == 's') continue;
+        if (u == 'H' || u == 'h') continue;
+        if (u == 'Z' || u == 'z') continue;
+
+        if (u == 'F' || u == 'f')
+            value *= 1e-15;
+        else if (u == 'P' || u == 'p')
+            value *= 1e-12;
+        else if (u == 'N' || u == 'n')
+            value *= 1e-9;
+        else if (u == 'U' || u == 'u')
+            value *= 1e-6;
+        else if (u == 'M' || u == 'm')
+            value *= 1e-3;
+        else if (u == 'K' || u == 'k')
+            value *= 1e3;
+        else if (u == 'G' || u == 'g') {
+            if (str[i - 1] == 'E' || str[i - 1] == 'e')
+                value *= 1e6;
+            else
+                value *= 1e9;
+        } else if (u >= '0' && u <= '9')
+            break;
+    }
+
+    return value;
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::duration<double> used = std::chrono::steady_clock::now() - start;
+    return used.count();
+}
+
+int main(int argc, char *argv[])
+{
+    int count = (argc > 1) ? atoi(argv[1]) : DEFAULT_VALUES;
+    if (count <= 0) {
+        fprintf(stderr, "Usage : %s [values]\n", argv[0]);
+        return 1;
+    }
+
+    std::mt19937 rand(1);
+    std::vector<std::string> values(count);
+    for (std::string &value : values) {
+        value = NUMBERS[rand() % (sizeof(NUMBERS) / sizeof(NUMBERS[0]))];
+        value += SUFFIXES[rand() % (sizeof(SUFFIXES) / sizeof(SUFFIXES[0]))];
+    }
+
+    /* best of ROUNDS, the sums keep the loops alive */
+    double oldBest = 1e30, newBest = 1e30, oldSum = 0, newSum = 0;
+    for (int round = 0; round < ROUNDS; ++ round) {
+        auto start = std::chrono::steady_clock::now();
+        for (const std::string &value : values)
+            oldSum += CvtStrToValue(value.c_str());
+        oldBest = std::min(oldBest, Seconds(start));
+
+        start = std::chrono::steady_clock::now();
+        double number = 0;
+        for (const std::string &value : values) {
+            ParseSpiceValue(value, &number);
+            newSum += number;
+        }
+        newBest = std::min(newBest, Seconds(start));
+    }
+
+    int differ = 0;
+    for (const std::string &value : values) {
+        double number = 0;
+        ParseSpiceValue(value, &number);
+        if (number != CvtStrToValue(value.c_str()))
+            differ++;
+    }
+
+    printf("values          : %d, best of %d (sums %g %g)\n", count, ROUNDS, oldSum, newSum);
+    printf("CvtStrToValue   : %6.1f ns/value\n", oldBest * 1e9 / count);
+    printf("ParseSpiceValue : %6.1f ns/value\n", newBest * 1e9 / count);
+    printf("disagree        : %d values (meg, pF, uF and ohm, which CvtStrToValue got wrong)\n", differ);
+    return 0;
+}
@@ -0,0 +1,19 @@
+#####################
+# valuebench, ParseSpiceValue against CvtStrToValue
+#####################
+
+TEMPLATE = app
+TARGET = valuebench
+
+QMAKE_CXXFLAGS += -std=c++17
+
+QT -= core gui
+CONFIG += console release
+CONFIG -= app_bundle qt
+
+OBJECTS_DIR = ./build
+
+INCLUDEPATH += ../../Src
+
+SOURCES += ./Main.cpp\
+           ../../Src/Parser/SpiceValue.cpp